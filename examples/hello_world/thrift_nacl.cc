@@ -1,15 +1,74 @@
+#include <pthread.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#include <set>
+#include <utility>
+#include <vector>
+
 #include <boost/shared_ptr.hpp>
 
+#include "ppapi/c/ppb_console.h"
+#include "ppapi/cpp/core.h"
 #include "ppapi/cpp/instance.h"
+#include "ppapi/cpp/message_loop.h"
 #include "ppapi/cpp/module.h"
 #include "ppapi/cpp/var.h"
+#include "ppapi/cpp/var_array.h"
+#include "ppapi/cpp/var_array_buffer.h"
 #include "ppapi/cpp/var_dictionary.h"
+#include "ppapi/utility/completion_callback_factory.h"
+#include "thrift/concurrency/Mutex.h"
+#include "thrift/concurrency/PosixThreadFactory.h"
+#include "thrift/concurrency/ThreadManager.h"
+#include "thrift/protocol/TCompactProtocol.h"
+#include "thrift/transport/TBufferTransports.h"
 
 #include "thrift_nacl.h"
+#include "thrift_nacl_cache.h"
+#include "thrift_nacl_vars.h"
+
+using apache::thrift::TException;
+using apache::thrift::TProcessor;
+using apache::thrift::concurrency::Guard;
+using apache::thrift::concurrency::Mutex;
+using apache::thrift::concurrency::PosixThreadFactory;
+using apache::thrift::concurrency::Runnable;
+using apache::thrift::concurrency::ThreadManager;
+using apache::thrift::protocol::TCompactProtocol;
+using apache::thrift::protocol::TMessageType;
+using apache::thrift::protocol::TNativeClientProtocol;
+using apache::thrift::protocol::TProtocol;
+using apache::thrift::transport::TMemoryBuffer;
 
 namespace thrift_nacl {
 
-typedef std::map<std::string, MessageHandler> MessageHandlerMap;
+struct MessageTypeStats;
+static MessageTypeStats* GetMessageTypeStats(const std::string& message_type);
+
+// A registered handler and the stats of its message type, which are looked
+// up when the handler is registered so that recording a message takes no
+// lock.
+template <typename Handler>
+struct RegisteredHandler {
+  RegisteredHandler(Handler handler, MessageTypeStats* stats)
+      : handler(handler), stats(stats) {}
+
+  Handler handler;
+  MessageTypeStats* stats;
+};
+
+typedef std::map<std::string, RegisteredHandler<MessageHandler> >
+    MessageHandlerMap;
+typedef std::map<std::string, RegisteredHandler<BinaryMessageHandler> >
+    BinaryMessageHandlerMap;
+typedef std::map<std::string, RegisteredHandler<StreamingMessageHandler> >
+    StreamingMessageHandlerMap;
+typedef std::set<std::string> WorkerMessageTypeSet;
+
+static size_t worker_thread_count = 4;
+static bool response_dedup = false;
 
 MessageHandlerMap& GetMessageHandlerMap() {
   static MessageHandlerMap message_handler_map;
@@ -19,12 +78,175 @@ MessageHandlerMap& GetMessageHandlerMap() {
 bool RegisterMessageHandler(const std::string& message_type,
                             MessageHandler handler) {
   GetMessageHandlerMap().insert(
-      MessageHandlerMap::value_type(message_type, handler));
+      MessageHandlerMap::value_type(
+          message_type, RegisteredHandler<MessageHandler>(
+              handler, GetMessageTypeStats(message_type))));
+  return true;
+}
+
+BinaryMessageHandlerMap& GetBinaryMessageHandlerMap() {
+  static BinaryMessageHandlerMap binary_message_handler_map;
+  return binary_message_handler_map;
+}
+
+bool RegisterBinaryMessageHandler(const std::string& message_type,
+                                  BinaryMessageHandler handler) {
+  GetBinaryMessageHandlerMap().insert(
+      BinaryMessageHandlerMap::value_type(
+          message_type, RegisteredHandler<BinaryMessageHandler>(
+              handler, GetMessageTypeStats(message_type))));
   return true;
 }
 
+bool GetBinaryMessageHandler(const std::string& message_type,
+                             BinaryMessageHandler* message_handler,
+                             MessageTypeStats** stats) {
+  const BinaryMessageHandlerMap& message_handler_map =
+      GetBinaryMessageHandlerMap();
+  BinaryMessageHandlerMap::const_iterator iter =
+      message_handler_map.find(message_type);
+
+  if (iter == message_handler_map.end()) {
+    return false;
+  }
+  *message_handler = iter->second.handler;
+  *stats = iter->second.stats;
+  return true;
+}
+
+StreamingMessageHandlerMap& GetStreamingMessageHandlerMap() {
+  static StreamingMessageHandlerMap streaming_message_handler_map;
+  return streaming_message_handler_map;
+}
+
+bool RegisterStreamingMessageHandler(const std::string& message_type,
+                                     StreamingMessageHandler handler) {
+  GetStreamingMessageHandlerMap().insert(
+      StreamingMessageHandlerMap::value_type(
+          message_type, RegisteredHandler<StreamingMessageHandler>(
+              handler, GetMessageTypeStats(message_type))));
+  return true;
+}
+
+bool GetStreamingMessageHandler(const std::string& message_type,
+                                StreamingMessageHandler* message_handler,
+                                MessageTypeStats** stats) {
+  const StreamingMessageHandlerMap& message_handler_map =
+      GetStreamingMessageHandlerMap();
+  StreamingMessageHandlerMap::const_iterator iter =
+      message_handler_map.find(message_type);
+
+  if (iter == message_handler_map.end()) {
+    return false;
+  }
+  *message_handler = iter->second.handler;
+  *stats = iter->second.stats;
+  return true;
+}
+
+boost::shared_ptr<TProcessor>& GetProcessor() {
+  static boost::shared_ptr<TProcessor> processor;
+  return processor;
+}
+
+bool RegisterProcessor(boost::shared_ptr<TProcessor> processor) {
+  if (GetProcessor()) {
+    return false;
+  }
+  GetProcessor() = processor;
+  return true;
+}
+
+struct MessageRecord;
+
+// Protocols reused by the messages handled on a thread, and the stats of the
+// message being handled.
+struct ThreadState {
+  ThreadState() : record(NULL), timer(NULL) {}
+
+  boost::shared_ptr<TNativeClientProtocol> in;
+  boost::shared_ptr<TNativeClientProtocol> out;
+  // NULL outside of a message or with message stats disabled.
+  MessageRecord* record;
+  // The innermost running ScopedPhaseTimer.
+  ScopedPhaseTimer* timer;
+  // NULL outside of a message or for messages without deadline handled on
+  // the main thread.
+  boost::shared_ptr<CancellationToken> token;
+};
+
+static pthread_key_t thread_state_key;
+static pthread_once_t thread_state_once = PTHREAD_ONCE_INIT;
+
+static void DeleteThreadState(void* state) {
+  delete static_cast<ThreadState*>(state);
+}
+
+static void CreateThreadStateKey() {
+  pthread_key_create(&thread_state_key, DeleteThreadState);
+}
+
+static ThreadState* GetThreadState() {
+  pthread_once(&thread_state_once, CreateThreadStateKey);
+  ThreadState* state = static_cast<ThreadState*>(
+      pthread_getspecific(thread_state_key));
+  if (state == NULL) {
+    state = new ThreadState();
+    state->in.reset(new TNativeClientProtocol());
+    state->out.reset(new TNativeClientProtocol());
+    pthread_setspecific(thread_state_key, state);
+  }
+  return state;
+}
+
+boost::shared_ptr<TNativeClientProtocol> GetThreadInputProtocol(
+    const pp::Var& var) {
+  ThreadState* state = GetThreadState();
+  state->in->setRootVar(var);
+  return state->in;
+}
+
+boost::shared_ptr<TNativeClientProtocol> GetThreadOutputProtocol() {
+  ThreadState* state = GetThreadState();
+  state->out->reset();
+  state->out->setDedupSubtrees(response_dedup);
+  return state->out;
+}
+
+void SetResponseDedup(bool dedup) {
+  response_dedup = dedup;
+}
+
+bool GetResponseDedup() {
+  return response_dedup;
+}
+
+WorkerMessageTypeSet& GetWorkerMessageTypeSet() {
+  static WorkerMessageTypeSet worker_message_type_set;
+  return worker_message_type_set;
+}
+
+bool SetHandlerThread(const std::string& message_type,
+                      HandlerThread handler_thread) {
+  if (handler_thread == WORKER_THREAD) {
+    GetWorkerMessageTypeSet().insert(message_type);
+  } else {
+    GetWorkerMessageTypeSet().erase(message_type);
+  }
+  return true;
+}
+
+void SetWorkerThreadCount(size_t count) {
+  worker_thread_count = count;
+}
+
+size_t GetWorkerThreadCount() {
+  return worker_thread_count;
+}
+
 bool GetMessageHandler(const std::string& message_type,
-                       MessageHandler* message_handler) {
+                       MessageHandler* message_handler,
+                       MessageTypeStats** stats) {
   const MessageHandlerMap& message_handler_map = GetMessageHandlerMap();
   MessageHandlerMap::const_iterator iter =
       message_handler_map.find(message_type);
@@ -32,28 +254,929 @@ bool GetMessageHandler(const std::string& message_type,
   if (iter == message_handler_map.end()) {
     return false;
   }
-  *message_handler = iter->second;
+  *message_handler = iter->second.handler;
+  *stats = iter->second.stats;
+  return true;
+}
+
+// Message stats.  The counters are only updated with atomic operations, so
+// the main thread and the worker threads record messages without locking.
+// The lock only guards the map of stats by message type, which is used when
+// handlers are registered and when the stats are read.
+
+static bool message_stats_enabled = true;
+static bool message_size_stats_enabled = false;
+static int32_t message_stats_log_interval_ms = 0;
+
+// Element i of a histogram counts durations of [2^i, 2^(i+1)) nanoseconds,
+// the last element the longer ones.
+static const int kNumHistogramBuckets = 32;
+
+// Calls dispatched to the processor are counted as kProcessorMessageType,
+// and those of unknown message types as kOtherMessageType.
+static const char kProcessorMessageType[] = "__processor";
+static const char kOtherMessageType[] = "__other";
+
+static const char* const kMessagePhaseNames[NUM_MESSAGE_PHASES] = {
+  "parse", "read", "handler", "write", "post"
+};
+
+struct PhaseStats {
+  uint64_t count;
+  uint64_t total_ns;
+  uint64_t max_ns;
+  uint64_t histogram[kNumHistogramBuckets];
+};
+
+struct MessageTypeStats {
+  uint64_t count;
+  uint64_t request_nodes;
+  uint64_t request_bytes;
+  uint64_t response_nodes;
+  uint64_t response_bytes;
+  PhaseStats phases[NUM_MESSAGE_PHASES];
+};
+
+// Stats of one message, recorded by the thread handling it and added to the
+// stats of its message type once the response is posted.
+struct MessageRecord {
+  MessageRecord()
+      : stats(NULL),
+        request_nodes(0),
+        request_bytes(0),
+        response_nodes(0),
+        response_bytes(0) {
+    memset(phase_ns, 0, sizeof(phase_ns));
+  }
+
+  // Stats of the message type.  NULL if the message was not handled, or
+  // handed to a worker thread which records it separately.
+  MessageTypeStats* stats;
+  uint64_t phase_ns[NUM_MESSAGE_PHASES];
+  uint64_t request_nodes;
+  uint64_t request_bytes;
+  uint64_t response_nodes;
+  uint64_t response_bytes;
+};
+
+typedef std::map<std::string, MessageTypeStats*> MessageStatsMap;
+
+static uint64_t GetMonotonicTimeNs() {
+  struct timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return static_cast<uint64_t>(now.tv_sec) * 1000000000ULL + now.tv_nsec;
+}
+
+static void AtomicAdd(uint64_t* value, uint64_t delta) {
+  __sync_fetch_and_add(value, delta);
+}
+
+static void AtomicMax(uint64_t* value, uint64_t candidate) {
+  uint64_t current = *value;
+  while (candidate > current) {
+    uint64_t previous =
+        __sync_val_compare_and_swap(value, current, candidate);
+    if (previous == current) {
+      break;
+    }
+    current = previous;
+  }
+}
+
+// 64 bit loads are not atomic on every NaCl target.
+static uint64_t AtomicRead(uint64_t* value, bool reset) {
+  return reset ? __sync_fetch_and_and(value, 0)
+               : __sync_fetch_and_add(value, 0);
+}
+
+static int GetHistogramBucket(uint64_t ns) {
+  int bucket = 0;
+  while (ns > 1 && bucket < kNumHistogramBuckets - 1) {
+    ns >>= 1;
+    ++bucket;
+  }
+  return bucket;
+}
+
+static Mutex& GetMessageStatsMutex() {
+  static Mutex message_stats_mutex;
+  return message_stats_mutex;
+}
+
+// Must be called with the message stats mutex held.
+static MessageStatsMap& GetMessageStatsMap() {
+  static MessageStatsMap message_stats_map;
+  return message_stats_map;
+}
+
+// Returns the stats of a message type, creating them if needed.  Called
+// when a handler is registered, not for each message.
+static MessageTypeStats* GetMessageTypeStats(const std::string& message_type) {
+  Guard guard(GetMessageStatsMutex());
+  MessageStatsMap& message_stats_map = GetMessageStatsMap();
+  MessageStatsMap::iterator iter = message_stats_map.find(message_type);
+  if (iter != message_stats_map.end()) {
+    return iter->second;
+  }
+  // Stats are never freed, so they can be updated without the lock.
+  MessageTypeStats* stats = new MessageTypeStats();
+  message_stats_map[message_type] = stats;
+  return stats;
+}
+
+static MessageTypeStats* GetProcessorMessageStats() {
+  static MessageTypeStats* stats = GetMessageTypeStats(kProcessorMessageType);
+  return stats;
+}
+
+static MessageTypeStats* GetOtherMessageStats() {
+  static MessageTypeStats* stats = GetMessageTypeStats(kOtherMessageType);
+  return stats;
+}
+
+// Returns the stats of a message without a registered handler.
+static MessageTypeStats* GetUnhandledMessageStats() {
+  return GetProcessor() ? GetProcessorMessageStats() : GetOtherMessageStats();
+}
+
+static void AddMessageRecord(const MessageRecord& record) {
+  if (!message_stats_enabled || record.stats == NULL) {
+    return;
+  }
+
+  MessageTypeStats* stats = record.stats;
+  AtomicAdd(&stats->count, 1);
+  if (message_size_stats_enabled) {
+    AtomicAdd(&stats->request_nodes, record.request_nodes);
+    AtomicAdd(&stats->request_bytes, record.request_bytes);
+    AtomicAdd(&stats->response_nodes, record.response_nodes);
+    AtomicAdd(&stats->response_bytes, record.response_bytes);
+  }
+  for (int i = 0; i < NUM_MESSAGE_PHASES; ++i) {
+    PhaseStats* phase = &stats->phases[i];
+    uint64_t ns = record.phase_ns[i];
+    AtomicAdd(&phase->count, 1);
+    AtomicAdd(&phase->total_ns, ns);
+    AtomicMax(&phase->max_ns, ns);
+    AtomicAdd(&phase->histogram[GetHistogramBucket(ns)], 1);
+  }
+}
+
+// Adds the number of vars in the tree of var and an estimate of their size
+// in bytes to nodes and bytes.
+static void CountVarNodes(const pp::Var& var, uint64_t* nodes,
+                          uint64_t* bytes) {
+  ++*nodes;
+  if (var.is_string()) {
+    *bytes += var.AsString().size();
+  } else if (var.is_number()) {
+    *bytes += sizeof(double);
+  } else if (var.is_bool()) {
+    *bytes += 1;
+  } else if (var.is_array_buffer()) {
+    *bytes += pp::VarArrayBuffer(var).ByteLength();
+  } else if (var.is_array()) {
+    const pp::VarArray* array = static_cast<const pp::VarArray*>(&var);
+    uint32_t length = array->GetLength();
+    for (uint32_t i = 0; i < length; ++i) {
+      CountVarNodes(array->Get(i), nodes, bytes);
+    }
+  } else if (var.is_dictionary()) {
+    const pp::VarDictionary* dict = static_cast<const pp::VarDictionary*>(&var);
+    pp::VarArray keys = dict->GetKeys();
+    uint32_t length = keys.GetLength();
+    for (uint32_t i = 0; i < length; ++i) {
+      pp::Var key = keys.Get(i);
+      *bytes += key.AsString().size();
+      CountVarNodes(dict->Get(key), nodes, bytes);
+    }
+  }
+}
+
+// Makes record and token those of the message handled on the calling thread
+// while in scope.  The phases timed on the thread are recorded in record
+// unless it is NULL or message stats are disabled.
+class MessageScope {
+ public:
+  MessageScope(MessageRecord* record,
+               const boost::shared_ptr<CancellationToken>& token)
+      : state_(GetThreadState()) {
+    state_->record = message_stats_enabled ? record : NULL;
+    state_->token = token;
+  }
+
+  ~MessageScope() {
+    state_->record = NULL;
+    state_->token.reset();
+  }
+
+ private:
+  ThreadState* state_;
+};
+
+ScopedPhaseTimer::ScopedPhaseTimer(MessagePhase phase)
+    : phase_(phase),
+      start_ns_(0),
+      nested_ns_(0),
+      parent_(NULL),
+      active_(false) {
+  if (!message_stats_enabled) {
+    return;
+  }
+  ThreadState* state = GetThreadState();
+  if (state->record == NULL) {
+    return;
+  }
+  active_ = true;
+  parent_ = state->timer;
+  state->timer = this;
+  start_ns_ = GetMonotonicTimeNs();
+}
+
+ScopedPhaseTimer::~ScopedPhaseTimer() {
+  if (!active_) {
+    return;
+  }
+  uint64_t elapsed_ns = GetMonotonicTimeNs() - start_ns_;
+  ThreadState* state = GetThreadState();
+  state->timer = parent_;
+  if (parent_) {
+    parent_->nested_ns_ += elapsed_ns;
+  }
+  if (state->record) {
+    state->record->phase_ns[phase_] += elapsed_ns - nested_ns_;
+  }
+}
+
+void SetMessageStatsEnabled(bool enabled) {
+  message_stats_enabled = enabled;
+}
+
+bool GetMessageStatsEnabled() {
+  return message_stats_enabled;
+}
+
+void SetMessageSizeStatsEnabled(bool enabled) {
+  message_size_stats_enabled = enabled;
+}
+
+bool GetMessageSizeStatsEnabled() {
+  return message_size_stats_enabled;
+}
+
+void SetMessageStatsLogInterval(int32_t interval_ms) {
+  message_stats_log_interval_ms = interval_ms;
+}
+
+int32_t GetMessageStatsLogInterval() {
+  return message_stats_log_interval_ms;
+}
+
+static void GetPhaseStats(PhaseStats* phase, bool reset,
+                          ThriftNaClPhaseStats* phase_stats) {
+  phase_stats->set_count(AtomicRead(&phase->count, reset));
+  phase_stats->set_total_ns(AtomicRead(&phase->total_ns, reset));
+  phase_stats->set_max_ns(AtomicRead(&phase->max_ns, reset));
+  std::vector<int64_t>* histogram = phase_stats->mutable_histogram();
+  histogram->resize(kNumHistogramBuckets);
+  for (int i = 0; i < kNumHistogramBuckets; ++i) {
+    (*histogram)[i] = AtomicRead(&phase->histogram[i], reset);
+  }
+}
+
+static void GetMessageCacheStats(const std::string& message_type, bool reset,
+                                 ThriftNaClMessageStats* stats);
+
+// Returns the stats of every message type, and clears them if reset is
+// true.
+static void GetMessageStats(bool reset, ThriftNaClStats* stats) {
+  std::vector<std::pair<std::string, MessageTypeStats*> > message_types;
+  {
+    Guard guard(GetMessageStatsMutex());
+    const MessageStatsMap& message_stats_map = GetMessageStatsMap();
+    message_types.assign(message_stats_map.begin(), message_stats_map.end());
+  }
+
+  std::vector<ThriftNaClMessageStats>* message_stats =
+      stats->mutable_message_types();
+  message_stats->resize(message_types.size());
+  for (size_t i = 0; i < message_types.size(); ++i) {
+    MessageTypeStats* type_stats = message_types[i].second;
+    ThriftNaClMessageStats* out = &(*message_stats)[i];
+    out->set_message_type(message_types[i].first);
+    out->set_count(AtomicRead(&type_stats->count, reset));
+    if (message_size_stats_enabled) {
+      out->set_request_nodes(AtomicRead(&type_stats->request_nodes, reset));
+      out->set_request_bytes(AtomicRead(&type_stats->request_bytes, reset));
+      out->set_response_nodes(
+          AtomicRead(&type_stats->response_nodes, reset));
+      out->set_response_bytes(
+          AtomicRead(&type_stats->response_bytes, reset));
+    }
+    GetMessageCacheStats(message_types[i].first, reset, out);
+
+    std::vector<ThriftNaClPhaseStats>* phases = out->mutable_phases();
+    phases->resize(NUM_MESSAGE_PHASES);
+    for (int j = 0; j < NUM_MESSAGE_PHASES; ++j) {
+      (*phases)[j].set_phase(kMessagePhaseNames[j]);
+      GetPhaseStats(&type_stats->phases[j], reset, &(*phases)[j]);
+    }
+  }
+}
+
+// Formats the stats for the JavaScript console, one line per message type
+// with the mean and maximum latency of each phase in microseconds.
+static std::string FormatMessageStats(const ThriftNaClStats& stats) {
+  std::string text = "thrift_nacl message stats:";
+  const std::vector<ThriftNaClMessageStats>& message_types =
+      stats.get_message_types();
+  for (size_t i = 0; i < message_types.size(); ++i) {
+    const ThriftNaClMessageStats& type_stats = message_types[i];
+    int64_t count = type_stats.get_count();
+    if (count == 0) {
+      continue;
+    }
+
+    char line[256];
+    snprintf(line, sizeof(line), "\n%s: %lld messages",
+             type_stats.get_message_type().c_str(),
+             static_cast<long long>(count));
+    text += line;
+    if (type_stats.has_request_nodes()) {
+      snprintf(line, sizeof(line),
+               ", %lld/%lld request nodes/bytes, "
+               "%lld/%lld response nodes/bytes",
+               static_cast<long long>(type_stats.get_request_nodes() / count),
+               static_cast<long long>(type_stats.get_request_bytes() / count),
+               static_cast<long long>(type_stats.get_response_nodes() / count),
+               static_cast<long long>(
+                   type_stats.get_response_bytes() / count));
+      text += line;
+    }
+    if (type_stats.has_cache_hits()) {
+      snprintf(line, sizeof(line), ", %lld/%lld cache hits/misses",
+               static_cast<long long>(type_stats.get_cache_hits()),
+               static_cast<long long>(type_stats.get_cache_misses()));
+      text += line;
+    }
+
+    const std::vector<ThriftNaClPhaseStats>& phases =
+        type_stats.get_phases();
+    for (size_t j = 0; j < phases.size(); ++j) {
+      snprintf(line, sizeof(line), ", %s %.1f/%.1f us",
+               phases[j].get_phase().c_str(),
+               phases[j].get_total_ns() / 1000.0 / count,
+               phases[j].get_max_ns() / 1000.0);
+      text += line;
+    }
+  }
+  return text;
+}
+
+static bool GetStats(const ThriftNaClStatsRequest& request,
+                     ThriftNaClStats* response,
+                     ThriftNaClError* error) {
+  GetMessageStats(request.get_reset(), response);
   return true;
 }
 
+REGISTER_MESSAGE_HANDLER_FULL("__stats", GetStats, ThriftNaClStatsRequest, ThriftNaClStats, ThriftNaClError)
+
+// Tokens of the messages queued or running on a worker thread, by message
+// id.
+typedef std::map<std::string, boost::shared_ptr<CancellationToken> >
+    CancellationTokenMap;
+
+CancellationToken::CancellationToken()
+    : cancelled_(0),
+      deadline_ns_(0) {}
+
+CancellationToken::CancellationToken(uint64_t deadline_ns)
+    : cancelled_(0),
+      deadline_ns_(deadline_ns) {}
+
+bool CancellationToken::IsCancelled() const {
+  return cancelled_ != 0 || IsDeadlineExceeded();
+}
+
+bool CancellationToken::IsDeadlineExceeded() const {
+  return deadline_ns_ != 0 && GetMonotonicTimeNs() >= deadline_ns_;
+}
+
+void CancellationToken::Cancel() {
+  __sync_lock_test_and_set(&cancelled_, 1);
+}
+
+boost::shared_ptr<CancellationToken> GetCancellationToken() {
+  static boost::shared_ptr<CancellationToken> never_cancelled(
+      new CancellationToken());
+  const boost::shared_ptr<CancellationToken>& token = GetThreadState()->token;
+  return token ? token : never_cancelled;
+}
+
+// Returns the token for a message, with the deadline of a {id, type, data,
+// deadline} message, or NULL if the message has no deadline.
+static boost::shared_ptr<CancellationToken> CreateCancellationToken(
+    const pp::Var& var_message) {
+  boost::shared_ptr<CancellationToken> token;
+  if (!var_message.is_dictionary()) {
+    return token;
+  }
+  pp::Var deadline =
+      static_cast<const pp::VarDictionary*>(&var_message)->Get("deadline");
+  if (deadline.is_number() && deadline.AsDouble() > 0) {
+    token.reset(new CancellationToken(
+        GetMonotonicTimeNs() +
+        static_cast<uint64_t>(deadline.AsDouble() * 1000000)));
+  }
+  return token;
+}
+
+static Mutex& GetCancellationTokenMutex() {
+  static Mutex cancellation_token_mutex;
+  return cancellation_token_mutex;
+}
+
+// Must be called with the cancellation token mutex held.
+static CancellationTokenMap& GetCancellationTokenMap() {
+  static CancellationTokenMap cancellation_token_map;
+  return cancellation_token_map;
+}
+
+static void RegisterCancellationToken(
+    const std::string& message_id,
+    const boost::shared_ptr<CancellationToken>& token) {
+  Guard guard(GetCancellationTokenMutex());
+  GetCancellationTokenMap()[message_id] = token;
+}
+
+static void UnregisterCancellationToken(const std::string& message_id) {
+  Guard guard(GetCancellationTokenMutex());
+  GetCancellationTokenMap().erase(message_id);
+}
+
+// Unregisters the token of a message handed to a worker thread when the
+// message ends, whether or not its handler threw.
+class ScopedCancellationTokenRegistration {
+ public:
+  explicit ScopedCancellationTokenRegistration(const std::string& message_id)
+      : message_id_(message_id) {}
+
+  ~ScopedCancellationTokenRegistration() {
+    if (!message_id_.empty()) {
+      UnregisterCancellationToken(message_id_);
+    }
+  }
+
+ private:
+  std::string message_id_;
+};
+
+static bool CancelMessage(const ThriftNaClCancelRequest& request,
+                          ThriftNaClCancelResponse* response,
+                          ThriftNaClError* error) {
+  Guard guard(GetCancellationTokenMutex());
+  CancellationTokenMap& cancellation_token_map = GetCancellationTokenMap();
+  CancellationTokenMap::iterator iter =
+      cancellation_token_map.find(request.get_id());
+  if (iter != cancellation_token_map.end()) {
+    iter->second->Cancel();
+  }
+  response->set_cancelled(iter != cancellation_token_map.end());
+  return true;
+}
+
+REGISTER_MESSAGE_HANDLER_FULL("__cancel", CancelMessage, ThriftNaClCancelRequest, ThriftNaClCancelResponse, ThriftNaClError)
+
+ResponseStream::ResponseStream(const std::string& message_id)
+    : message_id_(message_id),
+      seq_(0),
+      chunk_size_(kDefaultChunkSize),
+      chunk_length_(0) {}
+
+ResponseStream::~ResponseStream() {}
+
+void ResponseStream::Write(const apache::thrift::TStruct& element) {
+  if (chunk_length_ == 0) {
+    chunk_ = pp::VarArray();
+  }
+
+  protocol_.reset();
+  element.write(&protocol_);
+  static_cast<pp::VarArray*>(&chunk_)->Set(chunk_length_++,
+                                           protocol_.getRootVar());
+
+  if (chunk_length_ >= chunk_size_) {
+    Flush();
+  }
+}
+
+void ResponseStream::WriteBinary(const void* data, uint32_t size) {
+  Flush();
+
+  pp::VarArrayBuffer buffer(size);
+  if (size > 0) {
+    memcpy(buffer.Map(), data, size);
+    buffer.Unmap();
+  }
+  PostChunk(buffer);
+}
+
+void ResponseStream::Flush() {
+  if (chunk_length_ == 0) {
+    return;
+  }
+  pp::Var chunk = chunk_;
+  chunk_ = pp::Var();
+  chunk_length_ = 0;
+  PostChunk(chunk);
+}
+
+void ResponseStream::PostChunk(const pp::Var& chunk) {
+  pp::VarDictionary message;
+  message.Set(pp::Var("id"), pp::Var(message_id_));
+  message.Set(pp::Var("seq"), pp::Var(static_cast<int32_t>(seq_++)));
+  message.Set(pp::Var("chunk"), chunk);
+  PostChunkMessage(message);
+}
+
+StatePublisher::StatePublisher(pp::Instance* instance,
+                               const std::string& state_name)
+    : instance_(instance),
+      state_name_(state_name) {}
+
+void StatePublisher::Publish(const apache::thrift::TStruct& state) {
+  protocol_.reset();
+  state.write(&protocol_);
+  pp::Var state_var = protocol_.getRootVar();
+
+  pp::VarDictionary message;
+  message.Set("state", pp::Var(state_name_));
+  if (snapshot_.is_undefined()) {
+    message.Set("data", state_var);
+  } else {
+    pp::VarDictionary patch;
+    if (DiffVar(snapshot_, state_var, &patch) == DIFF_UNCHANGED) {
+      snapshot_ = state_var;
+      return;
+    }
+    message.Set("patch", patch);
+  }
+
+  snapshot_ = state_var;
+  instance_->PostMessage(message);
+}
+
+void StatePublisher::Reset() {
+  snapshot_ = pp::Var();
+}
+
+typedef std::map<std::string, MessageCache*> MessageCacheMap;
+
+MessageCacheMap& GetMessageCacheMap() {
+  static MessageCacheMap message_cache_map;
+  return message_cache_map;
+}
+
+bool SetMessageCacheSize(const std::string& message_type,
+                         size_t max_entries) {
+  MessageCacheMap& message_cache_map = GetMessageCacheMap();
+  MessageCacheMap::iterator iter = message_cache_map.find(message_type);
+  if (iter != message_cache_map.end()) {
+    delete iter->second;
+    message_cache_map.erase(iter);
+  }
+  if (max_entries > 0) {
+    message_cache_map[message_type] = new MessageCache(max_entries);
+  }
+  return true;
+}
+
+static MessageCache* GetMessageCache(const std::string& message_type) {
+  const MessageCacheMap& message_cache_map = GetMessageCacheMap();
+  if (message_cache_map.empty()) {
+    return NULL;
+  }
+  MessageCacheMap::const_iterator iter = message_cache_map.find(message_type);
+  return iter != message_cache_map.end() ? iter->second : NULL;
+}
+
+static void GetMessageCacheStats(const std::string& message_type, bool reset,
+                                 ThriftNaClMessageStats* stats) {
+  MessageCache* cache = GetMessageCache(message_type);
+  if (cache == NULL) {
+    return;
+  }
+  uint64_t hits;
+  uint64_t misses;
+  cache->GetStats(reset, &hits, &misses);
+  stats->set_cache_hits(hits);
+  stats->set_cache_misses(misses);
+}
+
 class ThriftNaClInstance : public pp::Instance {
  public:
   // The constructor creates the plugin-side instance.
   // @param[in] instance the handle to the browser-side plugin instance.
-  explicit ThriftNaClInstance(PP_Instance instance) : pp::Instance(instance) {}
-  virtual ~ThriftNaClInstance() {}
+  explicit ThriftNaClInstance(PP_Instance instance)
+      : pp::Instance(instance),
+        callback_factory_(this) {
+    if (GetMessageStatsLogInterval() > 0) {
+      ScheduleStatsLog();
+    }
+  }
+
+  virtual ~ThriftNaClInstance() {
+    // Wait for running handlers, which post their responses through
+    // callback_factory_.
+    if (thread_manager_) {
+      thread_manager_->stop();
+    }
+  }
 
   // Handler for messages coming in from the browser via postMessage().
   // @param[in] var_message The message posted by the browser.
   virtual void HandleMessage(const pp::Var& var_message) {
+    if (var_message.is_array()) {
+      HandleBatchMessage(pp::VarArray(var_message));
+      return;
+    }
+    MessageRecord record;
+    pp::Var response = DispatchMessage(var_message, &record);
+    PostResponse(PP_OK, response, record);
+  }
+
+ private:
+  // Handles a batch of messages posted together by thrift_nacl.js.  The
+  // responses of the handlers run on the main thread are posted together as
+  // one array.  Handlers run on a worker thread post their responses
+  // separately as they complete.
+  void HandleBatchMessage(const pp::VarArray& batch) {
+    pp::VarArray responses;
+    uint32_t num_responses = 0;
+    uint32_t length = batch.GetLength();
+    std::vector<MessageRecord> records(length);
+    for (uint32_t i = 0; i < length; ++i) {
+      pp::Var response = DispatchMessage(batch.Get(i), &records[i]);
+      if (!response.is_undefined()) {
+        responses.Set(num_responses++, response);
+      }
+    }
+
+    uint64_t post_ns = 0;
+    if (num_responses > 0) {
+      uint64_t start_ns = GetMonotonicTimeNs();
+      PostMessage(responses);
+      post_ns = GetMonotonicTimeNs() - start_ns;
+    }
+
+    // The messages handled on the main thread share the time to post the
+    // batch.  The records of messages handed to a worker thread have no
+    // stats, their task records them.
+    uint32_t num_records = 0;
+    for (uint32_t i = 0; i < length; ++i) {
+      if (records[i].stats) {
+        ++num_records;
+      }
+    }
+    for (uint32_t i = 0; i < length; ++i) {
+      if (records[i].stats) {
+        records[i].phase_ns[PHASE_POST] = post_ns / num_records;
+        AddMessageRecord(records[i]);
+      }
+    }
+  }
+
+  // Runs the handler for a message on the main thread and returns its
+  // response, or hands the message to a worker thread and returns an
+  // undefined var.  The stats of a message run on the main thread are
+  // recorded in record.
+  pp::Var DispatchMessage(const pp::Var& var_message, MessageRecord* record) {
+    boost::shared_ptr<CancellationToken> token =
+        CreateCancellationToken(var_message);
+    if (RunsOnWorkerThread(var_message)) {
+      // Messages on worker threads can be cancelled by id, or by seqid for
+      // binary messages.
+      if (!token) {
+        token.reset(new CancellationToken());
+      }
+      std::string message_id = GetMessageId(var_message);
+      if (!message_id.empty()) {
+        RegisterCancellationToken(message_id, token);
+      }
+      GetThreadManager()->add(boost::shared_ptr<Runnable>(
+          new MessageTask(this, var_message, message_id, token)));
+      return pp::Var();
+    }
+    return ProcessMessage(var_message, record, token);
+  }
+
+  // Processes a message on a worker thread and posts the response from the
+  // main thread.
+  class MessageTask : public Runnable {
+   public:
+    MessageTask(ThriftNaClInstance* instance,
+                const pp::Var& var_message,
+                const std::string& message_id,
+                const boost::shared_ptr<CancellationToken>& token)
+        : instance_(instance),
+          var_message_(var_message),
+          message_id_(message_id),
+          token_(token) {}
+
+    virtual void run() {
+      MessageRecord record;
+      pp::Var response;
+      {
+        ScopedCancellationTokenRegistration registration(message_id_);
+        try {
+          response = instance_->ProcessMessage(var_message_, &record, token_);
+        } catch (const TException& e) {
+          // The thread manager would drop the exception and the page would
+          // never get a response.
+          response = CreateErrorResponse(message_id_, "invalid_message",
+                                         e.what());
+        }
+      }
+      pp::MessageLoop::GetForMainThread().PostWork(
+          instance_->callback_factory_.NewCallback(
+              &ThriftNaClInstance::PostResponse, response, record));
+    }
+
+   private:
+    ThriftNaClInstance* instance_;
+    pp::Var var_message_;
+    std::string message_id_;
+    boost::shared_ptr<CancellationToken> token_;
+  };
+
+  // Posts the chunks of a streaming handler.  Chunks written on a worker
+  // thread are posted from the main thread, in order with the response.
+  class InstanceResponseStream : public ResponseStream {
+   public:
+    InstanceResponseStream(ThriftNaClInstance* instance,
+                           const std::string& message_id)
+        : ResponseStream(message_id), instance_(instance) {}
+
+   protected:
+    virtual void PostChunkMessage(const pp::Var& message) {
+      if (pp::Module::Get()->core()->IsMainThread()) {
+        instance_->PostMessage(message);
+      } else {
+        pp::MessageLoop::GetForMainThread().PostWork(
+            instance_->callback_factory_.NewCallback(
+                &ThriftNaClInstance::PostResponse, message, MessageRecord()));
+      }
+    }
+
+   private:
+    ThriftNaClInstance* instance_;
+  };
+
+  // Posts the response to a message and adds the stats of the message to
+  // those of its type.  Oneway calls have an undefined response and nothing
+  // is posted.
+  void PostResponse(int32_t result, const pp::Var& response,
+                    const MessageRecord& record) {
+    MessageRecord posted_record(record);
+    {
+      MessageScope message_scope(&posted_record,
+                                 boost::shared_ptr<CancellationToken>());
+      ScopedPhaseTimer timer(PHASE_POST);
+      if (!response.is_undefined()) {
+        PostMessage(response);
+      }
+    }
+    AddMessageRecord(posted_record);
+  }
+
+  void ScheduleStatsLog() {
+    pp::MessageLoop::GetForMainThread().PostWork(
+        callback_factory_.NewCallback(&ThriftNaClInstance::LogStats),
+        GetMessageStatsLogInterval());
+  }
+
+  void LogStats(int32_t result) {
+    ThriftNaClStats stats;
+    GetMessageStats(false, &stats);
+    LogToConsole(PP_LOGLEVEL_LOG, pp::Var(FormatMessageStats(stats)));
+    ScheduleStatsLog();
+  }
+
+  // Returns the id of a {id, type, data} message, the seqid of a binary
+  // message, which thrift_nacl.js uses as its id, or an empty string.
+  static std::string GetMessageId(const pp::Var& var_message) {
+    if (var_message.is_array_buffer()) {
+      std::string message_type;
+      int32_t seqid;
+      if (!ReadBinaryMessageHeader(pp::VarArrayBuffer(var_message),
+                                   &message_type, &seqid)) {
+        return std::string();
+      }
+      char id[16];
+      snprintf(id, sizeof(id), "%d", seqid);
+      return id;
+    }
+    if (!var_message.is_dictionary()) {
+      return std::string();
+    }
+    pp::Var var_id =
+        static_cast<const pp::VarDictionary*>(&var_message)->Get("id");
+    return var_id.is_string() ? var_id.AsString() : std::string();
+  }
+
+  // Returns true if the handler for the message type of var_message is set
+  // to run on a worker thread.
+  static bool RunsOnWorkerThread(const pp::Var& var_message) {
+    const WorkerMessageTypeSet& worker_message_types =
+        GetWorkerMessageTypeSet();
+    if (worker_message_types.empty()) {
+      return false;
+    }
+
+    std::string message_type;
+    if (var_message.is_array_buffer()) {
+      int32_t seqid;
+      if (!ReadBinaryMessageHeader(pp::VarArrayBuffer(var_message),
+                                   &message_type, &seqid)) {
+        return false;
+      }
+    } else if (var_message.is_dictionary()) {
+      pp::Var var_type =
+          static_cast<const pp::VarDictionary*>(&var_message)->Get("type");
+      if (!var_type.is_string()) {
+        return false;
+      }
+      message_type = var_type.AsString();
+    } else {
+      return false;
+    }
+    return worker_message_types.count(message_type) != 0;
+  }
+
+  // The worker threads are started when the first message is handed to
+  // them.
+  boost::shared_ptr<ThreadManager> GetThreadManager() {
+    if (!thread_manager_) {
+      thread_manager_ = ThreadManager::newSimpleThreadManager(
+          GetWorkerThreadCount());
+      // The default SCHED_RR policy needs privileges that Linux processes
+      // usually lack, and the thread manager then fails to start.
+      thread_manager_->threadFactory(
+          boost::shared_ptr<PosixThreadFactory>(new PosixThreadFactory(
+              PosixThreadFactory::OTHER, PosixThreadFactory::NORMAL)));
+      thread_manager_->start();
+    }
+    return thread_manager_;
+  }
+
+  // Runs the handler for a message and returns the response to post.  This
+  // is called on the main thread or, for message types set to
+  // WORKER_THREAD, on a worker thread.  The message type, the phases timed
+  // on the way and, with message size stats enabled, the size of the message
+  // and response are recorded in record.  token, which may be NULL, is the
+  // CancellationToken of the message.
+  pp::Var ProcessMessage(const pp::Var& var_message, MessageRecord* record,
+                         const boost::shared_ptr<CancellationToken>& token) {
+    MessageScope message_scope(record, token);
+    pp::Var response;
+    if (var_message.is_array_buffer()) {
+      response = ProcessBinaryMessage(pp::VarArrayBuffer(var_message),
+                                      token.get(), &record->stats);
+    } else {
+      response = ProcessDictionaryMessage(var_message, token.get(),
+                                          &record->stats);
+    }
+
+    if (GetMessageStatsEnabled() && GetMessageSizeStatsEnabled()) {
+      CountVarNodes(var_message, &record->request_nodes,
+                    &record->request_bytes);
+      CountVarNodes(response, &record->response_nodes,
+                    &record->response_bytes);
+    }
+    return response;
+  }
+
+  // Handles a {id, type, data} message and sets handled_stats to the stats
+  // of its type.  The handler is not run if token is cancelled.
+  pp::Var ProcessDictionaryMessage(const pp::Var& var_message,
+                                   const CancellationToken* token,
+                                   MessageTypeStats** handled_stats) {
     pp::VarDictionary var_response;
 
     std::string message_id;
     std::string message_type;
     MessageHandler message_handler;
-    boost::shared_ptr<pp::Var> in;
+    StreamingMessageHandler streaming_message_handler;
+    pp::Var in;
 
-    if (!ParseMessage(var_message, &message_id, &message_type, &in)) {
+    bool parsed;
+    {
+      ScopedPhaseTimer timer(PHASE_PARSE);
+      parsed = ParseMessage(var_message, &message_id, &message_type, &in);
+    }
+
+    if (!parsed) {
       pp::VarDictionary error_var;
       error_var.Set(pp::Var("type"), pp::Var("invalid_message"));
       error_var.Set(pp::Var("message"), pp::Var("Invalid message")); 
@@ -61,38 +1184,290 @@ class ThriftNaClInstance : public pp::Instance {
     } else {
       // Response message id is set to match the request message id.
       var_response.Set(pp::Var("id"), pp::Var(message_id));
+      MessageTypeStats* stats = NULL;
+      bool has_handler =
+          GetMessageHandler(message_type, &message_handler, &stats);
+      bool has_streaming_handler =
+          !has_handler &&
+          GetStreamingMessageHandler(message_type, &streaming_message_handler,
+                                     &stats);
+      *handled_stats = stats ? stats : GetUnhandledMessageStats();
+
+      if (token && token->IsCancelled()) {
+        pp::VarDictionary error_var;
+        if (token->IsDeadlineExceeded()) {
+          error_var.Set(pp::Var("type"), pp::Var("deadline_exceeded"));
+          error_var.Set(pp::Var("message"), pp::Var("Deadline exceeded"));
+        } else {
+          error_var.Set(pp::Var("type"), pp::Var("cancelled"));
+          error_var.Set(pp::Var("message"), pp::Var("Cancelled"));
+        }
+        var_response.Set(pp::Var("error"), error_var);
+      } else if (has_handler) {
+        pp::Var out;
+        pp::Var error;
+
+        MessageCache* cache = GetMessageCache(message_type);
+        uint64_t hash = 0;
+        bool result = false;
+        if (cache) {
+          hash = HashVar(in);
+          result = cache->Lookup(in, hash, &out);
+        }
+        if (!result) {
+          {
+            ScopedPhaseTimer timer(PHASE_HANDLER);
+            result = RunMessageHandler(message_handler, in, &out, &error);
+          }
+          // Only successful responses are cached.
+          if (result && cache) {
+            cache->Insert(in, hash, out);
+          }
+        }
+        if (!result) {
+          var_response.Set(pp::Var("error"), error);
+        } else {
+          var_response.Set(pp::Var("data"), out);
+        }
+      } else if (has_streaming_handler) {
+        InstanceResponseStream stream(this, message_id);
+        pp::Var out;
+        pp::Var error;
 
-      if (!GetMessageHandler(message_type, &message_handler)) {
+        bool result;
+        {
+          ScopedPhaseTimer timer(PHASE_HANDLER);
+          result = RunStreamingMessageHandler(streaming_message_handler, in,
+                                              &stream, &out, &error);
+          // The last chunk is posted before the response.
+          stream.Flush();
+        }
+        if (!result) {
+          var_response.Set(pp::Var("error"), error);
+        } else {
+          var_response.Set(pp::Var("data"), out);
+        }
+      } else if (GetProcessor()) {
+        return ProcessProcessorMessage(var_message, message_id);
+      } else {
         pp::VarDictionary error_var;
         error_var.Set(pp::Var("type"), pp::Var("unknown_message_type"));
         std::string error_message = "Unknown message type: " + message_type; 
         error_var.Set(pp::Var("message"), pp::Var(error_message)); 
         var_response.Set(pp::Var("error"), error_var); 
-      } else {
-        boost::shared_ptr<const pp::Var> out;
-        boost::shared_ptr<const pp::Var> error;
+      }
+    }
+
+    return var_response;
+  }
+
+  // Dispatches a {id, type, data} message to the registered processor, which
+  // reads the message header and writes the reply through
+  // TNativeClientProtocol.  Returns an undefined var for oneway calls.
+  pp::Var ProcessProcessorMessage(const pp::Var& var_message,
+                                  const std::string& message_id) {
+    boost::shared_ptr<TNativeClientProtocol> in =
+        GetThreadInputProtocol(var_message);
+    boost::shared_ptr<TNativeClientProtocol> out = GetThreadOutputProtocol();
+
+    try {
+      ScopedPhaseTimer timer(PHASE_HANDLER);
+      GetProcessor()->process(in, out, NULL);
+    } catch (const TException& e) {
+      return CreateErrorResponse(message_id, "invalid_message", e.what());
+    }
+
+    return out->getRootVar();
+  }
+
+  // Runs a message handler.  The generated wrappers throw a TException when
+  // the request cannot be read, for example when a required field is
+  // missing, which is returned as an invalid_message error.
+  static bool RunMessageHandler(MessageHandler message_handler,
+                                const pp::Var& in, pp::Var* out,
+                                pp::Var* error) {
+    try {
+      return message_handler(in, out, error);
+    } catch (const TException& e) {
+      *error = CreateErrorVar("invalid_message", e.what());
+      return false;
+    }
+  }
+
+  static bool RunStreamingMessageHandler(
+      StreamingMessageHandler streaming_message_handler, const pp::Var& in,
+      ResponseStream* stream, pp::Var* out, pp::Var* error) {
+    try {
+      return streaming_message_handler(in, stream, out, error);
+    } catch (const TException& e) {
+      *error = CreateErrorVar("invalid_message", e.what());
+      return false;
+    }
+  }
+
+  static pp::Var CreateErrorVar(const std::string& error_type,
+                                const std::string& error_message) {
+    pp::VarDictionary error_var;
+    error_var.Set(pp::Var("type"), pp::Var(error_type));
+    error_var.Set(pp::Var("message"), pp::Var(error_message));
+    return error_var;
+  }
+
+  // Returns an {id, error} response.
+  static pp::Var CreateErrorResponse(const std::string& message_id,
+                                     const std::string& error_type,
+                                     const std::string& error_message) {
+    pp::VarDictionary var_response;
+    var_response.Set(pp::Var("id"), pp::Var(message_id));
+    var_response.Set(pp::Var("error"),
+                     CreateErrorVar(error_type, error_message));
+    return var_response;
+  }
+
+  // Reads the name and seqid from the header of a compact protocol encoded
+  // message.
+  static bool ReadBinaryMessageHeader(pp::VarArrayBuffer request_buffer,
+                                      std::string* message_type,
+                                      int32_t* seqid) {
+    uint32_t request_size = request_buffer.ByteLength();
+    if (request_size == 0) {
+      return false;
+    }
+    uint8_t* request_data = static_cast<uint8_t*>(request_buffer.Map());
+
+    boost::shared_ptr<TMemoryBuffer> in_transport(new TMemoryBuffer(
+        request_data, request_data ? request_size : 0,
+        TMemoryBuffer::OBSERVE));
+    TCompactProtocol in(in_transport);
+    TMessageType type;
+    bool result = true;
+    try {
+      in.readMessageBegin(*message_type, type, *seqid);
+    } catch (const TException& e) {
+      result = false;
+    }
+
+    if (request_data) {
+      request_buffer.Unmap();
+    }
+    return result;
+  }
+
+  // Handles a message posted as an ArrayBuffer holding a compact protocol
+  // encoded call.  The request is decoded directly from the mapped buffer
+  // and the reply is returned as an ArrayBuffer, or as an undefined var for
+  // oneway calls.  Sets handled_stats to the stats of the message type.  The
+  // handler is not run if token is cancelled.
+  pp::Var ProcessBinaryMessage(pp::VarArrayBuffer request_buffer,
+                               const CancellationToken* token,
+                               MessageTypeStats** handled_stats) {
+    uint32_t request_size = request_buffer.ByteLength();
+    uint8_t* request_data = NULL;
+    if (request_size > 0) {
+      request_data = static_cast<uint8_t*>(request_buffer.Map());
+    }
+
+    boost::shared_ptr<TMemoryBuffer> in_transport(new TMemoryBuffer(
+        request_data, request_data ? request_size : 0,
+        TMemoryBuffer::OBSERVE));
+    boost::shared_ptr<TMemoryBuffer> out_transport(new TMemoryBuffer());
+    boost::shared_ptr<TCompactProtocol> in(new TCompactProtocol(in_transport));
+    boost::shared_ptr<TCompactProtocol> out(
+        new TCompactProtocol(out_transport));
+
+    std::string message_type;
+    TMessageType type;
+    int32_t seqid = 0;
+    BinaryMessageHandler message_handler;
 
-        if (!message_handler(in, &out, &error)) {
-          var_response.Set(pp::Var("error"), *error);
+    try {
+      {
+        ScopedPhaseTimer timer(PHASE_PARSE);
+        in->readMessageBegin(message_type, type, seqid);
+      }
+      MessageTypeStats* stats = NULL;
+      bool has_handler =
+          GetBinaryMessageHandler(message_type, &message_handler, &stats);
+      *handled_stats = stats ? stats : GetUnhandledMessageStats();
+
+      if (type != apache::thrift::protocol::T_CALL &&
+          type != apache::thrift::protocol::T_ONEWAY) {
+        WriteBinaryError(out.get(), message_type, seqid, "invalid_message",
+                         "Invalid message");
+      } else if (token && token->IsCancelled()) {
+        if (token->IsDeadlineExceeded()) {
+          WriteBinaryError(out.get(), message_type, seqid,
+                           "deadline_exceeded", "Deadline exceeded");
         } else {
-          var_response.Set(pp::Var("data"), *out);
+          WriteBinaryError(out.get(), message_type, seqid, "cancelled",
+                           "Cancelled");
         }
+      } else if (has_handler) {
+        ScopedPhaseTimer timer(PHASE_HANDLER);
+        message_handler(message_type, seqid, in.get(), out.get());
+      } else if (GetProcessor()) {
+        // The processor reads the message header itself.
+        in_transport->resetBuffer(request_data,
+                                  request_data ? request_size : 0,
+                                  TMemoryBuffer::OBSERVE);
+        ScopedPhaseTimer timer(PHASE_HANDLER);
+        GetProcessor()->process(in, out, NULL);
+      } else {
+        WriteBinaryError(out.get(), message_type, seqid,
+                         "unknown_message_type",
+                         "Unknown message type: " + message_type);
       }
+    } catch (const TException& e) {
+      out_transport->resetBuffer();
+      WriteBinaryError(out.get(), message_type, seqid, "invalid_message",
+                       e.what());
+    }
+
+    if (request_data) {
+      request_buffer.Unmap();
+    }
+
+    uint8_t* reply_data;
+    uint32_t reply_size;
+    out_transport->getBuffer(&reply_data, &reply_size);
+    if (reply_size == 0) {
+      // Oneway calls have no reply.
+      return pp::Var();
     }
 
-    PostMessage(var_response);
+    ScopedPhaseTimer timer(PHASE_WRITE);
+    pp::VarArrayBuffer reply_buffer(reply_size);
+    memcpy(reply_buffer.Map(), reply_data, reply_size);
+    reply_buffer.Unmap();
+    return reply_buffer;
+  }
+
+  // Writes an exception reply carrying a ThriftNaClError.
+  static void WriteBinaryError(TProtocol* out,
+                               const std::string& message_type,
+                               int32_t seqid,
+                               const std::string& error_type,
+                               const std::string& error_message) {
+    ThriftNaClError error;
+    error.set_type(error_type);
+    error.set_message(error_message);
+
+    out->writeMessageBegin(message_type, apache::thrift::protocol::T_EXCEPTION,
+                           seqid);
+    error.write(out);
+    out->writeMessageEnd();
   }
 
- private:
   // Parse an incoming message from js.
   //
-  // Valid messages have 3 required fields: id, type, and data.
+  // Valid messages have 3 required fields: id, type, and data.  The optional
+  // deadline field is read by CreateCancellationToken().
   // Returns true and sets message_id, message_type, and data iff the message
   // is valid.
   static bool ParseMessage(const pp::Var& var_message,
                            std::string* message_id,
                            std::string* message_type,
-                           boost::shared_ptr<pp::Var>* data) {
+                           pp::Var* data) {
     if (!var_message.is_dictionary()) {
       return false;
     }
@@ -121,15 +1496,18 @@ class ThriftNaClInstance : public pp::Instance {
       return false;
     }
 
-    // Using pp_var increments the reference count of pp_var instead of
-    // performing a deep copy if pp::Var was used.
-    data->reset(new pp::Var(var_dict->Get("data").pp_var()));
-    if (!(*data)->is_dictionary()) {
+    // Assigning the pp::Var increments the reference count of the data var
+    // instead of performing a deep copy.
+    *data = var_dict->Get("data");
+    if (!data->is_dictionary()) {
       return false;
     }
 
     return true;
   }
+
+  pp::CompletionCallbackFactory<ThriftNaClInstance> callback_factory_;
+  boost::shared_ptr<ThreadManager> thread_manager_;
 };
 
 // The Module class.  The browser calls the CreateInstance() method to create
@@ -3,8 +3,11 @@
 
 #include <boost/shared_ptr.hpp>
 
+#include "ppapi/cpp/instance.h"
 #include "ppapi/cpp/var.h"
+#include "thrift/TProcessor.h"
 #include "thrift/protocol/TNativeClientProtocol.h"
+#include "thrift/protocol/TProtocol.h"
 #include "thrift_nacl_types.h"
 
 #include <map>
@@ -12,45 +15,371 @@
 
 namespace thrift_nacl {
 
-typedef bool (*MessageHandler)(const boost::shared_ptr<pp::Var>& in,
-                               boost::shared_ptr<const pp::Var>* out,
-                               boost::shared_ptr<const pp::Var>* error);
+// Message handlers receive the request data and write the response or error
+// directly as pp::Vars.  pp::Var is a reference to the browser var, so no
+// copies of the var trees are made.
+typedef bool (*MessageHandler)(const pp::Var& in,
+                               pp::Var* out,
+                               pp::Var* error);
+
+// Streams the results of a streaming message handler to JavaScript as they
+// are produced.  Each chunk is posted as a {id, seq, chunk} message ahead of
+// the final {id, data} or {id, error} response, where seq counts the chunks
+// of the message from 0.  A chunk is either an array of structs or an
+// ArrayBuffer holding a slice of binary data.  thrift_nacl.js hands chunks to
+// the onChunk callback of postStreamingMessage() or reassembles them.
+class ResponseStream {
+ public:
+  // Structs are posted in chunks of this many elements by default.
+  static const uint32_t kDefaultChunkSize = 1000;
+
+  explicit ResponseStream(const std::string& message_id);
+  virtual ~ResponseStream();
+
+  void set_chunk_size(uint32_t chunk_size) { chunk_size_ = chunk_size; }
+  uint32_t chunk_size() const { return chunk_size_; }
+
+  // Appends element, a struct generated by 'thrift --gen cpp', to the current
+  // chunk and posts the chunk once it holds chunk_size() elements.
+  void Write(const apache::thrift::TStruct& element);
+
+  // Posts size bytes from data as one ArrayBuffer chunk, after any pending
+  // elements.
+  void WriteBinary(const void* data, uint32_t size);
+
+  // Posts the pending elements, if any.
+  void Flush();
+
+ protected:
+  // Posts a chunk message to JavaScript from the thread running the handler.
+  virtual void PostChunkMessage(const pp::Var& message) = 0;
+
+ private:
+  void PostChunk(const pp::Var& chunk);
+
+  std::string message_id_;
+  uint32_t seq_;
+  uint32_t chunk_size_;
+  pp::Var chunk_;
+  uint32_t chunk_length_;
+  apache::thrift::protocol::TNativeClientProtocol protocol_;
+};
+
+// Pushes a state struct from the module to the page.  The first Publish()
+// posts the whole state as a {state, data} message.  Later calls serialize the
+// new state, compare it with the var tree of the previously published state
+// and post only the changed fields and list elements as a {state, patch}
+// message, which thrift_nacl.js applies to its copy of the state.  Nothing is
+// posted if the state is unchanged.  Publish() must be called on the main
+// thread.
+//
+// A patch is a dictionary with any of:
+//   set:    {key: value} fields or elements that are new or replaced
+//   patch:  {key: patch} fields or elements patched in place
+//   delete: [key] fields that were removed
+//   length: new length of a list
+// List elements are keyed by index.  Packed lists and binary fields are
+// replaced whole when any byte changes.
+class StatePublisher {
+ public:
+  StatePublisher(pp::Instance* instance, const std::string& state_name);
+
+  void Publish(const apache::thrift::TStruct& state);
+
+  // Makes the next Publish() post the whole state, for example after the
+  // page has been reloaded.
+  void Reset();
+
+ private:
+  pp::Instance* instance_;
+  std::string state_name_;
+  // The var tree of the last published state.
+  pp::Var snapshot_;
+  apache::thrift::protocol::TNativeClientProtocol protocol_;
+};
+
+// Streaming message handlers are message handlers that also receive a
+// ResponseStream.  The chunks written to it are posted before the response.
+typedef bool (*StreamingMessageHandler)(const pp::Var& in,
+                                        ResponseStream* stream,
+                                        pp::Var* out,
+                                        pp::Var* error);
+
+// Binary message handlers read the request from in, which is positioned just
+// after the message header, and write the complete reply message, header
+// included, to out.
+typedef void (*BinaryMessageHandler)(
+    const std::string& message_type,
+    int32_t seqid,
+    apache::thrift::protocol::TProtocol* in,
+    apache::thrift::protocol::TProtocol* out);
 
 bool RegisterMessageHandler(const std::string& message_type,
                             MessageHandler handler);
 
+bool RegisterBinaryMessageHandler(const std::string& message_type,
+                                  BinaryMessageHandler handler);
+
+bool RegisterStreamingMessageHandler(const std::string& message_type,
+                                     StreamingMessageHandler handler);
+
+// Registers a processor generated by 'thrift --gen cpp' for a service.  Calls
+// of message types without a registered handler are dispatched to the
+// processor, in both the dictionary and the ArrayBuffer wire modes.  Replies
+// to oneway methods are not posted.  Only one processor can be registered.
+bool RegisterProcessor(
+    boost::shared_ptr<apache::thrift::TProcessor> processor);
+
+// Handlers run on the main thread unless their message type is set to
+// WORKER_THREAD, in which case they run on a pool of worker threads and their
+// responses are posted as they complete, possibly out of order.  Worker
+// handlers must be thread safe.  For a processor the message type is the
+// method name.
+enum HandlerThread {
+  MAIN_THREAD,
+  WORKER_THREAD
+};
+
+bool SetHandlerThread(const std::string& message_type,
+                      HandlerThread handler_thread);
+
+// Caches the responses of message_type, keyed on the request data, in an LRU
+// cache of at most max_entries entries, or removes the cache if max_entries
+// is 0.  A request equal to a cached one gets the cached response without
+// running the handler.  Only for handlers registered with
+// RegisterMessageHandler() whose response depends on nothing but the
+// request; errors are not cached.  The hits and misses are returned by the
+// __stats message type.  Must be called before messages are handled.
+bool SetMessageCacheSize(const std::string& message_type, size_t max_entries);
+
+// Return protocols owned by the calling thread for reading a request and for
+// writing its response.  The input protocol is set to read var and the output
+// protocol is reset.  Each thread reuses its two protocols for every message
+// it handles, so they must not be kept past the message.
+boost::shared_ptr<apache::thrift::protocol::TNativeClientProtocol>
+GetThreadInputProtocol(const pp::Var& var);
+boost::shared_ptr<apache::thrift::protocol::TNativeClientProtocol>
+GetThreadOutputProtocol();
+
+// Makes the output protocols returned by GetThreadOutputProtocol() share the
+// var of identical structs and containers within a response, see
+// TNativeClientProtocol::setDedupSubtrees().  Disabled by default.
+void SetResponseDedup(bool dedup);
+bool GetResponseDedup();
+
+// Sets the number of worker threads.  Takes effect if called before the first
+// message is handed to a worker thread.
+void SetWorkerThreadCount(size_t count);
+size_t GetWorkerThreadCount();
+
+// Tells a handler that the page no longer waits for its response.  An {id,
+// type, data} message may carry a deadline, the number of milliseconds the
+// page waits for the response, and messages handed to a worker thread can be
+// cancelled with the reserved __cancel message type, which takes a
+// ThriftNaClCancelRequest.  Binary messages are cancelled by their seqid,
+// which thrift_nacl.js returns as their id.
+// Messages whose token is cancelled before their handler starts get a
+// deadline_exceeded or cancelled error instead.  Long running handlers should
+// poll the token of their message and return early once it is cancelled.
+class CancellationToken {
+ public:
+  // A token without deadline.
+  CancellationToken();
+  explicit CancellationToken(uint64_t deadline_ns);
+
+  // True once the message is cancelled or its deadline has passed.
+  bool IsCancelled() const;
+  bool IsDeadlineExceeded() const;
+
+  void Cancel();
+
+ private:
+  volatile int32_t cancelled_;
+  // Deadline on the CLOCK_MONOTONIC clock, or 0.
+  uint64_t deadline_ns_;
+};
+
+// Returns the token of the message handled on the calling thread.  Outside
+// of a message the token is never cancelled.
+boost::shared_ptr<CancellationToken> GetCancellationToken();
+
+// Phases of handling a message whose latency is recorded per message type.
+// The stats are returned by the reserved __stats message type, which takes a
+// ThriftNaClStatsRequest and returns ThriftNaClStats.
+enum MessagePhase {
+  // Parsing the message envelope or binary message header.
+  PHASE_PARSE,
+  // Reading the request struct.
+  PHASE_READ,
+  // Running the handler, or the processor, which reads and writes the
+  // structs itself.
+  PHASE_HANDLER,
+  // Writing the response struct.
+  PHASE_WRITE,
+  // Posting the response to JavaScript.
+  PHASE_POST,
+  NUM_MESSAGE_PHASES
+};
+
+// Records the time from construction to destruction as phase of the message
+// handled on the calling thread.  The time of timers nested in this one is
+// only recorded in their own phases.  Does nothing outside of a message or
+// with message stats disabled.
+class ScopedPhaseTimer {
+ public:
+  explicit ScopedPhaseTimer(MessagePhase phase);
+  ~ScopedPhaseTimer();
+
+ private:
+  MessagePhase phase_;
+  uint64_t start_ns_;
+  uint64_t nested_ns_;
+  ScopedPhaseTimer* parent_;
+  bool active_;
+};
+
+// Message stats are enabled by default.
+void SetMessageStatsEnabled(bool enabled);
+bool GetMessageStatsEnabled();
+
+// Estimating the size of the requests and responses walks every var of both,
+// so it is disabled by default.  The size fields of ThriftNaClMessageStats
+// are only set while it is enabled.
+void SetMessageSizeStatsEnabled(bool enabled);
+bool GetMessageSizeStatsEnabled();
+
+// Logs the message stats to the JavaScript console every interval_ms
+// milliseconds, or never if interval_ms is 0, which is the default.  Takes
+// effect for instances created after the call.
+void SetMessageStatsLogInterval(int32_t interval_ms);
+int32_t GetMessageStatsLogInterval();
+
 }  // namespace thrift_nacl
 
 #define MAKE_HANDLER_WRAPPER(handler, in_type, out_type, error_type) \
-bool handler##Wrapper(const boost::shared_ptr<pp::Var>& in, \
-                      boost::shared_ptr<const pp::Var>* out, \
-                      boost::shared_ptr<const pp::Var>* err) { \
-  boost::shared_ptr<apache::thrift::protocol::TNativeClientProtocol> protocol(\
-      new apache::thrift::protocol::TNativeClientProtocol()); \
+bool handler##Wrapper(const pp::Var& in, \
+                      pp::Var* out, \
+                      pp::Var* err) { \
+  apache::thrift::protocol::TNativeClientProtocol* in_protocol = \
+      thrift_nacl::GetThreadInputProtocol(in).get(); \
+  apache::thrift::protocol::TNativeClientProtocol* out_protocol = \
+      thrift_nacl::GetThreadOutputProtocol().get(); \
   in_type request; \
   out_type response; \
   error_type error; \
 \
-  protocol->setVar(in); \
-  request.read(protocol.get()); \
+  { \
+    thrift_nacl::ScopedPhaseTimer timer(thrift_nacl::PHASE_READ); \
+    request.read(in_protocol); \
+  } \
+\
+  bool result = handler(request, &response, &error); \
+  thrift_nacl::ScopedPhaseTimer timer(thrift_nacl::PHASE_WRITE); \
+  if (result) { \
+    response.write(out_protocol); \
+    *out = out_protocol->getRootVar(); \
+  } else { \
+    error.write(out_protocol); \
+    *err = out_protocol->getRootVar(); \
+  } \
+  return result; \
+} \
+\
+void handler##BinaryWrapper(const std::string& message_type, \
+                            int32_t seqid, \
+                            apache::thrift::protocol::TProtocol* in, \
+                            apache::thrift::protocol::TProtocol* out) { \
+  in_type request; \
+  out_type response; \
+  error_type error; \
+\
+  { \
+    thrift_nacl::ScopedPhaseTimer timer(thrift_nacl::PHASE_READ); \
+    request.read(in); \
+    in->readMessageEnd(); \
+  } \
 \
-  if (handler(request, &response, &error)) { \
-    response.write(protocol.get()); \
-    *out = protocol->getVar(); \
-    return true; \
+  bool result = handler(request, &response, &error); \
+  thrift_nacl::ScopedPhaseTimer timer(thrift_nacl::PHASE_WRITE); \
+  if (result) { \
+    out->writeMessageBegin(message_type, \
+                           apache::thrift::protocol::T_REPLY, seqid); \
+    response.write(out); \
   } else { \
-    error.write(protocol.get()); \
-    *err = protocol->getVar(); \
-    return false; \
+    out->writeMessageBegin(message_type, \
+                           apache::thrift::protocol::T_EXCEPTION, seqid); \
+    error.write(out); \
   } \
+  out->writeMessageEnd(); \
 }
 
 #define REGISTER_MESSAGE_HANDLER_FULL(message_type, handler, in_type, out_type, error_type) \
 MAKE_HANDLER_WRAPPER(handler, in_type, out_type, error_type) \
 static bool handler##_result = thrift_nacl::RegisterMessageHandler( \
-  std::string(message_type), handler##Wrapper);
+  std::string(message_type), handler##Wrapper) && \
+  thrift_nacl::RegisterBinaryMessageHandler( \
+  std::string(message_type), handler##BinaryWrapper);
+
+#define MAKE_STREAMING_HANDLER_WRAPPER(handler, in_type, out_type, error_type) \
+bool handler##StreamingWrapper(const pp::Var& in, \
+                               thrift_nacl::ResponseStream* stream, \
+                               pp::Var* out, \
+                               pp::Var* err) { \
+  apache::thrift::protocol::TNativeClientProtocol* in_protocol = \
+      thrift_nacl::GetThreadInputProtocol(in).get(); \
+  in_type request; \
+  out_type response; \
+  error_type error; \
+\
+  { \
+    thrift_nacl::ScopedPhaseTimer timer(thrift_nacl::PHASE_READ); \
+    request.read(in_protocol); \
+  } \
+\
+  bool result = handler(request, stream, &response, &error); \
+  thrift_nacl::ScopedPhaseTimer timer(thrift_nacl::PHASE_WRITE); \
+  apache::thrift::protocol::TNativeClientProtocol* out_protocol = \
+      thrift_nacl::GetThreadOutputProtocol().get(); \
+  if (result) { \
+    response.write(out_protocol); \
+    *out = out_protocol->getRootVar(); \
+  } else { \
+    error.write(out_protocol); \
+    *err = out_protocol->getRootVar(); \
+  } \
+  return result; \
+}
+
+// Registers a handler taking (request, stream, response, error) that writes
+// its results to the ResponseStream and a summary, which may be empty, to the
+// response.
+#define REGISTER_STREAMING_MESSAGE_HANDLER(message_type, handler) \
+MAKE_STREAMING_HANDLER_WRAPPER(handler, handler##Request, handler##Response, ThriftNaClError) \
+static bool handler##_result = thrift_nacl::RegisterStreamingMessageHandler( \
+  std::string(message_type), handler##StreamingWrapper);
+
+// Registers the generated processor_type for a service implemented by
+// handler_type, which must derive from the generated service interface.
+#define REGISTER_PROCESSOR(processor_type, handler_type) \
+static bool processor_type##_result = thrift_nacl::RegisterProcessor( \
+  boost::shared_ptr<apache::thrift::TProcessor>(new processor_type( \
+      boost::shared_ptr<handler_type>(new handler_type()))));
 
 #define REGISTER_MESSAGE_HANDLER(message_type, handler) \
 REGISTER_MESSAGE_HANDLER_FULL(message_type, handler, handler##Request, handler##Response, ThriftNaClError)
 
+// Registers handler like REGISTER_MESSAGE_HANDLER and runs it on a worker
+// thread.
+#define REGISTER_WORKER_MESSAGE_HANDLER(message_type, handler) \
+REGISTER_MESSAGE_HANDLER(message_type, handler) \
+static bool handler##_thread_result = thrift_nacl::SetHandlerThread( \
+  std::string(message_type), thrift_nacl::WORKER_THREAD);
+
+// Registers handler like REGISTER_MESSAGE_HANDLER and caches up to
+// max_entries of its responses.
+#define REGISTER_CACHED_MESSAGE_HANDLER(message_type, handler, max_entries) \
+REGISTER_MESSAGE_HANDLER(message_type, handler) \
+static bool handler##_cache_result = thrift_nacl::SetMessageCacheSize( \
+  std::string(message_type), max_entries);
+
 #endif  // MESSAGE_HANDLER_H_
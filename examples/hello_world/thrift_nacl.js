@@ -1,10 +1,782 @@
 (function () {
   'use strict';
 
+  // Lists of byte, i32 and double are sent as an ArrayBuffer wrapped in a
+  // dictionary naming the typed array that views it.  These are the typed
+  // arrays that can be sent this way.
+  var TYPED_ARRAY_KEY = '__typed_array';
+  var TYPED_ARRAYS = {
+    Int8Array: Int8Array,
+    Int32Array: Int32Array,
+    Float64Array: Float64Array
+  };
+
+  var isPlainContainer = function (value) {
+    return value !== null && typeof value === 'object' &&
+        !(value instanceof ArrayBuffer) && !ArrayBuffer.isView(value);
+  };
+
+  var shallowCopy = function (value) {
+    if (Array.isArray(value)) {
+      return value.slice();
+    }
+    var copy = {};
+    for (var key in value) {
+      if (value.hasOwnProperty(key)) {
+        copy[key] = value[key];
+      }
+    }
+    return copy;
+  };
+
+  // Returns the bytes viewed by a typed array or DataView, copied only if the
+  // view does not cover its whole buffer.
+  var viewBuffer = function (view) {
+    var buffer = view.buffer;
+    if (view.byteOffset !== 0 || view.byteLength !== buffer.byteLength) {
+      buffer = buffer.slice(view.byteOffset,
+                            view.byteOffset + view.byteLength);
+    }
+    return buffer;
+  };
+
+  // Returns the packed list for a typed array of the named type.
+  var packTypedArray = function (value, name) {
+    var packed = {buffer: viewBuffer(value)};
+    packed[TYPED_ARRAY_KEY] = name;
+    return packed;
+  };
+
+  // Returns value with typed arrays replaced by packed lists.  Containers are
+  // copied only if they hold a typed array, so the caller's data is never
+  // modified.
+  var packTypedArrays = function (value) {
+    if (ArrayBuffer.isView(value)) {
+      for (var name in TYPED_ARRAYS) {
+        if (value instanceof TYPED_ARRAYS[name]) {
+          return packTypedArray(value, name);
+        }
+      }
+      return value;
+    }
+    if (!isPlainContainer(value)) {
+      return value;
+    }
+
+    var copy = null;
+    for (var key in value) {
+      if (!value.hasOwnProperty(key)) {
+        continue;
+      }
+      var packedValue = packTypedArrays(value[key]);
+      if (packedValue !== value[key]) {
+        copy = copy || shallowCopy(value);
+        copy[key] = packedValue;
+      }
+    }
+    return copy || value;
+  };
+
+  // Replaces packed lists in value by typed arrays, in place, and returns the
+  // result.
+  var unpackTypedArrays = function (value) {
+    if (!isPlainContainer(value)) {
+      return value;
+    }
+    if (!Array.isArray(value) && TYPED_ARRAY_KEY in value) {
+      var TypedArray = TYPED_ARRAYS[value[TYPED_ARRAY_KEY]];
+      if (TypedArray && value.buffer instanceof ArrayBuffer) {
+        return new TypedArray(value.buffer);
+      }
+      return value;
+    }
+    for (var key in value) {
+      if (value.hasOwnProperty(key)) {
+        value[key] = unpackTypedArrays(value[key]);
+      }
+    }
+    return value;
+  };
+
+  // Returns the dictionary to post for the data of a message, which is either
+  // a struct generated with 'thrift --gen js:nacl' or a plain object.
+  var encodeData = function (data) {
+    if (data && typeof data.toNaCl === 'function') {
+      return data.toNaCl();
+    }
+    return packTypedArrays(data);
+  };
+
+  // Runtime of the codecs generated by 'thrift --gen js:nacl'.  The generated
+  // Struct.prototype.toNaCl() checks the type of every field and returns the
+  // dictionary TNativeClientProtocol reads, and Struct.fromNaCl(dict) builds
+  // a struct from the dictionary it writes.
+  var NaClCodec = {
+    checkBoolean: function (value, path) {
+      if (typeof value !== 'boolean') {
+        throw new TypeError(path + ' must be a boolean');
+      }
+      return value;
+    },
+
+    checkInteger: function (value, path) {
+      if (typeof value !== 'number' || value % 1 !== 0) {
+        throw new TypeError(path + ' must be an integer');
+      }
+      return value;
+    },
+
+    checkNumber: function (value, path) {
+      if (typeof value !== 'number') {
+        throw new TypeError(path + ' must be a number');
+      }
+      return value;
+    },
+
+    checkString: function (value, path) {
+      if (typeof value !== 'string') {
+        throw new TypeError(path + ' must be a string');
+      }
+      return value;
+    },
+
+    checkArray: function (value, path) {
+      if (!Array.isArray(value)) {
+        throw new TypeError(path + ' must be an array');
+      }
+      return value;
+    },
+
+    checkObject: function (value, path) {
+      if (!isPlainContainer(value) || Array.isArray(value)) {
+        throw new TypeError(path + ' must be an object');
+      }
+      return value;
+    },
+
+    // Binary fields are sent as ArrayBuffers.
+    toArrayBuffer: function (value, path) {
+      if (value instanceof ArrayBuffer) {
+        return value;
+      }
+      if (ArrayBuffer.isView(value)) {
+        return viewBuffer(value);
+      }
+      throw new TypeError(path + ' must be an ArrayBuffer or a typed array');
+    },
+
+    // Returns the packed list for an array or typed array of numbers.
+    packList: function (value, name, path) {
+      var TypedArray = TYPED_ARRAYS[name];
+      if (!(value instanceof TypedArray)) {
+        NaClCodec.checkArray(value, path);
+        for (var i = 0; i < value.length; ++i) {
+          NaClCodec.checkNumber(value[i], path + '[]');
+        }
+        value = new TypedArray(value);
+      }
+      return packTypedArray(value, name);
+    },
+
+    // Returns the typed array for a packed list, which may already have been
+    // unpacked by NaClModule, or for an array of numbers.
+    unpackList: function (value, name) {
+      var TypedArray = TYPED_ARRAYS[name];
+      if (value instanceof TypedArray) {
+        return value;
+      }
+      if (Array.isArray(value)) {
+        return new TypedArray(value);
+      }
+      return new TypedArray(value.buffer);
+    }
+  };
+
+  // Thrift type and message type ids, matching Thrift.Type and
+  // Thrift.MessageType of the Thrift JavaScript library.
+  var Type = {
+    STOP: 0,
+    VOID: 1,
+    BOOL: 2,
+    BYTE: 3,
+    DOUBLE: 4,
+    I16: 6,
+    I32: 8,
+    I64: 10,
+    STRING: 11,
+    STRUCT: 12,
+    MAP: 13,
+    SET: 14,
+    LIST: 15
+  };
+
+  var MessageType = {
+    CALL: 1,
+    REPLY: 2,
+    EXCEPTION: 3,
+    ONEWAY: 4
+  };
+
+  var COMPACT_PROTOCOL_ID = 0x82;
+  var COMPACT_VERSION = 1;
+  var COMPACT_VERSION_MASK = 0x1f;
+  var COMPACT_TYPE_SHIFT = 5;
+
+  var CompactType = {
+    STOP: 0,
+    BOOLEAN_TRUE: 1,
+    BOOLEAN_FALSE: 2,
+    BYTE: 3,
+    I16: 4,
+    I32: 5,
+    I64: 6,
+    DOUBLE: 7,
+    BINARY: 8,
+    LIST: 9,
+    SET: 10,
+    MAP: 11,
+    STRUCT: 12
+  };
+
+  var TYPE_TO_COMPACT = {};
+  TYPE_TO_COMPACT[Type.STOP] = CompactType.STOP;
+  TYPE_TO_COMPACT[Type.BOOL] = CompactType.BOOLEAN_TRUE;
+  TYPE_TO_COMPACT[Type.BYTE] = CompactType.BYTE;
+  TYPE_TO_COMPACT[Type.I16] = CompactType.I16;
+  TYPE_TO_COMPACT[Type.I32] = CompactType.I32;
+  TYPE_TO_COMPACT[Type.I64] = CompactType.I64;
+  TYPE_TO_COMPACT[Type.DOUBLE] = CompactType.DOUBLE;
+  TYPE_TO_COMPACT[Type.STRING] = CompactType.BINARY;
+  TYPE_TO_COMPACT[Type.LIST] = CompactType.LIST;
+  TYPE_TO_COMPACT[Type.SET] = CompactType.SET;
+  TYPE_TO_COMPACT[Type.MAP] = CompactType.MAP;
+  TYPE_TO_COMPACT[Type.STRUCT] = CompactType.STRUCT;
+
+  var COMPACT_TO_TYPE = {};
+  COMPACT_TO_TYPE[CompactType.STOP] = Type.STOP;
+  COMPACT_TO_TYPE[CompactType.BOOLEAN_TRUE] = Type.BOOL;
+  COMPACT_TO_TYPE[CompactType.BOOLEAN_FALSE] = Type.BOOL;
+  COMPACT_TO_TYPE[CompactType.BYTE] = Type.BYTE;
+  COMPACT_TO_TYPE[CompactType.I16] = Type.I16;
+  COMPACT_TO_TYPE[CompactType.I32] = Type.I32;
+  COMPACT_TO_TYPE[CompactType.I64] = Type.I64;
+  COMPACT_TO_TYPE[CompactType.DOUBLE] = Type.DOUBLE;
+  COMPACT_TO_TYPE[CompactType.BINARY] = Type.STRING;
+  COMPACT_TO_TYPE[CompactType.LIST] = Type.LIST;
+  COMPACT_TO_TYPE[CompactType.SET] = Type.SET;
+  COMPACT_TO_TYPE[CompactType.MAP] = Type.MAP;
+  COMPACT_TO_TYPE[CompactType.STRUCT] = Type.STRUCT;
+
+  var textEncoder = typeof TextEncoder !== 'undefined' ?
+      new TextEncoder() : null;
+  var textDecoder = typeof TextDecoder !== 'undefined' ?
+      new TextDecoder('utf-8') : null;
+
+  var encodeUtf8 = function (str) {
+    if (textEncoder) {
+      return textEncoder.encode(str);
+    }
+    var binary = unescape(encodeURIComponent(str));
+    var bytes = new Uint8Array(binary.length);
+    for (var i = 0; i < binary.length; i++) {
+      bytes[i] = binary.charCodeAt(i);
+    }
+    return bytes;
+  };
+
+  var decodeUtf8 = function (bytes) {
+    if (textDecoder) {
+      return textDecoder.decode(bytes);
+    }
+    var binary = '';
+    for (var i = 0; i < bytes.length; i++) {
+      binary += String.fromCharCode(bytes[i]);
+    }
+    return decodeURIComponent(escape(binary));
+  };
+
+  // Thrift compact protocol over an ArrayBuffer.  It implements the protocol
+  // interface used by the types generated by 'thrift --gen js', so they can
+  // be written to and read from binary messages.  Without opt_buffer the
+  // protocol writes to a growing buffer returned by getBuffer().
+  var NaClCompactProtocol = function (opt_buffer) {
+    if (opt_buffer) {
+      this.bytes = new Uint8Array(opt_buffer);
+      this.length = this.bytes.length;
+    } else {
+      this.bytes = new Uint8Array(256);
+      this.length = 0;
+    }
+    this.view = new DataView(this.bytes.buffer);
+    this.position = 0;
+
+    this.lastFieldId = 0;
+    this.lastFieldIdStack = [];
+    // Id of a bool field whose header is written along with its value.
+    this.boolFieldId = null;
+    // Value of a bool field read from its header.
+    this.boolValue = null;
+  };
+
+  NaClCompactProtocol.prototype.getBuffer = function () {
+    return this.bytes.buffer.slice(0, this.length);
+  };
+
+  NaClCompactProtocol.prototype.reserve_ = function (size) {
+    if (this.length + size <= this.bytes.length) {
+      return;
+    }
+    var capacity = this.bytes.length * 2;
+    while (capacity < this.length + size) {
+      capacity *= 2;
+    }
+    var bytes = new Uint8Array(capacity);
+    bytes.set(this.bytes.subarray(0, this.length));
+    this.bytes = bytes;
+    this.view = new DataView(bytes.buffer);
+  };
+
+  NaClCompactProtocol.prototype.writeUint8_ = function (b) {
+    this.reserve_(1);
+    this.bytes[this.length++] = b;
+  };
+
+  NaClCompactProtocol.prototype.writeBytes_ = function (bytes) {
+    this.writeVarint32_(bytes.length);
+    this.reserve_(bytes.length);
+    this.bytes.set(bytes, this.length);
+    this.length += bytes.length;
+  };
+
+  NaClCompactProtocol.prototype.writeVarint32_ = function (n) {
+    n = n >>> 0;
+    while (n >= 0x80) {
+      this.writeUint8_((n & 0x7f) | 0x80);
+      n = n >>> 7;
+    }
+    this.writeUint8_(n);
+  };
+
+  // 64 bit varints are handled as high and low unsigned 32 bit halves.
+  NaClCompactProtocol.prototype.writeVarint64_ = function (hi, lo) {
+    while (hi !== 0 || lo >= 0x80) {
+      this.writeUint8_((lo & 0x7f) | 0x80);
+      lo = ((lo >>> 7) | (hi << 25)) >>> 0;
+      hi = hi >>> 7;
+    }
+    this.writeUint8_(lo);
+  };
+
+  NaClCompactProtocol.prototype.writeFieldHeader_ = function (type, id) {
+    if (id > this.lastFieldId && id - this.lastFieldId <= 15) {
+      this.writeUint8_(((id - this.lastFieldId) << 4) | type);
+    } else {
+      this.writeUint8_(type);
+      this.writeI16(id);
+    }
+    this.lastFieldId = id;
+  };
+
+  NaClCompactProtocol.prototype.writeCollectionBegin_ = function (etype, size) {
+    if (size <= 14) {
+      this.writeUint8_((size << 4) | TYPE_TO_COMPACT[etype]);
+    } else {
+      this.writeUint8_(0xf0 | TYPE_TO_COMPACT[etype]);
+      this.writeVarint32_(size);
+    }
+  };
+
+  NaClCompactProtocol.prototype.writeMessageBegin = function (name, type,
+                                                              seqid) {
+    this.writeUint8_(COMPACT_PROTOCOL_ID);
+    this.writeUint8_((COMPACT_VERSION & COMPACT_VERSION_MASK) |
+                     (type << COMPACT_TYPE_SHIFT));
+    this.writeVarint32_(seqid);
+    this.writeString(name);
+  };
+
+  NaClCompactProtocol.prototype.writeMessageEnd = function () {};
+
+  NaClCompactProtocol.prototype.writeStructBegin = function (name) {
+    this.lastFieldIdStack.push(this.lastFieldId);
+    this.lastFieldId = 0;
+  };
+
+  NaClCompactProtocol.prototype.writeStructEnd = function () {
+    this.lastFieldId = this.lastFieldIdStack.pop();
+  };
+
+  NaClCompactProtocol.prototype.writeFieldBegin = function (name, type, id) {
+    if (type == Type.BOOL) {
+      this.boolFieldId = id;
+    } else {
+      this.writeFieldHeader_(TYPE_TO_COMPACT[type], id);
+    }
+  };
+
+  NaClCompactProtocol.prototype.writeFieldEnd = function () {};
+
+  NaClCompactProtocol.prototype.writeFieldStop = function () {
+    this.writeUint8_(CompactType.STOP);
+  };
+
+  NaClCompactProtocol.prototype.writeMapBegin = function (ktype, vtype, size) {
+    if (size === 0) {
+      this.writeUint8_(0);
+    } else {
+      this.writeVarint32_(size);
+      this.writeUint8_((TYPE_TO_COMPACT[ktype] << 4) | TYPE_TO_COMPACT[vtype]);
+    }
+  };
+
+  NaClCompactProtocol.prototype.writeMapEnd = function () {};
+
+  NaClCompactProtocol.prototype.writeListBegin = function (etype, size) {
+    this.writeCollectionBegin_(etype, size);
+  };
+
+  NaClCompactProtocol.prototype.writeListEnd = function () {};
+
+  NaClCompactProtocol.prototype.writeSetBegin = function (etype, size) {
+    this.writeCollectionBegin_(etype, size);
+  };
+
+  NaClCompactProtocol.prototype.writeSetEnd = function () {};
+
+  NaClCompactProtocol.prototype.writeBool = function (value) {
+    var type = value ? CompactType.BOOLEAN_TRUE : CompactType.BOOLEAN_FALSE;
+    if (this.boolFieldId !== null) {
+      this.writeFieldHeader_(type, this.boolFieldId);
+      this.boolFieldId = null;
+    } else {
+      this.writeUint8_(type);
+    }
+  };
+
+  NaClCompactProtocol.prototype.writeByte = function (b) {
+    this.writeUint8_(b & 0xff);
+  };
+
+  NaClCompactProtocol.prototype.writeI16 = function (i16) {
+    this.writeVarint32_((i16 << 1) ^ (i16 >> 31));
+  };
+
+  NaClCompactProtocol.prototype.writeI32 = function (i32) {
+    this.writeVarint32_((i32 << 1) ^ (i32 >> 31));
+  };
+
+  // i64 values are numbers, so they are exact up to 2^53.
+  NaClCompactProtocol.prototype.writeI64 = function (i64) {
+    var magnitude = Math.abs(i64);
+    var hi = Math.floor(magnitude / 0x100000000);
+    var lo = magnitude % 0x100000000;
+
+    // Zigzag encoding: 2 * |i64| for positive and 2 * |i64| - 1 for negative
+    // values.
+    hi = ((hi << 1) | (lo >>> 31)) >>> 0;
+    lo = (lo << 1) >>> 0;
+    if (i64 < 0) {
+      if (lo === 0) {
+        hi = (hi - 1) >>> 0;
+      }
+      lo = (lo - 1) >>> 0;
+    }
+    this.writeVarint64_(hi, lo);
+  };
+
+  NaClCompactProtocol.prototype.writeDouble = function (dub) {
+    this.reserve_(8);
+    this.view.setFloat64(this.length, dub, true);
+    this.length += 8;
+  };
+
+  NaClCompactProtocol.prototype.writeString = function (str) {
+    this.writeBytes_(encodeUtf8(str));
+  };
+
+  // Binary values may be ArrayBuffers, typed arrays or strings.
+  NaClCompactProtocol.prototype.writeBinary = function (value) {
+    if (typeof value === 'string') {
+      this.writeString(value);
+    } else if (value instanceof ArrayBuffer) {
+      this.writeBytes_(new Uint8Array(value));
+    } else {
+      this.writeBytes_(new Uint8Array(value.buffer, value.byteOffset,
+                                      value.byteLength));
+    }
+  };
+
+  NaClCompactProtocol.prototype.readUint8_ = function () {
+    if (this.position >= this.length) {
+      throw new Error('Read past the end of the message');
+    }
+    return this.bytes[this.position++];
+  };
+
+  NaClCompactProtocol.prototype.readBytes_ = function () {
+    var size = this.readVarint32_();
+    if (this.position + size > this.length) {
+      throw new Error('Read past the end of the message');
+    }
+    var bytes = this.bytes.subarray(this.position, this.position + size);
+    this.position += size;
+    return bytes;
+  };
+
+  NaClCompactProtocol.prototype.readVarint32_ = function () {
+    var result = 0;
+    var shift = 0;
+    while (true) {
+      var b = this.readUint8_();
+      result |= (b & 0x7f) << shift;
+      if (!(b & 0x80)) {
+        return result >>> 0;
+      }
+      shift += 7;
+    }
+  };
+
+  NaClCompactProtocol.prototype.readVarint64_ = function () {
+    var hi = 0;
+    var lo = 0;
+    var shift = 0;
+    while (true) {
+      var b = this.readUint8_();
+      if (shift < 32) {
+        lo |= (b & 0x7f) << shift;
+        if (shift > 25) {
+          hi |= (b & 0x7f) >>> (32 - shift);
+        }
+      } else {
+        hi |= (b & 0x7f) << (shift - 32);
+      }
+      if (!(b & 0x80)) {
+        return {hi: hi >>> 0, lo: lo >>> 0};
+      }
+      shift += 7;
+    }
+  };
+
+  NaClCompactProtocol.prototype.readCollectionBegin_ = function () {
+    var sizeAndType = this.readUint8_();
+    var size = (sizeAndType >> 4) & 0x0f;
+    if (size == 15) {
+      size = this.readVarint32_();
+    }
+    return {etype: COMPACT_TO_TYPE[sizeAndType & 0x0f], size: size};
+  };
+
+  NaClCompactProtocol.prototype.readMessageBegin = function () {
+    if (this.readUint8_() != COMPACT_PROTOCOL_ID) {
+      throw new Error('Bad protocol identifier');
+    }
+    var versionAndType = this.readUint8_();
+    if ((versionAndType & COMPACT_VERSION_MASK) != COMPACT_VERSION) {
+      throw new Error('Bad protocol version');
+    }
+    var type = (versionAndType >> COMPACT_TYPE_SHIFT) & 0x07;
+    var seqid = this.readVarint32_() | 0;
+    var name = this.readString().value;
+    return {fname: name, mtype: type, rseqid: seqid};
+  };
+
+  NaClCompactProtocol.prototype.readMessageEnd = function () {};
+
+  NaClCompactProtocol.prototype.readStructBegin = function () {
+    this.lastFieldIdStack.push(this.lastFieldId);
+    this.lastFieldId = 0;
+    return {fname: ''};
+  };
+
+  NaClCompactProtocol.prototype.readStructEnd = function () {
+    this.lastFieldId = this.lastFieldIdStack.pop();
+  };
+
+  NaClCompactProtocol.prototype.readFieldBegin = function () {
+    var b = this.readUint8_();
+    var type = b & 0x0f;
+    if (type == CompactType.STOP) {
+      return {fname: '', ftype: Type.STOP, fid: 0};
+    }
+
+    var delta = (b >> 4) & 0x0f;
+    var id = delta === 0 ? this.readI16().value : this.lastFieldId + delta;
+    this.lastFieldId = id;
+
+    if (type == CompactType.BOOLEAN_TRUE || type == CompactType.BOOLEAN_FALSE) {
+      this.boolValue = type == CompactType.BOOLEAN_TRUE;
+    }
+    return {fname: '', ftype: COMPACT_TO_TYPE[type], fid: id};
+  };
+
+  NaClCompactProtocol.prototype.readFieldEnd = function () {};
+
+  NaClCompactProtocol.prototype.readMapBegin = function () {
+    var size = this.readVarint32_();
+    var types = size === 0 ? 0 : this.readUint8_();
+    return {
+      ktype: COMPACT_TO_TYPE[(types >> 4) & 0x0f],
+      vtype: COMPACT_TO_TYPE[types & 0x0f],
+      size: size
+    };
+  };
+
+  NaClCompactProtocol.prototype.readMapEnd = function () {};
+
+  NaClCompactProtocol.prototype.readListBegin = function () {
+    return this.readCollectionBegin_();
+  };
+
+  NaClCompactProtocol.prototype.readListEnd = function () {};
+
+  NaClCompactProtocol.prototype.readSetBegin = function () {
+    return this.readCollectionBegin_();
+  };
+
+  NaClCompactProtocol.prototype.readSetEnd = function () {};
+
+  NaClCompactProtocol.prototype.readBool = function () {
+    var value;
+    if (this.boolValue !== null) {
+      value = this.boolValue;
+      this.boolValue = null;
+    } else {
+      value = this.readUint8_() == CompactType.BOOLEAN_TRUE;
+    }
+    return {value: value};
+  };
+
+  NaClCompactProtocol.prototype.readByte = function () {
+    var b = this.readUint8_();
+    return {value: b > 127 ? b - 256 : b};
+  };
+
+  NaClCompactProtocol.prototype.readI16 = function () {
+    var n = this.readVarint32_();
+    return {value: (n >>> 1) ^ -(n & 1)};
+  };
+
+  NaClCompactProtocol.prototype.readI32 = function () {
+    var n = this.readVarint32_();
+    return {value: (n >>> 1) ^ -(n & 1)};
+  };
+
+  NaClCompactProtocol.prototype.readI64 = function () {
+    var n = this.readVarint64_();
+    var negative = n.lo & 1;
+    var hi = n.hi >>> 1;
+    var lo = ((n.lo >>> 1) | (n.hi << 31)) >>> 0;
+    var magnitude = hi * 0x100000000 + lo;
+    return {value: negative ? -magnitude - 1 : magnitude};
+  };
+
+  NaClCompactProtocol.prototype.readDouble = function () {
+    if (this.position + 8 > this.length) {
+      throw new Error('Read past the end of the message');
+    }
+    var value = this.view.getFloat64(this.position, true);
+    this.position += 8;
+    return {value: value};
+  };
+
+  NaClCompactProtocol.prototype.readString = function () {
+    return {value: decodeUtf8(this.readBytes_())};
+  };
+
+  // Binary values are read as ArrayBuffers.
+  NaClCompactProtocol.prototype.readBinary = function () {
+    var bytes = this.readBytes_();
+    return {value: bytes.buffer.slice(bytes.byteOffset,
+                                      bytes.byteOffset + bytes.length)};
+  };
+
+  NaClCompactProtocol.prototype.skip = function (type) {
+    var i;
+    var header;
+    switch (type) {
+      case Type.BOOL:
+        this.readBool();
+        break;
+      case Type.BYTE:
+        this.readUint8_();
+        break;
+      case Type.I16:
+      case Type.I32:
+        this.readVarint32_();
+        break;
+      case Type.I64:
+        this.readVarint64_();
+        break;
+      case Type.DOUBLE:
+        this.readDouble();
+        break;
+      case Type.STRING:
+        this.readBytes_();
+        break;
+      case Type.STRUCT:
+        this.readStructBegin();
+        while (true) {
+          header = this.readFieldBegin();
+          if (header.ftype == Type.STOP) {
+            break;
+          }
+          this.skip(header.ftype);
+          this.readFieldEnd();
+        }
+        this.readStructEnd();
+        break;
+      case Type.MAP:
+        header = this.readMapBegin();
+        for (i = 0; i < header.size; i++) {
+          this.skip(header.ktype);
+          this.skip(header.vtype);
+        }
+        this.readMapEnd();
+        break;
+      case Type.SET:
+      case Type.LIST:
+        header = this.readListBegin();
+        for (i = 0; i < header.size; i++) {
+          this.skip(header.etype);
+        }
+        this.readListEnd();
+        break;
+      default:
+        throw new Error('Invalid type: ' + type);
+    }
+  };
+
+  // Reads the ThriftNaClError struct sent with exception replies.
+  var readError = function (protocol) {
+    var error = {};
+    protocol.readStructBegin();
+    while (true) {
+      var header = protocol.readFieldBegin();
+      if (header.ftype == Type.STOP) {
+        break;
+      }
+      if (header.fid == 1 && header.ftype == Type.STRING) {
+        error.type = protocol.readString().value;
+      } else if (header.fid == 2 && header.ftype == Type.STRING) {
+        error.message = protocol.readString().value;
+      } else {
+        protocol.skip(header.ftype);
+      }
+      protocol.readFieldEnd();
+    }
+    protocol.readStructEnd();
+    return error;
+  };
+
   var NaClModule = function (element) {
     this.element = element;
     this.messageMap = {}; 
     this.nextMessageId = 1;
+    this.batching = false;
+    this.pendingBatch = null;
+    this.states = {};
+    this.stateListeners = {};
+    this.defaultTimeout = 0;
 
     element.addEventListener('message', this.handleMessage.bind(this), true);
   };
@@ -13,16 +785,49 @@
   // posts a message to the browser by calling PPB_Messaging.PostMessage()
   // (in C) or pp::Instance.PostMessage() (in C++).
   NaClModule.prototype.handleMessage = function (message) {
-    var response = message.data;
+    if (Array.isArray(message.data)) {
+      // A batch of responses, see setBatching().
+      for (var i = 0; i < message.data.length; i++) {
+        this.handleResponse_(message.data[i]);
+      }
+    } else {
+      this.handleResponse_(message.data);
+    }
+  };
+
+  NaClModule.prototype.handleResponse_ = function (response) {
+    if (response instanceof ArrayBuffer) {
+      this.handleBinaryMessage(response);
+      return;
+    }
+
+    if ('state' in response) {
+      this.handleState_(response);
+      return;
+    }
+
     //console.log('handleMessage: ' + response.id);
 
     if (response.id in this.messageMap) {
+      // Callbacks are null once the message expired or was cancelled.
       var callbacks = this.messageMap[response.id];
-      delete this.messageMap[message.id];
+      if ('chunk' in response) {
+        if (callbacks) {
+          this.handleChunk_(callbacks, response);
+        }
+        return;
+      }
+      delete this.messageMap[response.id];
 
       if (callbacks) {
+        clearTimeout(callbacks.timer);
         if (response.data && callbacks.onSuccess) {
-          callbacks.onSuccess(response.data); 
+          if (callbacks.chunks) {
+            callbacks.onSuccess(unpackTypedArrays(response.data),
+                                concatChunks(callbacks.chunks));
+          } else {
+            callbacks.onSuccess(unpackTypedArrays(response.data));
+          }
         } else if (callbacks.onError) {
           callbacks.onError(response.error);
         }
@@ -32,24 +837,311 @@
     }
   };
 
-  NaClModule.prototype.postMessage = function (type, data, onSuccess, onError) {
+  // Applies a patch posted by a StatePublisher to value, in place, and
+  // returns the result.
+  var applyPatch = function (value, patch) {
+    if ('length' in patch) {
+      value.length = patch.length;
+    }
+    if (patch['delete']) {
+      for (var i = 0; i < patch['delete'].length; i++) {
+        delete value[patch['delete'][i]];
+      }
+    }
+    var key;
+    if (patch.set) {
+      for (key in patch.set) {
+        if (patch.set.hasOwnProperty(key)) {
+          value[key] = unpackTypedArrays(patch.set[key]);
+        }
+      }
+    }
+    if (patch.patch) {
+      for (key in patch.patch) {
+        if (patch.patch.hasOwnProperty(key)) {
+          value[key] = applyPatch(value[key], patch.patch[key]);
+        }
+      }
+    }
+    return value;
+  };
+
+  NaClModule.prototype.handleState_ = function (response) {
+    var name = response.state;
+    var state;
+    if ('patch' in response) {
+      if (!(name in this.states)) {
+        throw new Error('Received patch of unknown state: ' + name);
+      }
+      state = applyPatch(this.states[name], response.patch);
+    } else {
+      state = unpackTypedArrays(response.data);
+    }
+    this.states[name] = state;
+
+    var listeners = this.stateListeners[name] || [];
+    for (var i = 0; i < listeners.length; i++) {
+      listeners[i](state);
+    }
+  };
+
+  // Returns the last state published by the StatePublisher named name, or
+  // undefined.  The state is updated in place when patches arrive.
+  NaClModule.prototype.getState = function (name) {
+    return this.states[name];
+  };
+
+  // Calls callback(state) whenever the StatePublisher named name publishes a
+  // new state.
+  NaClModule.prototype.onStateChange = function (name, callback) {
+    if (!(name in this.stateListeners)) {
+      this.stateListeners[name] = [];
+    }
+    this.stateListeners[name].push(callback);
+  };
+
+  // Joins the chunks of a streamed response.  Chunks are either arrays of
+  // structs or ArrayBuffers.
+  var concatChunks = function (chunks) {
+    if (chunks.length > 0 && chunks[0] instanceof ArrayBuffer) {
+      var length = 0;
+      for (var i = 0; i < chunks.length; i++) {
+        length += chunks[i].byteLength;
+      }
+      var bytes = new Uint8Array(length);
+      var offset = 0;
+      for (var i = 0; i < chunks.length; i++) {
+        bytes.set(new Uint8Array(chunks[i]), offset);
+        offset += chunks[i].byteLength;
+      }
+      return bytes.buffer;
+    }
+    return Array.prototype.concat.apply([], chunks);
+  };
+
+  NaClModule.prototype.handleChunk_ = function (callbacks, response) {
+    if (response.seq !== callbacks.nextSeq) {
+      throw new Error('Received chunk ' + response.seq + ' of message ' +
+                      response.id + ', expected ' + callbacks.nextSeq);
+    }
+    callbacks.nextSeq++;
+
+    var chunk = unpackTypedArrays(response.chunk);
+    if (callbacks.onChunk) {
+      callbacks.onChunk(chunk);
+    } else {
+      callbacks.chunks.push(chunk);
+    }
+  };
+
+  // Posts a message to a handler registered with
+  // REGISTER_STREAMING_MESSAGE_HANDLER.  Chunks of results are passed to
+  // onChunk(chunk) as they arrive, followed by onSuccess(data) with the
+  // response.  Without onChunk the chunks are kept and joined, and
+  // onSuccess(data, results) receives the response and the joined array or
+  // ArrayBuffer.  Returns the message id; timeout is as for postMessage().
+  NaClModule.prototype.postStreamingMessage = function (type, data, onChunk,
+                                                        onSuccess, onError,
+                                                        timeout) {
+    var id = this.postMessage(type, data, onSuccess, onError, timeout);
+
+    var callbacks = this.messageMap[id];
+    callbacks.nextSeq = 0;
+    if (onChunk) {
+      callbacks.onChunk = onChunk;
+    } else {
+      callbacks.chunks = [];
+    }
+    return id;
+  };
+
+  // Posts a message and returns its id.  If no response arrives within
+  // timeout milliseconds, which defaults to the timeout set with
+  // setDefaultTimeout(), onError receives a deadline_exceeded error.  The
+  // timeout is also sent as the deadline of the message, so the module drops
+  // it if it has not started by then and handlers can stop early, see
+  // CancellationToken in thrift_nacl.h.
+  NaClModule.prototype.postMessage = function (type, data, onSuccess, onError,
+                                               timeout) {
     var message = {
         id: this.nextMessageId.toString(),
         type: type,
-        data: data
+        data: encodeData(data)
     };
 
     if (message.id in this.messageMap) {
       throw new Error('Duplicate message id: ' + message.id);
     }
 
-    this.messageMap[message.id] = {
+    var callbacks = {
         onSuccess: onSuccess,
         onError: onError
     };
+    if (timeout === undefined) {
+      timeout = this.defaultTimeout;
+    }
+    if (timeout > 0) {
+      message.deadline = timeout;
+      callbacks.timer = setTimeout(
+          this.abort_.bind(this, message.id, 'deadline_exceeded',
+                           'Deadline exceeded'),
+          timeout);
+    }
+    this.messageMap[message.id] = callbacks;
     this.nextMessageId++;
 
-    this.element.postMessage(message);
+    this.send_(message);
+    return message.id;
+  };
+
+  // Sets the timeout in milliseconds of messages posted without one, or 0
+  // for no timeout, which is the default.
+  NaClModule.prototype.setDefaultTimeout = function (timeout) {
+    this.defaultTimeout = timeout;
+  };
+
+  // Cancels the message with the given id.  Its onError receives a cancelled
+  // error right away, and a handler running on a worker thread sees its
+  // CancellationToken cancelled.  Returns false if the message already
+  // completed.
+  NaClModule.prototype.cancel = function (id) {
+    if (!this.abort_(id, 'cancelled', 'Cancelled')) {
+      return false;
+    }
+    this.postMessage('__cancel', {id: id});
+    return true;
+  };
+
+  // Fails a pending message with an error of type errorType.  The entry of
+  // the message is kept until the module responds, so that the late response
+  // is ignored.
+  NaClModule.prototype.abort_ = function (id, errorType, errorMessage) {
+    var callbacks = this.messageMap[id];
+    if (!callbacks) {
+      return false;
+    }
+    clearTimeout(callbacks.timer);
+    this.messageMap[id] = null;
+    if (callbacks.onError) {
+      callbacks.onError({type: errorType, message: errorMessage});
+    }
+    return true;
+  };
+
+  // Requests the latency and size stats of every message type handled by the
+  // module, see ThriftNaClStats in thrift_nacl.thrift.  The stats are cleared
+  // after reading them if reset is true.
+  NaClModule.prototype.getStats = function (reset, onSuccess, onError) {
+    this.postMessage('__stats', {reset: !!reset}, onSuccess, onError);
+  };
+
+  // Posts a call of a oneway method of a service registered with
+  // REGISTER_PROCESSOR.  The module does not reply to oneway calls, so no
+  // callbacks are kept.  Replies to other methods of the service arrive
+  // through postMessage() as the method's result struct, e.g. {success: ...}.
+  NaClModule.prototype.postOnewayMessage = function (type, data) {
+    var message = {
+        id: this.nextMessageId.toString(),
+        type: type,
+        data: encodeData(data)
+    };
+    this.nextMessageId++;
+
+    this.send_(message);
+  };
+
+  // Handles a compact protocol encoded reply to postBinaryMessage().
+  NaClModule.prototype.handleBinaryMessage = function (buffer) {
+    var protocol = new NaClCompactProtocol(buffer);
+    var header = protocol.readMessageBegin();
+    var id = header.rseqid.toString();
+
+    if (!(id in this.messageMap)) {
+      throw new Error('Received message with unknown id: ' + id);
+    }
+    // Callbacks are null once the message was cancelled.
+    var callbacks = this.messageMap[id];
+    delete this.messageMap[id];
+    if (!callbacks) {
+      return;
+    }
+
+    if (header.mtype == MessageType.REPLY) {
+      if (callbacks.onSuccess) {
+        var response = new callbacks.ResponseType();
+        response.read(protocol);
+        callbacks.onSuccess(response);
+      }
+    } else if (callbacks.onError) {
+      callbacks.onError(readError(protocol));
+    }
+  };
+
+  // Posts request as a single ArrayBuffer holding a compact protocol encoded
+  // call, which the module decodes without building a tree of vars.  request
+  // must have a write(protocol) method and ResponseType a read(protocol)
+  // method, as the types generated by 'thrift --gen js' do.  onError receives
+  // the ThriftNaClError as {type, message}.  Returns the message id, which
+  // can be passed to cancel().
+  NaClModule.prototype.postBinaryMessage = function (type, request,
+                                                     ResponseType, onSuccess,
+                                                     onError) {
+    var seqid = this.nextMessageId;
+    var id = seqid.toString();
+
+    if (id in this.messageMap) {
+      throw new Error('Duplicate message id: ' + id);
+    }
+
+    var protocol = new NaClCompactProtocol();
+    protocol.writeMessageBegin(type, MessageType.CALL, seqid);
+    request.write(protocol);
+    protocol.writeMessageEnd();
+
+    this.messageMap[id] = {
+        onSuccess: onSuccess,
+        onError: onError,
+        ResponseType: ResponseType
+    };
+    this.nextMessageId++;
+
+    this.send_(protocol.getBuffer());
+    return id;
+  };
+
+  // When batching is enabled, messages posted in the same task are sent to
+  // the module together as one array once the task completes, and the module
+  // answers them with one array of responses.  This saves a round of
+  // postMessage overhead per message when many small messages are posted at
+  // once.  Responses of handlers that run on a worker thread still arrive
+  // one at a time.
+  NaClModule.prototype.setBatching = function (enabled) {
+    if (!enabled) {
+      this.flushBatch();
+    }
+    this.batching = enabled;
+  };
+
+  // Sends the pending batch of messages right away.
+  NaClModule.prototype.flushBatch = function () {
+    var batch = this.pendingBatch;
+    this.pendingBatch = null;
+    if (batch === null) {
+      return;
+    }
+    this.element.postMessage(batch.length == 1 ? batch[0] : batch);
+  };
+
+  NaClModule.prototype.send_ = function (message) {
+    if (!this.batching) {
+      this.element.postMessage(message);
+      return;
+    }
+    if (this.pendingBatch === null) {
+      this.pendingBatch = [];
+      Promise.resolve().then(this.flushBatch.bind(this));
+    }
+    this.pendingBatch.push(message);
   };
 
   var createNaClElement = function (id, manifestPath) {
@@ -64,4 +1156,6 @@
 
   window.createNaclElement = createNaClElement;
   window.NaClModule = NaClModule;
+  window.NaClCodec = NaClCodec;
+  window.NaClCompactProtocol = NaClCompactProtocol;
 })();
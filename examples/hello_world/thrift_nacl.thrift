@@ -2,3 +2,52 @@ struct ThriftNaClError {
   1: optional string type;
   2: optional string message;
 }
+
+// Latency of one phase of handling the messages of a type, see the
+// __stats message type in thrift_nacl.h.
+struct ThriftNaClPhaseStats {
+  1: optional string phase;
+  2: optional i64 count;
+  3: optional i64 total_ns;
+  4: optional i64 max_ns;
+  // Element i counts the phases that took [2^i, 2^(i+1)) nanoseconds, the
+  // last element the longer ones.
+  5: optional list<i64> histogram;
+}
+
+struct ThriftNaClMessageStats {
+  1: optional string message_type;
+  2: optional i64 count;
+  // Estimated size of the requests and responses: the number of vars and
+  // bytes of strings, ArrayBuffers and numbers.  Only set with
+  // SetMessageSizeStatsEnabled().
+  3: optional i64 request_nodes;
+  4: optional i64 request_bytes;
+  5: optional i64 response_nodes;
+  6: optional i64 response_bytes;
+  7: optional list<ThriftNaClPhaseStats> phases;
+  // Set for message types with a cache, see SetMessageCacheSize().
+  8: optional i64 cache_hits;
+  9: optional i64 cache_misses;
+}
+
+struct ThriftNaClStatsRequest {
+  // Clears the stats after reading them.
+  1: optional bool reset;
+}
+
+struct ThriftNaClStats {
+  1: optional list<ThriftNaClMessageStats> message_types;
+}
+
+// Request of the reserved __cancel message type, see CancellationToken in
+// thrift_nacl.h.
+struct ThriftNaClCancelRequest {
+  // Id of the message to cancel.
+  1: optional string id;
+}
+
+struct ThriftNaClCancelResponse {
+  // False if the message was not running or queued on a worker thread.
+  1: optional bool cancelled;
+}
@@ -0,0 +1,59 @@
+#include "thrift_nacl_cache.h"
+
+#include "thrift_nacl_vars.h"
+
+using apache::thrift::concurrency::Guard;
+
+namespace thrift_nacl {
+
+MessageCache::MessageCache(size_t max_entries)
+    : max_entries_(max_entries),
+      hits_(0),
+      misses_(0) {}
+
+bool MessageCache::Lookup(const pp::Var& request, uint64_t hash,
+                          pp::Var* response) {
+  Guard guard(mutex_);
+  EntryMap::iterator iter = index_.find(hash);
+  if (iter == index_.end() || !VarEquals(iter->second->request, request)) {
+    ++misses_;
+    return false;
+  }
+  ++hits_;
+  entries_.splice(entries_.begin(), entries_, iter->second);
+  *response = iter->second->response;
+  return true;
+}
+
+void MessageCache::Insert(const pp::Var& request, uint64_t hash,
+                          const pp::Var& response) {
+  Guard guard(mutex_);
+  EntryMap::iterator iter = index_.find(hash);
+  if (iter != index_.end()) {
+    // Replaces an entry with the same hash.
+    entries_.erase(iter->second);
+    index_.erase(iter);
+  } else if (index_.size() >= max_entries_) {
+    index_.erase(entries_.back().hash);
+    entries_.pop_back();
+  }
+
+  Entry entry;
+  entry.hash = hash;
+  entry.request = request;
+  entry.response = response;
+  entries_.push_front(entry);
+  index_[hash] = entries_.begin();
+}
+
+void MessageCache::GetStats(bool reset, uint64_t* hits, uint64_t* misses) {
+  Guard guard(mutex_);
+  *hits = hits_;
+  *misses = misses_;
+  if (reset) {
+    hits_ = 0;
+    misses_ = 0;
+  }
+}
+
+}  // namespace thrift_nacl
@@ -0,0 +1,54 @@
+#ifndef THRIFT_NACL_CACHE_H_
+#define THRIFT_NACL_CACHE_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <list>
+#include <map>
+
+#include "ppapi/cpp/var.h"
+#include "thrift/concurrency/Mutex.h"
+
+namespace thrift_nacl {
+
+// LRU cache of the responses of a message type, keyed on the request data.
+// Used from the main thread and the worker threads.  Requests are looked up
+// by their HashVar() and compared with VarEquals(), so a hash collision is a
+// miss.  Only one entry is kept per hash.
+class MessageCache {
+ public:
+  explicit MessageCache(size_t max_entries);
+
+  // Sets response to the cached response to request, whose hash is hash,
+  // and returns true, or returns false on a miss.
+  bool Lookup(const pp::Var& request, uint64_t hash, pp::Var* response);
+
+  // Caches response as the most recently used entry, replacing the entry
+  // with the same hash if any, or else evicting the least recently used
+  // entry if the cache is full.
+  void Insert(const pp::Var& request, uint64_t hash, const pp::Var& response);
+
+  void GetStats(bool reset, uint64_t* hits, uint64_t* misses);
+
+ private:
+  struct Entry {
+    uint64_t hash;
+    pp::Var request;
+    pp::Var response;
+  };
+  // Most recently used first.
+  typedef std::list<Entry> EntryList;
+  typedef std::map<uint64_t, EntryList::iterator> EntryMap;
+
+  apache::thrift::concurrency::Mutex mutex_;
+  size_t max_entries_;
+  EntryList entries_;
+  EntryMap index_;
+  uint64_t hits_;
+  uint64_t misses_;
+};
+
+}  // namespace thrift_nacl
+
+#endif  // THRIFT_NACL_CACHE_H_
@@ -0,0 +1,236 @@
+#include <stdio.h>
+#include <string.h>
+
+#include "ppapi/cpp/var_array.h"
+#include "ppapi/cpp/var_array_buffer.h"
+
+#include "thrift_nacl_vars.h"
+
+namespace thrift_nacl {
+
+static bool IsPackedList(const pp::Var& var) {
+  return var.is_dictionary() &&
+      static_cast<const pp::VarDictionary*>(&var)->HasKey("__typed_array");
+}
+
+static bool ArrayBufferEquals(const pp::Var& a, const pp::Var& b) {
+  pp::VarArrayBuffer buffer_a(a);
+  pp::VarArrayBuffer buffer_b(b);
+  uint32_t length = buffer_a.ByteLength();
+  if (buffer_b.ByteLength() != length) {
+    return false;
+  }
+  if (length == 0) {
+    return true;
+  }
+  bool equal = memcmp(buffer_a.Map(), buffer_b.Map(), length) == 0;
+  buffer_a.Unmap();
+  buffer_b.Unmap();
+  return equal;
+}
+
+// Compares vars that are not patched in place.
+static bool LeafEquals(const pp::Var& a, const pp::Var& b) {
+  if (a.is_string() && b.is_string()) {
+    return a.AsString() == b.AsString();
+  }
+  if (a.is_number() && b.is_number()) {
+    return a.AsDouble() == b.AsDouble();
+  }
+  if (a.is_bool() && b.is_bool()) {
+    return a.AsBool() == b.AsBool();
+  }
+  if (a.is_array_buffer() && b.is_array_buffer()) {
+    return ArrayBufferEquals(a, b);
+  }
+  if (IsPackedList(a) && IsPackedList(b)) {
+    const pp::VarDictionary* dict_a = static_cast<const pp::VarDictionary*>(&a);
+    const pp::VarDictionary* dict_b = static_cast<const pp::VarDictionary*>(&b);
+    return LeafEquals(dict_a->Get("__typed_array"),
+                      dict_b->Get("__typed_array")) &&
+        ArrayBufferEquals(dict_a->Get("buffer"), dict_b->Get("buffer"));
+  }
+  return (a.is_null() && b.is_null()) || (a.is_undefined() && b.is_undefined());
+}
+
+// Records the difference between the values of key in from and to in set or
+// patches.
+static void DiffEntry(const pp::Var& key, const pp::Var& from,
+                      const pp::Var& to, pp::VarDictionary* set,
+                      pp::VarDictionary* patches) {
+  pp::VarDictionary sub_patch;
+  switch (DiffVar(from, to, &sub_patch)) {
+    case DIFF_UNCHANGED:
+      break;
+    case DIFF_PATCHED:
+      patches->Set(key, sub_patch);
+      break;
+    case DIFF_REPLACED:
+      set->Set(key, to);
+      break;
+  }
+}
+
+DiffResult DiffVar(const pp::Var& from, const pp::Var& to,
+                   pp::VarDictionary* patch) {
+  pp::VarDictionary set;
+  pp::VarDictionary patches;
+
+  if (from.is_dictionary() && to.is_dictionary() &&
+      !IsPackedList(from) && !IsPackedList(to)) {
+    const pp::VarDictionary* from_dict =
+        static_cast<const pp::VarDictionary*>(&from);
+    const pp::VarDictionary* to_dict =
+        static_cast<const pp::VarDictionary*>(&to);
+
+    pp::VarArray keys = to_dict->GetKeys();
+    for (uint32_t i = 0; i < keys.GetLength(); ++i) {
+      pp::Var key = keys.Get(i);
+      pp::Var to_value = to_dict->Get(key);
+      if (!from_dict->HasKey(key)) {
+        set.Set(key, to_value);
+      } else {
+        DiffEntry(key, from_dict->Get(key), to_value, &set, &patches);
+      }
+    }
+
+    pp::VarArray deleted;
+    uint32_t num_deleted = 0;
+    keys = from_dict->GetKeys();
+    for (uint32_t i = 0; i < keys.GetLength(); ++i) {
+      if (!to_dict->HasKey(keys.Get(i))) {
+        deleted.Set(num_deleted++, keys.Get(i));
+      }
+    }
+    if (num_deleted > 0) {
+      patch->Set("delete", deleted);
+    }
+  } else if (from.is_array() && to.is_array()) {
+    const pp::VarArray* from_array = static_cast<const pp::VarArray*>(&from);
+    const pp::VarArray* to_array = static_cast<const pp::VarArray*>(&to);
+    uint32_t from_length = from_array->GetLength();
+    uint32_t to_length = to_array->GetLength();
+
+    for (uint32_t i = 0; i < to_length; ++i) {
+      // Keys of the patch are strings, as they are in JavaScript.
+      char index[16];
+      snprintf(index, sizeof(index), "%u", i);
+      if (i >= from_length) {
+        set.Set(index, to_array->Get(i));
+      } else {
+        DiffEntry(pp::Var(index), from_array->Get(i), to_array->Get(i), &set,
+                  &patches);
+      }
+    }
+    if (to_length != from_length) {
+      patch->Set("length", pp::Var(static_cast<int32_t>(to_length)));
+    }
+  } else {
+    return LeafEquals(from, to) ? DIFF_UNCHANGED : DIFF_REPLACED;
+  }
+
+  if (set.GetKeys().GetLength() > 0) {
+    patch->Set("set", set);
+  }
+  if (patches.GetKeys().GetLength() > 0) {
+    patch->Set("patch", patches);
+  }
+  return patch->GetKeys().GetLength() > 0 ? DIFF_PATCHED : DIFF_UNCHANGED;
+}
+
+bool VarEquals(const pp::Var& a, const pp::Var& b) {
+  if (a.is_array() && b.is_array()) {
+    const pp::VarArray* array_a = static_cast<const pp::VarArray*>(&a);
+    const pp::VarArray* array_b = static_cast<const pp::VarArray*>(&b);
+    uint32_t length = array_a->GetLength();
+    if (array_b->GetLength() != length) {
+      return false;
+    }
+    for (uint32_t i = 0; i < length; ++i) {
+      if (!VarEquals(array_a->Get(i), array_b->Get(i))) {
+        return false;
+      }
+    }
+    return true;
+  }
+  if (a.is_dictionary() && b.is_dictionary()) {
+    const pp::VarDictionary* dict_a = static_cast<const pp::VarDictionary*>(&a);
+    const pp::VarDictionary* dict_b = static_cast<const pp::VarDictionary*>(&b);
+    pp::VarArray keys = dict_a->GetKeys();
+    uint32_t length = keys.GetLength();
+    if (dict_b->GetKeys().GetLength() != length) {
+      return false;
+    }
+    for (uint32_t i = 0; i < length; ++i) {
+      pp::Var key = keys.Get(i);
+      if (!dict_b->HasKey(key) ||
+          !VarEquals(dict_a->Get(key), dict_b->Get(key))) {
+        return false;
+      }
+    }
+    return true;
+  }
+  return LeafEquals(a, b);
+}
+
+static const uint64_t kHashOffsetBasis = 14695981039346656037ULL;
+static const uint64_t kHashPrime = 1099511628211ULL;
+
+// FNV-1a.
+static uint64_t HashBytes(uint64_t hash, const void* data, size_t size) {
+  const uint8_t* bytes = static_cast<const uint8_t*>(data);
+  for (size_t i = 0; i < size; ++i) {
+    hash = (hash ^ bytes[i]) * kHashPrime;
+  }
+  return hash;
+}
+
+uint64_t HashVar(const pp::Var& var) {
+  uint8_t tag = 0;
+  uint64_t hash = kHashOffsetBasis;
+  if (var.is_string()) {
+    tag = 1;
+    std::string value = var.AsString();
+    hash = HashBytes(hash, value.data(), value.size());
+  } else if (var.is_number()) {
+    tag = 2;
+    double value = var.AsDouble();
+    hash = HashBytes(hash, &value, sizeof(value));
+  } else if (var.is_bool()) {
+    tag = var.AsBool() ? 3 : 4;
+  } else if (var.is_array_buffer()) {
+    tag = 5;
+    pp::VarArrayBuffer buffer(var);
+    uint32_t length = buffer.ByteLength();
+    if (length > 0) {
+      hash = HashBytes(hash, buffer.Map(), length);
+      buffer.Unmap();
+    }
+  } else if (var.is_array()) {
+    tag = 6;
+    const pp::VarArray* array = static_cast<const pp::VarArray*>(&var);
+    uint32_t length = array->GetLength();
+    for (uint32_t i = 0; i < length; ++i) {
+      uint64_t element_hash = HashVar(array->Get(i));
+      hash = HashBytes(hash, &element_hash, sizeof(element_hash));
+    }
+  } else if (var.is_dictionary()) {
+    tag = 7;
+    const pp::VarDictionary* dict = static_cast<const pp::VarDictionary*>(&var);
+    pp::VarArray keys = dict->GetKeys();
+    uint32_t length = keys.GetLength();
+    uint64_t entries_hash = 0;
+    for (uint32_t i = 0; i < length; ++i) {
+      pp::Var key = keys.Get(i);
+      uint64_t entry_hash[2] = {HashVar(key), HashVar(dict->Get(key))};
+      entries_hash += HashBytes(kHashOffsetBasis, entry_hash,
+                                sizeof(entry_hash));
+    }
+    hash = HashBytes(hash, &entries_hash, sizeof(entries_hash));
+  } else if (var.is_null()) {
+    tag = 8;
+  }
+  return HashBytes(hash, &tag, sizeof(tag));
+}
+
+}  // namespace thrift_nacl
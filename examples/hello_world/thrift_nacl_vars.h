@@ -0,0 +1,36 @@
+#ifndef THRIFT_NACL_VARS_H_
+#define THRIFT_NACL_VARS_H_
+
+#include <stdint.h>
+
+#include "ppapi/cpp/var.h"
+#include "ppapi/cpp/var_dictionary.h"
+
+namespace thrift_nacl {
+
+// Compares two var trees.  Dictionaries are equal if they have the same
+// entries, whatever the order of their keys.
+bool VarEquals(const pp::Var& a, const pp::Var& b);
+
+// Hashes a var tree so that trees for which VarEquals() is true have the same
+// hash.  Dictionary entries are combined independently of their order.
+uint64_t HashVar(const pp::Var& var);
+
+// Result of comparing two var trees.
+enum DiffResult {
+  DIFF_UNCHANGED,
+  // The new var is described by a patch of the old one.
+  DIFF_PATCHED,
+  // The new var replaces the old one.
+  DIFF_REPLACED
+};
+
+// Compares the var trees from and to.  If to can be described as a change of
+// from, sets the entries of patch, in the format documented on
+// StatePublisher, and returns DIFF_PATCHED.
+DiffResult DiffVar(const pp::Var& from, const pp::Var& to,
+                   pp::VarDictionary* patch);
+
+}  // namespace thrift_nacl
+
+#endif  // THRIFT_NACL_VARS_H_
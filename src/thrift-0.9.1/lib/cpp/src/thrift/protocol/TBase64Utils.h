@@ -37,6 +37,25 @@ void base64_encode(const uint8_t *in, uint32_t len, uint8_t *buf);
 // no '=' padding should be included in the input
 void base64_decode(uint8_t *buf, uint32_t len);
 
+// Returns the number of characters in the unpadded encoding of len bytes
+size_t base64_encoded_length(size_t len);
+
+// Encodes len bytes of in as unpadded base64 into out, which must have room
+// for base64_encoded_length(len) characters. Returns the number written.
+size_t base64_encode_buffer(const uint8_t *in, size_t len, uint8_t *out);
+
+// Returns the most bytes that len base64 characters can decode to
+size_t base64_decoded_length(size_t len);
+
+// Decodes len base64 characters of in into out, which must have room for
+// base64_decoded_length(len) bytes and may be the same buffer as in.
+// The input may be padded with '=' up to a multiple of 4 characters.
+// Returns false if it holds characters outside the base64 alphabet,
+// misplaced padding, a single trailing character or nonzero trailing bits;
+// otherwise sets out_len to the number of bytes decoded.
+bool base64_decode_buffer(const uint8_t *in, size_t len, uint8_t *out,
+                          size_t *out_len);
+
 void base64EncodeString(const std::string& in, std::string* out);
 
 bool base64DecodeString(const std::string& in, std::string* out);
@@ -139,6 +139,14 @@ class TBinaryProtocolT
 
   inline uint32_t writeBinary(const std::string& str);
 
+  inline uint32_t writeI16Array(const int16_t* values, uint32_t size);
+
+  inline uint32_t writeI32Array(const int32_t* values, uint32_t size);
+
+  inline uint32_t writeI64Array(const int64_t* values, uint32_t size);
+
+  inline uint32_t writeDoubleArray(const double* values, uint32_t size);
+
   /**
    * Reading functions
    */
@@ -193,10 +201,31 @@ class TBinaryProtocolT
 
   inline uint32_t readBinary(std::string& str);
 
+  inline uint32_t readI16Array(int16_t* values, uint32_t size);
+
+  inline uint32_t readI32Array(int32_t* values, uint32_t size);
+
+  inline uint32_t readI64Array(int64_t* values, uint32_t size);
+
+  inline uint32_t readDoubleArray(double* values, uint32_t size);
+
  protected:
   template<typename StrType>
   uint32_t readStringBody(StrType& str, int32_t sz);
 
+  // Write and read size values of type T as a span of big-endian UInt_
+  // words.
+  template<typename UInt_, typename T>
+  uint32_t writeFixedArray(const T* values, uint32_t size);
+
+  template<typename UInt_, typename T>
+  uint32_t readFixedArray(T* values, uint32_t size);
+
+  // Copy size big-endian UInt_ words from src to dst in host byte order, or
+  // the other way around.  dst may equal src.
+  template<typename UInt_>
+  static void swapArray(uint8_t* dst, const uint8_t* src, uint32_t size);
+
   Transport_* trans_;
 
   int32_t string_limit_;
@@ -22,8 +22,16 @@
 
 #include <thrift/protocol/TBinaryProtocol.h>
 
+#include <algorithm>
+#include <cstring>
 #include <limits>
 
+#if defined(__SSSE3__)
+#include <tmmintrin.h>
+#elif defined(__ARM_NEON__)
+#include <arm_neon.h>
+#endif
+
 
 namespace apache { namespace thrift { namespace protocol {
 
@@ -193,6 +201,57 @@ uint32_t TBinaryProtocolT<Transport_>::writeBinary(const std::string& str) {
   return TBinaryProtocolT<Transport_>::writeString(str);
 }
 
+template <class Transport_>
+uint32_t TBinaryProtocolT<Transport_>::writeI16Array(const int16_t* values,
+                                                     uint32_t size) {
+  return writeFixedArray<uint16_t>(values, size);
+}
+
+template <class Transport_>
+uint32_t TBinaryProtocolT<Transport_>::writeI32Array(const int32_t* values,
+                                                     uint32_t size) {
+  return writeFixedArray<uint32_t>(values, size);
+}
+
+template <class Transport_>
+uint32_t TBinaryProtocolT<Transport_>::writeI64Array(const int64_t* values,
+                                                     uint32_t size) {
+  return writeFixedArray<uint64_t>(values, size);
+}
+
+template <class Transport_>
+uint32_t TBinaryProtocolT<Transport_>::writeDoubleArray(const double* values,
+                                                        uint32_t size) {
+  BOOST_STATIC_ASSERT(std::numeric_limits<double>::is_iec559);
+  return writeFixedArray<uint64_t>(values, size);
+}
+
+template <class Transport_>
+template<typename UInt_, typename T>
+uint32_t TBinaryProtocolT<Transport_>::writeFixedArray(const T* values,
+                                                       uint32_t size) {
+  BOOST_STATIC_ASSERT(sizeof(T) == sizeof(UInt_));
+  if (size > (std::numeric_limits<uint32_t>::max)() / sizeof(UInt_)) {
+    throw TProtocolException(TProtocolException::SIZE_LIMIT);
+  }
+  const uint8_t* src = reinterpret_cast<const uint8_t*>(values);
+  uint32_t length = size * sizeof(UInt_);
+
+#if __THRIFT_BYTE_ORDER == __THRIFT_BIG_ENDIAN
+  this->trans_->write(src, length);
+#else
+  // Swap through a stack buffer, so large lists cost no allocation.
+  uint8_t chunk[4096];
+  const uint32_t chunk_size = sizeof(chunk) / sizeof(UInt_);
+  for (uint32_t i = 0; i < size; i += chunk_size) {
+    uint32_t count = (std::min)(chunk_size, size - i);
+    swapArray<UInt_>(chunk, src + i * sizeof(UInt_), count);
+    this->trans_->write(chunk, count * sizeof(UInt_));
+  }
+#endif
+  return length;
+}
+
 /**
  * Reading functions
  */
@@ -417,6 +476,112 @@ uint32_t TBinaryProtocolT<Transport_>::readBinary(std::string& str) {
   return TBinaryProtocolT<Transport_>::readString(str);
 }
 
+template <class Transport_>
+uint32_t TBinaryProtocolT<Transport_>::readI16Array(int16_t* values,
+                                                    uint32_t size) {
+  return readFixedArray<uint16_t>(values, size);
+}
+
+template <class Transport_>
+uint32_t TBinaryProtocolT<Transport_>::readI32Array(int32_t* values,
+                                                    uint32_t size) {
+  return readFixedArray<uint32_t>(values, size);
+}
+
+template <class Transport_>
+uint32_t TBinaryProtocolT<Transport_>::readI64Array(int64_t* values,
+                                                    uint32_t size) {
+  return readFixedArray<uint64_t>(values, size);
+}
+
+template <class Transport_>
+uint32_t TBinaryProtocolT<Transport_>::readDoubleArray(double* values,
+                                                       uint32_t size) {
+  BOOST_STATIC_ASSERT(std::numeric_limits<double>::is_iec559);
+  return readFixedArray<uint64_t>(values, size);
+}
+
+template <class Transport_>
+template<typename UInt_, typename T>
+uint32_t TBinaryProtocolT<Transport_>::readFixedArray(T* values,
+                                                      uint32_t size) {
+  BOOST_STATIC_ASSERT(sizeof(T) == sizeof(UInt_));
+  if (size > (std::numeric_limits<uint32_t>::max)() / sizeof(UInt_)) {
+    throw TProtocolException(TProtocolException::SIZE_LIMIT);
+  }
+  uint8_t* dst = reinterpret_cast<uint8_t*>(values);
+  uint32_t length = size * sizeof(UInt_);
+  if (length == 0) {
+    return 0;
+  }
+
+  // Try to borrow the whole span first, and swap it straight into values
+  const uint8_t* borrow_buf;
+  uint32_t got = length;
+  if ((borrow_buf = this->trans_->borrow(NULL, &got))) {
+    swapArray<UInt_>(dst, borrow_buf, size);
+    this->trans_->consume(length);
+    return length;
+  }
+
+  this->trans_->readAll(dst, length);
+  swapArray<UInt_>(dst, dst, size);
+  return length;
+}
+
+template <class Transport_>
+template<typename UInt_>
+void TBinaryProtocolT<Transport_>::swapArray(uint8_t* dst,
+                                             const uint8_t* src,
+                                             uint32_t size) {
+#if __THRIFT_BYTE_ORDER == __THRIFT_BIG_ENDIAN
+  if (dst != src) {
+    std::memmove(dst, src, size * sizeof(UInt_));
+  }
+#else
+  const uint32_t width = sizeof(UInt_);
+  uint32_t i = 0;
+
+#if defined(__SSSE3__)
+  // Reverse the bytes of each word, 16 bytes at a time
+  uint8_t shuffle[16];
+  for (uint32_t j = 0; j < 16; ++j) {
+    shuffle[j] = static_cast<uint8_t>(j - j % width + (width - 1 - j % width));
+  }
+  const __m128i mask =
+    _mm_loadu_si128(reinterpret_cast<const __m128i*>(shuffle));
+  for (; i + 16 / width <= size; i += 16 / width) {
+    __m128i words =
+      _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i * width));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i * width),
+                     _mm_shuffle_epi8(words, mask));
+  }
+#elif defined(__ARM_NEON__)
+  for (; i + 16 / width <= size; i += 16 / width) {
+    uint8x16_t words = vld1q_u8(src + i * width);
+    if (width == 2) {
+      words = vrev16q_u8(words);
+    } else if (width == 4) {
+      words = vrev32q_u8(words);
+    } else {
+      words = vrev64q_u8(words);
+    }
+    vst1q_u8(dst + i * width, words);
+  }
+#endif
+
+  // Assembling each word from its bytes most significant first swaps it
+  for (; i < size; ++i) {
+    const uint8_t* bytes = src + i * width;
+    UInt_ word = 0;
+    for (uint32_t j = 0; j < width; ++j) {
+      word = static_cast<UInt_>((word << 8) | bytes[j]);
+    }
+    std::memcpy(dst + i * width, &word, width);
+  }
+#endif
+}
+
 template <class Transport_>
 template<typename StrType>
 uint32_t TBinaryProtocolT<Transport_>::readStringBody(StrType& str,
@@ -146,6 +146,14 @@ class TCompactProtocolT
 
   uint32_t writeBinary(const std::string& str);
 
+  uint32_t writeI16Array(const int16_t* values, uint32_t size);
+
+  uint32_t writeI32Array(const int32_t* values, uint32_t size);
+
+  uint32_t writeI64Array(const int64_t* values, uint32_t size);
+
+  uint32_t writeDoubleArray(const double* values, uint32_t size);
+
   /**
   * These methods are called by structs, but don't actually have any wired
   * output or purpose
@@ -167,6 +175,8 @@ class TCompactProtocolT
   uint64_t i64ToZigzag(const int64_t l);
   uint32_t i32ToZigzag(const int32_t n);
   inline int8_t getCompactType(const TType ttype);
+  template <typename T>
+  uint32_t writeVarintArray(const T* values, uint32_t size);
 
  public:
   uint32_t readMessageBegin(std::string& name,
@@ -209,6 +219,14 @@ class TCompactProtocolT
 
   uint32_t readBinary(std::string& str);
 
+  uint32_t readI16Array(int16_t* values, uint32_t size);
+
+  uint32_t readI32Array(int32_t* values, uint32_t size);
+
+  uint32_t readI64Array(int64_t* values, uint32_t size);
+
+  uint32_t readDoubleArray(double* values, uint32_t size);
+
   /*
    *These methods are here for the struct to call, but don't have any wire
    * encoding.
@@ -224,6 +242,8 @@ class TCompactProtocolT
   uint32_t readVarint64(int64_t& i64);
   int32_t zigzagToI32(uint32_t n);
   int64_t zigzagToI64(uint64_t n);
+  template <typename T>
+  uint32_t readVarintArray(T* values, uint32_t size);
   TType getTType(int8_t type);
 
   // Buffer for reading strings, save for the lifetime of the protocol to
@@ -19,8 +19,13 @@
 #ifndef _THRIFT_PROTOCOL_TCOMPACTPROTOCOL_TCC_
 #define _THRIFT_PROTOCOL_TCOMPACTPROTOCOL_TCC_ 1
 
+#include <cstring>
 #include <limits>
 
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
 /*
  * TCompactProtocol::i*ToZigzag depend on the fact that the right shift
  * operator on a signed integer is an arithmetic (sign-extending) shift.
@@ -80,6 +85,122 @@ const int8_t TTypeToCType[16] = {
   CT_LIST, // T_LIST
 };
 
+/**
+ * Returns the value of the zigzag varint n, truncated to T.
+ */
+template <typename T>
+inline T zigzagToValue(uint64_t n) {
+  return static_cast<T>(static_cast<int64_t>((n >> 1) ^ (~(n & 1) + 1)));
+}
+
+inline uint32_t countTrailingZeros(uint64_t n) {
+#ifdef __GNUC__
+  return static_cast<uint32_t>(__builtin_ctzll(n));
+#else
+  uint32_t count = 0;
+  while (!(n & 1)) {
+    n >>= 1;
+    ++count;
+  }
+  return count;
+#endif
+}
+
+/**
+ * Decode the varint in [p, end) into value.  Returns its length, or 0 if
+ * it continues past end.
+ */
+inline uint32_t decodeVarint(const uint8_t* p, const uint8_t* end,
+                             uint64_t& value) {
+  uint64_t val = 0;
+  int shift = 0;
+  for (uint32_t rsize = 0; rsize < 10; ++rsize) {
+    if (p + rsize == end) {
+      return 0;
+    }
+    uint8_t byte = p[rsize];
+    val |= (uint64_t)(byte & 0x7f) << shift;
+    shift += 7;
+    if (!(byte & 0x80)) {
+      value = val;
+      return rsize + 1;
+    }
+  }
+  throw TProtocolException(TProtocolException::INVALID_DATA, "Variable-length int over 10 bytes.");
+}
+
+/**
+ * Decode up to size zigzag varints in [buf, end) into values, stopping at
+ * the first one that continues past end.  Sets decoded to the number of
+ * values and returns the number of bytes they took.
+ *
+ * Runs of one-byte varints are decoded 16 (with SSE2) or 8 at a time.
+ * Other varints of up to 8 bytes are found and packed with masks on a
+ * 64-bit word instead of a loop over their bytes.
+ */
+template <typename T>
+uint32_t decodeZigzagVarints(const uint8_t* buf, const uint8_t* end,
+                             T* values, uint32_t size, uint32_t& decoded) {
+  const uint8_t* p = buf;
+  uint32_t i = 0;
+  while (i < size) {
+#if defined(__SSE2__)
+    if (end - p >= 16 && size - i >= 16) {
+      __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+      if (_mm_movemask_epi8(bytes) == 0) {
+        for (uint32_t j = 0; j < 16; ++j) {
+          values[i + j] = zigzagToValue<T>(p[j]);
+        }
+        i += 16;
+        p += 16;
+        continue;
+      }
+    }
+#endif
+    if (end - p >= 8) {
+      uint64_t word;
+      std::memcpy(&word, p, 8);
+      word = letohll(word);
+      uint64_t stops = ~word & 0x8080808080808080ULL;
+      if (stops == 0x8080808080808080ULL && size - i >= 8) {
+        for (uint32_t j = 0; j < 8; ++j) {
+          values[i + j] = zigzagToValue<T>(p[j]);
+        }
+        i += 8;
+        p += 8;
+        continue;
+      }
+      if (stops != 0) {
+        // The first byte without the continuation bit ends the varint.
+        uint32_t length = (countTrailingZeros(stops) >> 3) + 1;
+        uint64_t bits = word & 0x7f7f7f7f7f7f7f7fULL;
+        if (length < 8) {
+          bits &= (1ULL << (8 * length)) - 1;
+        }
+        bits = ((bits & 0x7f007f007f007f00ULL) >> 1) |
+               (bits & 0x007f007f007f007fULL);
+        bits = ((bits & 0x3fff00003fff0000ULL) >> 2) |
+               (bits & 0x00003fff00003fffULL);
+        bits = ((bits & 0x0fffffff00000000ULL) >> 4) |
+               (bits & 0x000000000fffffffULL);
+        values[i++] = zigzagToValue<T>(bits);
+        p += length;
+        continue;
+      }
+    }
+
+    uint64_t value;
+    uint32_t length = decodeVarint(p, end, value);
+    if (length == 0) {
+      break;
+    }
+    values[i++] = zigzagToValue<T>(value);
+    p += length;
+  }
+  decoded = i;
+  return static_cast<uint32_t>(p - buf);
+}
+
 }} // end detail::compact namespace
 
 
@@ -260,6 +381,78 @@ uint32_t TCompactProtocolT<Transport_>::writeDouble(const double dub) {
   return 8;
 }
 
+/**
+ * Write the elements of a list as zigzag varints, encoding them into a
+ * stack buffer so the transport sees one write per kilobyte.
+ */
+template <class Transport_>
+template <typename T>
+uint32_t TCompactProtocolT<Transport_>::writeVarintArray(const T* values,
+                                                        uint32_t size) {
+  uint8_t buf[1024];
+  uint32_t used = 0;
+  uint32_t wsize = 0;
+
+  for (uint32_t i = 0; i < size; ++i) {
+    if (used > sizeof(buf) - 10) {
+      trans_->write(buf, used);
+      wsize += used;
+      used = 0;
+    }
+    uint64_t n = i64ToZigzag(values[i]);
+    while (n >= 0x80) {
+      buf[used++] = (uint8_t)((n & 0x7F) | 0x80);
+      n >>= 7;
+    }
+    buf[used++] = (uint8_t)n;
+  }
+  if (used > 0) {
+    trans_->write(buf, used);
+    wsize += used;
+  }
+  return wsize;
+}
+
+template <class Transport_>
+uint32_t TCompactProtocolT<Transport_>::writeI16Array(const int16_t* values,
+                                                      uint32_t size) {
+  return writeVarintArray(values, size);
+}
+
+template <class Transport_>
+uint32_t TCompactProtocolT<Transport_>::writeI32Array(const int32_t* values,
+                                                      uint32_t size) {
+  return writeVarintArray(values, size);
+}
+
+template <class Transport_>
+uint32_t TCompactProtocolT<Transport_>::writeI64Array(const int64_t* values,
+                                                      uint32_t size) {
+  return writeVarintArray(values, size);
+}
+
+/**
+ * Write the elements of a list of doubles, which are already in wire
+ * order on little-endian hosts.
+ */
+template <class Transport_>
+uint32_t TCompactProtocolT<Transport_>::writeDoubleArray(const double* values,
+                                                         uint32_t size) {
+#if __THRIFT_BYTE_ORDER == __THRIFT_LITTLE_ENDIAN
+  if (size > (std::numeric_limits<uint32_t>::max)() / 8) {
+    throw TProtocolException(TProtocolException::SIZE_LIMIT);
+  }
+  trans_->write(reinterpret_cast<const uint8_t*>(values), size * 8);
+  return size * 8;
+#else
+  uint32_t wsize = 0;
+  for (uint32_t i = 0; i < size; ++i) {
+    wsize += writeDouble(values[i]);
+  }
+  return wsize;
+#endif
+}
+
 /**
  * Write a string to the wire with a varint size preceeding.
  */
@@ -657,6 +850,84 @@ uint32_t TCompactProtocolT<Transport_>::readDouble(double& dub) {
   return 8;
 }
 
+/**
+ * Read the elements of a list of zigzag varints.  Runs of them are decoded
+ * straight out of the transport's buffer; a varint that straddles its end
+ * is read with readVarint64().
+ */
+template <class Transport_>
+template <typename T>
+uint32_t TCompactProtocolT<Transport_>::readVarintArray(T* values,
+                                                       uint32_t size) {
+  uint32_t rsize = 0;
+  uint32_t i = 0;
+
+  while (i < size) {
+    uint32_t available = 1;
+    const uint8_t* borrowed = trans_->borrow(NULL, &available);
+    if (borrowed != NULL) {
+      uint32_t decoded;
+      uint32_t consumed = detail::compact::decodeZigzagVarints(
+        borrowed, borrowed + available, values + i, size - i, decoded);
+      if (decoded > 0) {
+        trans_->consume(consumed);
+        rsize += consumed;
+        i += decoded;
+        continue;
+      }
+    }
+
+    int64_t value;
+    rsize += readVarint64(value);
+    values[i++] = detail::compact::zigzagToValue<T>((uint64_t)value);
+  }
+  return rsize;
+}
+
+template <class Transport_>
+uint32_t TCompactProtocolT<Transport_>::readI16Array(int16_t* values,
+                                                     uint32_t size) {
+  return readVarintArray(values, size);
+}
+
+template <class Transport_>
+uint32_t TCompactProtocolT<Transport_>::readI32Array(int32_t* values,
+                                                     uint32_t size) {
+  return readVarintArray(values, size);
+}
+
+template <class Transport_>
+uint32_t TCompactProtocolT<Transport_>::readI64Array(int64_t* values,
+                                                     uint32_t size) {
+  return readVarintArray(values, size);
+}
+
+/**
+ * Read the elements of a list of doubles in one call.
+ */
+template <class Transport_>
+uint32_t TCompactProtocolT<Transport_>::readDoubleArray(double* values,
+                                                        uint32_t size) {
+  BOOST_STATIC_ASSERT(sizeof(double) == sizeof(uint64_t));
+  BOOST_STATIC_ASSERT(std::numeric_limits<double>::is_iec559);
+
+  if (size > (std::numeric_limits<uint32_t>::max)() / 8) {
+    throw TProtocolException(TProtocolException::SIZE_LIMIT);
+  }
+  if (size > 0) {
+    trans_->readAll(reinterpret_cast<uint8_t*>(values), size * 8);
+  }
+#if __THRIFT_BYTE_ORDER != __THRIFT_LITTLE_ENDIAN
+  for (uint32_t i = 0; i < size; ++i) {
+    uint64_t bits;
+    std::memcpy(&bits, &values[i], 8);
+    bits = letohll(bits);
+    std::memcpy(&values[i], &bits, 8);
+  }
+#endif
+  return size * 8;
+}
+
 template <class Transport_>
 uint32_t TCompactProtocolT<Transport_>::readString(std::string& str) {
   return readBinary(str);
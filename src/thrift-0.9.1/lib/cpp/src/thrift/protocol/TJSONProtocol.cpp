@@ -19,11 +19,21 @@
 
 #include <thrift/protocol/TJSONProtocol.h>
 
+#include <float.h>
 #include <math.h>
-#include <boost/lexical_cast.hpp>
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+#include <limits>
 #include <thrift/protocol/TBase64Utils.h>
 #include <thrift/transport/TTransportException.h>
 
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
 using namespace apache::thrift::transport;
 
 namespace apache { namespace thrift { namespace protocol {
@@ -43,7 +53,8 @@ static const uint8_t kJSONStringDelimiter = '"';
 static const uint8_t kJSONZeroChar = '0';
 static const uint8_t kJSONEscapeChar = 'u';
 
-static const std::string kJSONEscapePrefix("\\u00");
+// Longest run of numeric characters accepted when reading a number
+static const uint32_t kJSONMaxNumberLength = 128;
 
 static const uint32_t kThriftVersion1 = 1;
 
@@ -215,6 +226,78 @@ static uint8_t hexChar(uint8_t val) {
   }
 }
 
+// Return true if the character ch must be escaped inside a JSON string:
+// the quote, the backslash and control characters.
+static inline bool isJSONSpecialChar(uint8_t ch) {
+  return ch < 0x20 || ch == kJSONStringDelimiter || ch == kJSONBackslash;
+}
+
+// Return the first character in [p, end) that must be escaped inside a JSON
+// string, or end if there is none. Characters are classified 32 (with AVX2),
+// 16 (with SSE2) or 8 at a time before falling back to one at a time.
+static const uint8_t* findJSONSpecialChar(const uint8_t* p,
+                                          const uint8_t* end) {
+#if defined(__AVX2__)
+  const __m256i quote32 = _mm256_set1_epi8(kJSONStringDelimiter);
+  const __m256i backslash32 = _mm256_set1_epi8(kJSONBackslash);
+  const __m256i control32 = _mm256_set1_epi8(0x1f);
+  while (end - p >= 32) {
+    __m256i bytes = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+    __m256i special = _mm256_or_si256(
+        _mm256_or_si256(_mm256_cmpeq_epi8(bytes, quote32),
+                        _mm256_cmpeq_epi8(bytes, backslash32)),
+        _mm256_cmpeq_epi8(_mm256_min_epu8(bytes, control32), bytes));
+    uint32_t mask = static_cast<uint32_t>(_mm256_movemask_epi8(special));
+    if (mask != 0) {
+      return p + __builtin_ctz(mask);
+    }
+    p += 32;
+  }
+#endif
+#if defined(__SSE2__)
+  const __m128i quote = _mm_set1_epi8(kJSONStringDelimiter);
+  const __m128i backslash = _mm_set1_epi8(kJSONBackslash);
+  const __m128i control = _mm_set1_epi8(0x1f);
+  while (end - p >= 16) {
+    __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+    __m128i special = _mm_or_si128(
+        _mm_or_si128(_mm_cmpeq_epi8(bytes, quote),
+                     _mm_cmpeq_epi8(bytes, backslash)),
+        _mm_cmpeq_epi8(_mm_min_epu8(bytes, control), bytes));
+    int mask = _mm_movemask_epi8(special);
+    if (mask != 0) {
+      return p + __builtin_ctz(mask);
+    }
+    p += 16;
+  }
+#endif
+  const uint64_t ones = 0x0101010101010101ULL;
+  const uint64_t highs = 0x8080808080808080ULL;
+  while (end - p >= 8) {
+    uint64_t word;
+    memcpy(&word, p, 8);
+    uint64_t quotes = word ^ (ones * kJSONStringDelimiter);
+    uint64_t backslashes = word ^ (ones * kJSONBackslash);
+    // Flags every byte that is zero (or below 0x20) but may also flag some
+    // that are not, so a flagged word is rescanned one character at a time.
+    uint64_t flagged = (((quotes - ones) & ~quotes) |
+                        ((backslashes - ones) & ~backslashes) |
+                        ((word - ones * 0x20) & ~word)) & highs;
+    if (flagged != 0) {
+      for (uint32_t i = 0; i < 8; ++i) {
+        if (isJSONSpecialChar(p[i])) {
+          return p + i;
+        }
+      }
+    }
+    p += 8;
+  }
+  while (p != end && !isJSONSpecialChar(*p)) {
+    ++p;
+  }
+  return p;
+}
+
 // Return true if the character ch is in [-+0-9.Ee]; false otherwise
 static bool isJSONNumeric(uint8_t ch) {
   switch (ch) {
@@ -238,153 +321,525 @@ static bool isJSONNumeric(uint8_t ch) {
   return false;
 }
 
+// Formatting and parsing of numbers into and out of stack buffers, without
+// the allocations of boost::lexical_cast.
+
+// Writes the decimal digits of num to buf, which must hold 20 characters,
+// and returns their count.
+static uint32_t formatJSONInteger(int64_t num, char* buf) {
+  uint64_t value = num < 0 ? ~static_cast<uint64_t>(num) + 1 :
+                             static_cast<uint64_t>(num);
+  char digits[20];
+  uint32_t count = 0;
+  do {
+    digits[count++] = static_cast<char>('0' + value % 10);
+    value /= 10;
+  } while (value != 0);
+
+  uint32_t len = 0;
+  if (num < 0) {
+    buf[len++] = '-';
+  }
+  while (count > 0) {
+    buf[len++] = digits[--count];
+  }
+  return len;
+}
 
-/**
- * Class to serve as base JSON context and as base class for other context
- * implementations
- */
-class TJSONContext {
-
- public:
-
-  TJSONContext() {};
-
-  virtual ~TJSONContext() {};
+// Round-trip formatting of doubles, using the Grisu2 algorithm of Florian
+// Loitsch, "Printing Floating-Point Numbers Quickly and Accurately with
+// Integers" (PLDI 2010).  The digits always read back as the same double and
+// are usually, but not always, the shortest that do.
 
-  /**
-   * Write context data to the transport. Default is to do nothing.
-   */
-  virtual uint32_t write(TTransport &trans) {
-    (void) trans;
-    return 0;
-  };
+// A floating point number f * 2^e with a 64-bit significand.
+struct DiyFp {
+  DiyFp(uint64_t f, int e) : f(f), e(e) {}
 
-  /**
-   * Read context data from the transport. Default is to do nothing.
-   */
-  virtual uint32_t read(TJSONProtocol::LookaheadReader &reader) {
-    (void) reader;
-    return 0;
-  };
+  uint64_t f;
+  int e;
+};
 
-  /**
-   * Return true if numbers need to be escaped as strings in this context.
-   * Default behavior is to return false.
-   */
-  virtual bool escapeNum() {
-    return false;
+static const uint64_t kDpSignificandMask = 0x000FFFFFFFFFFFFFULL;
+static const uint64_t kDpHiddenBit = 0x0010000000000000ULL;
+static const int kDpExponentBias = 0x3FF + 52;
+static const int kDpMinExponent = -kDpExponentBias;
+
+static DiyFp diyFpFromDouble(double d) {
+  uint64_t bits = bitwise_cast<uint64_t>(d);
+  int biased_e = static_cast<int>((bits >> 52) & 0x7FF);
+  uint64_t significand = bits & kDpSignificandMask;
+  if (biased_e != 0) {
+    return DiyFp(significand + kDpHiddenBit, biased_e - kDpExponentBias);
+  }
+  return DiyFp(significand, kDpMinExponent + 1);
+}
+
+// Returns x * y, rounded to 64 bits of significand.
+static DiyFp multiply(const DiyFp& x, const DiyFp& y) {
+  const uint64_t M32 = 0xFFFFFFFF;
+  uint64_t a = x.f >> 32;
+  uint64_t b = x.f & M32;
+  uint64_t c = y.f >> 32;
+  uint64_t d = y.f & M32;
+  uint64_t ac = a * c;
+  uint64_t bc = b * c;
+  uint64_t ad = a * d;
+  uint64_t bd = b * d;
+  uint64_t tmp = (bd >> 32) + (ad & M32) + (bc & M32);
+  tmp += 1U << 31;
+  return DiyFp(ac + (ad >> 32) + (bc >> 32) + (tmp >> 32), x.e + y.e + 64);
+}
+
+static DiyFp normalize(DiyFp x) {
+  while (!(x.f & (1ULL << 63))) {
+    x.f <<= 1;
+    x.e--;
   }
+  return x;
+}
+
+// Sets minus and plus to the normalized boundaries of v, halfway to its
+// neighbouring doubles.
+static void normalizedBoundaries(const DiyFp& v, DiyFp& minus, DiyFp& plus) {
+  plus = normalize(DiyFp((v.f << 1) + 1, v.e - 1));
+  minus = (v.f == kDpHiddenBit) ? DiyFp((v.f << 2) - 1, v.e - 2)
+                                : DiyFp((v.f << 1) - 1, v.e - 1);
+  minus.f <<= minus.e - plus.e;
+  minus.e = plus.e;
+}
+
+// Normalized powers 10^-348, 10^-340, ..., 10^340.
+static const uint64_t kCachedPowersF[] = {
+  0xfa8fd5a0081c0288ULL, 0xbaaee17fa23ebf76ULL, 0x8b16fb203055ac76ULL,
+  0xcf42894a5dce35eaULL, 0x9a6bb0aa55653b2dULL, 0xe61acf033d1a45dfULL,
+  0xab70fe17c79ac6caULL, 0xff77b1fcbebcdc4fULL, 0xbe5691ef416bd60cULL,
+  0x8dd01fad907ffc3cULL, 0xd3515c2831559a83ULL, 0x9d71ac8fada6c9b5ULL,
+  0xea9c227723ee8bcbULL, 0xaecc49914078536dULL, 0x823c12795db6ce57ULL,
+  0xc21094364dfb5637ULL, 0x9096ea6f3848984fULL, 0xd77485cb25823ac7ULL,
+  0xa086cfcd97bf97f4ULL, 0xef340a98172aace5ULL, 0xb23867fb2a35b28eULL,
+  0x84c8d4dfd2c63f3bULL, 0xc5dd44271ad3cdbaULL, 0x936b9fcebb25c996ULL,
+  0xdbac6c247d62a584ULL, 0xa3ab66580d5fdaf6ULL, 0xf3e2f893dec3f126ULL,
+  0xb5b5ada8aaff80b8ULL, 0x87625f056c7c4a8bULL, 0xc9bcff6034c13053ULL,
+  0x964e858c91ba2655ULL, 0xdff9772470297ebdULL, 0xa6dfbd9fb8e5b88fULL,
+  0xf8a95fcf88747d94ULL, 0xb94470938fa89bcfULL, 0x8a08f0f8bf0f156bULL,
+  0xcdb02555653131b6ULL, 0x993fe2c6d07b7facULL, 0xe45c10c42a2b3b06ULL,
+  0xaa242499697392d3ULL, 0xfd87b5f28300ca0eULL, 0xbce5086492111aebULL,
+  0x8cbccc096f5088ccULL, 0xd1b71758e219652cULL, 0x9c40000000000000ULL,
+  0xe8d4a51000000000ULL, 0xad78ebc5ac620000ULL, 0x813f3978f8940984ULL,
+  0xc097ce7bc90715b3ULL, 0x8f7e32ce7bea5c70ULL, 0xd5d238a4abe98068ULL,
+  0x9f4f2726179a2245ULL, 0xed63a231d4c4fb27ULL, 0xb0de65388cc8ada8ULL,
+  0x83c7088e1aab65dbULL, 0xc45d1df942711d9aULL, 0x924d692ca61be758ULL,
+  0xda01ee641a708deaULL, 0xa26da3999aef774aULL, 0xf209787bb47d6b85ULL,
+  0xb454e4a179dd1877ULL, 0x865b86925b9bc5c2ULL, 0xc83553c5c8965d3dULL,
+  0x952ab45cfa97a0b3ULL, 0xde469fbd99a05fe3ULL, 0xa59bc234db398c25ULL,
+  0xf6c69a72a3989f5cULL, 0xb7dcbf5354e9beceULL, 0x88fcf317f22241e2ULL,
+  0xcc20ce9bd35c78a5ULL, 0x98165af37b2153dfULL, 0xe2a0b5dc971f303aULL,
+  0xa8d9d1535ce3b396ULL, 0xfb9b7cd9a4a7443cULL, 0xbb764c4ca7a44410ULL,
+  0x8bab8eefb6409c1aULL, 0xd01fef10a657842cULL, 0x9b10a4e5e9913129ULL,
+  0xe7109bfba19c0c9dULL, 0xac2820d9623bf429ULL, 0x80444b5e7aa7cf85ULL,
+  0xbf21e44003acdd2dULL, 0x8e679c2f5e44ff8fULL, 0xd433179d9c8cb841ULL,
+  0x9e19db92b4e31ba9ULL, 0xeb96bf6ebadf77d9ULL, 0xaf87023b9bf0ee6bULL
 };
 
-// Context class for object member key-value pairs
-class JSONPairContext : public TJSONContext {
+static const int16_t kCachedPowersE[] = {
+  -1220, -1193, -1166, -1140, -1113, -1087, -1060, -1034, -1007, -980,
+  -954, -927, -901, -874, -847, -821, -794, -768, -741, -715,
+  -688, -661, -635, -608, -582, -555, -529, -502, -475, -449,
+  -422, -396, -369, -343, -316, -289, -263, -236, -210, -183,
+  -157, -130, -103, -77, -50, -24, 3, 30, 56, 83,
+  109, 136, 162, 189, 216, 242, 269, 295, 322, 348,
+  375, 402, 428, 455, 481, 508, 534, 561, 588, 614,
+  641, 667, 694, 720, 747, 774, 800, 827, 853, 880,
+  907, 933, 960, 986, 1013, 1039, 1066
+};
 
-public:
+static const uint64_t kPow10[] = {
+  1ULL, 10ULL, 100ULL, 1000ULL, 10000ULL,
+  100000ULL, 1000000ULL, 10000000ULL,
+  100000000ULL, 1000000000ULL, 10000000000ULL,
+  100000000000ULL, 1000000000000ULL, 10000000000000ULL,
+  100000000000000ULL, 1000000000000000ULL,
+  10000000000000000ULL, 100000000000000000ULL,
+  1000000000000000000ULL, 10000000000000000000ULL
+};
 
-  JSONPairContext() :
-    first_(true),
-    colon_(true) {
+// Returns the cached power c = 10^-k with a binary exponent such that
+// e + c.e lands in [-60, -32], and sets k.
+static DiyFp cachedPower(int e, int& k) {
+  double dk = (-61 - e) * 0.30102999566398114 + 347;
+  int ik = static_cast<int>(dk);
+  if (dk - ik > 0.0) {
+    ik++;
   }
+  unsigned index = static_cast<unsigned>((ik >> 3) + 1);
+  k = -(-348 + static_cast<int>(index << 3));
+  return DiyFp(kCachedPowersF[index], kCachedPowersE[index]);
+}
+
+static void grisuRound(char* buf, int len, uint64_t delta, uint64_t rest,
+                       uint64_t ten_kappa, uint64_t wp_w) {
+  while (rest < wp_w && delta - rest >= ten_kappa &&
+         (rest + ten_kappa < wp_w ||
+          wp_w - rest > rest + ten_kappa - wp_w)) {
+    buf[len - 1]--;
+    rest += ten_kappa;
+  }
+}
 
-  uint32_t write(TTransport &trans) {
-    if (first_) {
-      first_ = false;
-      colon_ = true;
-      return 0;
+static int countDecimalDigits(uint32_t n) {
+  int count = 1;
+  while (count < 10 && n >= kPow10[count]) {
+    count++;
+  }
+  return count;
+}
+
+// Generates the digits of a number within delta below Mp, usually the
+// shortest ones.
+static void digitGen(const DiyFp& W, const DiyFp& Mp, uint64_t delta,
+                     char* buf, int& len, int& k) {
+  const DiyFp one(1ULL << -Mp.e, Mp.e);
+  const uint64_t wp_w = Mp.f - W.f;
+  uint32_t p1 = static_cast<uint32_t>(Mp.f >> -one.e);
+  uint64_t p2 = Mp.f & (one.f - 1);
+  int kappa = countDecimalDigits(p1);
+  len = 0;
+
+  while (kappa > 0) {
+    uint32_t divisor = static_cast<uint32_t>(kPow10[kappa - 1]);
+    uint32_t d = p1 / divisor;
+    p1 %= divisor;
+    if (d || len) {
+      buf[len++] = static_cast<char>('0' + d);
     }
-    else {
-      trans.write(colon_ ? &kJSONPairSeparator : &kJSONElemSeparator, 1);
-      colon_ = !colon_;
-      return 1;
+    kappa--;
+    uint64_t tmp = (static_cast<uint64_t>(p1) << -one.e) + p2;
+    if (tmp <= delta) {
+      k += kappa;
+      grisuRound(buf, len, delta, tmp, kPow10[kappa] << -one.e, wp_w);
+      return;
     }
   }
 
-  uint32_t read(TJSONProtocol::LookaheadReader &reader) {
-    if (first_) {
-      first_ = false;
-      colon_ = true;
-      return 0;
+  while (true) {
+    p2 *= 10;
+    delta *= 10;
+    char d = static_cast<char>(p2 >> -one.e);
+    if (d || len) {
+      buf[len++] = static_cast<char>('0' + d);
     }
-    else {
-      uint8_t ch = (colon_ ? kJSONPairSeparator : kJSONElemSeparator);
-      colon_ = !colon_;
-      return readSyntaxChar(reader, ch);
+    p2 &= one.f - 1;
+    kappa--;
+    if (p2 < delta) {
+      k += kappa;
+      int index = -kappa;
+      grisuRound(buf, len, delta, p2, one.f,
+                 wp_w * (index < 20 ? kPow10[index] : 0));
+      return;
     }
   }
+}
 
-  // Numbers must be turned into strings if they are the key part of a pair
-  virtual bool escapeNum() {
-    return colon_;
+// Writes digits that round-trip to the positive finite value to buf, usually
+// the shortest ones, so that value is buf * 10^k, and returns their count.
+static int grisu2(double value, char* buf, int& k) {
+  const DiyFp v = diyFpFromDouble(value);
+  DiyFp w_m(0, 0), w_p(0, 0);
+  normalizedBoundaries(v, w_m, w_p);
+
+  const DiyFp c_mk = cachedPower(w_p.e, k);
+  const DiyFp W = multiply(normalize(v), c_mk);
+  DiyFp Wp = multiply(w_p, c_mk);
+  DiyFp Wm = multiply(w_m, c_mk);
+  Wm.f++;
+  Wp.f--;
+  int len;
+  digitGen(W, Wp, Wp.f - Wm.f, buf, len, k);
+  return len;
+}
+
+// Writes the finite num to buf, which must hold 32 characters, the way
+// JavaScript's Number.prototype.toString() does, and returns the length.
+static uint32_t formatJSONDouble(double num, char* buf) {
+  char* p = buf;
+  if (bitwise_cast<uint64_t>(num) >> 63) {
+    *p++ = '-';
+    num = -num;
+  }
+  if (num == 0) {
+    *p++ = '0';
+    return static_cast<uint32_t>(p - buf);
   }
 
-  private:
+  char digits[20];
+  int k;
+  int len = grisu2(num, digits, k);
+  int point = len + k;  // position of the decimal point
+
+  if (k >= 0 && point <= 21) {
+    // 1234e7 -> 12340000000
+    std::memcpy(p, digits, len);
+    p += len;
+    std::memset(p, '0', k);
+    p += k;
+  } else if (point > 0 && point <= 21) {
+    // 1234e-2 -> 12.34
+    std::memcpy(p, digits, point);
+    p += point;
+    *p++ = '.';
+    std::memcpy(p, digits + point, len - point);
+    p += len - point;
+  } else if (point > -6 && point <= 0) {
+    // 1234e-6 -> 0.001234
+    *p++ = '0';
+    *p++ = '.';
+    std::memset(p, '0', -point);
+    p += -point;
+    std::memcpy(p, digits, len);
+    p += len;
+  } else {
+    // 1234e30 -> 1.234e+33
+    *p++ = digits[0];
+    if (len > 1) {
+      *p++ = '.';
+      std::memcpy(p, digits + 1, len - 1);
+      p += len - 1;
+    }
+    *p++ = 'e';
+    int exponent = point - 1;
+    *p++ = exponent < 0 ? '-' : '+';
+    p += formatJSONInteger(exponent < 0 ? -exponent : exponent, p);
+  }
+  return static_cast<uint32_t>(p - buf);
+}
 
-    bool first_;
-    bool colon_;
-};
+// Parses the integer in [str, str + len) into num.  Returns false if it is
+// malformed or out of range for NumberType.
+template <typename NumberType>
+static bool parseJSONInteger(const char* str, uint32_t len, NumberType& num) {
+  const char* p = str;
+  const char* end = str + len;
+  bool negative = false;
+  if (p != end && (*p == '-' || *p == '+')) {
+    negative = (*p == '-');
+    ++p;
+  }
+  if (p == end) {
+    return false;
+  }
 
-// Context class for lists
-class JSONListContext : public TJSONContext {
+  uint64_t value = 0;
+  for (; p != end; ++p) {
+    if (*p < '0' || *p > '9') {
+      return false;
+    }
+    uint64_t digit = static_cast<uint64_t>(*p - '0');
+    if (value > ((std::numeric_limits<uint64_t>::max)() - digit) / 10) {
+      return false;
+    }
+    value = value * 10 + digit;
+  }
+
+  uint64_t max = static_cast<uint64_t>((std::numeric_limits<NumberType>::max)());
+  if (!negative) {
+    if (value > max) {
+      return false;
+    }
+    num = static_cast<NumberType>(value);
+  } else if (value == 0) {
+    num = 0;
+  } else {
+    if (!std::numeric_limits<NumberType>::is_signed || value - 1 > max) {
+      return false;
+    }
+    num = static_cast<NumberType>(-static_cast<int64_t>(value - 1) - 1);
+  }
+  return true;
+}
 
-public:
+// Powers of ten that doubles represent exactly.
+static const double kExactPowersOf10[] = {
+  1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11, 1e12, 1e13,
+  1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
 
-  JSONListContext() :
-    first_(true) {
+// Parses the number in str, which holds len characters followed by a NUL,
+// into num.  Returns false if it is malformed.
+static bool parseJSONDouble(const char* str, uint32_t len, double& num) {
+  const char* p = str;
+  const char* end = str + len;
+  bool negative = false;
+  if (p != end && (*p == '-' || *p == '+')) {
+    negative = (*p == '-');
+    ++p;
   }
 
-  uint32_t write(TTransport &trans) {
-    if (first_) {
-      first_ = false;
-      return 0;
+  // Up to 19 significant digits fit in the mantissa; any more make the
+  // value inexact.
+  uint64_t mantissa = 0;
+  int significant = 0;
+  int exponent = 0;
+  bool digits = false;
+  bool exact = true;
+  for (; p != end && *p >= '0' && *p <= '9'; ++p) {
+    digits = true;
+    if (significant < 19) {
+      mantissa = mantissa * 10 + (*p - '0');
+      significant += (mantissa != 0);
+    } else {
+      exponent++;
+      exact = exact && *p == '0';
     }
-    else {
-      trans.write(&kJSONElemSeparator, 1);
-      return 1;
+  }
+  if (p != end && *p == '.') {
+    for (++p; p != end && *p >= '0' && *p <= '9'; ++p) {
+      digits = true;
+      if (significant < 19) {
+        mantissa = mantissa * 10 + (*p - '0');
+        significant += (mantissa != 0);
+        exponent--;
+      } else {
+        exact = exact && *p == '0';
+      }
     }
   }
-
-  uint32_t read(TJSONProtocol::LookaheadReader &reader) {
-    if (first_) {
-      first_ = false;
-      return 0;
+  if (!digits) {
+    return false;
+  }
+  if (p != end && (*p == 'e' || *p == 'E')) {
+    ++p;
+    bool negative_exponent = false;
+    if (p != end && (*p == '-' || *p == '+')) {
+      negative_exponent = (*p == '-');
+      ++p;
     }
-    else {
-      return readSyntaxChar(reader, kJSONElemSeparator);
+    if (p == end) {
+      return false;
+    }
+    int explicit_exponent = 0;
+    for (; p != end && *p >= '0' && *p <= '9'; ++p) {
+      if (explicit_exponent < 100000) {
+        explicit_exponent = explicit_exponent * 10 + (*p - '0');
+      }
     }
+    exponent += negative_exponent ? -explicit_exponent : explicit_exponent;
+  }
+  if (p != end) {
+    return false;
   }
 
-  private:
-    bool first_;
-};
+  if (mantissa == 0 && exact) {
+    num = negative ? -0.0 : 0.0;
+    return true;
+  }
+
+#if defined(FLT_EVAL_METHOD) && FLT_EVAL_METHOD == 0
+  // Both the mantissa and the power of ten are exact doubles, so a single
+  // multiplication or division rounds correctly (Clinger's fast path).
+  if (exact && mantissa <= (1ULL << 53) &&
+      exponent >= -22 && exponent <= 22) {
+    double value = static_cast<double>(mantissa);
+    if (exponent < 0) {
+      value /= kExactPowersOf10[-exponent];
+    } else {
+      value *= kExactPowersOf10[exponent];
+    }
+    num = negative ? -value : value;
+    return true;
+  }
+#endif
+
+  char* parsed_end;
+  num = strtod(str, &parsed_end);
+  return parsed_end == end;
+}
 
 
 TJSONProtocol::TJSONProtocol(boost::shared_ptr<TTransport> ptrans) :
   TVirtualProtocol<TJSONProtocol>(ptrans),
   trans_(ptrans.get()),
-  context_(new TJSONContext()),
-  reader_(*ptrans) {
+  contextDepth_(0),
+  reader_(*ptrans),
+  skipping_(false) {
+  context_.type = CONTEXT_BASE;
+  context_.first = true;
+  context_.colon = true;
 }
 
 TJSONProtocol::~TJSONProtocol() {}
 
-void TJSONProtocol::pushContext(boost::shared_ptr<TJSONContext> c) {
-  contexts_.push(context_);
-  context_ = c;
+void TJSONProtocol::pushContext(ContextType type) {
+  if (contextDepth_ < kInlineContexts) {
+    contextStack_[contextDepth_] = context_;
+  }
+  else {
+    deepContexts_.push_back(context_);
+  }
+  ++contextDepth_;
+  context_.type = type;
+  context_.first = true;
+  context_.colon = true;
 }
 
 void TJSONProtocol::popContext() {
-  context_ = contexts_.top();
-  contexts_.pop();
+  --contextDepth_;
+  if (contextDepth_ < kInlineContexts) {
+    context_ = contextStack_[contextDepth_];
+  }
+  else {
+    context_ = deepContexts_.back();
+    deepContexts_.pop_back();
+  }
+}
+
+// Write the separator, if any, that goes before the next value in the
+// current context. Object members alternate between ':' and ','.
+uint32_t TJSONProtocol::writeContext() {
+  if (context_.type == CONTEXT_BASE) {
+    return 0;
+  }
+  if (context_.first) {
+    context_.first = false;
+    return 0;
+  }
+  if (context_.type == CONTEXT_PAIR) {
+    trans_->write(context_.colon ? &kJSONPairSeparator : &kJSONElemSeparator,
+                  1);
+    context_.colon = !context_.colon;
+  }
+  else {
+    trans_->write(&kJSONElemSeparator, 1);
+  }
+  return 1;
+}
+
+// Read and verify the separator, if any, that goes before the next value in
+// the current context.
+uint32_t TJSONProtocol::readContext() {
+  if (context_.type == CONTEXT_BASE) {
+    return 0;
+  }
+  if (context_.first) {
+    context_.first = false;
+    return 0;
+  }
+  if (context_.type == CONTEXT_PAIR) {
+    uint8_t ch = (context_.colon ? kJSONPairSeparator : kJSONElemSeparator);
+    context_.colon = !context_.colon;
+    return readSyntaxChar(reader_, ch);
+  }
+  return readSyntaxChar(reader_, kJSONElemSeparator);
+}
+
+// Numbers must be turned into strings if they are the key part of a pair
+bool TJSONProtocol::escapeNum() const {
+  return context_.type == CONTEXT_PAIR && context_.colon;
 }
 
 // Write the character ch as a JSON escape sequence ("\u00xx")
 uint32_t TJSONProtocol::writeJSONEscapeChar(uint8_t ch) {
-  trans_->write((const uint8_t *)kJSONEscapePrefix.c_str(),
-                static_cast<uint32_t>(kJSONEscapePrefix.length()));
-  uint8_t outCh = hexChar(ch >> 4);
-  trans_->write(&outCh, 1);
-  outCh = hexChar(ch);
-  trans_->write(&outCh, 1);
+  uint8_t buf[6] = { '\\', 'u', '0', '0', hexChar(ch >> 4), hexChar(ch) };
+  trans_->write(buf, 6);
   return 6;
 }
 
@@ -392,8 +847,8 @@ uint32_t TJSONProtocol::writeJSONEscapeChar(uint8_t ch) {
 uint32_t TJSONProtocol::writeJSONChar(uint8_t ch) {
   if (ch >= 0x30) {
     if (ch == kJSONBackslash) { // Only special character >= 0x30 is '\'
-      trans_->write(&kJSONBackslash, 1);
-      trans_->write(&kJSONBackslash, 1);
+      uint8_t buf[2] = { kJSONBackslash, kJSONBackslash };
+      trans_->write(buf, 2);
       return 2;
     }
     else {
@@ -409,8 +864,8 @@ uint32_t TJSONProtocol::writeJSONChar(uint8_t ch) {
       return 1;
     }
     else if (outCh > 1) {
-      trans_->write(&kJSONBackslash, 1);
-      trans_->write(&outCh, 1);
+      uint8_t buf[2] = { kJSONBackslash, outCh };
+      trans_->write(buf, 2);
       return 2;
     }
     else {
@@ -420,15 +875,26 @@ uint32_t TJSONProtocol::writeJSONChar(uint8_t ch) {
 }
 
 // Write out the contents of the string str as a JSON string, escaping
-// characters as appropriate.
+// characters as appropriate. Runs of characters that need no escaping are
+// written with a single call to the transport.
 uint32_t TJSONProtocol::writeJSONString(const std::string &str) {
-  uint32_t result = context_->write(*trans_);
+  uint32_t result = writeContext();
   result += 2; // For quotes
   trans_->write(&kJSONStringDelimiter, 1);
-  std::string::const_iterator iter(str.begin());
-  std::string::const_iterator end(str.end());
-  while (iter != end) {
-    result += writeJSONChar(*iter++);
+  const uint8_t* p = (const uint8_t *)str.data();
+  const uint8_t* end = p + str.length();
+  while (p != end) {
+    const uint8_t* special = findJSONSpecialChar(p, end);
+    if (special != p) {
+      uint32_t run = static_cast<uint32_t>(special - p);
+      trans_->write(p, run);
+      result += run;
+      p = special;
+      if (p == end) {
+        break;
+      }
+    }
+    result += writeJSONChar(*p++);
   }
   trans_->write(&kJSONStringDelimiter, 1);
   return result;
@@ -437,26 +903,23 @@ uint32_t TJSONProtocol::writeJSONString(const std::string &str) {
 // Write out the contents of the string as JSON string, base64-encoding
 // the string's contents, and escaping as appropriate
 uint32_t TJSONProtocol::writeJSONBase64(const std::string &str) {
-  uint32_t result = context_->write(*trans_);
+  uint32_t result = writeContext();
   result += 2; // For quotes
   trans_->write(&kJSONStringDelimiter, 1);
-  uint8_t b[4];
   const uint8_t *bytes = (const uint8_t *)str.c_str();
   if(str.length() > (std::numeric_limits<uint32_t>::max)())
     throw TProtocolException(TProtocolException::SIZE_LIMIT);
   uint32_t len = static_cast<uint32_t>(str.length());
-  while (len >= 3) {
-    // Encode 3 bytes at a time
-    base64_encode(bytes, 3, b);
-    trans_->write(b, 4);
-    result += 4;
-    bytes += 3;
-    len -=3;
-  }
-  if (len) { // Handle remainder
-    base64_encode(bytes, len, b);
-    trans_->write(b, len + 1);
-    result += len + 1;
+  // Encode whole chunks of 3 bytes through a buffer on the stack
+  uint8_t b[4096];
+  while (len > 0) {
+    uint32_t chunk = (std::min)(len, static_cast<uint32_t>(sizeof(b) / 4 * 3));
+    uint32_t encoded =
+      static_cast<uint32_t>(base64_encode_buffer(bytes, chunk, b));
+    trans_->write(b, encoded);
+    result += encoded;
+    bytes += chunk;
+    len -= chunk;
   }
   trans_->write(&kJSONStringDelimiter, 1);
   return result;
@@ -466,18 +929,17 @@ uint32_t TJSONProtocol::writeJSONBase64(const std::string &str) {
 // if the context requires it (eg: key in a map pair).
 template <typename NumberType>
 uint32_t TJSONProtocol::writeJSONInteger(NumberType num) {
-  uint32_t result = context_->write(*trans_);
-  std::string val(boost::lexical_cast<std::string>(num));
-  bool escapeNum = context_->escapeNum();
-  if (escapeNum) {
+  uint32_t result = writeContext();
+  char val[20];
+  uint32_t len = formatJSONInteger(static_cast<int64_t>(num), val);
+  bool quoted = escapeNum();
+  if (quoted) {
     trans_->write(&kJSONStringDelimiter, 1);
     result += 1;
   }
-  if(val.length() > (std::numeric_limits<uint32_t>::max)())
-    throw TProtocolException(TProtocolException::SIZE_LIMIT);
-  trans_->write((const uint8_t *)val.c_str(), static_cast<uint32_t>(val.length()));
-  result += static_cast<uint32_t>(val.length());
-  if (escapeNum) {
+  trans_->write((const uint8_t *)val, len);
+  result += len;
+  if (quoted) {
     trans_->write(&kJSONStringDelimiter, 1);
     result += 1;
   }
@@ -487,40 +949,35 @@ uint32_t TJSONProtocol::writeJSONInteger(NumberType num) {
 // Convert the given double to a JSON string, which is either the number,
 // "NaN" or "Infinity" or "-Infinity".
 uint32_t TJSONProtocol::writeJSONDouble(double num) {
-  uint32_t result = context_->write(*trans_);
-  std::string val(boost::lexical_cast<std::string>(num));
-
-  // Normalize output of boost::lexical_cast for NaNs and Infinities
-  bool special = false;
-  switch (val[0]) {
-  case 'N':
-  case 'n':
-    val = kThriftNan;
-    special = true;
-    break;
-  case 'I':
-  case 'i':
-    val = kThriftInfinity;
-    special = true;
-    break;
-  case '-':
-    if ((val[1] == 'I') || (val[1] == 'i')) {
-      val = kThriftNegativeInfinity;
-      special = true;
-    }
-    break;
+  uint32_t result = writeContext();
+  char buf[32];
+  const char* val = buf;
+  uint32_t len;
+
+  // NaNs and Infinities are written as strings
+  bool special = true;
+  if (num != num) {
+    val = kThriftNan.c_str();
+    len = static_cast<uint32_t>(kThriftNan.length());
+  } else if (num == HUGE_VAL) {
+    val = kThriftInfinity.c_str();
+    len = static_cast<uint32_t>(kThriftInfinity.length());
+  } else if (num == -HUGE_VAL) {
+    val = kThriftNegativeInfinity.c_str();
+    len = static_cast<uint32_t>(kThriftNegativeInfinity.length());
+  } else {
+    len = formatJSONDouble(num, buf);
+    special = false;
   }
 
-  bool escapeNum = special || context_->escapeNum();
-  if (escapeNum) {
+  bool quoted = special || escapeNum();
+  if (quoted) {
     trans_->write(&kJSONStringDelimiter, 1);
     result += 1;
   }
-  if(val.length() > (std::numeric_limits<uint32_t>::max)())
-    throw TProtocolException(TProtocolException::SIZE_LIMIT);
-  trans_->write((const uint8_t *)val.c_str(), static_cast<uint32_t>(val.length()));
-  result += static_cast<uint32_t>(val.length());
-  if (escapeNum) {
+  trans_->write((const uint8_t *)val, len);
+  result += len;
+  if (quoted) {
     trans_->write(&kJSONStringDelimiter, 1);
     result += 1;
   }
@@ -528,9 +985,9 @@ uint32_t TJSONProtocol::writeJSONDouble(double num) {
 }
 
 uint32_t TJSONProtocol::writeJSONObjectStart() {
-  uint32_t result = context_->write(*trans_);
+  uint32_t result = writeContext();
   trans_->write(&kJSONObjectStart, 1);
-  pushContext(boost::shared_ptr<TJSONContext>(new JSONPairContext()));
+  pushContext(CONTEXT_PAIR);
   return result + 1;
 }
 
@@ -541,9 +998,9 @@ uint32_t TJSONProtocol::writeJSONObjectEnd() {
 }
 
 uint32_t TJSONProtocol::writeJSONArrayStart() {
-  uint32_t result = context_->write(*trans_);
+  uint32_t result = writeContext();
   trans_->write(&kJSONArrayStart, 1);
-  pushContext(boost::shared_ptr<TJSONContext>(new JSONListContext()));
+  pushContext(CONTEXT_LIST);
   return result + 1;
 }
 
@@ -689,13 +1146,29 @@ uint32_t TJSONProtocol::readJSONEscapeChar(uint8_t *out) {
   return 4;
 }
 
-// Decodes a JSON string, including unescaping, and returns the string via str
+// Decodes a JSON string, including unescaping, and returns the string via str.
+// Unescaped control characters are accepted as themselves.
 uint32_t TJSONProtocol::readJSONString(std::string &str, bool skipContext) {
-  uint32_t result = (skipContext ? 0 : context_->read(reader_));
+  uint32_t result = (skipContext ? 0 : readContext());
   result += readJSONSyntaxChar(kJSONStringDelimiter);
   uint8_t ch;
   str.clear();
   while (true) {
+    // Copy runs of characters that need no unescaping straight out of the
+    // transport's buffer when it can be borrowed.
+    uint32_t available;
+    const uint8_t* borrowed = reader_.borrow(&available);
+    if (borrowed != NULL) {
+      const uint8_t* special =
+        findJSONSpecialChar(borrowed, borrowed + available);
+      uint32_t run = static_cast<uint32_t>(special - borrowed);
+      str.append((const char *)borrowed, run);
+      reader_.consume(run);
+      result += run;
+      if (run == available) {
+        continue;
+      }
+    }
     ch = reader_.read();
     ++result;
     if (ch == kJSONStringDelimiter) {
@@ -726,62 +1199,87 @@ uint32_t TJSONProtocol::readJSONString(std::string &str, bool skipContext) {
 uint32_t TJSONProtocol::readJSONBase64(std::string &str) {
   std::string tmp;
   uint32_t result = readJSONString(tmp);
-  uint8_t *b = (uint8_t *)tmp.c_str();
   if(tmp.length() > (std::numeric_limits<uint32_t>::max)())
     throw TProtocolException(TProtocolException::SIZE_LIMIT);
-  uint32_t len = static_cast<uint32_t>(tmp.length());
-  str.clear();
-  while (len >= 4) {
-    base64_decode(b, 4);
-    str.append((const char *)b, 3);
-    b += 4;
-    len -= 4;
-  }
-  // Don't decode if we hit the end or got a single leftover byte (invalid
-  // base64 but legal for skip of regular string type)
-  if (len > 1) {
-    base64_decode(b, len);
-    str.append((const char *)b, len - 1);
+  str.resize(base64_decoded_length(tmp.length()));
+  size_t decoded = 0;
+  if (!tmp.empty() &&
+      !base64_decode_buffer((const uint8_t *)tmp.data(), tmp.length(),
+                            (uint8_t *)&str[0], &decoded)) {
+    throw TProtocolException(TProtocolException::INVALID_DATA,
+                             "Invalid base64 data");
   }
+  str.resize(decoded);
   return result;
 }
 
-// Reads a sequence of characters, stopping at the first one that is not
-// a valid JSON numeric character.
-uint32_t TJSONProtocol::readJSONNumericChars(std::string &str) {
-  uint32_t result = 0;
-  str.clear();
+// Reads the run of numeric characters that comes next into str, which holds
+// kJSONMaxNumberLength + 1 characters, scanning the transport's buffer in
+// place when it can be borrowed.  Stops at the first character that is not
+// a valid JSON numeric character and NUL-terminates str.
+uint32_t TJSONProtocol::LookaheadReader::readNumericChars(char *str) {
+  uint32_t len = 0;
+  if (hasData_) {
+    if (!isJSONNumeric(data_)) {
+      str[len] = '\0';
+      return len;
+    }
+    str[len++] = static_cast<char>(data_);
+    hasData_ = false;
+  }
+
   while (true) {
-    uint8_t ch = reader_.peek();
-    if (!isJSONNumeric(ch)) {
+    uint32_t available = 1;
+    const uint8_t* borrowed = trans_->borrow(NULL, &available);
+    if (borrowed == NULL) {
+      // Nothing buffered; read a character at a time instead
+      uint8_t ch = peek();
+      if (!isJSONNumeric(ch)) {
+        break;
+      }
+      hasData_ = false;
+      if (len == kJSONMaxNumberLength) {
+        throw TProtocolException(TProtocolException::INVALID_DATA,
+                                 "Numeric value too long");
+      }
+      str[len++] = static_cast<char>(ch);
+      continue;
+    }
+
+    uint32_t i = 0;
+    while (i < available && isJSONNumeric(borrowed[i])) {
+      if (len == kJSONMaxNumberLength) {
+        throw TProtocolException(TProtocolException::INVALID_DATA,
+                                 "Numeric value too long");
+      }
+      str[len++] = static_cast<char>(borrowed[i++]);
+    }
+    trans_->consume(i);
+    if (i < available) {
       break;
     }
-    reader_.read();
-    str += ch;
-    ++result;
   }
-  return result;
+  str[len] = '\0';
+  return len;
 }
 
 // Reads a sequence of characters and assembles them into a number,
 // returning them via num
 template <typename NumberType>
 uint32_t TJSONProtocol::readJSONInteger(NumberType &num) {
-  uint32_t result = context_->read(reader_);
-  if (context_->escapeNum()) {
+  uint32_t result = readContext();
+  if (escapeNum()) {
     result += readJSONSyntaxChar(kJSONStringDelimiter);
   }
-  std::string str;
-  result += readJSONNumericChars(str);
-  try {
-    num = boost::lexical_cast<NumberType>(str);
-  }
-  catch (boost::bad_lexical_cast e) {
-    throw new TProtocolException(TProtocolException::INVALID_DATA,
-                                 "Expected numeric value; got \"" + str +
-                                  "\"");
+  char str[kJSONMaxNumberLength + 1];
+  uint32_t len = reader_.readNumericChars(str);
+  result += len;
+  if (!parseJSONInteger(str, len, num)) {
+    throw TProtocolException(TProtocolException::INVALID_DATA,
+                             "Expected numeric value; got \"" +
+                             std::string(str, len) + "\"");
   }
-  if (context_->escapeNum()) {
+  if (escapeNum()) {
     result += readJSONSyntaxChar(kJSONStringDelimiter);
   }
   return result;
@@ -789,7 +1287,7 @@ uint32_t TJSONProtocol::readJSONInteger(NumberType &num) {
 
 // Reads a JSON number or string and interprets it as a double.
 uint32_t TJSONProtocol::readJSONDouble(double &num) {
-  uint32_t result = context_->read(reader_);
+  uint32_t result = readContext();
   std::string str;
   if (reader_.peek() == kJSONStringDelimiter) {
     result += readJSONString(str, true);
@@ -804,43 +1302,40 @@ uint32_t TJSONProtocol::readJSONDouble(double &num) {
       num = -HUGE_VAL;
     }
     else {
-      if (!context_->escapeNum()) {
+      if (!escapeNum()) {
         // Throw exception -- we should not be in a string in this case
-        throw new TProtocolException(TProtocolException::INVALID_DATA,
-                                     "Numeric data unexpectedly quoted");
+        throw TProtocolException(TProtocolException::INVALID_DATA,
+                                 "Numeric data unexpectedly quoted");
       }
-      try {
-        num = boost::lexical_cast<double>(str);
-      }
-      catch (boost::bad_lexical_cast e) {
-        throw new TProtocolException(TProtocolException::INVALID_DATA,
-                                     "Expected numeric value; got \"" + str +
-                                     "\"");
+      if (!parseJSONDouble(str.c_str(), static_cast<uint32_t>(str.length()),
+                           num)) {
+        throw TProtocolException(TProtocolException::INVALID_DATA,
+                                 "Expected numeric value; got \"" + str +
+                                 "\"");
       }
     }
   }
   else {
-    if (context_->escapeNum()) {
+    if (escapeNum()) {
       // This will throw - we should have had a quote if escapeNum == true
       readJSONSyntaxChar(kJSONStringDelimiter);
     }
-    result += readJSONNumericChars(str);
-    try {
-      num = boost::lexical_cast<double>(str);
-    }
-    catch (boost::bad_lexical_cast e) {
-      throw new TProtocolException(TProtocolException::INVALID_DATA,
-                                   "Expected numeric value; got \"" + str +
-                                   "\"");
+    char chars[kJSONMaxNumberLength + 1];
+    uint32_t len = reader_.readNumericChars(chars);
+    result += len;
+    if (!parseJSONDouble(chars, len, num)) {
+      throw TProtocolException(TProtocolException::INVALID_DATA,
+                               "Expected numeric value; got \"" +
+                               std::string(chars, len) + "\"");
     }
   }
   return result;
 }
 
 uint32_t TJSONProtocol::readJSONObjectStart() {
-  uint32_t result = context_->read(reader_);
+  uint32_t result = readContext();
   result += readJSONSyntaxChar(kJSONObjectStart);
-  pushContext(boost::shared_ptr<TJSONContext>(new JSONPairContext()));
+  pushContext(CONTEXT_PAIR);
   return result;
 }
 
@@ -851,9 +1346,9 @@ uint32_t TJSONProtocol::readJSONObjectEnd() {
 }
 
 uint32_t TJSONProtocol::readJSONArrayStart() {
-  uint32_t result = context_->read(reader_);
+  uint32_t result = readContext();
   result += readJSONSyntaxChar(kJSONArrayStart);
-  pushContext(boost::shared_ptr<TJSONContext>(new JSONListContext()));
+  pushContext(CONTEXT_LIST);
   return result;
 }
 
@@ -1017,7 +1512,26 @@ uint32_t TJSONProtocol::readString(std::string &str) {
 }
 
 uint32_t TJSONProtocol::readBinary(std::string &str) {
+  if (skipping_) {
+    return readJSONString(str);
+  }
   return readJSONBase64(str);
 }
 
+// Binary and plain strings cannot be told apart, so while skipping, strings
+// at any depth are read by readBinary() as plain strings rather than
+// rejected for not being Base64.
+uint32_t TJSONProtocol::skip(TType type) {
+  skipping_ = true;
+  uint32_t result;
+  try {
+    result = apache::thrift::protocol::skip(*this, type);
+  } catch (...) {
+    skipping_ = false;
+    throw;
+  }
+  skipping_ = false;
+  return result;
+}
+
 }}} // apache::thrift::protocol
@@ -22,13 +22,10 @@
 
 #include <thrift/protocol/TVirtualProtocol.h>
 
-#include <stack>
+#include <vector>
 
 namespace apache { namespace thrift { namespace protocol {
 
-// Forward declaration
-class TJSONContext;
-
 /**
  * JSON protocol for Thrift.
  *
@@ -48,8 +45,8 @@ class TJSONContext;
  *    escaping.
  *
  * 4. Thrift binary values are encoded into Base64 and emitted as JSON strings.
- *    The readBinary() method is written such that it will properly skip if
- *    called on a Thrift string (although it will decode garbage data).
+ *    readBinary() throws if the string is not valid Base64, except within
+ *    skip(), which cannot tell binary and plain strings apart.
  *
  * 5. Thrift structs are represented as JSON objects, with the field ID as the
  *    key, and the field value represented as a JSON object with a single
@@ -96,10 +93,32 @@ class TJSONProtocol : public TVirtualProtocol<TJSONProtocol> {
 
  private:
 
-  void pushContext(boost::shared_ptr<TJSONContext> c);
+  /**
+   * Separator state of a JSON object or array being written or read. The
+   * base context, outside of any object or array, writes no separators.
+   */
+  enum ContextType {
+    CONTEXT_BASE,
+    CONTEXT_PAIR,
+    CONTEXT_LIST
+  };
+
+  struct Context {
+    uint8_t type;
+    bool first;
+    bool colon;
+  };
+
+  void pushContext(ContextType type);
 
   void popContext();
 
+  uint32_t writeContext();
+
+  uint32_t readContext();
+
+  bool escapeNum() const;
+
   uint32_t writeJSONEscapeChar(uint8_t ch);
 
   uint32_t writeJSONChar(uint8_t ch);
@@ -129,8 +148,6 @@ class TJSONProtocol : public TVirtualProtocol<TJSONProtocol> {
 
   uint32_t readJSONBase64(std::string &str);
 
-  uint32_t readJSONNumericChars(std::string &str);
-
   template <typename NumberType>
   uint32_t readJSONInteger(NumberType &num);
 
@@ -255,6 +272,8 @@ class TJSONProtocol : public TVirtualProtocol<TJSONProtocol> {
 
   uint32_t readBinary(std::string& str);
 
+  uint32_t skip(TType type);
+
   class LookaheadReader {
 
    public:
@@ -282,6 +301,24 @@ class TJSONProtocol : public TVirtualProtocol<TJSONProtocol> {
       return data_;
     }
 
+    /**
+     * Returns the transport's buffered bytes and sets len to their number,
+     * or returns NULL if there are none or a peeked character is pending.
+     */
+    const uint8_t* borrow(uint32_t *len) {
+      if (hasData_) {
+        return NULL;
+      }
+      *len = 1;
+      return trans_->borrow(NULL, len);
+    }
+
+    void consume(uint32_t len) {
+      trans_->consume(len);
+    }
+
+    uint32_t readNumericChars(char *str);
+
    private:
     TTransport *trans_;
     bool hasData_;
@@ -291,9 +328,18 @@ class TJSONProtocol : public TVirtualProtocol<TJSONProtocol> {
  private:
   TTransport* trans_;
 
-  std::stack<boost::shared_ptr<TJSONContext> > contexts_;
-  boost::shared_ptr<TJSONContext> context_;
+  // Enclosing contexts are saved by value, in contextStack_ up to
+  // kInlineContexts deep and in deepContexts_ beyond that.
+  static const uint32_t kInlineContexts = 32;
+
+  Context context_;
+  Context contextStack_[kInlineContexts];
+  std::vector<Context> deepContexts_;
+  uint32_t contextDepth_;
   LookaheadReader reader_;
+
+  // True while skip() runs, to make readBinary() accept any string.
+  bool skipping_;
 };
 
 /**
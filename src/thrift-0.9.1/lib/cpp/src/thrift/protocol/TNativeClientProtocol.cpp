@@ -19,15 +19,23 @@
 
 #include <thrift/protocol/TNativeClientProtocol.h>
 
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
 #include <limits>
+#include <utility>
 
 #include <boost/make_shared.hpp>
 #include <math.h>
+#include <thrift/concurrency/Mutex.h>
 #include <thrift/protocol/TBase64Utils.h>
-#include <thrift/transport/TBufferTransports.h>
+#include <thrift/transport/TTransportUtils.h>
 
 #include "ppapi/cpp/var.h"
 #include "ppapi/cpp/var_array.h"
+#include "ppapi/cpp/var_array_buffer.h"
 #include "ppapi/cpp/var_dictionary.h"
 
 // Largest integer such that all smaller integers can be represented
@@ -35,97 +43,386 @@
 static const double kMaxPreciseDouble = 9007199254740992.0L;
 static const double kMinPreciseDouble = -9007199254740992.0L;
 
+// Keys of the dictionary wrapping a packed list.
+static const char kTypedArrayKey[] = "__typed_array";
+static const char kTypedArrayBufferKey[] = "buffer";
+
+// FNV-1a parameters of the subtree hashes.
+static const uint64_t kHashOffsetBasis = 14695981039346656037ULL;
+static const uint64_t kHashPrime = 1099511628211ULL;
+
+// Keys of the message dictionary.  Calls are {id, type, data}, replies
+// {id, data} and exceptions {id, error}.
+static const char kMessageIdKey[] = "id";
+static const char kMessageTypeKey[] = "type";
+static const char kMessageDataKey[] = "data";
+static const char kMessageErrorKey[] = "error";
+
 using namespace apache::thrift::transport;
+using apache::thrift::concurrency::Guard;
+using apache::thrift::concurrency::Mutex;
 
 namespace apache { namespace thrift { namespace protocol {
 
+// Field ids of the message keys, in the order they are read.
+static const int16_t kMessageIdFieldId = 1;
+static const int16_t kMessageTypeFieldId = 2;
+static const int16_t kMessageDataFieldId = 3;
+static const int16_t kMessageErrorFieldId = 4;
+
+static const TFieldTypeSpec kMessageFields[] = {
+  {kMessageIdFieldId, T_STRING, kMessageIdKey},
+  {kMessageTypeFieldId, T_STRING, kMessageTypeKey},
+  {kMessageDataFieldId, T_STRUCT, kMessageDataKey},
+  {kMessageErrorFieldId, T_STRUCT, kMessageErrorKey}
+};
+
+// Returns the sequence id held by a message id, which is a string of
+// decimal digits as posted by thrift_nacl.js or an integer.
+static int32_t readMessageId(const pp::Var& var) {
+  if (var.is_int()) {
+    return var.AsInt();
+  }
+  if (var.is_string()) {
+    std::string id = var.AsString();
+    if (!id.empty()) {
+      char* end;
+      errno = 0;
+      long value = strtol(id.c_str(), &end, 10);
+      if (*end == '\0' && errno == 0 &&
+          value <= std::numeric_limits<int32_t>::max() &&
+          value >= std::numeric_limits<int32_t>::min()) {
+        return static_cast<int32_t>(value);
+      }
+    }
+  }
+  throw TProtocolException(TProtocolException::INVALID_DATA,
+                           "Message id must be a 32 bit integer");
+}
+
+// Returns the size of an element of a packed list of the given type, or 0 if
+// lists of the type are not packed.
+static uint32_t getPackedElemSize(TType elem_type) {
+  switch (elem_type) {
+    case T_BYTE:
+      return sizeof(int8_t);
+    case T_I32:
+      return sizeof(int32_t);
+    case T_DOUBLE:
+      return sizeof(double);
+    default:
+      return 0;
+  }
+}
+
+// Name of the JavaScript typed array for a packed list of elem_type.
+static const char* getTypedArrayName(TType elem_type) {
+  switch (elem_type) {
+    case T_BYTE:
+      return "Int8Array";
+    case T_I32:
+      return "Int32Array";
+    case T_DOUBLE:
+      return "Float64Array";
+    default:
+      assert(false);
+      return NULL;
+  }
+}
+
+// Element type of the packed list for a JavaScript typed array name, or
+// T_STOP if the typed array is not supported.
+static TType getTypedArrayElemType(const std::string& name) {
+  if (name == "Int8Array") {
+    return T_BYTE;
+  } else if (name == "Int32Array") {
+    return T_I32;
+  } else if (name == "Float64Array") {
+    return T_DOUBLE;
+  }
+  return T_STOP;
+}
+
+// Compares two var trees.  Containers are compared by identity first, so
+// subtrees that are already shared are not visited.
+static bool varEquals(const pp::Var& a, const pp::Var& b) {
+  if (a == b) {
+    return true;
+  }
+  if (a.is_array() && b.is_array()) {
+    const pp::VarArray* array_a = static_cast<const pp::VarArray*>(&a);
+    const pp::VarArray* array_b = static_cast<const pp::VarArray*>(&b);
+    uint32_t length = array_a->GetLength();
+    if (array_b->GetLength() != length) {
+      return false;
+    }
+    for (uint32_t i = 0; i < length; ++i) {
+      if (!varEquals(array_a->Get(i), array_b->Get(i))) {
+        return false;
+      }
+    }
+    return true;
+  }
+  if (a.is_dictionary() && b.is_dictionary()) {
+    const pp::VarDictionary* dict_a = static_cast<const pp::VarDictionary*>(&a);
+    const pp::VarDictionary* dict_b = static_cast<const pp::VarDictionary*>(&b);
+    pp::VarArray keys = dict_a->GetKeys();
+    uint32_t length = keys.GetLength();
+    if (dict_b->GetKeys().GetLength() != length) {
+      return false;
+    }
+    for (uint32_t i = 0; i < length; ++i) {
+      pp::Var key = keys.Get(i);
+      if (!dict_b->HasKey(key) ||
+          !varEquals(dict_a->Get(key), dict_b->Get(key))) {
+        return false;
+      }
+    }
+    return true;
+  }
+  if (a.is_array_buffer() && b.is_array_buffer()) {
+    pp::VarArrayBuffer buffer_a(a);
+    pp::VarArrayBuffer buffer_b(b);
+    uint32_t length = buffer_a.ByteLength();
+    if (buffer_b.ByteLength() != length) {
+      return false;
+    }
+    if (length == 0) {
+      return true;
+    }
+    bool equal = memcmp(buffer_a.Map(), buffer_b.Map(), length) == 0;
+    buffer_a.Unmap();
+    buffer_b.Unmap();
+    return equal;
+  }
+  return false;
+}
+
+// The protocol reads and writes pp::Vars and never uses its transport, but
+// TProtocol requires one and generated processors call readEnd(), writeEnd()
+// and flush() on it.  All instances share one stateless transport so that
+// constructing a protocol does not allocate a buffer.
+static boost::shared_ptr<TTransport> getNullTransport() {
+  static boost::shared_ptr<TTransport> transport(new TNullTransport());
+  return transport;
+}
+
 TNativeClientProtocol::TNativeClientProtocol()
   : TVirtualProtocol<TNativeClientProtocol>(
-      boost::shared_ptr<TTransport>(boost::make_shared<TMemoryBuffer>())) {
+      getNullTransport()),
+    writer_depth_(0),
+    reader_depth_(0),
+    field_ordered_reads_(true),
+    binary_encoding_(BINARY_ARRAY_BUFFER),
+    packed_lists_(true),
+    dedup_subtrees_(false),
+    next_struct_fields_(NULL),
+    next_struct_num_fields_(0) {
+  writer_stack_.resize(kInitialStackDepth);
+  reader_stack_.resize(kInitialStackDepth);
+}
+
+TNativeClientProtocol::TNativeClientProtocol(const pp::Var& var)
+  : TVirtualProtocol<TNativeClientProtocol>(
+      getNullTransport()),
+    writer_depth_(0),
+    reader_depth_(0),
+    root_var_(var),
+    field_ordered_reads_(true),
+    binary_encoding_(BINARY_ARRAY_BUFFER),
+    packed_lists_(true),
+    dedup_subtrees_(false),
+    next_struct_fields_(NULL),
+    next_struct_num_fields_(0) {
+  writer_stack_.resize(kInitialStackDepth);
+  reader_stack_.resize(kInitialStackDepth);
+}
+
+TNativeClientProtocol::TNativeClientProtocol(boost::shared_ptr<const pp::Var> var)
+  : TVirtualProtocol<TNativeClientProtocol>(
+      getNullTransport()),
+    writer_depth_(0),
+    reader_depth_(0),
+    field_ordered_reads_(true),
+    binary_encoding_(BINARY_ARRAY_BUFFER),
+    packed_lists_(true),
+    dedup_subtrees_(false),
+    next_struct_fields_(NULL),
+    next_struct_num_fields_(0) {
+  writer_stack_.resize(kInitialStackDepth);
+  reader_stack_.resize(kInitialStackDepth);
+  if (var) {
+    root_var_ = *var;
+  }
 }
 
-TNativeClientProtocol::TNativeClientProtocol(boost::shared_ptr<const pp::Var> var) :
-  TVirtualProtocol<TNativeClientProtocol>(
-      boost::shared_ptr<TTransport>(boost::make_shared<TMemoryBuffer>())),
-  root_var_(var) {
+void TNativeClientProtocol::reset() {
+  // Contexts left open by an aborted write are not deduplicated.
+  while (writer_depth_ > 0) {
+    topWriterContext()->clear();
+    --writer_depth_;
+  }
+  subtrees_.clear();
+  while (reader_depth_ > 0) {
+    popReaderContext();
+  }
+  root_var_ = pp::Var();
+  next_struct_fields_ = NULL;
+  next_struct_num_fields_ = 0;
 }
 
-void TNativeClientProtocol::reset() {
-  writer_stack_.clear();
-  reader_stack_.clear();
-  root_var_.reset();
+void TNativeClientProtocol::setRootVar(const pp::Var& var) {
+  reset();
+  root_var_ = var;
 }
 
 void TNativeClientProtocol::setVar(boost::shared_ptr<const pp::Var> var) {
   reset();
-  root_var_ = var;
+  if (var) {
+    root_var_ = *var;
+  }
+}
+
+boost::shared_ptr<const pp::Var> TNativeClientProtocol::getVar() const {
+  if (root_var_.is_undefined()) {
+    return boost::shared_ptr<const pp::Var>();
+  }
+  return boost::make_shared<const pp::Var>(root_var_);
 }
 
 void TNativeClientProtocol::writeVar(const pp::Var& var) {
-  if (writer_stack_.empty()) {
+  if (writer_depth_ == 0) {
     if (!var.is_dictionary()) {
       throw TProtocolException(TProtocolException::UNKNOWN,
                                "Root node must be a dictionary");
     }
-    root_var_ = boost::make_shared<pp::Var>(var);
+    root_var_ = var;
   } else {
     topWriterContext()->writeVar(var);
   }
 }
 
-boost::shared_ptr<const pp::Var> TNativeClientProtocol::readVar() {
-  if (reader_stack_.empty()) {
-    if (!root_var_) {
+void TNativeClientProtocol::readVar(pp::Var* var) {
+  if (reader_depth_ == 0) {
+    if (root_var_.is_undefined()) {
       throw TProtocolException(TProtocolException::UNKNOWN,
           "Trying to read but pp::Var has not been set "
-          "(use TNativeClientProtocol(shared_ptr<const pp::Var>) constructor)");
+          "(use setRootVar() or the TNativeClientProtocol(const pp::Var&) "
+          "constructor)");
     }
-    return root_var_;
+    *var = root_var_;
   } else {
     ReaderContext* context = topReaderContext();
-    T_DEBUG("readVar: %d %d", reader_stack_.size(), context->getIndex());
+    T_DEBUG("readVar: %d %d", reader_depth_, context->getIndex());
 
-    boost::shared_ptr<pp::Var> var = boost::make_shared<pp::Var>();
-    context->nextVar(var.get());
+    context->nextVar(var);
     context->advance();
-    return var;
   }
 }
 
-void TNativeClientProtocol::pushWriterContext(WriterContext* context) {
-  assert(context->getVar().is_dictionary() || context->getVar().is_array());
+void TNativeClientProtocol::pushWriterContext(ContextType type,
+                                              TType elem_type,
+                                              uint32_t size) {
+  if (writer_depth_ == writer_stack_.size()) {
+    writer_stack_.resize(2 * writer_stack_.size());
+  }
+
+  WriterContext* context = &writer_stack_[writer_depth_];
+  context->init(type, elem_type, size);
+
+  // The new container is added to its parent before it is filled in.  pp::Var
+  // has reference semantics so the parent sees the elements written later.
   writeVar(context->getVar());
-  writer_stack_.push_back(context);
+  ++writer_depth_;
 }
 
 void TNativeClientProtocol::popWriterContext() {
-  writer_stack_.pop_back();
+  assert(writer_depth_ > 0);
+  if (topWriterContext()->isPacked() && !topWriterContext()->isFilled()) {
+    topWriterContext()->clear();
+    --writer_depth_;
+    throw TProtocolException(TProtocolException::INVALID_DATA,
+                             "Fewer list elements written than declared");
+  }
+  if (dedup_subtrees_ && writer_depth_ > 1) {
+    dedupSubtree();
+  }
+  topWriterContext()->clear();
+  --writer_depth_;
 }
 
-void TNativeClientProtocol::pushReaderContext(ReaderContext* context) {
-  assert(context->getVar().is_dictionary() || context->getVar().is_array());
-  reader_stack_.push_back(context);
+void TNativeClientProtocol::dedupSubtree() {
+  WriterContext* context = topWriterContext();
+  WriterContext* parent = &writer_stack_[writer_depth_ - 2];
+  uint64_t hash = context->finishHash();
+  parent->hash(&hash, sizeof(hash));
+
+  std::pair<std::map<uint64_t, pp::Var>::iterator, bool> inserted =
+      subtrees_.insert(std::make_pair(hash, context->getVar()));
+  if (!inserted.second &&
+      varEquals(inserted.first->second, context->getVar())) {
+    parent->replaceLastVar(inserted.first->second);
+  }
+}
+
+TNativeClientProtocol::ReaderContext*
+TNativeClientProtocol::pushReaderContext(const pp::Var& var,
+                                         ContextType type,
+                                         const TFieldTypeSpec* fields,
+                                         uint32_t num_fields) {
+  if (reader_depth_ == reader_stack_.size()) {
+    reader_stack_.resize(2 * reader_stack_.size());
+  }
+
+  ReaderContext* context = &reader_stack_[reader_depth_];
+  context->init(var, type, fields, num_fields);
+  ++reader_depth_;
+  return context;
 }
 
 void TNativeClientProtocol::popReaderContext() {
-  reader_stack_.pop_back();
+  assert(reader_depth_ > 0);
+  topReaderContext()->clear();
+  --reader_depth_;
 }
 
 uint32_t TNativeClientProtocol::writeMessageBegin(const std::string& name,
                                                  const TMessageType messageType,
                                                  const int32_t seqid) {
-  throw TProtocolException(TProtocolException::NOT_IMPLEMENTED);
+  T_DEBUG("writeMessageBegin: %s %d", name.c_str(), seqid);
+  if (writer_depth_ != 0) {
+    throw TProtocolException(TProtocolException::INVALID_DATA,
+                             "Message must be the root node");
+  }
+  pushWriterContext(DICTIONARY_CONTEXT);
+
+  WriterContext* context = topWriterContext();
+  char id[16];
+  snprintf(id, sizeof(id), "%d", seqid);
+  context->setFieldName(&field_names_.get(kMessageIdKey));
+  context->writeVar(pp::Var(id));
+
+  // Replies are matched to their call by id alone.
+  if (messageType == T_CALL || messageType == T_ONEWAY) {
+    context->setFieldName(&field_names_.get(kMessageTypeKey));
+    context->writeVar(pp::Var(name));
+  }
+
+  // The struct written next becomes the data or error of the message.
+  context->setFieldName(&field_names_.get(
+      messageType == T_EXCEPTION ? kMessageErrorKey : kMessageDataKey));
   return 0;
 }
 
 uint32_t TNativeClientProtocol::writeMessageEnd() {
-  throw TProtocolException(TProtocolException::NOT_IMPLEMENTED);
+  T_DEBUG("writeMessageEnd");
+  popWriterContext();
   return 0;
 }
 
 uint32_t TNativeClientProtocol::writeStructBegin(const char* name) {
   T_DEBUG("writeStructBegin: %s", name);
-  pushWriterContext(WriterContext::createDictionaryContext());
+  pushWriterContext(DICTIONARY_CONTEXT);
   return 0;
 }
 
@@ -139,7 +436,9 @@ uint32_t TNativeClientProtocol::writeFieldBegin(const char* name,
                                                 const TType fieldType,
                                                 const int16_t fieldId) {
   T_DEBUG("writeFieldBegin: %s", name);
-  topWriterContext()->setFieldName(name); 
+  const pp::Var* field_name = &field_names_.get(name);
+  hashValue(T_STOP, &field_name, sizeof(field_name));
+  topWriterContext()->setFieldName(field_name);
   return 0;
 }
 
@@ -156,7 +455,7 @@ uint32_t TNativeClientProtocol::writeMapBegin(const TType keyType,
                                               const TType valType,
                                               const uint32_t size) {
   T_DEBUG("writeMapBegin: %u", size);
-  pushWriterContext(WriterContext::createMapContext());
+  pushWriterContext(MAP_KEY_CONTEXT);
   return 0;
 }
 
@@ -169,7 +468,11 @@ uint32_t TNativeClientProtocol::writeMapEnd() {
 uint32_t TNativeClientProtocol::writeListBegin(const TType elemType,
                                                const uint32_t size) {
   T_DEBUG("writeListBegin: %u", size);
-  pushWriterContext(WriterContext::createListContext());
+  if (packed_lists_ && getPackedElemSize(elemType) != 0) {
+    pushWriterContext(PACKED_LIST_CONTEXT, elemType, size);
+  } else {
+    pushWriterContext(LIST_CONTEXT);
+  }
   return 0;
 }
 
@@ -182,7 +485,7 @@ uint32_t TNativeClientProtocol::writeListEnd() {
 uint32_t TNativeClientProtocol::writeSetBegin(const TType elemType,
                                               const uint32_t size) {
   T_DEBUG("writeSetBegin: %u", size);
-  pushWriterContext(WriterContext::createListContext());
+  pushWriterContext(LIST_CONTEXT);
   return 0;
 }
 
@@ -193,22 +496,36 @@ uint32_t TNativeClientProtocol::writeSetEnd() {
 }
 
 uint32_t TNativeClientProtocol::writeBool(const bool value) {
+  hashValue(T_BOOL, &value, sizeof(value));
   writeVar(pp::Var(value));
   return 0;
 }
 
 uint32_t TNativeClientProtocol::writeByte(const int8_t byte) {
-  writeVar(pp::Var(static_cast<int32_t>(byte)));
+  WriterContext* context = packedWriterContext(T_BYTE);
+  if (context != NULL) {
+    context->writePacked(byte);
+  } else {
+    hashValue(T_BYTE, &byte, sizeof(byte));
+    writeVar(pp::Var(static_cast<int32_t>(byte)));
+  }
   return 0;
 }
 
 uint32_t TNativeClientProtocol::writeI16(const int16_t i16) {
+  hashValue(T_I16, &i16, sizeof(i16));
   writeVar(pp::Var(static_cast<int32_t>(i16)));
   return 0;
 }
 
 uint32_t TNativeClientProtocol::writeI32(const int32_t i32) {
-  writeVar(pp::Var(i32));
+  WriterContext* context = packedWriterContext(T_I32);
+  if (context != NULL) {
+    context->writePacked(i32);
+  } else {
+    hashValue(T_I32, &i32, sizeof(i32));
+    writeVar(pp::Var(i32));
+  }
   return 0;
 }
 
@@ -218,43 +535,138 @@ uint32_t TNativeClientProtocol::writeI64(const int64_t i64) {
     throw TProtocolException(TProtocolException::SIZE_LIMIT,
         "Int64 value too large to be represented as a double");
   }
+  hashValue(T_I64, &i64, sizeof(i64));
   writeVar(pp::Var(static_cast<double>(i64)));
   return 0;
 }
 
 uint32_t TNativeClientProtocol::writeDouble(const double dbl) {
-  writeVar(pp::Var(dbl));
+  WriterContext* context = packedWriterContext(T_DOUBLE);
+  if (context != NULL) {
+    context->writePacked(dbl);
+  } else {
+    hashValue(T_DOUBLE, &dbl, sizeof(dbl));
+    writeVar(pp::Var(dbl));
+  }
   return 0;
 }
 
 uint32_t TNativeClientProtocol::writeString(const std::string& str) {
+  hashValue(T_STRING, str.data(), str.size());
   writeVar(pp::Var(str));
   return 0;
 }
 
 uint32_t TNativeClientProtocol::writeBinary(const std::string& str) {
-  std::string b64str;
-  base64EncodeString(str, &b64str);
-  writeVar(pp::Var(b64str));
+  hashValue(T_STRING, str.data(), str.size());
+  if (binary_encoding_ == BINARY_BASE64) {
+    std::string b64str;
+    base64EncodeString(str, &b64str);
+    writeVar(pp::Var(b64str));
+    return 0;
+  }
+
+  // The bytes are copied once, straight into the buffer shared with
+  // JavaScript.
+  pp::VarArrayBuffer buffer(static_cast<uint32_t>(str.size()));
+  if (!str.empty()) {
+    void* data = buffer.Map();
+    if (data == NULL) {
+      throw TProtocolException(TProtocolException::UNKNOWN,
+                               "Unable to map ArrayBuffer");
+    }
+    memcpy(data, str.data(), str.size());
+    buffer.Unmap();
+  }
+  writeVar(buffer);
   return 0;
 }
 
 uint32_t TNativeClientProtocol::readMessageBegin(std::string& name,
                                                  TMessageType& messageType,
                                                  int32_t& seqid) {
-  throw TProtocolException(TProtocolException::NOT_IMPLEMENTED);
+  if (reader_depth_ != 0) {
+    throw TProtocolException(TProtocolException::INVALID_DATA,
+                             "Message must be the root node");
+  }
+  pp::Var var;
+  readVar(&var);
+  if (!var.is_dictionary()) {
+    throw TProtocolException(TProtocolException::INVALID_DATA,
+                             "Expected message dictionary");
+  }
+  ReaderContext* context = pushReaderContext(
+      var, DICTIONARY_CONTEXT, kMessageFields,
+      sizeof(kMessageFields) / sizeof(kMessageFields[0]));
+
+  bool has_id = false;
+  name.clear();
+  const TFieldTypeSpec* field;
+  while ((field = context->nextField(&field_names_)) != NULL) {
+    pp::Var value;
+    if (field->fid == kMessageIdFieldId) {
+      readVar(&value);
+      seqid = readMessageId(value);
+      has_id = true;
+    } else if (field->fid == kMessageTypeFieldId) {
+      readVar(&value);
+      if (!value.is_string()) {
+        throw TProtocolException(TProtocolException::INVALID_DATA,
+                                 "Expected string message type");
+      }
+      name = value.AsString();
+    } else {
+      // Leave the data or error to be read as the message struct.
+      break;
+    }
+  }
+
+  if (!has_id) {
+    throw TProtocolException(TProtocolException::INVALID_DATA,
+                             "Message has no id");
+  }
+  if (field == NULL) {
+    throw TProtocolException(TProtocolException::INVALID_DATA,
+                             "Message has no data or error");
+  }
+  if (field->fid == kMessageErrorFieldId) {
+    messageType = T_EXCEPTION;
+  } else {
+    messageType = name.empty() ? T_REPLY : T_CALL;
+  }
+
+  T_DEBUG("readMessageBegin: %s %d", name.c_str(), seqid);
   return 0;
 }
 
 uint32_t TNativeClientProtocol::readMessageEnd() {
-  throw TProtocolException(TProtocolException::NOT_IMPLEMENTED);
+  T_DEBUG("readMessageEnd");
+  popReaderContext();
   return 0;
 }
 
+void TNativeClientProtocol::setNextStructFields(const TFieldTypeSpec* fields,
+                                                uint32_t num_fields) {
+  next_struct_fields_ = fields;
+  next_struct_num_fields_ = num_fields;
+}
+
 uint32_t TNativeClientProtocol::readStructBegin(std::string& name) {
   T_DEBUG("readStructBegin: %s", name.c_str());
-  boost::shared_ptr<const pp::Var> var(readVar());
-  pushReaderContext(ReaderContext::createDictionaryContext(var));
+  const TFieldTypeSpec* fields = NULL;
+  uint32_t num_fields = 0;
+  if (field_ordered_reads_) {
+    fields = next_struct_fields_;
+    num_fields = next_struct_num_fields_;
+  }
+  // The field table only applies to the struct read next, not to any
+  // nested struct read without one.
+  next_struct_fields_ = NULL;
+  next_struct_num_fields_ = 0;
+
+  pp::Var var;
+  readVar(&var);
+  pushReaderContext(var, DICTIONARY_CONTEXT, fields, num_fields);
   return 0;
 }
 
@@ -269,7 +681,16 @@ uint32_t TNativeClientProtocol::readFieldBegin(std::string& name,
                                                int16_t& fieldId) {
   ReaderContext* context = topReaderContext();
 
-  if (context->isAtEnd()) {
+  if (context->hasFields()) {
+    const TFieldTypeSpec* field = context->nextField(&field_names_);
+    if (field == NULL) {
+      fieldType = ::apache::thrift::protocol::T_STOP;
+    } else {
+      name = field->name;
+      fieldType = field->ftype;
+      fieldId = field->fid;
+    }
+  } else if (context->isAtEnd()) {
     fieldType = ::apache::thrift::protocol::T_STOP;
   } else {
     pp::Var key;
@@ -303,9 +724,9 @@ uint32_t TNativeClientProtocol::readFieldEnd() {
 uint32_t TNativeClientProtocol::readMapBegin(TType& keyType,
                                              TType& valType,
                                              uint32_t& size) {
-  boost::shared_ptr<const pp::Var> var(readVar());
-  ReaderContext* context = ReaderContext::createMapContext(var);
-  pushReaderContext(context);
+  pp::Var var;
+  readVar(&var);
+  ReaderContext* context = pushReaderContext(var, MAP_KEY_CONTEXT);
   size = context->size();
 
   T_DEBUG("readMapBegin: %d", size);
@@ -321,10 +742,15 @@ uint32_t TNativeClientProtocol::readMapEnd() {
 
 uint32_t TNativeClientProtocol::readListBegin(TType& elemType,
                                               uint32_t& size) {
-  boost::shared_ptr<const pp::Var> var(readVar());
-  ReaderContext* context = ReaderContext::createListContext(var);
-  pushReaderContext(context);
-  size = context->size(); 
+  pp::Var var;
+  readVar(&var);
+  // Lists are arrays unless they were packed into a typed array buffer.
+  ReaderContext* context = pushReaderContext(
+      var, var.is_dictionary() ? PACKED_LIST_CONTEXT : LIST_CONTEXT);
+  size = context->size();
+  if (context->isPacked()) {
+    elemType = context->getElemType();
+  }
 
   T_DEBUG("readListBegin: %d", size);
 
@@ -339,9 +765,9 @@ uint32_t TNativeClientProtocol::readListEnd() {
 
 uint32_t TNativeClientProtocol::readSetBegin(TType& elemType,
                                              uint32_t& size) {
-  boost::shared_ptr<const pp::Var> var(readVar());
-  ReaderContext* context = ReaderContext::createListContext(var);
-  pushReaderContext(context);
+  pp::Var var;
+  readVar(&var);
+  ReaderContext* context = pushReaderContext(var, LIST_CONTEXT);
   size = context->size(); 
 
   T_DEBUG("readSetBegin: %d", size);
@@ -356,13 +782,14 @@ uint32_t TNativeClientProtocol::readSetEnd() {
 }
 
 uint32_t TNativeClientProtocol::readBool(bool& value) {
-  boost::shared_ptr<const pp::Var> var(readVar());
+  pp::Var var;
+  readVar(&var);
 
-  if (!var->is_bool()) {
+  if (!var.is_bool()) {
     throw TProtocolException(TProtocolException::INVALID_DATA,
                              "Expected boolean value");
   }
-  value = var->AsBool();
+  value = var.AsBool();
 
   T_DEBUG("readBool: %s", value ? "true" : "false");
 
@@ -370,14 +797,15 @@ uint32_t TNativeClientProtocol::readBool(bool& value) {
 }
 
 int64_t TNativeClientProtocol::readIntegerValue() {
-  boost::shared_ptr<const pp::Var> var(readVar());
+  pp::Var var;
+  readVar(&var);
 
   int64_t int_value;
 
-  if (var->is_int()) {
-    int_value = static_cast<int64_t>(var->AsInt());
-  } else if (var->is_double()) {
-    double dbl_value = var->AsDouble();
+  if (var.is_int()) {
+    int_value = static_cast<int64_t>(var.AsInt());
+  } else if (var.is_double()) {
+    double dbl_value = var.AsDouble();
 
     if (fmod(dbl_value, 1.0) != 0.0) {
       throw TProtocolException(TProtocolException::INVALID_DATA,
@@ -407,7 +835,12 @@ int64_t TNativeClientProtocol::readIntegerValue() {
 
 
 uint32_t TNativeClientProtocol::readByte(int8_t& byte) {
-  READ_INTEGER_VALUE(int8_t, byte);
+  ReaderContext* context = packedReaderContext(T_BYTE);
+  if (context != NULL) {
+    byte = context->readPacked<int8_t>();
+  } else {
+    READ_INTEGER_VALUE(int8_t, byte);
+  }
   T_DEBUG("readI8: %c", byte);
 
   return 0;
@@ -421,7 +854,12 @@ uint32_t TNativeClientProtocol::readI16(int16_t& i16) {
 }
 
 uint32_t TNativeClientProtocol::readI32(int32_t& i32) {
-  READ_INTEGER_VALUE(int32_t, i32);
+  ReaderContext* context = packedReaderContext(T_I32);
+  if (context != NULL) {
+    i32 = context->readPacked<int32_t>();
+  } else {
+    READ_INTEGER_VALUE(int32_t, i32);
+  }
   T_DEBUG("readI32: %d", i32);
 
   return 0;
@@ -434,46 +872,69 @@ uint32_t TNativeClientProtocol::readI64(int64_t& i64) {
 }
 
 uint32_t TNativeClientProtocol::readDouble(double& dbl) {
-  boost::shared_ptr<const pp::Var> var(readVar());
+  ReaderContext* context = packedReaderContext(T_DOUBLE);
+  if (context != NULL) {
+    dbl = context->readPacked<double>();
+    return 0;
+  }
+
+  pp::Var var;
+  readVar(&var);
 
-  if (var->is_double()) {
-    dbl = var->AsDouble();
-  } else if (var->is_int()) {
-    dbl = static_cast<double>(var->AsInt());
+  if (var.is_double()) {
+    dbl = var.AsDouble();
+  } else if (var.is_int()) {
+    dbl = static_cast<double>(var.AsInt());
   } else {
     throw TProtocolException(TProtocolException::INVALID_DATA,
                              "Expected double value");
   }
-  dbl = var->AsDouble();
+  dbl = var.AsDouble();
   T_DEBUG("readDouble: %f", dbl);
 
   return 0;
 }
 
 uint32_t TNativeClientProtocol::readString(std::string &str) {
-  boost::shared_ptr<const pp::Var> var(readVar());
+  pp::Var var;
+  readVar(&var);
 
-  if (!var->is_string()) {
+  if (!var.is_string()) {
     throw TProtocolException(TProtocolException::INVALID_DATA,
                              "Expected string value");
   }
-  str = var->AsString();
+  str = var.AsString();
   T_DEBUG("readString: %s", str.c_str());
 
   return 0;
 }
 
 uint32_t TNativeClientProtocol::readBinary(std::string &str) {
-  boost::shared_ptr<const pp::Var> var(readVar());
-
-  if (!var->is_string()) {
-    throw TProtocolException(TProtocolException::INVALID_DATA,
-                             "Expected base 64 string value");
-  }
-
-  if (!base64DecodeString(var->AsString(), &str)) {
+  pp::Var var;
+  readVar(&var);
+
+  if (var.is_array_buffer()) {
+    pp::VarArrayBuffer buffer(var);
+    uint32_t length = buffer.ByteLength();
+    if (length == 0) {
+      str.clear();
+    } else {
+      const void* data = buffer.Map();
+      if (data == NULL) {
+        throw TProtocolException(TProtocolException::UNKNOWN,
+                                 "Unable to map ArrayBuffer");
+      }
+      str.assign(static_cast<const char*>(data), length);
+      buffer.Unmap();
+    }
+  } else if (var.is_string()) {
+    if (!base64DecodeString(var.AsString(), &str)) {
+      throw TProtocolException(TProtocolException::INVALID_DATA,
+                               "Invalid base 64 string");
+    }
+  } else {
     throw TProtocolException(TProtocolException::INVALID_DATA,
-                             "Invalid base 64 string");
+                             "Expected ArrayBuffer or base 64 string value");
   }
 
   T_DEBUG("readBinary: %d", str.size());
@@ -484,39 +945,130 @@ uint32_t TNativeClientProtocol::readBinary(std::string &str) {
 uint32_t TNativeClientProtocol::skip(TType type) {
   T_DEBUG("skip");
 
-  if (!reader_stack_.empty()) {
+  if (reader_depth_ > 0) {
     topReaderContext()->advance();
   }
 
   return 0;
 }
 
+/**
+ * FieldNameCache
+ */
+
+// Returns the process-wide var for a field name.  Vars are never released so
+// each name is converted once.
+static pp::Var internFieldName(const char* name) {
+  typedef std::map<const char*, pp::Var> NameMap;
+  static Mutex mutex;
+  static NameMap names;
+
+  Guard g(mutex);
+  NameMap::iterator iter = names.find(name);
+  if (iter == names.end()) {
+    iter = names.insert(NameMap::value_type(name, pp::Var(name))).first;
+  }
+  // Names are found by address, so a name must not be reused for a
+  // different string.
+  assert(iter->second.AsString() == name);
+  return iter->second;
+}
+
+const pp::Var& TNativeClientProtocol::FieldNameCache::get(const char* name) {
+  NameMap::iterator iter = names_.find(name);
+  if (iter == names_.end()) {
+    iter = names_.insert(NameMap::value_type(name, internFieldName(name))).first;
+  }
+  return iter->second;
+}
+
 /**
  *  WriterContext 
  */
 
-TNativeClientProtocol::WriterContext::WriterContext(
-    boost::shared_ptr<pp::Var> var, ContextType type)
-    : var_(var), type_(type) {
-  assert((var->is_dictionary() &&
-          (type_ == DICTIONARY_CONTEXT || type_ == MAP_KEY_CONTEXT)) ||
-         (var_->is_array() && type_ == LIST_CONTEXT));
+void TNativeClientProtocol::WriterContext::init(ContextType type,
+                                                TType elem_type,
+                                                uint32_t size) {
+  type_ = type;
+  hash_ = kHashOffsetBasis;
+  uint8_t tag = static_cast<uint8_t>(type);
+  hash(&tag, sizeof(tag));
+  if (type_ == LIST_CONTEXT) {
+    var_ = pp::VarArray();
+  } else if (type_ == PACKED_LIST_CONTEXT) {
+    uint32_t elem_size = getPackedElemSize(elem_type);
+    assert(elem_size != 0);
+    if (size > std::numeric_limits<uint32_t>::max() / elem_size) {
+      throw TProtocolException(TProtocolException::SIZE_LIMIT,
+                               "List too large to be packed");
+    }
+
+    pp::VarArrayBuffer buffer(size * elem_size);
+    if (size > 0) {
+      data_ = static_cast<uint8_t*>(buffer.Map());
+      if (data_ == NULL) {
+        throw TProtocolException(TProtocolException::UNKNOWN,
+                                 "Unable to map ArrayBuffer");
+      }
+    }
+    buffer_ = buffer;
+    elem_type_ = elem_type;
+    size_ = size;
+    index_ = 0;
+
+    pp::VarDictionary packed;
+    packed.Set(pp::Var(kTypedArrayKey),
+               pp::Var(getTypedArrayName(elem_type)));
+    packed.Set(pp::Var(kTypedArrayBufferKey), buffer);
+    var_ = packed;
+  } else {
+    assert(type_ == DICTIONARY_CONTEXT || type_ == MAP_KEY_CONTEXT);
+    var_ = pp::VarDictionary();
+  }
+}
+
+void TNativeClientProtocol::WriterContext::clear() {
+  var_ = pp::Var();
+  field_name_ = NULL;
+  map_key_ = pp::Var();
+  if (data_ != NULL) {
+    static_cast<pp::VarArrayBuffer*>(&buffer_)->Unmap();
+    data_ = NULL;
+  }
+  buffer_ = pp::Var();
+  elem_type_ = T_STOP;
+  size_ = 0;
+  index_ = 0;
+  hash_ = 0;
+}
+
+template <typename T>
+void TNativeClientProtocol::WriterContext::writePacked(T value) {
+  assert(type_ == PACKED_LIST_CONTEXT);
+  assert(sizeof(T) == getPackedElemSize(elem_type_));
+  if (index_ >= size_) {
+    throw TProtocolException(TProtocolException::INVALID_DATA,
+                             "More list elements written than declared");
+  }
+  memcpy(data_ + index_ * sizeof(T), &value, sizeof(T));
+  ++index_;
 }
 
 pp::VarDictionary* TNativeClientProtocol::WriterContext::asDictionary() {
-  assert(var_->is_dictionary());
-  return static_cast<pp::VarDictionary*>(var_.get());
+  assert(var_.is_dictionary());
+  return static_cast<pp::VarDictionary*>(&var_);
 }
 
 pp::VarArray* TNativeClientProtocol::WriterContext::asArray() {
-  assert(var_->is_array());
-  return static_cast<pp::VarArray*>(var_.get());
+  assert(var_.is_array());
+  return static_cast<pp::VarArray*>(&var_);
 }
 
 void TNativeClientProtocol::WriterContext::writeVar(const pp::Var& var) {
   switch (type_) {
     case DICTIONARY_CONTEXT:
-      asDictionary()->Set(pp::Var(getFieldName()), var); 
+      assert(field_name_ != NULL);
+      asDictionary()->Set(*field_name_, var);
       break;
 
     case LIST_CONTEXT:
@@ -532,55 +1084,208 @@ void TNativeClientProtocol::WriterContext::writeVar(const pp::Var& var) {
       asDictionary()->Set(map_key_, var); 
       type_ = MAP_KEY_CONTEXT;
       break;
+
+    case PACKED_LIST_CONTEXT:
+      throw TProtocolException(TProtocolException::INVALID_DATA,
+                               "Element type does not match packed list");
   }
 }
 
-TNativeClientProtocol::WriterContext*
-TNativeClientProtocol::WriterContext::createDictionaryContext() {
-  boost::shared_ptr<pp::Var> var = boost::make_shared<pp::VarDictionary>();
-  return new WriterContext(var, DICTIONARY_CONTEXT);
+void TNativeClientProtocol::WriterContext::replaceLastVar(
+    const pp::Var& var) {
+  switch (type_) {
+    case DICTIONARY_CONTEXT:
+      assert(field_name_ != NULL);
+      asDictionary()->Set(*field_name_, var);
+      break;
+
+    case LIST_CONTEXT:
+      asArray()->Set(asArray()->GetLength() - 1, var);
+      break;
+
+    case MAP_KEY_CONTEXT:
+      // The value of an entry was written last.
+      asDictionary()->Set(map_key_, var);
+      break;
+
+    case MAP_VALUE_CONTEXT:
+      map_key_ = var;
+      break;
+
+    case PACKED_LIST_CONTEXT:
+      assert(false);
+      break;
+  }
 }
 
-TNativeClientProtocol::WriterContext*
-TNativeClientProtocol::WriterContext::createMapContext() {
-  boost::shared_ptr<pp::Var> var = boost::make_shared<pp::VarDictionary>();
-  return new WriterContext(var, MAP_KEY_CONTEXT);
+void TNativeClientProtocol::WriterContext::hash(const void* data,
+                                                size_t size) {
+  const uint8_t* bytes = static_cast<const uint8_t*>(data);
+  for (size_t i = 0; i < size; ++i) {
+    hash_ = (hash_ ^ bytes[i]) * kHashPrime;
+  }
 }
 
-TNativeClientProtocol::WriterContext*
-TNativeClientProtocol::WriterContext::createListContext() {
-  boost::shared_ptr<pp::Var> var = boost::make_shared<pp::VarArray>();
-  return new WriterContext(var, LIST_CONTEXT);
+uint64_t TNativeClientProtocol::WriterContext::finishHash() {
+  if (type_ == PACKED_LIST_CONTEXT) {
+    hash(&elem_type_, sizeof(elem_type_));
+    if (data_ != NULL) {
+      hash(data_, index_ * getPackedElemSize(elem_type_));
+    }
+  }
+  return hash_;
 }
 
 /** 
  * ReaderContext
  */
 
-TNativeClientProtocol::ReaderContext::ReaderContext(
-    boost::shared_ptr<const pp::Var> var, ContextType type)
-    : var_(var), type_(type), index_(0) {
-  if (var_->is_dictionary()) {
-    assert(type_ == DICTIONARY_CONTEXT || type_ == MAP_KEY_CONTEXT);
-    keys_ = asDictionary()->GetKeys();
+void TNativeClientProtocol::ReaderContext::init(const pp::Var& var,
+                                                ContextType type,
+                                                const TFieldTypeSpec* fields,
+                                                uint32_t num_fields) {
+  switch (type) {
+    case DICTIONARY_CONTEXT:
+      if (!var.is_dictionary()) {
+        throw TProtocolException(TProtocolException::UNKNOWN,
+            "Attempt to create dictionary context without a dictionary");
+      }
+      break;
+
+    case MAP_KEY_CONTEXT:
+      if (!var.is_dictionary()) {
+        throw TProtocolException(TProtocolException::UNKNOWN,
+            "Attempt to create map context without a dictionary");
+      }
+      break;
+
+    case LIST_CONTEXT:
+      if (!var.is_array()) {
+        throw TProtocolException(TProtocolException::UNKNOWN,
+            "Attempt to create list context without an array");
+      }
+      break;
+
+    case PACKED_LIST_CONTEXT:
+      if (!var.is_dictionary()) {
+        throw TProtocolException(TProtocolException::UNKNOWN,
+            "Attempt to create packed list context without a dictionary");
+      }
+      break;
+
+    default:
+      assert(false);
+  }
+
+  var_ = var;
+  type_ = type;
+  index_ = 0;
+
+  if (type_ == PACKED_LIST_CONTEXT) {
+    fields_ = NULL;
+    num_fields_ = 0;
+    keys_ = pp::Var();
+    initPacked();
+  } else if (type_ == DICTIONARY_CONTEXT && fields != NULL) {
+    fields_ = fields;
+    num_fields_ = num_fields;
+    keys_ = pp::Var();
   } else {
-    assert(var_->is_array() && type_ == LIST_CONTEXT);
+    fields_ = NULL;
+    num_fields_ = 0;
+    if (var_.is_dictionary()) {
+      keys_ = asDictionary()->GetKeys();
+    } else {
+      keys_ = pp::Var();
+    }
+  }
+}
+
+void TNativeClientProtocol::ReaderContext::initPacked() {
+  pp::Var name = asDictionary()->Get(pp::Var(kTypedArrayKey));
+  pp::Var buffer = asDictionary()->Get(pp::Var(kTypedArrayBufferKey));
+
+  TType elem_type = T_STOP;
+  if (name.is_string()) {
+    elem_type = getTypedArrayElemType(name.AsString());
+  }
+  if (elem_type == T_STOP || !buffer.is_array_buffer()) {
+    throw TProtocolException(TProtocolException::INVALID_DATA,
+                             "Expected array or packed list");
+  }
+
+  uint32_t elem_size = getPackedElemSize(elem_type);
+  uint32_t length = static_cast<pp::VarArrayBuffer*>(&buffer)->ByteLength();
+  if (length % elem_size != 0) {
+    throw TProtocolException(TProtocolException::INVALID_DATA,
+                             "Packed list length is not a multiple of the "
+                             "element size");
+  }
+
+  buffer_ = buffer;
+  elem_type_ = elem_type;
+  size_ = length / elem_size;
+  if (size_ > 0) {
+    data_ = static_cast<const uint8_t*>(
+        static_cast<pp::VarArrayBuffer*>(&buffer_)->Map());
+    if (data_ == NULL) {
+      throw TProtocolException(TProtocolException::UNKNOWN,
+                               "Unable to map ArrayBuffer");
+    }
+  }
+}
+
+void TNativeClientProtocol::ReaderContext::clear() {
+  var_ = pp::Var();
+  keys_ = pp::Var();
+  field_value_ = pp::Var();
+  fields_ = NULL;
+  num_fields_ = 0;
+  if (data_ != NULL) {
+    static_cast<pp::VarArrayBuffer*>(&buffer_)->Unmap();
+    data_ = NULL;
+  }
+  buffer_ = pp::Var();
+  elem_type_ = T_STOP;
+  size_ = 0;
+}
+
+template <typename T>
+T TNativeClientProtocol::ReaderContext::readPacked() {
+  assert(type_ == PACKED_LIST_CONTEXT);
+  assert(sizeof(T) == getPackedElemSize(elem_type_));
+  if (isAtEnd()) {
+    throw TProtocolException(TProtocolException::INVALID_DATA,
+                             "Read past the end of packed list");
   }
+  T value;
+  memcpy(&value, data_ + index_ * sizeof(T), sizeof(T));
+  ++index_;
+  return value;
 }
 
 const pp::VarDictionary* TNativeClientProtocol::ReaderContext::asDictionary() const {
-  assert(var_->is_dictionary());
-  return static_cast<const pp::VarDictionary*>(var_.get());
+  assert(var_.is_dictionary());
+  return static_cast<const pp::VarDictionary*>(&var_);
 }
 
 const pp::VarArray* TNativeClientProtocol::ReaderContext::asArray() const {
-  assert(var_->is_array());
-  return static_cast<const pp::VarArray*>(var_.get());
+  assert(var_.is_array());
+  return static_cast<const pp::VarArray*>(&var_);
+}
+
+const pp::VarArray* TNativeClientProtocol::ReaderContext::keys() const {
+  assert(keys_.is_array());
+  return static_cast<const pp::VarArray*>(&keys_);
 }
 
 int TNativeClientProtocol::ReaderContext::size() const {
-  if (var_->is_dictionary()) {
-    return keys_.GetLength();
+  if (hasFields()) {
+    return num_fields_;
+  } else if (type_ == PACKED_LIST_CONTEXT) {
+    return size_;
+  } else if (var_.is_dictionary()) {
+    return keys()->GetLength();
   } else {
     return asArray()->GetLength();
   }
@@ -601,6 +1306,7 @@ void TNativeClientProtocol::ReaderContext::advance() {
       break;
 
     case LIST_CONTEXT:
+    case PACKED_LIST_CONTEXT:
       ++index_;
       break;
 
@@ -617,30 +1323,47 @@ void TNativeClientProtocol::ReaderContext::advance() {
 
 void TNativeClientProtocol::ReaderContext::nextKeyValue(pp::Var* key,
                                                         pp::Var* value) {
-  assert(index_ < keys_.GetLength());
-  *key = keys_.Get(index_);
+  assert(index_ < static_cast<int>(keys()->GetLength()));
+  *key = keys()->Get(index_);
   *value = asDictionary()->Get(*key);
+  field_value_ = *value;
 }
 
 void TNativeClientProtocol::ReaderContext::nextKey(pp::Var* key) {
-  assert(index_ < keys_.GetLength());
-  *key = keys_.Get(index_);
+  assert(index_ < static_cast<int>(keys()->GetLength()));
+  *key = keys()->Get(index_);
 }
 
 void TNativeClientProtocol::ReaderContext::nextValue(pp::Var* value) {
-  assert(index_ < keys_.GetLength());
-  *value = asDictionary()->Get(keys_.Get(index_));
+  assert(index_ < static_cast<int>(keys()->GetLength()));
+  *value = asDictionary()->Get(keys()->Get(index_));
 }
 
 void TNativeClientProtocol::ReaderContext::nextArrayValue(pp::Var* value) {
-  assert(index_ < asArray()->GetLength());
+  assert(index_ < static_cast<int>(asArray()->GetLength()));
   *value = asArray()->Get(index_); 
 }
 
+const TFieldTypeSpec* TNativeClientProtocol::ReaderContext::nextField(
+    FieldNameCache* field_names) {
+  assert(hasFields());
+  while (index_ < static_cast<int>(num_fields_)) {
+    const TFieldTypeSpec* field = &fields_[index_];
+    field_value_ = asDictionary()->Get(field_names->get(field->name));
+    if (!field_value_.is_null() && !field_value_.is_undefined()) {
+      return field;
+    }
+    ++index_;
+  }
+  field_value_ = pp::Var();
+  return NULL;
+}
+
 void TNativeClientProtocol::ReaderContext::nextVar(pp::Var* var) {
   switch (getType()) {
     case DICTIONARY_CONTEXT:
-      nextValue(var);
+      // Fetched by readFieldBegin() along with the field name.
+      *var = field_value_;
       break;
 
     case LIST_CONTEXT:
@@ -654,37 +1377,69 @@ void TNativeClientProtocol::ReaderContext::nextVar(pp::Var* var) {
     case MAP_VALUE_CONTEXT:
       nextValue(var);
       break;
+
+    case PACKED_LIST_CONTEXT:
+      nextPackedValue(var);
+      break;
   }
 }
 
-TNativeClientProtocol::ReaderContext*
-TNativeClientProtocol::ReaderContext::createDictionaryContext(
-    boost::shared_ptr<const pp::Var> var) {
-  if (!var->is_dictionary()) {
-    throw TProtocolException(TProtocolException::UNKNOWN,
-        "Attempt to createDictionaryContext without a dictionary");
+void TNativeClientProtocol::ReaderContext::nextPackedValue(pp::Var* value) {
+  assert(index_ < static_cast<int>(size_));
+  switch (elem_type_) {
+    case T_BYTE: {
+      int8_t byte;
+      memcpy(&byte, data_ + index_, sizeof(byte));
+      *value = pp::Var(static_cast<int32_t>(byte));
+      break;
+    }
+
+    case T_I32: {
+      int32_t i32;
+      memcpy(&i32, data_ + index_ * sizeof(i32), sizeof(i32));
+      *value = pp::Var(i32);
+      break;
+    }
+
+    case T_DOUBLE: {
+      double dbl;
+      memcpy(&dbl, data_ + index_ * sizeof(dbl), sizeof(dbl));
+      *value = pp::Var(dbl);
+      break;
+    }
+
+    default:
+      assert(false);
   }
-  return new ReaderContext(var, DICTIONARY_CONTEXT);
 }
 
-TNativeClientProtocol::ReaderContext*
-TNativeClientProtocol::ReaderContext::createMapContext(
-    boost::shared_ptr<const pp::Var> var) {
-  if (!var->is_dictionary()) {
-    throw TProtocolException(TProtocolException::UNKNOWN,
-        "Attempt to createMapContext without a dictionary");
+/**
+ * TNativeClientView
+ */
+
+pp::Var TNativeClientView::getField(const char* name) const {
+  if (!var_.is_dictionary()) {
+    return pp::Var();
+  }
+  if (!protocol_) {
+    protocol_.reset(new TNativeClientProtocol());
   }
-  return new ReaderContext(var, MAP_KEY_CONTEXT);
+  return static_cast<const pp::VarDictionary*>(&var_)->Get(
+      protocol_->field_names_.get(name));
 }
 
-TNativeClientProtocol::ReaderContext*
-TNativeClientProtocol::ReaderContext::createListContext(
-    boost::shared_ptr<const pp::Var> var) {
-  if (!var->is_array()) {
-    throw TProtocolException(TProtocolException::UNKNOWN,
-        "Attempt to createListContext without an array");
+bool TNativeClientView::hasField(const char* name) const {
+  pp::Var value = getField(name);
+  return !value.is_null() && !value.is_undefined();
+}
+
+TProtocol* TNativeClientView::beginField(const char* name) const {
+  pp::Var value = getField(name);
+  if (value.is_null() || value.is_undefined()) {
+    return NULL;
   }
-  return new ReaderContext(var, LIST_CONTEXT);
+  protocol_->setRootVar(value);
+  return protocol_.get();
 }
 
 }}} // apache::thrift::protocol
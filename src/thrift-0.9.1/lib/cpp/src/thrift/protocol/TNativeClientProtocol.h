@@ -22,10 +22,12 @@
 
 #include <thrift/protocol/TVirtualProtocol.h>
 
-#include <boost/ptr_container/ptr_deque.hpp>
-#include <stack>
+#include <map>
+#include <vector>
 
 #include "ppapi/cpp/var.h"
+#include "ppapi/cpp/var_array.h"
+#include "ppapi/cpp/var_array_buffer.h"
 #include "ppapi/cpp/var_dictionary.h"
 
 namespace apache { namespace thrift { namespace protocol {
@@ -35,17 +37,96 @@ class TNativeClientContext;
 /**
  * Protocol for Native Client messages.
  *
+ * Structs are written as dictionaries keyed by field name.  Message headers
+ * map onto the dictionary posted between JavaScript and the module, so that
+ * generated processors and clients can be driven over postMessage:
+ *
+ *   call/oneway:  {"id": "<seqid>", "type": "<name>", "data": <args>}
+ *   reply:        {"id": "<seqid>", "data": <result>}
+ *   exception:    {"id": "<seqid>", "error": <exception>}
+ *
+ * A read message is a call if it has a type, since the dictionary does not
+ * distinguish oneway calls.
  */
 class TNativeClientProtocol : public TVirtualProtocol<TNativeClientProtocol> {
  public:
 
   TNativeClientProtocol();
+  explicit TNativeClientProtocol(const pp::Var& var);
   explicit TNativeClientProtocol(boost::shared_ptr<const pp::Var> var);
 
   void reset();
 
+  /**
+   * Sets the var to read from and returns the var that was written.  The
+   * pp::Var is a reference to the underlying browser var, so neither call
+   * copies the var tree.
+   */
+  void setRootVar(const pp::Var& var);
+  const pp::Var& getRootVar() const { return root_var_; }
+
   void setVar(boost::shared_ptr<const pp::Var> var);
-  boost::shared_ptr<const pp::Var> getVar() const { return root_var_; }
+  boost::shared_ptr<const pp::Var> getVar() const;
+
+  /**
+   * When enabled (the default), structs whose declared fields are known via
+   * setNextStructFields() are read by probing the dictionary for each
+   * declared field name in order instead of enumerating its keys.  Keys the
+   * struct does not declare are never visited, which is what the key
+   * enumeration would skip anyway.  Structs read without a field table
+   * always use key enumeration.
+   */
+  void setFieldOrderedReads(bool field_ordered_reads) {
+    field_ordered_reads_ = field_ordered_reads;
+  }
+  bool getFieldOrderedReads() const { return field_ordered_reads_; }
+
+  /**
+   * How binary fields are written.  By default they are written as
+   * ArrayBuffers, which JavaScript receives without an encoding step.
+   * BINARY_BASE64 writes base 64 strings instead, for JavaScript written
+   * against older versions of this protocol.  Either representation is
+   * accepted when reading.
+   */
+  enum BinaryEncoding {
+    BINARY_ARRAY_BUFFER,
+    BINARY_BASE64
+  };
+
+  void setBinaryEncoding(BinaryEncoding binary_encoding) {
+    binary_encoding_ = binary_encoding;
+  }
+  BinaryEncoding getBinaryEncoding() const { return binary_encoding_; }
+
+  /**
+   * When enabled (the default), lists of byte, i32 and double are written
+   * as a single ArrayBuffer of packed elements instead of an array with one
+   * var per element.  The buffer is wrapped in a dictionary naming the
+   * JavaScript typed array that views it:
+   *
+   *   {"__typed_array": "Float64Array", "buffer": <ArrayBuffer>}
+   *
+   * thrift_nacl.js converts these to and from typed arrays.  Packed lists are
+   * accepted when reading regardless of this setting.
+   */
+  void setPackedLists(bool packed_lists) {
+    packed_lists_ = packed_lists;
+  }
+  bool getPackedLists() const { return packed_lists_; }
+
+  /**
+   * When enabled, a struct or container written with the same content as
+   * one written earlier since the last reset() shares the var of the earlier
+   * one, so JavaScript receives one object referenced from several places
+   * instead of copies.  Identical subtrees are found by a hash computed as
+   * the values are written and confirmed by comparing the vars.  Disabled by
+   * default, since JavaScript that modifies the received objects in place
+   * would see the change through every reference.
+   */
+  void setDedupSubtrees(bool dedup_subtrees) {
+    dedup_subtrees_ = dedup_subtrees;
+  }
+  bool getDedupSubtrees() const { return dedup_subtrees_; }
 
   /**
    * Writing functions.
@@ -96,6 +177,8 @@ class TNativeClientProtocol : public TVirtualProtocol<TNativeClientProtocol> {
                             int32_t& seqid);
   uint32_t readMessageEnd();
 
+  void setNextStructFields(const TFieldTypeSpec* fields, uint32_t num_fields);
+
   uint32_t readStructBegin(std::string& name);
   uint32_t readStructEnd();
 
@@ -132,46 +215,130 @@ class TNativeClientProtocol : public TVirtualProtocol<TNativeClientProtocol> {
   uint32_t skip(TType type);
 
  private:
+  friend class TNativeClientView;
+
   enum ContextType {
     DICTIONARY_CONTEXT,
     MAP_KEY_CONTEXT,
     MAP_VALUE_CONTEXT,
-    LIST_CONTEXT
+    LIST_CONTEXT,
+    PACKED_LIST_CONTEXT
   };
 
-  class WriterContext {
+  /**
+   * Field name vars, keyed by the address of the name.  Field names passed
+   * to writeFieldBegin() and in field tables are string literals emitted by
+   * the generator, so each distinct name is converted to a pp::Var once per
+   * process and then found by its address.  Each protocol keeps its own
+   * unlocked copy of the names it has used in front of the process-wide
+   * table.
+   */
+  class FieldNameCache {
    public:
-    WriterContext(boost::shared_ptr<pp::Var> var, ContextType type);
+    // Returns the var for name, which must have static storage duration.
+    // The reference stays valid for the life of the cache.
+    const pp::Var& get(const char* name);
+
+   private:
+    typedef std::map<const char*, pp::Var> NameMap;
+    NameMap names_;
+  };
 
-    inline const std::string& getFieldName() const { return field_name_; }
-    inline void setFieldName(const std::string& field_name) {
+  // Initial depth of the reader and writer context stacks.  The stacks grow
+  // if a deeper nesting is encountered and keep their storage across reset().
+  static const size_t kInitialStackDepth = 16;
+
+  class WriterContext {
+   public:
+    WriterContext()
+      : type_(DICTIONARY_CONTEXT),
+        field_name_(NULL),
+        data_(NULL),
+        elem_type_(T_STOP),
+        size_(0),
+        index_(0),
+        hash_(0) {}
+
+    // Starts a new dictionary or array var for the given context type.  A
+    // PACKED_LIST_CONTEXT allocates a buffer for size elements of elem_type.
+    void init(ContextType type, TType elem_type = T_STOP, uint32_t size = 0);
+    // Releases the reference to the var.
+    void clear();
+
+    inline bool isPacked() const { return type_ == PACKED_LIST_CONTEXT; }
+    inline TType getElemType() const { return elem_type_; }
+    // Returns true once a packed list holds as many elements as declared.
+    inline bool isFilled() const { return index_ == size_; }
+    // Stores the next element of a packed list.
+    template <typename T> void writePacked(T value);
+
+    // Sets the key of the next var written to a DICTIONARY_CONTEXT.  The
+    // var is owned by a FieldNameCache.
+    inline void setFieldName(const pp::Var* field_name) {
       field_name_ = field_name;
     }
 
-    inline const pp::Var& getVar() const { return *var_; }
+    inline const pp::Var& getVar() const { return var_; }
     void writeVar(const pp::Var& var);
+    // Replaces the container written last, which was written when its
+    // context was pushed, by var.
+    void replaceLastVar(const pp::Var& var);
 
-    static WriterContext* createDictionaryContext();
-    static WriterContext* createMapContext();
-    static WriterContext* createListContext();
+    // Adds size bytes at data to the hash of the content.
+    void hash(const void* data, size_t size);
+    // Returns the hash of the content, including the elements of a packed
+    // list.
+    uint64_t finishHash();
 
   private:
     pp::VarDictionary* asDictionary();
     pp::VarArray* asArray();
 
-    boost::shared_ptr<pp::Var> var_;
+    pp::Var var_;
     ContextType type_;
-    std::string field_name_;
+    const pp::Var* field_name_;
     pp::Var map_key_;
+
+    // Buffer of a packed list and the mapped elements.
+    pp::Var buffer_;
+    uint8_t* data_;
+    TType elem_type_;
+    uint32_t size_;
+    uint32_t index_;
+
+    // Hash of the values written, for setDedupSubtrees().
+    uint64_t hash_;
   };
 
   class ReaderContext {
    public:
-    ReaderContext(boost::shared_ptr<const pp::Var> var, ContextType type);
-
-    inline const pp::Var& getVar() const { return *var_; }
+    ReaderContext()
+      : type_(DICTIONARY_CONTEXT),
+        index_(0),
+        fields_(NULL),
+        num_fields_(0),
+        data_(NULL),
+        elem_type_(T_STOP),
+        size_(0) {}
+
+    // Starts reading var, which must be a dictionary for DICTIONARY_CONTEXT,
+    // MAP_KEY_CONTEXT and PACKED_LIST_CONTEXT or an array for
+    // LIST_CONTEXT.  If fields is given
+    // for a DICTIONARY_CONTEXT the declared fields are probed by name and the
+    // keys of the dictionary are not enumerated.
+    void init(const pp::Var& var, ContextType type,
+              const TFieldTypeSpec* fields = NULL, uint32_t num_fields = 0);
+    // Releases the references to the var and its keys.
+    void clear();
+
+    inline const pp::Var& getVar() const { return var_; }
     inline ContextType getType() const { return type_; }
     inline int getIndex() const { return index_; }
+    inline TType getElemType() const { return elem_type_; }
+
+    inline bool isPacked() const { return type_ == PACKED_LIST_CONTEXT; }
+    // Returns the next element of a packed list.
+    template <typename T> T readPacked();
 
     int size() const;
     bool isAtEnd() const;
@@ -181,44 +348,152 @@ class TNativeClientProtocol : public TVirtualProtocol<TNativeClientProtocol> {
     void nextValue(pp::Var* value);
     void nextKeyValue(pp::Var* key, pp::Var* value);
     void nextArrayValue(pp::Var* value);
+    void nextPackedValue(pp::Var* value);
     void nextVar(pp::Var* var);
 
-    static ReaderContext* createDictionaryContext(
-        boost::shared_ptr<const pp::Var> var);
-    static ReaderContext* createMapContext(
-        boost::shared_ptr<const pp::Var> var);
-    static ReaderContext* createListContext(
-        boost::shared_ptr<const pp::Var> var);
+    inline bool hasFields() const { return fields_ != NULL; }
+    // Moves to the next declared field present in the dictionary and returns
+    // its spec, or NULL once all declared fields have been visited.  The
+    // field names are looked up in field_names.
+    const TFieldTypeSpec* nextField(FieldNameCache* field_names);
 
    private:
     const pp::VarDictionary* asDictionary() const;
     const pp::VarArray* asArray() const;
+    const pp::VarArray* keys() const;
+    // Reads the element type and buffer of a packed list.
+    void initPacked();
 
-    boost::shared_ptr<const pp::Var> var_;
-    pp::VarArray keys_;
+    pp::Var var_;
+    pp::Var keys_;
     ContextType type_;
     int index_;
+
+    // Declared fields of the struct, if known.
+    const TFieldTypeSpec* fields_;
+    uint32_t num_fields_;
+    // Value of the current struct field, fetched along with its name so that
+    // reading the value does not look it up a second time.
+    pp::Var field_value_;
+
+    // Buffer of a packed list and the mapped elements.
+    pp::Var buffer_;
+    const uint8_t* data_;
+    TType elem_type_;
+    uint32_t size_;
   };
 
  private:
   void writeVar(const pp::Var& var);
-  boost::shared_ptr<const pp::Var> readVar();
+  void readVar(pp::Var* var);
 
-  void pushWriterContext(WriterContext* context);
+  void pushWriterContext(ContextType type, TType elem_type = T_STOP,
+                         uint32_t size = 0);
   void popWriterContext();
-  inline WriterContext* topWriterContext() { return &writer_stack_.back(); }
+  // Adds a value written to the current context to its hash, if subtrees
+  // are deduplicated.
+  inline void hashValue(TType type, const void* data, size_t size) {
+    if (dedup_subtrees_ && writer_depth_ > 0) {
+      WriterContext* context = topWriterContext();
+      uint8_t tag = static_cast<uint8_t>(type);
+      uint32_t length = static_cast<uint32_t>(size);
+      context->hash(&tag, sizeof(tag));
+      context->hash(&length, sizeof(length));
+      context->hash(data, size);
+    }
+  }
+  // Replaces the var of the current context by an identical var written
+  // earlier, if any.
+  void dedupSubtree();
+  inline WriterContext* topWriterContext() {
+    return &writer_stack_[writer_depth_ - 1];
+  }
 
-  void pushReaderContext(ReaderContext* context);
+  ReaderContext* pushReaderContext(const pp::Var& var, ContextType type,
+                                   const TFieldTypeSpec* fields = NULL,
+                                   uint32_t num_fields = 0);
   void popReaderContext();
-  inline ReaderContext* topReaderContext() { return &reader_stack_.back(); }
+  inline ReaderContext* topReaderContext() {
+    return &reader_stack_[reader_depth_ - 1];
+  }
+
+  // Return the current context if it is a packed list of elem_type, or NULL.
+  inline WriterContext* packedWriterContext(TType elem_type) {
+    if (writer_depth_ == 0) {
+      return NULL;
+    }
+    WriterContext* context = topWriterContext();
+    if (!context->isPacked() || context->getElemType() != elem_type) {
+      return NULL;
+    }
+    return context;
+  }
+  inline ReaderContext* packedReaderContext(TType elem_type) {
+    if (reader_depth_ == 0) {
+      return NULL;
+    }
+    ReaderContext* context = topReaderContext();
+    if (!context->isPacked() || context->getElemType() != elem_type) {
+      return NULL;
+    }
+    return context;
+  }
 
   int64_t readIntegerValue();
 
  private:
-  boost::ptr_deque<WriterContext> writer_stack_;
-  boost::ptr_deque<ReaderContext> reader_stack_;
+  // Contexts are kept in flat stacks that are reused from message to message
+  // so that nested structs and containers do not allocate a context each.
+  std::vector<WriterContext> writer_stack_;
+  size_t writer_depth_;
+  std::vector<ReaderContext> reader_stack_;
+  size_t reader_depth_;
+
+  pp::Var root_var_;
+  FieldNameCache field_names_;
+
+  bool field_ordered_reads_;
+  BinaryEncoding binary_encoding_;
+  bool packed_lists_;
+  bool dedup_subtrees_;
+  // Vars of the structs and containers written since the last reset(), by
+  // the hash of their content.
+  std::map<uint64_t, pp::Var> subtrees_;
+  // Field table passed to setNextStructFields() for the next readStructBegin.
+  const TFieldTypeSpec* next_struct_fields_;
+  uint32_t next_struct_num_fields_;
+};
+
+
+/**
+ * Base of the lazy view readers generated by 'thrift --gen cpp:views'.  A
+ * view wraps the pp::Var dictionary of a struct and decodes each field the
+ * first time it is accessed, so handlers that look at a few fields of a large
+ * request do not decode the rest.  Views are not thread safe.
+ */
+class TNativeClientView {
+ public:
+  TNativeClientView() {}
+  explicit TNativeClientView(const pp::Var& var) : var_(var) {}
+  virtual ~TNativeClientView() {}
+
+  const pp::Var& getVar() const { return var_; }
+
+ protected:
+  // Returns true if the dictionary holds a value other than null or
+  // undefined for the field.  name must have static storage duration.
+  bool hasField(const char* name) const;
+
+  // Returns a protocol that reads the value of the field, or NULL if the
+  // field has no value.  name must have static storage duration.
+  TProtocol* beginField(const char* name) const;
+
+ private:
+  pp::Var getField(const char* name) const;
 
-  boost::shared_ptr<const pp::Var> root_var_;
+  pp::Var var_;
+  // Created on first use and shared by copies of the view.
+  mutable boost::shared_ptr<TNativeClientProtocol> protocol_;
 };
 
 
@@ -169,12 +169,15 @@ enum TType {
 
 const int16_t kFieldIdUnknown = -1;
 
-class TFieldTypeSpec {
- public:
-  TFieldTypeSpec(int16_t fid, TType ftype) : fid(fid), ftype(ftype) {}
-
+/**
+ * Field id and type of a named field, used by protocols that identify fields
+ * by name.  This is an aggregate so that the tables of field specs emitted by
+ * the code generator are initialized at compile time.
+ */
+struct TFieldTypeSpec {
   int16_t fid;
   TType ftype;
+  const char* name;
 };
 
 /**
@@ -481,6 +484,60 @@ class TProtocol {
     return writeBinary_virt(str);
   }
 
+  /**
+   * Write the elements of a list of fixed-width numbers in one call, between
+   * writeListBegin() and writeListEnd().  The defaults write them one at a
+   * time; protocols with a fixed-width encoding override them to write the
+   * whole span at once.
+   */
+  uint32_t writeI16Array(const int16_t* values, uint32_t size) {
+    T_VIRTUAL_CALL();
+    return writeI16Array_virt(values, size);
+  }
+  virtual uint32_t writeI16Array_virt(const int16_t* values, uint32_t size) {
+    uint32_t result = 0;
+    for (uint32_t i = 0; i < size; ++i) {
+      result += writeI16(values[i]);
+    }
+    return result;
+  }
+
+  uint32_t writeI32Array(const int32_t* values, uint32_t size) {
+    T_VIRTUAL_CALL();
+    return writeI32Array_virt(values, size);
+  }
+  virtual uint32_t writeI32Array_virt(const int32_t* values, uint32_t size) {
+    uint32_t result = 0;
+    for (uint32_t i = 0; i < size; ++i) {
+      result += writeI32(values[i]);
+    }
+    return result;
+  }
+
+  uint32_t writeI64Array(const int64_t* values, uint32_t size) {
+    T_VIRTUAL_CALL();
+    return writeI64Array_virt(values, size);
+  }
+  virtual uint32_t writeI64Array_virt(const int64_t* values, uint32_t size) {
+    uint32_t result = 0;
+    for (uint32_t i = 0; i < size; ++i) {
+      result += writeI64(values[i]);
+    }
+    return result;
+  }
+
+  uint32_t writeDoubleArray(const double* values, uint32_t size) {
+    T_VIRTUAL_CALL();
+    return writeDoubleArray_virt(values, size);
+  }
+  virtual uint32_t writeDoubleArray_virt(const double* values, uint32_t size) {
+    uint32_t result = 0;
+    for (uint32_t i = 0; i < size; ++i) {
+      result += writeDouble(values[i]);
+    }
+    return result;
+  }
+
   /**
    * Reading functions
    */
@@ -649,6 +706,61 @@ class TProtocol {
     return readBool_virt(value);
   }
 
+  /**
+   * Read the elements of a list or set of fixed-width numbers, between
+   * readListBegin() and readListEnd() or readSetBegin() and readSetEnd().
+   * The elements may be read in several consecutive calls.  The defaults
+   * read them one at a time; protocols with a fixed-width encoding override
+   * them to read the whole span at once.
+   */
+  uint32_t readI16Array(int16_t* values, uint32_t size) {
+    T_VIRTUAL_CALL();
+    return readI16Array_virt(values, size);
+  }
+  virtual uint32_t readI16Array_virt(int16_t* values, uint32_t size) {
+    uint32_t result = 0;
+    for (uint32_t i = 0; i < size; ++i) {
+      result += readI16(values[i]);
+    }
+    return result;
+  }
+
+  uint32_t readI32Array(int32_t* values, uint32_t size) {
+    T_VIRTUAL_CALL();
+    return readI32Array_virt(values, size);
+  }
+  virtual uint32_t readI32Array_virt(int32_t* values, uint32_t size) {
+    uint32_t result = 0;
+    for (uint32_t i = 0; i < size; ++i) {
+      result += readI32(values[i]);
+    }
+    return result;
+  }
+
+  uint32_t readI64Array(int64_t* values, uint32_t size) {
+    T_VIRTUAL_CALL();
+    return readI64Array_virt(values, size);
+  }
+  virtual uint32_t readI64Array_virt(int64_t* values, uint32_t size) {
+    uint32_t result = 0;
+    for (uint32_t i = 0; i < size; ++i) {
+      result += readI64(values[i]);
+    }
+    return result;
+  }
+
+  uint32_t readDoubleArray(double* values, uint32_t size) {
+    T_VIRTUAL_CALL();
+    return readDoubleArray_virt(values, size);
+  }
+  virtual uint32_t readDoubleArray_virt(double* values, uint32_t size) {
+    uint32_t result = 0;
+    for (uint32_t i = 0; i < size; ++i) {
+      result += readDouble(values[i]);
+    }
+    return result;
+  }
+
   /**
    * Method to arbitrarily skip over data.
    */
@@ -660,6 +772,22 @@ class TProtocol {
     return ::apache::thrift::protocol::skip(*this, type);
   }
 
+  /**
+   * Hint giving the fields declared by the struct whose readStructBegin() is
+   * called next.  Protocols that identify fields by name may use it to look
+   * the declared fields up directly instead of enumerating the incoming
+   * ones.  The table must outlive the read of that struct.
+   */
+  void setNextStructFields(const TFieldTypeSpec* fields, uint32_t num_fields) {
+    T_VIRTUAL_CALL();
+    setNextStructFields_virt(fields, num_fields);
+  }
+  virtual void setNextStructFields_virt(const TFieldTypeSpec* fields,
+                                        uint32_t num_fields) {
+    (void) fields;
+    (void) num_fields;
+  }
+
   inline boost::shared_ptr<TTransport> getTransport() {
     return ptrans_;
   }
@@ -91,9 +91,15 @@ namespace apache
                 virtual uint32_t writeString_virt(const std::string& str) { return protocol->writeString(str); }
                 virtual uint32_t writeBinary_virt(const std::string& str) { return protocol->writeBinary(str); }
 
+                virtual uint32_t writeI16Array_virt(const int16_t* values, uint32_t size) { return protocol->writeI16Array(values, size); }
+                virtual uint32_t writeI32Array_virt(const int32_t* values, uint32_t size) { return protocol->writeI32Array(values, size); }
+                virtual uint32_t writeI64Array_virt(const int64_t* values, uint32_t size) { return protocol->writeI64Array(values, size); }
+                virtual uint32_t writeDoubleArray_virt(const double* values, uint32_t size) { return protocol->writeDoubleArray(values, size); }
+
                 virtual uint32_t readMessageBegin_virt(std::string& name, TMessageType& messageType, int32_t& seqid) { return protocol->readMessageBegin(name,messageType,seqid); }
                 virtual uint32_t readMessageEnd_virt() { return protocol->readMessageEnd(); }
 
+                virtual void setNextStructFields_virt(const TFieldTypeSpec* fields, uint32_t num_fields) { protocol->setNextStructFields(fields, num_fields); }
                 virtual uint32_t readStructBegin_virt(std::string& name) { return protocol->readStructBegin(name); }
                 virtual uint32_t readStructEnd_virt() { return protocol->readStructEnd(); }
 
@@ -123,6 +129,11 @@ namespace apache
                 virtual uint32_t readString_virt(std::string& str) { return protocol->readString(str); }
                 virtual uint32_t readBinary_virt(std::string& str) { return protocol->readBinary(str); }
 
+                virtual uint32_t readI16Array_virt(int16_t* values, uint32_t size) { return protocol->readI16Array(values, size); }
+                virtual uint32_t readI32Array_virt(int32_t* values, uint32_t size) { return protocol->readI32Array(values, size); }
+                virtual uint32_t readI64Array_virt(int64_t* values, uint32_t size) { return protocol->readI64Array(values, size); }
+                virtual uint32_t readDoubleArray_virt(double* values, uint32_t size) { return protocol->readDoubleArray(values, size); }
+
             private:
                 shared_ptr<TProtocol> protocol;    
             };
@@ -60,6 +60,11 @@ class TProtocolDefaults : public TProtocol {
                              "this protocol does not support reading (yet).");
   }
 
+  void setNextStructFields(const TFieldTypeSpec* fields, uint32_t num_fields) {
+    (void) fields;
+    (void) num_fields;
+  }
+
   uint32_t readStructEnd() {
     throw TProtocolException(TProtocolException::NOT_IMPLEMENTED,
                              "this protocol does not support reading (yet).");
@@ -421,6 +426,22 @@ class TVirtualProtocol : public Super_ {
     return static_cast<Protocol_*>(this)->writeBinary(str);
   }
 
+  virtual uint32_t writeI16Array_virt(const int16_t* values, uint32_t size) {
+    return static_cast<Protocol_*>(this)->writeI16Array(values, size);
+  }
+
+  virtual uint32_t writeI32Array_virt(const int32_t* values, uint32_t size) {
+    return static_cast<Protocol_*>(this)->writeI32Array(values, size);
+  }
+
+  virtual uint32_t writeI64Array_virt(const int64_t* values, uint32_t size) {
+    return static_cast<Protocol_*>(this)->writeI64Array(values, size);
+  }
+
+  virtual uint32_t writeDoubleArray_virt(const double* values, uint32_t size) {
+    return static_cast<Protocol_*>(this)->writeDoubleArray(values, size);
+  }
+
   /**
    * Reading functions
    */
@@ -519,10 +540,31 @@ class TVirtualProtocol : public Super_ {
     return static_cast<Protocol_*>(this)->readBinary(str);
   }
 
+  virtual uint32_t readI16Array_virt(int16_t* values, uint32_t size) {
+    return static_cast<Protocol_*>(this)->readI16Array(values, size);
+  }
+
+  virtual uint32_t readI32Array_virt(int32_t* values, uint32_t size) {
+    return static_cast<Protocol_*>(this)->readI32Array(values, size);
+  }
+
+  virtual uint32_t readI64Array_virt(int64_t* values, uint32_t size) {
+    return static_cast<Protocol_*>(this)->readI64Array(values, size);
+  }
+
+  virtual uint32_t readDoubleArray_virt(double* values, uint32_t size) {
+    return static_cast<Protocol_*>(this)->readDoubleArray(values, size);
+  }
+
   virtual uint32_t skip_virt(TType type) {
     return static_cast<Protocol_*>(this)->skip(type);
   }
 
+  virtual void setNextStructFields_virt(const TFieldTypeSpec* fields,
+                                        uint32_t num_fields) {
+    static_cast<Protocol_*>(this)->setNextStructFields(fields, num_fields);
+  }
+
   /*
    * Provide a default skip() implementation that uses non-virtual read
    * methods.
@@ -553,6 +595,83 @@ class TVirtualProtocol : public Super_ {
   }
   using Super_::readBool; // so we don't hide readBool(bool&)
 
+  /*
+   * Provide default implementations of the fixed-width array methods that
+   * write or read the elements one at a time through the non-virtual
+   * methods.  Protocols with a fixed-width encoding override them.
+   */
+  uint32_t writeI16Array(const int16_t* values, uint32_t size) {
+    Protocol_* const prot = static_cast<Protocol_*>(this);
+    uint32_t result = 0;
+    for (uint32_t i = 0; i < size; ++i) {
+      result += prot->writeI16(values[i]);
+    }
+    return result;
+  }
+
+  uint32_t writeI32Array(const int32_t* values, uint32_t size) {
+    Protocol_* const prot = static_cast<Protocol_*>(this);
+    uint32_t result = 0;
+    for (uint32_t i = 0; i < size; ++i) {
+      result += prot->writeI32(values[i]);
+    }
+    return result;
+  }
+
+  uint32_t writeI64Array(const int64_t* values, uint32_t size) {
+    Protocol_* const prot = static_cast<Protocol_*>(this);
+    uint32_t result = 0;
+    for (uint32_t i = 0; i < size; ++i) {
+      result += prot->writeI64(values[i]);
+    }
+    return result;
+  }
+
+  uint32_t writeDoubleArray(const double* values, uint32_t size) {
+    Protocol_* const prot = static_cast<Protocol_*>(this);
+    uint32_t result = 0;
+    for (uint32_t i = 0; i < size; ++i) {
+      result += prot->writeDouble(values[i]);
+    }
+    return result;
+  }
+
+  uint32_t readI16Array(int16_t* values, uint32_t size) {
+    Protocol_* const prot = static_cast<Protocol_*>(this);
+    uint32_t result = 0;
+    for (uint32_t i = 0; i < size; ++i) {
+      result += prot->readI16(values[i]);
+    }
+    return result;
+  }
+
+  uint32_t readI32Array(int32_t* values, uint32_t size) {
+    Protocol_* const prot = static_cast<Protocol_*>(this);
+    uint32_t result = 0;
+    for (uint32_t i = 0; i < size; ++i) {
+      result += prot->readI32(values[i]);
+    }
+    return result;
+  }
+
+  uint32_t readI64Array(int64_t* values, uint32_t size) {
+    Protocol_* const prot = static_cast<Protocol_*>(this);
+    uint32_t result = 0;
+    for (uint32_t i = 0; i < size; ++i) {
+      result += prot->readI64(values[i]);
+    }
+    return result;
+  }
+
+  uint32_t readDoubleArray(double* values, uint32_t size) {
+    Protocol_* const prot = static_cast<Protocol_*>(this);
+    uint32_t result = 0;
+    for (uint32_t i = 0; i < size; ++i) {
+      result += prot->readDouble(values[i]);
+    }
+    return result;
+  }
+
  protected:
   TVirtualProtocol(boost::shared_ptr<TTransport> ptrans)
     : Super_(ptrans)
@@ -0,0 +1,15 @@
+// Host emulation of the PPAPI PP_Bool type.  Only the subset used by
+// TNativeClientProtocol and the thrift_nacl framework is provided.
+
+#ifndef PPAPI_C_PP_BOOL_H_
+#define PPAPI_C_PP_BOOL_H_
+
+typedef enum {
+  PP_FALSE = 0,
+  PP_TRUE = 1
+} PP_Bool;
+
+#define PP_FromBool(b) ((b) ? PP_TRUE : PP_FALSE)
+#define PP_ToBool(b) ((b) != PP_FALSE)
+
+#endif  // PPAPI_C_PP_BOOL_H_
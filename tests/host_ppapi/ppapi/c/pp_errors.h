@@ -0,0 +1,14 @@
+// Host emulation of the PPAPI result codes.  Only the subset used by the
+// thrift_nacl framework is provided.
+
+#ifndef PPAPI_C_PP_ERRORS_H_
+#define PPAPI_C_PP_ERRORS_H_
+
+enum {
+  PP_OK = 0,
+  PP_OK_COMPLETIONPENDING = -1,
+  PP_ERROR_FAILED = -2,
+  PP_ERROR_ABORTED = -3
+};
+
+#endif  // PPAPI_C_PP_ERRORS_H_
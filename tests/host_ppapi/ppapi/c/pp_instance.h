@@ -0,0 +1,10 @@
+// Host emulation of the PPAPI PP_Instance type.
+
+#ifndef PPAPI_C_PP_INSTANCE_H_
+#define PPAPI_C_PP_INSTANCE_H_
+
+#include <stdint.h>
+
+typedef int32_t PP_Instance;
+
+#endif  // PPAPI_C_PP_INSTANCE_H_
@@ -0,0 +1,69 @@
+// Host emulation of the PPAPI PP_Var type.
+//
+// The layout matches ppapi/c/pp_var.h from the Native Client SDK.  Reference
+// counted types (strings, arrays, dictionaries) store an id that is resolved
+// by the host var tracker (see var_tracker.h).
+
+#ifndef PPAPI_C_PP_VAR_H_
+#define PPAPI_C_PP_VAR_H_
+
+#include <stdint.h>
+
+#include "ppapi/c/pp_bool.h"
+
+typedef enum {
+  PP_VARTYPE_UNDEFINED = 0,
+  PP_VARTYPE_NULL = 1,
+  PP_VARTYPE_BOOL = 2,
+  PP_VARTYPE_INT32 = 3,
+  PP_VARTYPE_DOUBLE = 4,
+  PP_VARTYPE_STRING = 5,
+  PP_VARTYPE_OBJECT = 6,
+  PP_VARTYPE_ARRAY = 7,
+  PP_VARTYPE_DICTIONARY = 8,
+  PP_VARTYPE_ARRAY_BUFFER = 9,
+  PP_VARTYPE_RESOURCE = 10
+} PP_VarType;
+
+union PP_VarValue {
+  PP_Bool as_bool;
+  int32_t as_int;
+  double as_double;
+  int64_t as_id;
+};
+
+struct PP_Var {
+  PP_VarType type;
+  int32_t padding;
+  union PP_VarValue value;
+};
+
+inline struct PP_Var PP_MakeUndefined() {
+  struct PP_Var result = { PP_VARTYPE_UNDEFINED, 0, { PP_FALSE } };
+  return result;
+}
+
+inline struct PP_Var PP_MakeNull() {
+  struct PP_Var result = { PP_VARTYPE_NULL, 0, { PP_FALSE } };
+  return result;
+}
+
+inline struct PP_Var PP_MakeBool(PP_Bool value) {
+  struct PP_Var result = { PP_VARTYPE_BOOL, 0, { PP_FALSE } };
+  result.value.as_bool = value;
+  return result;
+}
+
+inline struct PP_Var PP_MakeInt32(int32_t value) {
+  struct PP_Var result = { PP_VARTYPE_INT32, 0, { PP_FALSE } };
+  result.value.as_int = value;
+  return result;
+}
+
+inline struct PP_Var PP_MakeDouble(double value) {
+  struct PP_Var result = { PP_VARTYPE_DOUBLE, 0, { PP_FALSE } };
+  result.value.as_double = value;
+  return result;
+}
+
+#endif  // PPAPI_C_PP_VAR_H_
@@ -0,0 +1,36 @@
+// Host emulation of pp::CompletionCallback.
+
+#ifndef PPAPI_CPP_COMPLETION_CALLBACK_H_
+#define PPAPI_CPP_COMPLETION_CALLBACK_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "ppapi/c/pp_errors.h"
+
+typedef void (*PP_CompletionCallback_Func)(void* user_data, int32_t result);
+
+namespace pp {
+
+class CompletionCallback {
+ public:
+  CompletionCallback() : func_(NULL), user_data_(NULL) {}
+  CompletionCallback(PP_CompletionCallback_Func func, void* user_data)
+      : func_(func), user_data_(user_data) {}
+
+  bool IsOptional() const { return func_ == NULL; }
+
+  void Run(int32_t result) {
+    if (func_) {
+      func_(user_data_, result);
+    }
+  }
+
+ private:
+  PP_CompletionCallback_Func func_;
+  void* user_data_;
+};
+
+}  // namespace pp
+
+#endif  // PPAPI_CPP_COMPLETION_CALLBACK_H_
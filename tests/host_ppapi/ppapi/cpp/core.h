@@ -0,0 +1,16 @@
+// Host emulation of pp::Core.
+
+#ifndef PPAPI_CPP_CORE_H_
+#define PPAPI_CPP_CORE_H_
+
+namespace pp {
+
+class Core {
+ public:
+  // The main thread is the thread that created the Module.
+  bool IsMainThread();
+};
+
+}  // namespace pp
+
+#endif  // PPAPI_CPP_CORE_H_
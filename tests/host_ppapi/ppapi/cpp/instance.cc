@@ -0,0 +1,47 @@
+#include "ppapi/cpp/instance.h"
+
+namespace pp {
+
+Instance::Instance(PP_Instance instance) : pp_instance_(instance) {
+  pthread_mutex_init(&mutex_, NULL);
+}
+
+Instance::~Instance() {
+  pthread_mutex_destroy(&mutex_);
+}
+
+bool Instance::Init(uint32_t argc, const char* argn[], const char* argv[]) {
+  return true;
+}
+
+void Instance::HandleMessage(const Var& message) {}
+
+void Instance::PostMessage(const Var& message) {
+  pthread_mutex_lock(&mutex_);
+  posted_messages_.push_back(message);
+  pthread_mutex_unlock(&mutex_);
+}
+
+void Instance::LogToConsole(PP_LogLevel level, const Var& value) {
+  pthread_mutex_lock(&mutex_);
+  console_log_.push_back(value);
+  pthread_mutex_unlock(&mutex_);
+}
+
+std::vector<Var> Instance::TakePostedMessages() {
+  std::vector<Var> messages;
+  pthread_mutex_lock(&mutex_);
+  messages.swap(posted_messages_);
+  pthread_mutex_unlock(&mutex_);
+  return messages;
+}
+
+std::vector<Var> Instance::TakeConsoleLog() {
+  std::vector<Var> log;
+  pthread_mutex_lock(&mutex_);
+  log.swap(console_log_);
+  pthread_mutex_unlock(&mutex_);
+  return log;
+}
+
+}  // namespace pp
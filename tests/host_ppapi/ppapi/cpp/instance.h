@@ -0,0 +1,49 @@
+// Host emulation of pp::Instance.  Messages posted to the page and logged to
+// the console are kept for the tests to read.
+
+#ifndef PPAPI_CPP_INSTANCE_H_
+#define PPAPI_CPP_INSTANCE_H_
+
+#include <pthread.h>
+#include <stdint.h>
+
+#include <vector>
+
+#include "ppapi/c/pp_instance.h"
+#include "ppapi/c/ppb_console.h"
+#include "ppapi/cpp/var.h"
+
+namespace pp {
+
+class Instance {
+ public:
+  explicit Instance(PP_Instance instance);
+  virtual ~Instance();
+
+  PP_Instance pp_instance() const { return pp_instance_; }
+
+  virtual bool Init(uint32_t argc, const char* argn[], const char* argv[]);
+  virtual void HandleMessage(const Var& message);
+
+  // May be called from any thread.
+  void PostMessage(const Var& message);
+  void LogToConsole(PP_LogLevel level, const Var& value);
+
+  // Host only.  Return and forget the messages posted and the values logged
+  // so far.
+  std::vector<Var> TakePostedMessages();
+  std::vector<Var> TakeConsoleLog();
+
+ private:
+  Instance(const Instance&);
+  Instance& operator=(const Instance&);
+
+  PP_Instance pp_instance_;
+  pthread_mutex_t mutex_;
+  std::vector<Var> posted_messages_;
+  std::vector<Var> console_log_;
+};
+
+}  // namespace pp
+
+#endif  // PPAPI_CPP_INSTANCE_H_
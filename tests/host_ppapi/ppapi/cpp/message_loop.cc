@@ -0,0 +1,95 @@
+#include "ppapi/cpp/message_loop.h"
+
+#include <assert.h>
+#include <pthread.h>
+#include <time.h>
+
+#include <list>
+
+#include "ppapi/cpp/module.h"
+
+namespace pp {
+
+namespace {
+
+struct Work {
+  CompletionCallback callback;
+  // On the CLOCK_MONOTONIC clock.
+  int64_t due_ms;
+};
+
+pthread_mutex_t mutex = PTHREAD_MUTEX_INITIALIZER;
+pthread_cond_t work_posted = PTHREAD_COND_INITIALIZER;
+// In the order posted.
+std::list<Work> pending_work;
+
+int64_t GetMonotonicTimeMs() {
+  struct timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return static_cast<int64_t>(now.tv_sec) * 1000 + now.tv_nsec / 1000000;
+}
+
+// Must be called with mutex held.
+bool TakeDueWork(int64_t now_ms, Work* work) {
+  for (std::list<Work>::iterator iter = pending_work.begin();
+       iter != pending_work.end(); ++iter) {
+    if (iter->due_ms <= now_ms) {
+      *work = *iter;
+      pending_work.erase(iter);
+      return true;
+    }
+  }
+  return false;
+}
+
+}  // namespace
+
+// static
+MessageLoop MessageLoop::GetForMainThread() {
+  return MessageLoop();
+}
+
+int32_t MessageLoop::PostWork(const CompletionCallback& callback,
+                              int64_t delay_ms) {
+  Work work;
+  work.callback = callback;
+  work.due_ms = GetMonotonicTimeMs() + delay_ms;
+  pthread_mutex_lock(&mutex);
+  pending_work.push_back(work);
+  pthread_cond_broadcast(&work_posted);
+  pthread_mutex_unlock(&mutex);
+  return PP_OK;
+}
+
+int32_t MessageLoop::RunPendingWork(int64_t timeout_ms) {
+  assert(Module::Get() && Module::Get()->core()->IsMainThread());
+  int64_t end_ms = GetMonotonicTimeMs() + timeout_ms;
+  int32_t count = 0;
+  pthread_mutex_lock(&mutex);
+  while (true) {
+    Work work;
+    int64_t now_ms = GetMonotonicTimeMs();
+    if (TakeDueWork(now_ms, &work)) {
+      pthread_mutex_unlock(&mutex);
+      work.callback.Run(PP_OK);
+      ++count;
+      pthread_mutex_lock(&mutex);
+      continue;
+    }
+    if (count > 0 || now_ms >= end_ms) {
+      break;
+    }
+    // Wakes up for new work, or at least every millisecond for delayed work.
+    int64_t wait_ms = now_ms + 1;
+    struct timespec deadline;
+    clock_gettime(CLOCK_REALTIME, &deadline);
+    deadline.tv_nsec += (wait_ms - now_ms) * 1000000;
+    deadline.tv_sec += deadline.tv_nsec / 1000000000;
+    deadline.tv_nsec %= 1000000000;
+    pthread_cond_timedwait(&work_posted, &mutex, &deadline);
+  }
+  pthread_mutex_unlock(&mutex);
+  return count;
+}
+
+}  // namespace pp
@@ -0,0 +1,33 @@
+// Host emulation of pp::MessageLoop.  Only the main thread loop is provided.
+// There is no browser to run it, so tests run the work posted to it with
+// RunPendingWork().
+
+#ifndef PPAPI_CPP_MESSAGE_LOOP_H_
+#define PPAPI_CPP_MESSAGE_LOOP_H_
+
+#include <stdint.h>
+
+#include "ppapi/cpp/completion_callback.h"
+
+namespace pp {
+
+class MessageLoop {
+ public:
+  static MessageLoop GetForMainThread();
+
+  // Runs callback on the main thread once delay_ms milliseconds have passed.
+  // May be called from any thread.
+  int32_t PostWork(const CompletionCallback& callback, int64_t delay_ms = 0);
+
+  // Host only.  Runs the work that is due, waiting up to timeout_ms
+  // milliseconds for some if there is none.  Must be called on the main
+  // thread.  Returns the number of callbacks run.
+  int32_t RunPendingWork(int64_t timeout_ms);
+
+ private:
+  MessageLoop() {}
+};
+
+}  // namespace pp
+
+#endif  // PPAPI_CPP_MESSAGE_LOOP_H_
@@ -0,0 +1,35 @@
+#include "ppapi/cpp/module.h"
+
+#include <assert.h>
+#include <pthread.h>
+#include <stddef.h>
+
+namespace pp {
+
+namespace {
+
+Module* module = NULL;
+pthread_t main_thread;
+
+}  // namespace
+
+bool Core::IsMainThread() {
+  return module != NULL && pthread_equal(pthread_self(), main_thread);
+}
+
+Module::Module() {
+  assert(module == NULL);
+  module = this;
+  main_thread = pthread_self();
+}
+
+Module::~Module() {
+  module = NULL;
+}
+
+// static
+Module* Module::Get() {
+  return module;
+}
+
+}  // namespace pp
@@ -0,0 +1,40 @@
+// Host emulation of ppapi/cpp/module.h.  There is no browser on the host, so
+// tests create the module with pp::CreateModule() and its instances with
+// CreateInstance() themselves.
+
+#ifndef PPAPI_CPP_MODULE_H_
+#define PPAPI_CPP_MODULE_H_
+
+#include "ppapi/c/pp_instance.h"
+#include "ppapi/cpp/core.h"
+
+namespace pp {
+
+class Instance;
+
+class Module {
+ public:
+  // The thread constructing the module becomes the main thread.
+  Module();
+  virtual ~Module();
+
+  // Returns the module, or NULL if none was created.
+  static Module* Get();
+
+  Core* core() { return &core_; }
+
+  virtual Instance* CreateInstance(PP_Instance instance) = 0;
+
+ private:
+  Module(const Module&);
+  Module& operator=(const Module&);
+
+  Core core_;
+};
+
+// Implemented by the module code.
+Module* CreateModule();
+
+}  // namespace pp
+
+#endif  // PPAPI_CPP_MODULE_H_
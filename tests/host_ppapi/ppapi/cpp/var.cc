@@ -0,0 +1,160 @@
+#include "ppapi/cpp/var.h"
+
+#include <stdio.h>
+
+#include "var_tracker.h"
+
+using pp::host::StringVar;
+using pp::host::VarTracker;
+
+namespace pp {
+
+Var::Var() {
+  var_ = PP_MakeUndefined();
+}
+
+Var::Var(Null) {
+  var_ = PP_MakeNull();
+}
+
+Var::Var(bool b) {
+  var_ = PP_MakeBool(PP_FromBool(b));
+}
+
+Var::Var(int32_t i) {
+  var_ = PP_MakeInt32(i);
+}
+
+Var::Var(double d) {
+  var_ = PP_MakeDouble(d);
+}
+
+Var::Var(const char* utf8_str) {
+  var_ = VarTracker::MakeVar(new StringVar(utf8_str ? utf8_str : ""));
+}
+
+Var::Var(const std::string& utf8_str) {
+  var_ = VarTracker::MakeVar(new StringVar(utf8_str));
+}
+
+Var::Var(PassRef, const PP_Var& var) {
+  var_ = var;
+}
+
+Var::Var(const PP_Var& var) {
+  var_ = var;
+  VarTracker::AddRefVar(var_);
+}
+
+Var::Var(const Var& other) {
+  var_ = other.var_;
+  VarTracker::AddRefVar(var_);
+}
+
+Var::~Var() {
+  VarTracker::ReleaseVar(var_);
+}
+
+Var& Var::operator=(const Var& other) {
+  // Add the new reference before releasing the old one in case other is
+  // (or is owned by) this.
+  VarTracker::AddRefVar(other.var_);
+  VarTracker::ReleaseVar(var_);
+  var_ = other.var_;
+  return *this;
+}
+
+bool Var::operator==(const Var& other) const {
+  if (var_.type != other.var_.type) {
+    return false;
+  }
+  switch (var_.type) {
+    case PP_VARTYPE_UNDEFINED:
+    case PP_VARTYPE_NULL:
+      return true;
+    case PP_VARTYPE_BOOL:
+      return AsBool() == other.AsBool();
+    case PP_VARTYPE_INT32:
+      return AsInt() == other.AsInt();
+    case PP_VARTYPE_DOUBLE:
+      return AsDouble() == other.AsDouble();
+    case PP_VARTYPE_STRING:
+      if (var_.value.as_id == other.var_.value.as_id) {
+        return true;
+      }
+      return AsString() == other.AsString();
+    default:
+      return var_.value.as_id == other.var_.value.as_id;
+  }
+}
+
+bool Var::AsBool() const {
+  if (!is_bool()) {
+    return false;
+  }
+  return PP_ToBool(var_.value.as_bool);
+}
+
+int32_t Var::AsInt() const {
+  if (is_int()) {
+    return var_.value.as_int;
+  }
+  if (is_double()) {
+    return static_cast<int>(var_.value.as_double);
+  }
+  return 0;
+}
+
+double Var::AsDouble() const {
+  if (is_double()) {
+    return var_.value.as_double;
+  }
+  if (is_int()) {
+    return static_cast<double>(var_.value.as_int);
+  }
+  return 0.0;
+}
+
+std::string Var::AsString() const {
+  StringVar* string_var = VarTracker::GetStringVar(var_);
+  if (!string_var) {
+    return std::string();
+  }
+  return string_var->value();
+}
+
+PP_Var Var::Detach() {
+  PP_Var result = var_;
+  var_ = PP_MakeUndefined();
+  return result;
+}
+
+std::string Var::DebugString() const {
+  char buf[256];
+  switch (var_.type) {
+    case PP_VARTYPE_UNDEFINED:
+      return "Var(UNDEFINED)";
+    case PP_VARTYPE_NULL:
+      return "Var(NULL)";
+    case PP_VARTYPE_BOOL:
+      return AsBool() ? "Var(true)" : "Var(false)";
+    case PP_VARTYPE_INT32:
+      snprintf(buf, sizeof(buf), "Var(%d)", AsInt());
+      return buf;
+    case PP_VARTYPE_DOUBLE:
+      snprintf(buf, sizeof(buf), "Var(%f)", AsDouble());
+      return buf;
+    case PP_VARTYPE_STRING:
+      return "Var<'" + AsString() + "'>";
+    case PP_VARTYPE_ARRAY:
+      return "Var(ARRAY)";
+    case PP_VARTYPE_DICTIONARY:
+      return "Var(DICTIONARY)";
+    case PP_VARTYPE_ARRAY_BUFFER:
+      return "Var(ARRAY_BUFFER)";
+    default:
+      return "Var(UNKNOWN)";
+  }
+}
+
+}  // namespace pp
@@ -0,0 +1,80 @@
+// Host emulation of pp::Var.
+//
+// Mirrors the interface of ppapi/cpp/var.h from the Native Client SDK so that
+// code written against PPAPI (TNativeClientProtocol, the thrift_nacl
+// framework) can be built and profiled on a plain Linux host.
+
+#ifndef PPAPI_CPP_VAR_H_
+#define PPAPI_CPP_VAR_H_
+
+#include <string>
+
+#include "ppapi/c/pp_var.h"
+
+namespace pp {
+
+class Var {
+ public:
+  // Special value passed to constructor to make NULL.
+  struct Null {};
+
+  // Special value passed to constructor to take ownership of a reference
+  // without incrementing the reference count.
+  struct PassRef {};
+
+  Var();
+  Var(Null);
+  Var(bool b);
+  Var(int32_t i);
+  Var(double d);
+  Var(const char* utf8_str);
+  Var(const std::string& utf8_str);
+
+  Var(PassRef, const PP_Var& var);
+  explicit Var(const PP_Var& var);
+
+  Var(const Var& other);
+
+  virtual ~Var();
+
+  virtual Var& operator=(const Var& other);
+
+  bool operator==(const Var& other) const;
+
+  bool is_undefined() const { return var_.type == PP_VARTYPE_UNDEFINED; }
+  bool is_null() const { return var_.type == PP_VARTYPE_NULL; }
+  bool is_bool() const { return var_.type == PP_VARTYPE_BOOL; }
+  bool is_string() const { return var_.type == PP_VARTYPE_STRING; }
+  bool is_object() const { return var_.type == PP_VARTYPE_OBJECT; }
+  bool is_array() const { return var_.type == PP_VARTYPE_ARRAY; }
+  bool is_dictionary() const { return var_.type == PP_VARTYPE_DICTIONARY; }
+  bool is_resource() const { return var_.type == PP_VARTYPE_RESOURCE; }
+  bool is_int() const { return var_.type == PP_VARTYPE_INT32; }
+  bool is_double() const { return var_.type == PP_VARTYPE_DOUBLE; }
+  bool is_number() const {
+    return var_.type == PP_VARTYPE_INT32 || var_.type == PP_VARTYPE_DOUBLE;
+  }
+  bool is_array_buffer() const {
+    return var_.type == PP_VARTYPE_ARRAY_BUFFER;
+  }
+
+  bool AsBool() const;
+  int32_t AsInt() const;
+  double AsDouble() const;
+  std::string AsString() const;
+
+  const PP_Var& pp_var() const { return var_; }
+
+  // Detaches from the internal PP_Var without releasing the reference.  The
+  // caller becomes responsible for the reference.
+  PP_Var Detach();
+
+  std::string DebugString() const;
+
+ protected:
+  PP_Var var_;
+};
+
+}  // namespace pp
+
+#endif  // PPAPI_CPP_VAR_H_
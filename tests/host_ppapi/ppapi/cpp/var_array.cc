@@ -0,0 +1,85 @@
+#include "ppapi/cpp/var_array.h"
+
+#include "var_tracker.h"
+
+using pp::host::ArrayVar;
+using pp::host::VarTracker;
+
+namespace pp {
+
+VarArray::VarArray() : Var(Null()) {
+  var_ = VarTracker::MakeVar(new ArrayVar());
+}
+
+VarArray::VarArray(const Var& var) : Var(var) {
+  if (!var.is_array()) {
+    VarTracker::ReleaseVar(var_);
+    var_ = PP_MakeNull();
+  }
+}
+
+VarArray::VarArray(const PP_Var& var) : Var(var) {
+  if (var.type != PP_VARTYPE_ARRAY) {
+    VarTracker::ReleaseVar(var_);
+    var_ = PP_MakeNull();
+  }
+}
+
+VarArray::VarArray(const VarArray& other) : Var(other) {
+}
+
+VarArray::~VarArray() {
+}
+
+VarArray& VarArray::operator=(const VarArray& other) {
+  Var::operator=(other);
+  return *this;
+}
+
+Var& VarArray::operator=(const Var& other) {
+  if (other.is_array()) {
+    Var::operator=(other);
+  } else {
+    Var::operator=(Var(Null()));
+  }
+  return *this;
+}
+
+Var VarArray::Get(uint32_t index) const {
+  ArrayVar* array = VarTracker::GetArrayVar(var_);
+  if (!array || index >= array->elements().size()) {
+    return Var();
+  }
+  return array->elements()[index];
+}
+
+bool VarArray::Set(uint32_t index, const Var& value) {
+  ArrayVar* array = VarTracker::GetArrayVar(var_);
+  if (!array) {
+    return false;
+  }
+  if (index >= array->elements().size()) {
+    array->elements().resize(index + 1);
+  }
+  array->elements()[index] = value;
+  return true;
+}
+
+uint32_t VarArray::GetLength() const {
+  ArrayVar* array = VarTracker::GetArrayVar(var_);
+  if (!array) {
+    return 0;
+  }
+  return static_cast<uint32_t>(array->elements().size());
+}
+
+bool VarArray::SetLength(uint32_t length) {
+  ArrayVar* array = VarTracker::GetArrayVar(var_);
+  if (!array) {
+    return false;
+  }
+  array->elements().resize(length);
+  return true;
+}
+
+}  // namespace pp
@@ -0,0 +1,45 @@
+// Host emulation of pp::VarArray.
+
+#ifndef PPAPI_CPP_VAR_ARRAY_H_
+#define PPAPI_CPP_VAR_ARRAY_H_
+
+#include "ppapi/cpp/var.h"
+
+namespace pp {
+
+class VarArray : public Var {
+ public:
+  // Constructs a new, empty array var.
+  VarArray();
+
+  // Contructs a VarArray given a var for which is_array() is true.  This will
+  // refer to the same array var, but allow you to access methods specific to
+  // arrays.
+  explicit VarArray(const Var& var);
+  explicit VarArray(const PP_Var& var);
+
+  VarArray(const VarArray& other);
+
+  virtual ~VarArray();
+
+  VarArray& operator=(const VarArray& other);
+  virtual Var& operator=(const Var& other);
+
+  // Returns the element at |index|, or an undefined var if |index| is out of
+  // range.
+  Var Get(uint32_t index) const;
+
+  // Sets the value at |index|.  The array grows if |index| is larger than or
+  // equal to the current length.
+  bool Set(uint32_t index, const Var& value);
+
+  uint32_t GetLength() const;
+
+  // Sets the array length.  Elements beyond the new length are released and
+  // new elements are undefined.
+  bool SetLength(uint32_t length);
+};
+
+}  // namespace pp
+
+#endif  // PPAPI_CPP_VAR_ARRAY_H_
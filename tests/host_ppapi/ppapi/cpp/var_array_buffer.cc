@@ -0,0 +1,64 @@
+#include "ppapi/cpp/var_array_buffer.h"
+
+#include "var_tracker.h"
+
+using pp::host::ArrayBufferVar;
+using pp::host::VarTracker;
+
+namespace pp {
+
+VarArrayBuffer::VarArrayBuffer() : Var(Null()) {
+  var_ = VarTracker::MakeVar(new ArrayBufferVar(0));
+}
+
+VarArrayBuffer::VarArrayBuffer(const Var& var) : Var(var) {
+  if (!var.is_array_buffer()) {
+    VarTracker::ReleaseVar(var_);
+    var_ = PP_MakeNull();
+  }
+}
+
+VarArrayBuffer::VarArrayBuffer(uint32_t size_in_bytes) : Var(Null()) {
+  var_ = VarTracker::MakeVar(new ArrayBufferVar(size_in_bytes));
+}
+
+VarArrayBuffer::VarArrayBuffer(const VarArrayBuffer& buffer) : Var(buffer) {
+}
+
+VarArrayBuffer::~VarArrayBuffer() {
+}
+
+VarArrayBuffer& VarArrayBuffer::operator=(const VarArrayBuffer& other) {
+  Var::operator=(other);
+  return *this;
+}
+
+Var& VarArrayBuffer::operator=(const Var& other) {
+  if (other.is_array_buffer()) {
+    Var::operator=(other);
+  } else {
+    Var::operator=(Var(Null()));
+  }
+  return *this;
+}
+
+uint32_t VarArrayBuffer::ByteLength() const {
+  ArrayBufferVar* buffer = VarTracker::GetArrayBufferVar(var_);
+  if (!buffer) {
+    return 0;
+  }
+  return static_cast<uint32_t>(buffer->data().size());
+}
+
+void* VarArrayBuffer::Map() {
+  ArrayBufferVar* buffer = VarTracker::GetArrayBufferVar(var_);
+  if (!buffer || buffer->data().empty()) {
+    return NULL;
+  }
+  return &buffer->data()[0];
+}
+
+void VarArrayBuffer::Unmap() {
+}
+
+}  // namespace pp
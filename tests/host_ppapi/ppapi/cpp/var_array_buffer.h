@@ -0,0 +1,40 @@
+// Host emulation of pp::VarArrayBuffer.
+
+#ifndef PPAPI_CPP_VAR_ARRAY_BUFFER_H_
+#define PPAPI_CPP_VAR_ARRAY_BUFFER_H_
+
+#include "ppapi/cpp/var.h"
+
+namespace pp {
+
+class VarArrayBuffer : public Var {
+ public:
+  // Constructs a new, zero length array buffer var.
+  VarArrayBuffer();
+
+  // Contructs a VarArrayBuffer given a var for which is_array_buffer() is
+  // true.  This will refer to the same array buffer var, but allow you to
+  // access methods specific to array buffers.
+  explicit VarArrayBuffer(const Var& var);
+
+  // Constructs a new array buffer var of |size_in_bytes| zeroed bytes.
+  explicit VarArrayBuffer(uint32_t size_in_bytes);
+
+  VarArrayBuffer(const VarArrayBuffer& buffer);
+
+  virtual ~VarArrayBuffer();
+
+  VarArrayBuffer& operator=(const VarArrayBuffer& other);
+  virtual Var& operator=(const Var& other);
+
+  uint32_t ByteLength() const;
+
+  // Returns a pointer to the contents of the buffer, which stays valid until
+  // Unmap() is called.  Returns NULL for a zero length buffer.
+  void* Map();
+  void Unmap();
+};
+
+}  // namespace pp
+
+#endif  // PPAPI_CPP_VAR_ARRAY_BUFFER_H_
@@ -0,0 +1,110 @@
+#include "ppapi/cpp/var_dictionary.h"
+
+#include "var_tracker.h"
+
+using pp::host::DictionaryVar;
+using pp::host::StringVar;
+using pp::host::VarTracker;
+
+namespace pp {
+
+VarDictionary::VarDictionary() : Var(Null()) {
+  var_ = VarTracker::MakeVar(new DictionaryVar());
+}
+
+VarDictionary::VarDictionary(const Var& var) : Var(var) {
+  if (!var.is_dictionary()) {
+    VarTracker::ReleaseVar(var_);
+    var_ = PP_MakeNull();
+  }
+}
+
+VarDictionary::VarDictionary(const PP_Var& var) : Var(var) {
+  if (var.type != PP_VARTYPE_DICTIONARY) {
+    VarTracker::ReleaseVar(var_);
+    var_ = PP_MakeNull();
+  }
+}
+
+VarDictionary::VarDictionary(const VarDictionary& other) : Var(other) {
+}
+
+VarDictionary::~VarDictionary() {
+}
+
+VarDictionary& VarDictionary::operator=(const VarDictionary& other) {
+  Var::operator=(other);
+  return *this;
+}
+
+Var& VarDictionary::operator=(const Var& other) {
+  if (other.is_dictionary()) {
+    Var::operator=(other);
+  } else {
+    Var::operator=(Var(Null()));
+  }
+  return *this;
+}
+
+Var VarDictionary::Get(const Var& key) const {
+  DictionaryVar* dict = VarTracker::GetDictionaryVar(var_);
+  StringVar* key_string = VarTracker::GetStringVar(key.pp_var());
+  if (!dict || !key_string) {
+    return Var();
+  }
+
+  DictionaryVar::KeyValueMap::const_iterator iter =
+      dict->key_value_map().find(key_string->value());
+  if (iter == dict->key_value_map().end()) {
+    return Var();
+  }
+  return iter->second;
+}
+
+bool VarDictionary::Set(const Var& key, const Var& value) {
+  DictionaryVar* dict = VarTracker::GetDictionaryVar(var_);
+  StringVar* key_string = VarTracker::GetStringVar(key.pp_var());
+  if (!dict || !key_string) {
+    return false;
+  }
+  dict->key_value_map()[key_string->value()] = value;
+  return true;
+}
+
+void VarDictionary::Delete(const Var& key) {
+  DictionaryVar* dict = VarTracker::GetDictionaryVar(var_);
+  StringVar* key_string = VarTracker::GetStringVar(key.pp_var());
+  if (dict && key_string) {
+    dict->key_value_map().erase(key_string->value());
+  }
+}
+
+bool VarDictionary::HasKey(const Var& key) const {
+  DictionaryVar* dict = VarTracker::GetDictionaryVar(var_);
+  StringVar* key_string = VarTracker::GetStringVar(key.pp_var());
+  if (!dict || !key_string) {
+    return false;
+  }
+  return dict->key_value_map().count(key_string->value()) > 0;
+}
+
+VarArray VarDictionary::GetKeys() const {
+  VarArray keys;
+  DictionaryVar* dict = VarTracker::GetDictionaryVar(var_);
+  if (!dict) {
+    return keys;
+  }
+
+  keys.SetLength(static_cast<uint32_t>(dict->key_value_map().size()));
+
+  uint32_t index = 0;
+  DictionaryVar::KeyValueMap::const_iterator iter;
+  for (iter = dict->key_value_map().begin();
+       iter != dict->key_value_map().end();
+       ++iter, ++index) {
+    keys.Set(index, Var(iter->first));
+  }
+  return keys;
+}
+
+}  // namespace pp
@@ -0,0 +1,47 @@
+// Host emulation of pp::VarDictionary.
+
+#ifndef PPAPI_CPP_VAR_DICTIONARY_H_
+#define PPAPI_CPP_VAR_DICTIONARY_H_
+
+#include "ppapi/cpp/var.h"
+#include "ppapi/cpp/var_array.h"
+
+namespace pp {
+
+class VarDictionary : public Var {
+ public:
+  // Constructs a new, empty dictionary var.
+  VarDictionary();
+
+  // Contructs a VarDictionary given a var for which is_dictionary() is true.
+  // This will refer to the same dictionary var, but allow you to access
+  // methods specific to dictionaries.
+  explicit VarDictionary(const Var& var);
+  explicit VarDictionary(const PP_Var& var);
+
+  VarDictionary(const VarDictionary& other);
+
+  virtual ~VarDictionary();
+
+  VarDictionary& operator=(const VarDictionary& other);
+  virtual Var& operator=(const Var& other);
+
+  // Returns the value associated with |key|, or an undefined var if |key| is
+  // not a string or doesn't exist.
+  Var Get(const Var& key) const;
+
+  // Sets the value associated with |key|.  Returns false if |key| is not a
+  // string.
+  bool Set(const Var& key, const Var& value);
+
+  void Delete(const Var& key);
+
+  bool HasKey(const Var& key) const;
+
+  // Returns an array containing all of the keys.
+  VarArray GetKeys() const;
+};
+
+}  // namespace pp
+
+#endif  // PPAPI_CPP_VAR_DICTIONARY_H_
@@ -0,0 +1,128 @@
+// Host emulation of pp::CompletionCallbackFactory.  Callbacks made by the
+// factory call a method of its object with the bound arguments, unless the
+// factory was destroyed or CancelAll() was called before they run.
+
+#ifndef PPAPI_UTILITY_COMPLETION_CALLBACK_FACTORY_H_
+#define PPAPI_UTILITY_COMPLETION_CALLBACK_FACTORY_H_
+
+#include <stdint.h>
+
+#include <boost/shared_ptr.hpp>
+
+#include "ppapi/cpp/completion_callback.h"
+
+namespace pp {
+
+template <typename T>
+class CompletionCallbackFactory {
+ public:
+  explicit CompletionCallbackFactory(T* object = NULL)
+      : back_pointer_(new BackPointer(object)) {}
+
+  ~CompletionCallbackFactory() {
+    CancelAll();
+  }
+
+  // Must be called on the thread that runs the callbacks.
+  void CancelAll() {
+    back_pointer_->object = NULL;
+  }
+
+  template <typename Method>
+  CompletionCallback NewCallback(Method method) {
+    return NewCallbackHelper(new Dispatcher0<Method>(method));
+  }
+
+  template <typename Method, typename A>
+  CompletionCallback NewCallback(Method method, const A& a) {
+    return NewCallbackHelper(new Dispatcher1<Method, A>(method, a));
+  }
+
+  template <typename Method, typename A, typename B>
+  CompletionCallback NewCallback(Method method, const A& a, const B& b) {
+    return NewCallbackHelper(new Dispatcher2<Method, A, B>(method, a, b));
+  }
+
+ private:
+  struct BackPointer {
+    explicit BackPointer(T* object) : object(object) {}
+    T* volatile object;
+  };
+
+  class DispatcherBase {
+   public:
+    virtual ~DispatcherBase() {}
+    virtual void Dispatch(T* object, int32_t result) = 0;
+  };
+
+  template <typename Method>
+  class Dispatcher0 : public DispatcherBase {
+   public:
+    explicit Dispatcher0(Method method) : method_(method) {}
+    virtual void Dispatch(T* object, int32_t result) {
+      (object->*method_)(result);
+    }
+
+   private:
+    Method method_;
+  };
+
+  template <typename Method, typename A>
+  class Dispatcher1 : public DispatcherBase {
+   public:
+    Dispatcher1(Method method, const A& a) : method_(method), a_(a) {}
+    virtual void Dispatch(T* object, int32_t result) {
+      (object->*method_)(result, a_);
+    }
+
+   private:
+    Method method_;
+    A a_;
+  };
+
+  template <typename Method, typename A, typename B>
+  class Dispatcher2 : public DispatcherBase {
+   public:
+    Dispatcher2(Method method, const A& a, const B& b)
+        : method_(method), a_(a), b_(b) {}
+    virtual void Dispatch(T* object, int32_t result) {
+      (object->*method_)(result, a_, b_);
+    }
+
+   private:
+    Method method_;
+    A a_;
+    B b_;
+  };
+
+  struct CallbackData {
+    boost::shared_ptr<BackPointer> back_pointer;
+    DispatcherBase* dispatcher;
+  };
+
+  CompletionCallback NewCallbackHelper(DispatcherBase* dispatcher) {
+    CallbackData* data = new CallbackData();
+    data->back_pointer = back_pointer_;
+    data->dispatcher = dispatcher;
+    return CompletionCallback(&CallbackFactoryThunk, data);
+  }
+
+  static void CallbackFactoryThunk(void* user_data, int32_t result) {
+    CallbackData* data = static_cast<CallbackData*>(user_data);
+    T* object = data->back_pointer->object;
+    if (object) {
+      data->dispatcher->Dispatch(object, result);
+    }
+    delete data->dispatcher;
+    delete data;
+  }
+
+  CompletionCallbackFactory(const CompletionCallbackFactory&);
+  CompletionCallbackFactory& operator=(const CompletionCallbackFactory&);
+
+  boost::shared_ptr<BackPointer> back_pointer_;
+};
+
+}  // namespace pp
+
+#endif  // PPAPI_UTILITY_COMPLETION_CALLBACK_FACTORY_H_
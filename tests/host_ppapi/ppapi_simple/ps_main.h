@@ -0,0 +1,12 @@
+// Host replacement for ppapi_simple/ps_main.h.  On the host the registered
+// entry point is simply called from main().
+
+#ifndef PPAPI_SIMPLE_PS_MAIN_H_
+#define PPAPI_SIMPLE_PS_MAIN_H_
+
+#define PPAPI_SIMPLE_REGISTER_MAIN(main_func) \
+  int main(int argc, char* argv[]) { \
+    return main_func(argc, argv); \
+  }
+
+#endif  // PPAPI_SIMPLE_PS_MAIN_H_
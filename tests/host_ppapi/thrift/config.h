@@ -0,0 +1,23 @@
+/* Minimal thrift/config.h for the Linux host build of the NaCl tests.  The
+ * NaCl build gets this file from the naclports configure step. */
+
+#ifndef HOST_PPAPI_THRIFT_CONFIG_H_
+#define HOST_PPAPI_THRIFT_CONFIG_H_
+
+#define ARITHMETIC_RIGHT_SHIFT 1
+#define SIGNED_RIGHT_SHIFT_IS 1
+
+#define HAVE_INTTYPES_H 1
+#define HAVE_NETINET_IN_H 1
+#define HAVE_STDINT_H 1
+#define HAVE_SYS_PARAM_H 1
+#define HAVE_SYS_TIME_H 1
+#define HAVE_UNISTD_H 1
+#define HAVE_PTHREAD_H 1
+#define HAVE_SCHED_H 1
+#define HAVE_CLOCK_GETTIME 1
+
+#define HAVE_STRERROR_R 1
+#define STRERROR_R_CHAR_P 1
+
+#endif  /* HOST_PPAPI_THRIFT_CONFIG_H_ */
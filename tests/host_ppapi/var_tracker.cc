@@ -0,0 +1,109 @@
+#include "var_tracker.h"
+
+#include <assert.h>
+
+namespace pp {
+namespace host {
+
+volatile int32_t VarTracker::live_object_count_ = 0;
+
+VarObject::VarObject(PP_VarType type) : type_(type), ref_count_(0) {
+  __sync_add_and_fetch(&VarTracker::live_object_count_, 1);
+}
+
+VarObject::~VarObject() {
+  __sync_sub_and_fetch(&VarTracker::live_object_count_, 1);
+}
+
+void VarObject::AddRef() {
+  __sync_add_and_fetch(&ref_count_, 1);
+}
+
+bool VarObject::Release() {
+  int32_t ref_count = __sync_sub_and_fetch(&ref_count_, 1);
+  assert(ref_count >= 0);
+  return ref_count == 0;
+}
+
+// static
+PP_Var VarTracker::MakeVar(VarObject* object) {
+  PP_Var var;
+  var.type = object->type();
+  var.padding = 0;
+  var.value.as_id = reinterpret_cast<intptr_t>(object);
+  object->AddRef();
+  return var;
+}
+
+// static
+bool VarTracker::IsRefCounted(const PP_Var& var) {
+  return var.type == PP_VARTYPE_STRING ||
+         var.type == PP_VARTYPE_ARRAY ||
+         var.type == PP_VARTYPE_DICTIONARY ||
+         var.type == PP_VARTYPE_ARRAY_BUFFER;
+}
+
+// static
+void VarTracker::AddRefVar(const PP_Var& var) {
+  if (IsRefCounted(var)) {
+    GetVarObject(var)->AddRef();
+  }
+}
+
+// static
+void VarTracker::ReleaseVar(const PP_Var& var) {
+  if (IsRefCounted(var)) {
+    VarObject* object = GetVarObject(var);
+    if (object->Release()) {
+      delete object;
+    }
+  }
+}
+
+// static
+VarObject* VarTracker::GetVarObject(const PP_Var& var) {
+  if (!IsRefCounted(var)) {
+    return NULL;
+  }
+  return reinterpret_cast<VarObject*>(static_cast<intptr_t>(var.value.as_id));
+}
+
+// static
+StringVar* VarTracker::GetStringVar(const PP_Var& var) {
+  if (var.type != PP_VARTYPE_STRING) {
+    return NULL;
+  }
+  return static_cast<StringVar*>(GetVarObject(var));
+}
+
+// static
+ArrayVar* VarTracker::GetArrayVar(const PP_Var& var) {
+  if (var.type != PP_VARTYPE_ARRAY) {
+    return NULL;
+  }
+  return static_cast<ArrayVar*>(GetVarObject(var));
+}
+
+// static
+DictionaryVar* VarTracker::GetDictionaryVar(const PP_Var& var) {
+  if (var.type != PP_VARTYPE_DICTIONARY) {
+    return NULL;
+  }
+  return static_cast<DictionaryVar*>(GetVarObject(var));
+}
+
+// static
+ArrayBufferVar* VarTracker::GetArrayBufferVar(const PP_Var& var) {
+  if (var.type != PP_VARTYPE_ARRAY_BUFFER) {
+    return NULL;
+  }
+  return static_cast<ArrayBufferVar*>(GetVarObject(var));
+}
+
+// static
+int32_t VarTracker::GetLiveObjectCount() {
+  return __sync_add_and_fetch(&live_object_count_, 0);
+}
+
+}  // namespace host
+}  // namespace pp
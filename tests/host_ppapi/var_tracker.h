@@ -0,0 +1,115 @@
+// Host-side var tracker backing the pp::Var emulation.
+//
+// In the browser, reference counted vars (strings, arrays, dictionaries) live
+// in the renderer's var tracker and a PP_Var only carries an id.  The host
+// emulation keeps the same model: the id of a reference counted PP_Var is a
+// pointer to a VarObject that is destroyed when its last reference goes away.
+
+#ifndef HOST_PPAPI_VAR_TRACKER_H_
+#define HOST_PPAPI_VAR_TRACKER_H_
+
+#include <stdint.h>
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include "ppapi/c/pp_var.h"
+#include "ppapi/cpp/var.h"
+
+namespace pp {
+namespace host {
+
+class VarObject {
+ public:
+  explicit VarObject(PP_VarType type);
+  virtual ~VarObject();
+
+  inline PP_VarType type() const { return type_; }
+
+  void AddRef();
+  // Returns true if the last reference was released.
+  bool Release();
+
+ private:
+  VarObject(const VarObject&);
+  VarObject& operator=(const VarObject&);
+
+  PP_VarType type_;
+  volatile int32_t ref_count_;
+};
+
+class StringVar : public VarObject {
+ public:
+  explicit StringVar(const std::string& value)
+      : VarObject(PP_VARTYPE_STRING), value_(value) {}
+
+  inline const std::string& value() const { return value_; }
+
+ private:
+  std::string value_;
+};
+
+class ArrayVar : public VarObject {
+ public:
+  ArrayVar() : VarObject(PP_VARTYPE_ARRAY) {}
+
+  inline std::vector<Var>& elements() { return elements_; }
+
+ private:
+  std::vector<Var> elements_;
+};
+
+class DictionaryVar : public VarObject {
+ public:
+  typedef std::map<std::string, Var> KeyValueMap;
+
+  DictionaryVar() : VarObject(PP_VARTYPE_DICTIONARY) {}
+
+  inline KeyValueMap& key_value_map() { return key_value_map_; }
+
+ private:
+  KeyValueMap key_value_map_;
+};
+
+class ArrayBufferVar : public VarObject {
+ public:
+  explicit ArrayBufferVar(uint32_t size_in_bytes)
+      : VarObject(PP_VARTYPE_ARRAY_BUFFER), data_(size_in_bytes) {}
+
+  inline std::vector<uint8_t>& data() { return data_; }
+
+ private:
+  std::vector<uint8_t> data_;
+};
+
+class VarTracker {
+ public:
+  // Creates a new reference counted var holding one reference.
+  static PP_Var MakeVar(VarObject* object);
+
+  static bool IsRefCounted(const PP_Var& var);
+  static void AddRefVar(const PP_Var& var);
+  static void ReleaseVar(const PP_Var& var);
+
+  static VarObject* GetVarObject(const PP_Var& var);
+
+  static StringVar* GetStringVar(const PP_Var& var);
+  static ArrayVar* GetArrayVar(const PP_Var& var);
+  static DictionaryVar* GetDictionaryVar(const PP_Var& var);
+  static ArrayBufferVar* GetArrayBufferVar(const PP_Var& var);
+
+  // Number of reference counted vars currently alive.  Used by tests to check
+  // for leaked references.
+  static int32_t GetLiveObjectCount();
+
+ private:
+  friend class VarObject;
+
+  static volatile int32_t live_object_count_;
+};
+
+}  // namespace host
+}  // namespace pp
+
+#endif  // HOST_PPAPI_VAR_TRACKER_H_
@@ -0,0 +1,352 @@
+/**
+ * Autogenerated by Thrift Compiler (0.9.1)
+ *
+ * DO NOT EDIT UNLESS YOU ARE SURE THAT YOU KNOW WHAT YOU ARE DOING
+ *  @generated
+ */
+#ifndef TestService_H
+#define TestService_H
+
+#include <thrift/TDispatchProcessor.h>
+#include "thrift_nacl_test_types.h"
+
+
+
+class TestServiceIf {
+ public:
+  virtual ~TestServiceIf() {}
+  virtual void echo(String& _return, const String& s) = 0;
+  virtual void ping(const int32_t value) = 0;
+};
+
+class TestServiceIfFactory {
+ public:
+  typedef TestServiceIf Handler;
+
+  virtual ~TestServiceIfFactory() {}
+
+  virtual TestServiceIf* getHandler(const ::apache::thrift::TConnectionInfo& connInfo) = 0;
+  virtual void releaseHandler(TestServiceIf* /* handler */) = 0;
+};
+
+class TestServiceIfSingletonFactory : virtual public TestServiceIfFactory {
+ public:
+  TestServiceIfSingletonFactory(const boost::shared_ptr<TestServiceIf>& iface) : iface_(iface) {}
+  virtual ~TestServiceIfSingletonFactory() {}
+
+  virtual TestServiceIf* getHandler(const ::apache::thrift::TConnectionInfo&) {
+    return iface_.get();
+  }
+  virtual void releaseHandler(TestServiceIf* /* handler */) {}
+
+ protected:
+  boost::shared_ptr<TestServiceIf> iface_;
+};
+
+class TestServiceNull : virtual public TestServiceIf {
+ public:
+  virtual ~TestServiceNull() {}
+  void echo(String& /* _return */, const String& /* s */) {
+    return;
+  }
+  void ping(const int32_t /* value */) {
+    return;
+  }
+};
+
+typedef struct _TestService_echo_args__isset {
+  _TestService_echo_args__isset() : s(false) {}
+  bool s;
+} _TestService_echo_args__isset;
+
+class TestService_echo_args : public ::apache::thrift::TStruct {
+ public:
+
+  TestService_echo_args() {
+  }
+
+  virtual ~TestService_echo_args() throw() {}
+
+
+  inline const String& get_s() const {
+    return s;
+  }
+
+  inline void set_s(const String& val) {
+    s = val;
+  }
+
+  inline String* mutable_s() {
+    return &s;
+  }
+
+  bool operator == (const TestService_echo_args & rhs) const
+  {
+    if (!(s == rhs.s))
+      return false;
+    return true;
+  }
+  bool operator != (const TestService_echo_args &rhs) const {
+    return !(*this == rhs);
+  }
+
+  bool operator < (const TestService_echo_args & ) const;
+
+  virtual uint32_t read(::apache::thrift::protocol::TProtocol* iprot);
+  virtual uint32_t write(::apache::thrift::protocol::TProtocol* oprot) const;
+
+  static const apache::thrift::protocol::TFieldTypeSpec field_types[];
+  static const apache::thrift::protocol::TFieldTypeSpec* get_field_type(const std::string& fname);
+
+  String s;
+
+  _TestService_echo_args__isset __isset;
+};
+
+
+class TestService_echo_pargs {
+ public:
+
+
+  virtual ~TestService_echo_pargs() throw() {}
+
+
+  virtual uint32_t write(::apache::thrift::protocol::TProtocol* oprot) const;
+
+  static const apache::thrift::protocol::TFieldTypeSpec field_types[];
+  static const apache::thrift::protocol::TFieldTypeSpec* get_field_type(const std::string& fname);
+
+  const String* s;
+};
+
+typedef struct _TestService_echo_result__isset {
+  _TestService_echo_result__isset() : success(false) {}
+  bool success;
+} _TestService_echo_result__isset;
+
+class TestService_echo_result : public ::apache::thrift::TStruct {
+ public:
+
+  TestService_echo_result() {
+  }
+
+  virtual ~TestService_echo_result() throw() {}
+
+
+  inline const String& get_success() const {
+    return success;
+  }
+
+  inline void set_success(const String& val) {
+    success = val;
+  }
+
+  inline String* mutable_success() {
+    return &success;
+  }
+
+  bool operator == (const TestService_echo_result & rhs) const
+  {
+    if (!(success == rhs.success))
+      return false;
+    return true;
+  }
+  bool operator != (const TestService_echo_result &rhs) const {
+    return !(*this == rhs);
+  }
+
+  bool operator < (const TestService_echo_result & ) const;
+
+  virtual uint32_t read(::apache::thrift::protocol::TProtocol* iprot);
+  virtual uint32_t write(::apache::thrift::protocol::TProtocol* oprot) const;
+
+  static const apache::thrift::protocol::TFieldTypeSpec field_types[];
+  static const apache::thrift::protocol::TFieldTypeSpec* get_field_type(const std::string& fname);
+
+  String success;
+
+  _TestService_echo_result__isset __isset;
+};
+
+typedef struct _TestService_echo_presult__isset {
+  _TestService_echo_presult__isset() : success(false) {}
+  bool success;
+} _TestService_echo_presult__isset;
+
+class TestService_echo_presult {
+ public:
+
+
+  virtual ~TestService_echo_presult() throw() {}
+
+
+  virtual uint32_t read(::apache::thrift::protocol::TProtocol* iprot);
+
+  static const apache::thrift::protocol::TFieldTypeSpec field_types[];
+  static const apache::thrift::protocol::TFieldTypeSpec* get_field_type(const std::string& fname);
+
+  String* success;
+
+  _TestService_echo_presult__isset __isset;
+};
+
+typedef struct _TestService_ping_args__isset {
+  _TestService_ping_args__isset() : value(false) {}
+  bool value;
+} _TestService_ping_args__isset;
+
+class TestService_ping_args : public ::apache::thrift::TStruct {
+ public:
+
+  TestService_ping_args() : value(0) {
+  }
+
+  virtual ~TestService_ping_args() throw() {}
+
+
+  inline const int32_t get_value() const {
+    return value;
+  }
+
+  inline void set_value(const int32_t val) {
+    value = val;
+  }
+
+  bool operator == (const TestService_ping_args & rhs) const
+  {
+    if (!(value == rhs.value))
+      return false;
+    return true;
+  }
+  bool operator != (const TestService_ping_args &rhs) const {
+    return !(*this == rhs);
+  }
+
+  bool operator < (const TestService_ping_args & ) const;
+
+  virtual uint32_t read(::apache::thrift::protocol::TProtocol* iprot);
+  virtual uint32_t write(::apache::thrift::protocol::TProtocol* oprot) const;
+
+  static const apache::thrift::protocol::TFieldTypeSpec field_types[];
+  static const apache::thrift::protocol::TFieldTypeSpec* get_field_type(const std::string& fname);
+
+  int32_t value;
+
+  _TestService_ping_args__isset __isset;
+};
+
+
+class TestService_ping_pargs {
+ public:
+
+
+  virtual ~TestService_ping_pargs() throw() {}
+
+
+  virtual uint32_t write(::apache::thrift::protocol::TProtocol* oprot) const;
+
+  static const apache::thrift::protocol::TFieldTypeSpec field_types[];
+  static const apache::thrift::protocol::TFieldTypeSpec* get_field_type(const std::string& fname);
+
+  const int32_t* value;
+};
+
+class TestServiceClient : virtual public TestServiceIf {
+ public:
+  TestServiceClient(boost::shared_ptr< ::apache::thrift::protocol::TProtocol> prot) :
+    piprot_(prot),
+    poprot_(prot) {
+    iprot_ = prot.get();
+    oprot_ = prot.get();
+  }
+  TestServiceClient(boost::shared_ptr< ::apache::thrift::protocol::TProtocol> iprot, boost::shared_ptr< ::apache::thrift::protocol::TProtocol> oprot) :
+    piprot_(iprot),
+    poprot_(oprot) {
+    iprot_ = iprot.get();
+    oprot_ = oprot.get();
+  }
+  boost::shared_ptr< ::apache::thrift::protocol::TProtocol> getInputProtocol() {
+    return piprot_;
+  }
+  boost::shared_ptr< ::apache::thrift::protocol::TProtocol> getOutputProtocol() {
+    return poprot_;
+  }
+  void echo(String& _return, const String& s);
+  void send_echo(const String& s);
+  void recv_echo(String& _return);
+  void ping(const int32_t value);
+  void send_ping(const int32_t value);
+ protected:
+  boost::shared_ptr< ::apache::thrift::protocol::TProtocol> piprot_;
+  boost::shared_ptr< ::apache::thrift::protocol::TProtocol> poprot_;
+  ::apache::thrift::protocol::TProtocol* iprot_;
+  ::apache::thrift::protocol::TProtocol* oprot_;
+};
+
+class TestServiceProcessor : public ::apache::thrift::TDispatchProcessor {
+ protected:
+  boost::shared_ptr<TestServiceIf> iface_;
+  virtual bool dispatchCall(::apache::thrift::protocol::TProtocol* iprot, ::apache::thrift::protocol::TProtocol* oprot, const std::string& fname, int32_t seqid, void* callContext);
+ private:
+  typedef  void (TestServiceProcessor::*ProcessFunction)(int32_t, ::apache::thrift::protocol::TProtocol*, ::apache::thrift::protocol::TProtocol*, void*);
+  typedef std::map<std::string, ProcessFunction> ProcessMap;
+  ProcessMap processMap_;
+  void process_echo(int32_t seqid, ::apache::thrift::protocol::TProtocol* iprot, ::apache::thrift::protocol::TProtocol* oprot, void* callContext);
+  void process_ping(int32_t seqid, ::apache::thrift::protocol::TProtocol* iprot, ::apache::thrift::protocol::TProtocol* oprot, void* callContext);
+ public:
+  TestServiceProcessor(boost::shared_ptr<TestServiceIf> iface) :
+    iface_(iface) {
+    processMap_["echo"] = &TestServiceProcessor::process_echo;
+    processMap_["ping"] = &TestServiceProcessor::process_ping;
+  }
+
+  virtual ~TestServiceProcessor() {}
+};
+
+class TestServiceProcessorFactory : public ::apache::thrift::TProcessorFactory {
+ public:
+  TestServiceProcessorFactory(const ::boost::shared_ptr< TestServiceIfFactory >& handlerFactory) :
+      handlerFactory_(handlerFactory) {}
+
+  ::boost::shared_ptr< ::apache::thrift::TProcessor > getProcessor(const ::apache::thrift::TConnectionInfo& connInfo);
+
+ protected:
+  ::boost::shared_ptr< TestServiceIfFactory > handlerFactory_;
+};
+
+class TestServiceMultiface : virtual public TestServiceIf {
+ public:
+  TestServiceMultiface(std::vector<boost::shared_ptr<TestServiceIf> >& ifaces) : ifaces_(ifaces) {
+  }
+  virtual ~TestServiceMultiface() {}
+ protected:
+  std::vector<boost::shared_ptr<TestServiceIf> > ifaces_;
+  TestServiceMultiface() {}
+  void add(boost::shared_ptr<TestServiceIf> iface) {
+    ifaces_.push_back(iface);
+  }
+ public:
+  void echo(String& _return, const String& s) {
+    size_t sz = ifaces_.size();
+    size_t i = 0;
+    for (; i < (sz - 1); ++i) {
+      ifaces_[i]->echo(_return, s);
+    }
+    ifaces_[i]->echo(_return, s);
+    return;
+  }
+
+  void ping(const int32_t value) {
+    size_t sz = ifaces_.size();
+    size_t i = 0;
+    for (; i < (sz - 1); ++i) {
+      ifaces_[i]->ping(value);
+    }
+    ifaces_[i]->ping(value);
+  }
+
+};
+
+
+
+#endif
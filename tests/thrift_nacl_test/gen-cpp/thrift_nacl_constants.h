@@ -0,0 +1,24 @@
+/**
+ * Autogenerated by Thrift Compiler (0.9.1)
+ *
+ * DO NOT EDIT UNLESS YOU ARE SURE THAT YOU KNOW WHAT YOU ARE DOING
+ *  @generated
+ */
+#ifndef thrift_nacl_CONSTANTS_H
+#define thrift_nacl_CONSTANTS_H
+
+#include "thrift_nacl_types.h"
+
+
+
+class thrift_naclConstants {
+ public:
+  thrift_naclConstants();
+
+};
+
+extern const thrift_naclConstants g_thrift_nacl_constants;
+
+
+
+#endif
@@ -0,0 +1,17 @@
+/**
+ * Autogenerated by Thrift Compiler (0.9.1)
+ *
+ * DO NOT EDIT UNLESS YOU ARE SURE THAT YOU KNOW WHAT YOU ARE DOING
+ *  @generated
+ */
+#include "thrift_nacl_test_constants.h"
+
+
+
+const thrift_nacl_testConstants g_thrift_nacl_test_constants;
+
+thrift_nacl_testConstants::thrift_nacl_testConstants() {
+}
+
+
+
@@ -0,0 +1,24 @@
+/**
+ * Autogenerated by Thrift Compiler (0.9.1)
+ *
+ * DO NOT EDIT UNLESS YOU ARE SURE THAT YOU KNOW WHAT YOU ARE DOING
+ *  @generated
+ */
+#ifndef thrift_nacl_test_CONSTANTS_H
+#define thrift_nacl_test_CONSTANTS_H
+
+#include "thrift_nacl_test_types.h"
+
+
+
+class thrift_nacl_testConstants {
+ public:
+  thrift_nacl_testConstants();
+
+};
+
+extern const thrift_nacl_testConstants g_thrift_nacl_test_constants;
+
+
+
+#endif
@@ -0,0 +1,1565 @@
+/**
+ * Autogenerated by Thrift Compiler (0.9.1)
+ *
+ * DO NOT EDIT UNLESS YOU ARE SURE THAT YOU KNOW WHAT YOU ARE DOING
+ *  @generated
+ */
+#include "thrift_nacl_test_types.h"
+
+#include <algorithm>
+
+
+
+const char* Boolean::ascii_fingerprint = "BF054652DEF86253C2BEE7D947F167DD";
+const uint8_t Boolean::binary_fingerprint[16] = {0xBF,0x05,0x46,0x52,0xDE,0xF8,0x62,0x53,0xC2,0xBE,0xE7,0xD9,0x47,0xF1,0x67,0xDD};
+
+using ::apache::thrift::protocol::TFieldTypeSpec;
+
+/* static */
+const TFieldTypeSpec Boolean::field_types[] = {
+  {1, ::apache::thrift::protocol::T_BOOL, "value"},
+};
+
+/* static */
+const TFieldTypeSpec* Boolean::get_field_type(const std::string& fname) {
+  switch (fname.size()) {
+    case 5:
+      if (memcmp(fname.data(), "value", 5) == 0) return &field_types[0];
+      break;
+  }
+  return NULL;
+}
+
+uint32_t Boolean::read(::apache::thrift::protocol::TProtocol* iprot) {
+
+  uint32_t xfer = 0;
+  std::string fname;
+  ::apache::thrift::protocol::TType ftype;
+  int16_t fid;
+
+  iprot->setNextStructFields(field_types, 1);
+  xfer += iprot->readStructBegin(fname);
+
+  using ::apache::thrift::protocol::TProtocolException;
+
+
+  while (true)
+  {
+    xfer += iprot->readFieldBegin(fname, ftype, fid);
+    if (ftype == ::apache::thrift::protocol::T_STOP) {
+      break;
+    }
+    if (fid == ::apache::thrift::protocol::kFieldIdUnknown) {
+      const TFieldTypeSpec* field_type = get_field_type(fname);
+      if (field_type != NULL) {
+        fid = field_type->fid;
+        ftype = field_type->ftype;
+      }
+    }
+    switch (fid)
+    {
+      case 1:
+        if (ftype == ::apache::thrift::protocol::T_BOOL) {
+          xfer += iprot->readBool(this->value);
+          this->__isset.value = true;
+        } else {
+          xfer += iprot->skip(ftype);
+        }
+        break;
+      default:
+        xfer += iprot->skip(ftype);
+        break;
+    }
+    xfer += iprot->readFieldEnd();
+  }
+
+  xfer += iprot->readStructEnd();
+
+  return xfer;
+}
+
+uint32_t Boolean::write(::apache::thrift::protocol::TProtocol* oprot) const {
+  uint32_t xfer = 0;
+  xfer += oprot->writeStructBegin("Boolean");
+
+  if (this->__isset.value) {
+    xfer += oprot->writeFieldBegin("value", ::apache::thrift::protocol::T_BOOL, 1);
+    xfer += oprot->writeBool(this->value);
+    xfer += oprot->writeFieldEnd();
+  }
+  xfer += oprot->writeFieldStop();
+  xfer += oprot->writeStructEnd();
+  return xfer;
+}
+
+void swap(Boolean &a, Boolean &b) {
+  using ::std::swap;
+  swap(a.value, b.value);
+  swap(a.__isset, b.__isset);
+}
+
+const bool BooleanView::get_value() const {
+  if (!loaded_.value) {
+    ::apache::thrift::protocol::TProtocol* iprot = beginField(Boolean::field_types[0].name);
+    if (iprot != NULL) {
+      uint32_t xfer = 0;
+      xfer += iprot->readBool(this->value_.value);
+      (void) xfer;
+      value_.__isset.value = true;
+    }
+    loaded_.value = true;
+  }
+  return value_.value;
+}
+
+const char* Number::ascii_fingerprint = "AC34B2E1B97E5B4320CB6D16FFD88EBA";
+const uint8_t Number::binary_fingerprint[16] = {0xAC,0x34,0xB2,0xE1,0xB9,0x7E,0x5B,0x43,0x20,0xCB,0x6D,0x16,0xFF,0xD8,0x8E,0xBA};
+
+using ::apache::thrift::protocol::TFieldTypeSpec;
+
+/* static */
+const TFieldTypeSpec Number::field_types[] = {
+  {1, ::apache::thrift::protocol::T_BYTE, "i8_value"},
+  {2, ::apache::thrift::protocol::T_I16, "i16_value"},
+  {3, ::apache::thrift::protocol::T_I32, "i32_value"},
+  {4, ::apache::thrift::protocol::T_I64, "i64_value"},
+  {5, ::apache::thrift::protocol::T_DOUBLE, "double_value"},
+};
+
+/* static */
+const TFieldTypeSpec* Number::get_field_type(const std::string& fname) {
+  switch (fname.size()) {
+    case 8:
+      if (memcmp(fname.data(), "i8_value", 8) == 0) return &field_types[0];
+      break;
+    case 9:
+      if (memcmp(fname.data(), "i16_value", 9) == 0) return &field_types[1];
+      if (memcmp(fname.data(), "i32_value", 9) == 0) return &field_types[2];
+      if (memcmp(fname.data(), "i64_value", 9) == 0) return &field_types[3];
+      break;
+    case 12:
+      if (memcmp(fname.data(), "double_value", 12) == 0) return &field_types[4];
+      break;
+  }
+  return NULL;
+}
+
+uint32_t Number::read(::apache::thrift::protocol::TProtocol* iprot) {
+
+  uint32_t xfer = 0;
+  std::string fname;
+  ::apache::thrift::protocol::TType ftype;
+  int16_t fid;
+
+  iprot->setNextStructFields(field_types, 5);
+  xfer += iprot->readStructBegin(fname);
+
+  using ::apache::thrift::protocol::TProtocolException;
+
+
+  while (true)
+  {
+    xfer += iprot->readFieldBegin(fname, ftype, fid);
+    if (ftype == ::apache::thrift::protocol::T_STOP) {
+      break;
+    }
+    if (fid == ::apache::thrift::protocol::kFieldIdUnknown) {
+      const TFieldTypeSpec* field_type = get_field_type(fname);
+      if (field_type != NULL) {
+        fid = field_type->fid;
+        ftype = field_type->ftype;
+      }
+    }
+    switch (fid)
+    {
+      case 1:
+        if (ftype == ::apache::thrift::protocol::T_BYTE) {
+          xfer += iprot->readByte(this->i8_value);
+          this->__isset.i8_value = true;
+        } else {
+          xfer += iprot->skip(ftype);
+        }
+        break;
+      case 2:
+        if (ftype == ::apache::thrift::protocol::T_I16) {
+          xfer += iprot->readI16(this->i16_value);
+          this->__isset.i16_value = true;
+        } else {
+          xfer += iprot->skip(ftype);
+        }
+        break;
+      case 3:
+        if (ftype == ::apache::thrift::protocol::T_I32) {
+          xfer += iprot->readI32(this->i32_value);
+          this->__isset.i32_value = true;
+        } else {
+          xfer += iprot->skip(ftype);
+        }
+        break;
+      case 4:
+        if (ftype == ::apache::thrift::protocol::T_I64) {
+          xfer += iprot->readI64(this->i64_value);
+          this->__isset.i64_value = true;
+        } else {
+          xfer += iprot->skip(ftype);
+        }
+        break;
+      case 5:
+        if (ftype == ::apache::thrift::protocol::T_DOUBLE) {
+          xfer += iprot->readDouble(this->double_value);
+          this->__isset.double_value = true;
+        } else {
+          xfer += iprot->skip(ftype);
+        }
+        break;
+      default:
+        xfer += iprot->skip(ftype);
+        break;
+    }
+    xfer += iprot->readFieldEnd();
+  }
+
+  xfer += iprot->readStructEnd();
+
+  return xfer;
+}
+
+uint32_t Number::write(::apache::thrift::protocol::TProtocol* oprot) const {
+  uint32_t xfer = 0;
+  xfer += oprot->writeStructBegin("Number");
+
+  if (this->__isset.i8_value) {
+    xfer += oprot->writeFieldBegin("i8_value", ::apache::thrift::protocol::T_BYTE, 1);
+    xfer += oprot->writeByte(this->i8_value);
+    xfer += oprot->writeFieldEnd();
+  }
+  if (this->__isset.i16_value) {
+    xfer += oprot->writeFieldBegin("i16_value", ::apache::thrift::protocol::T_I16, 2);
+    xfer += oprot->writeI16(this->i16_value);
+    xfer += oprot->writeFieldEnd();
+  }
+  if (this->__isset.i32_value) {
+    xfer += oprot->writeFieldBegin("i32_value", ::apache::thrift::protocol::T_I32, 3);
+    xfer += oprot->writeI32(this->i32_value);
+    xfer += oprot->writeFieldEnd();
+  }
+  if (this->__isset.i64_value) {
+    xfer += oprot->writeFieldBegin("i64_value", ::apache::thrift::protocol::T_I64, 4);
+    xfer += oprot->writeI64(this->i64_value);
+    xfer += oprot->writeFieldEnd();
+  }
+  if (this->__isset.double_value) {
+    xfer += oprot->writeFieldBegin("double_value", ::apache::thrift::protocol::T_DOUBLE, 5);
+    xfer += oprot->writeDouble(this->double_value);
+    xfer += oprot->writeFieldEnd();
+  }
+  xfer += oprot->writeFieldStop();
+  xfer += oprot->writeStructEnd();
+  return xfer;
+}
+
+void swap(Number &a, Number &b) {
+  using ::std::swap;
+  swap(a.i8_value, b.i8_value);
+  swap(a.i16_value, b.i16_value);
+  swap(a.i32_value, b.i32_value);
+  swap(a.i64_value, b.i64_value);
+  swap(a.double_value, b.double_value);
+  swap(a.__isset, b.__isset);
+}
+
+const int8_t NumberView::get_i8_value() const {
+  if (!loaded_.i8_value) {
+    ::apache::thrift::protocol::TProtocol* iprot = beginField(Number::field_types[0].name);
+    if (iprot != NULL) {
+      uint32_t xfer = 0;
+      xfer += iprot->readByte(this->value_.i8_value);
+      (void) xfer;
+      value_.__isset.i8_value = true;
+    }
+    loaded_.i8_value = true;
+  }
+  return value_.i8_value;
+}
+
+const int16_t NumberView::get_i16_value() const {
+  if (!loaded_.i16_value) {
+    ::apache::thrift::protocol::TProtocol* iprot = beginField(Number::field_types[1].name);
+    if (iprot != NULL) {
+      uint32_t xfer = 0;
+      xfer += iprot->readI16(this->value_.i16_value);
+      (void) xfer;
+      value_.__isset.i16_value = true;
+    }
+    loaded_.i16_value = true;
+  }
+  return value_.i16_value;
+}
+
+const int32_t NumberView::get_i32_value() const {
+  if (!loaded_.i32_value) {
+    ::apache::thrift::protocol::TProtocol* iprot = beginField(Number::field_types[2].name);
+    if (iprot != NULL) {
+      uint32_t xfer = 0;
+      xfer += iprot->readI32(this->value_.i32_value);
+      (void) xfer;
+      value_.__isset.i32_value = true;
+    }
+    loaded_.i32_value = true;
+  }
+  return value_.i32_value;
+}
+
+const int64_t NumberView::get_i64_value() const {
+  if (!loaded_.i64_value) {
+    ::apache::thrift::protocol::TProtocol* iprot = beginField(Number::field_types[3].name);
+    if (iprot != NULL) {
+      uint32_t xfer = 0;
+      xfer += iprot->readI64(this->value_.i64_value);
+      (void) xfer;
+      value_.__isset.i64_value = true;
+    }
+    loaded_.i64_value = true;
+  }
+  return value_.i64_value;
+}
+
+const double NumberView::get_double_value() const {
+  if (!loaded_.double_value) {
+    ::apache::thrift::protocol::TProtocol* iprot = beginField(Number::field_types[4].name);
+    if (iprot != NULL) {
+      uint32_t xfer = 0;
+      xfer += iprot->readDouble(this->value_.double_value);
+      (void) xfer;
+      value_.__isset.double_value = true;
+    }
+    loaded_.double_value = true;
+  }
+  return value_.double_value;
+}
+
+const char* BinaryData::ascii_fingerprint = "EFB929595D312AC8F305D5A794CFEDA1";
+const uint8_t BinaryData::binary_fingerprint[16] = {0xEF,0xB9,0x29,0x59,0x5D,0x31,0x2A,0xC8,0xF3,0x05,0xD5,0xA7,0x94,0xCF,0xED,0xA1};
+
+using ::apache::thrift::protocol::TFieldTypeSpec;
+
+/* static */
+const TFieldTypeSpec BinaryData::field_types[] = {
+  {1, ::apache::thrift::protocol::T_STRING, "data"},
+};
+
+/* static */
+const TFieldTypeSpec* BinaryData::get_field_type(const std::string& fname) {
+  switch (fname.size()) {
+    case 4:
+      if (memcmp(fname.data(), "data", 4) == 0) return &field_types[0];
+      break;
+  }
+  return NULL;
+}
+
+uint32_t BinaryData::read(::apache::thrift::protocol::TProtocol* iprot) {
+
+  uint32_t xfer = 0;
+  std::string fname;
+  ::apache::thrift::protocol::TType ftype;
+  int16_t fid;
+
+  iprot->setNextStructFields(field_types, 1);
+  xfer += iprot->readStructBegin(fname);
+
+  using ::apache::thrift::protocol::TProtocolException;
+
+
+  while (true)
+  {
+    xfer += iprot->readFieldBegin(fname, ftype, fid);
+    if (ftype == ::apache::thrift::protocol::T_STOP) {
+      break;
+    }
+    if (fid == ::apache::thrift::protocol::kFieldIdUnknown) {
+      const TFieldTypeSpec* field_type = get_field_type(fname);
+      if (field_type != NULL) {
+        fid = field_type->fid;
+        ftype = field_type->ftype;
+      }
+    }
+    switch (fid)
+    {
+      case 1:
+        if (ftype == ::apache::thrift::protocol::T_STRING) {
+          xfer += iprot->readBinary(this->data);
+          this->__isset.data = true;
+        } else {
+          xfer += iprot->skip(ftype);
+        }
+        break;
+      default:
+        xfer += iprot->skip(ftype);
+        break;
+    }
+    xfer += iprot->readFieldEnd();
+  }
+
+  xfer += iprot->readStructEnd();
+
+  return xfer;
+}
+
+uint32_t BinaryData::write(::apache::thrift::protocol::TProtocol* oprot) const {
+  uint32_t xfer = 0;
+  xfer += oprot->writeStructBegin("BinaryData");
+
+  xfer += oprot->writeFieldBegin("data", ::apache::thrift::protocol::T_STRING, 1);
+  xfer += oprot->writeBinary(this->data);
+  xfer += oprot->writeFieldEnd();
+
+  xfer += oprot->writeFieldStop();
+  xfer += oprot->writeStructEnd();
+  return xfer;
+}
+
+void swap(BinaryData &a, BinaryData &b) {
+  using ::std::swap;
+  swap(a.data, b.data);
+  swap(a.__isset, b.__isset);
+}
+
+const std::string& BinaryDataView::get_data() const {
+  if (!loaded_.data) {
+    ::apache::thrift::protocol::TProtocol* iprot = beginField(BinaryData::field_types[0].name);
+    if (iprot != NULL) {
+      uint32_t xfer = 0;
+      xfer += iprot->readBinary(this->value_.data);
+      (void) xfer;
+      value_.__isset.data = true;
+    }
+    loaded_.data = true;
+  }
+  return value_.data;
+}
+
+const char* Date::ascii_fingerprint = "A5D9FD141E77B608AA21FD4BD8487AC1";
+const uint8_t Date::binary_fingerprint[16] = {0xA5,0xD9,0xFD,0x14,0x1E,0x77,0xB6,0x08,0xAA,0x21,0xFD,0x4B,0xD8,0x48,0x7A,0xC1};
+
+using ::apache::thrift::protocol::TFieldTypeSpec;
+
+/* static */
+const TFieldTypeSpec Date::field_types[] = {
+  {1, ::apache::thrift::protocol::T_I32, "day"},
+  {2, ::apache::thrift::protocol::T_I32, "month"},
+  {3, ::apache::thrift::protocol::T_I32, "year"},
+};
+
+/* static */
+const TFieldTypeSpec* Date::get_field_type(const std::string& fname) {
+  switch (fname.size()) {
+    case 3:
+      if (memcmp(fname.data(), "day", 3) == 0) return &field_types[0];
+      break;
+    case 4:
+      if (memcmp(fname.data(), "year", 4) == 0) return &field_types[2];
+      break;
+    case 5:
+      if (memcmp(fname.data(), "month", 5) == 0) return &field_types[1];
+      break;
+  }
+  return NULL;
+}
+
+uint32_t Date::read(::apache::thrift::protocol::TProtocol* iprot) {
+
+  uint32_t xfer = 0;
+  std::string fname;
+  ::apache::thrift::protocol::TType ftype;
+  int16_t fid;
+
+  iprot->setNextStructFields(field_types, 3);
+  xfer += iprot->readStructBegin(fname);
+
+  using ::apache::thrift::protocol::TProtocolException;
+
+  bool isset_month = false;
+
+  while (true)
+  {
+    xfer += iprot->readFieldBegin(fname, ftype, fid);
+    if (ftype == ::apache::thrift::protocol::T_STOP) {
+      break;
+    }
+    if (fid == ::apache::thrift::protocol::kFieldIdUnknown) {
+      const TFieldTypeSpec* field_type = get_field_type(fname);
+      if (field_type != NULL) {
+        fid = field_type->fid;
+        ftype = field_type->ftype;
+      }
+    }
+    switch (fid)
+    {
+      case 1:
+        if (ftype == ::apache::thrift::protocol::T_I32) {
+          xfer += iprot->readI32(this->day);
+          this->__isset.day = true;
+        } else {
+          xfer += iprot->skip(ftype);
+        }
+        break;
+      case 2:
+        if (ftype == ::apache::thrift::protocol::T_I32) {
+          xfer += iprot->readI32(this->month);
+          isset_month = true;
+        } else {
+          xfer += iprot->skip(ftype);
+        }
+        break;
+      case 3:
+        if (ftype == ::apache::thrift::protocol::T_I32) {
+          xfer += iprot->readI32(this->year);
+          this->__isset.year = true;
+        } else {
+          xfer += iprot->skip(ftype);
+        }
+        break;
+      default:
+        xfer += iprot->skip(ftype);
+        break;
+    }
+    xfer += iprot->readFieldEnd();
+  }
+
+  xfer += iprot->readStructEnd();
+
+  if (!isset_month)
+    throw TProtocolException(TProtocolException::INVALID_DATA);
+  return xfer;
+}
+
+uint32_t Date::write(::apache::thrift::protocol::TProtocol* oprot) const {
+  uint32_t xfer = 0;
+  xfer += oprot->writeStructBegin("Date");
+
+  if (this->__isset.day) {
+    xfer += oprot->writeFieldBegin("day", ::apache::thrift::protocol::T_I32, 1);
+    xfer += oprot->writeI32(this->day);
+    xfer += oprot->writeFieldEnd();
+  }
+  xfer += oprot->writeFieldBegin("month", ::apache::thrift::protocol::T_I32, 2);
+  xfer += oprot->writeI32(this->month);
+  xfer += oprot->writeFieldEnd();
+
+  xfer += oprot->writeFieldBegin("year", ::apache::thrift::protocol::T_I32, 3);
+  xfer += oprot->writeI32(this->year);
+  xfer += oprot->writeFieldEnd();
+
+  xfer += oprot->writeFieldStop();
+  xfer += oprot->writeStructEnd();
+  return xfer;
+}
+
+void swap(Date &a, Date &b) {
+  using ::std::swap;
+  swap(a.day, b.day);
+  swap(a.month, b.month);
+  swap(a.year, b.year);
+  swap(a.__isset, b.__isset);
+}
+
+const int32_t DateView::get_day() const {
+  if (!loaded_.day) {
+    ::apache::thrift::protocol::TProtocol* iprot = beginField(Date::field_types[0].name);
+    if (iprot != NULL) {
+      uint32_t xfer = 0;
+      xfer += iprot->readI32(this->value_.day);
+      (void) xfer;
+      value_.__isset.day = true;
+    }
+    loaded_.day = true;
+  }
+  return value_.day;
+}
+
+const int32_t DateView::get_month() const {
+  if (!loaded_.month) {
+    ::apache::thrift::protocol::TProtocol* iprot = beginField(Date::field_types[1].name);
+    if (iprot != NULL) {
+      uint32_t xfer = 0;
+      xfer += iprot->readI32(this->value_.month);
+      (void) xfer;
+    }
+    loaded_.month = true;
+  }
+  return value_.month;
+}
+
+const int32_t DateView::get_year() const {
+  if (!loaded_.year) {
+    ::apache::thrift::protocol::TProtocol* iprot = beginField(Date::field_types[2].name);
+    if (iprot != NULL) {
+      uint32_t xfer = 0;
+      xfer += iprot->readI32(this->value_.year);
+      (void) xfer;
+      value_.__isset.year = true;
+    }
+    loaded_.year = true;
+  }
+  return value_.year;
+}
+
+const char* String::ascii_fingerprint = "EFB929595D312AC8F305D5A794CFEDA1";
+const uint8_t String::binary_fingerprint[16] = {0xEF,0xB9,0x29,0x59,0x5D,0x31,0x2A,0xC8,0xF3,0x05,0xD5,0xA7,0x94,0xCF,0xED,0xA1};
+
+using ::apache::thrift::protocol::TFieldTypeSpec;
+
+/* static */
+const TFieldTypeSpec String::field_types[] = {
+  {1, ::apache::thrift::protocol::T_STRING, "s"},
+};
+
+/* static */
+const TFieldTypeSpec* String::get_field_type(const std::string& fname) {
+  switch (fname.size()) {
+    case 1:
+      if (memcmp(fname.data(), "s", 1) == 0) return &field_types[0];
+      break;
+  }
+  return NULL;
+}
+
+uint32_t String::read(::apache::thrift::protocol::TProtocol* iprot) {
+
+  uint32_t xfer = 0;
+  std::string fname;
+  ::apache::thrift::protocol::TType ftype;
+  int16_t fid;
+
+  iprot->setNextStructFields(field_types, 1);
+  xfer += iprot->readStructBegin(fname);
+
+  using ::apache::thrift::protocol::TProtocolException;
+
+
+  while (true)
+  {
+    xfer += iprot->readFieldBegin(fname, ftype, fid);
+    if (ftype == ::apache::thrift::protocol::T_STOP) {
+      break;
+    }
+    if (fid == ::apache::thrift::protocol::kFieldIdUnknown) {
+      const TFieldTypeSpec* field_type = get_field_type(fname);
+      if (field_type != NULL) {
+        fid = field_type->fid;
+        ftype = field_type->ftype;
+      }
+    }
+    switch (fid)
+    {
+      case 1:
+        if (ftype == ::apache::thrift::protocol::T_STRING) {
+          xfer += iprot->readString(this->s);
+          this->__isset.s = true;
+        } else {
+          xfer += iprot->skip(ftype);
+        }
+        break;
+      default:
+        xfer += iprot->skip(ftype);
+        break;
+    }
+    xfer += iprot->readFieldEnd();
+  }
+
+  xfer += iprot->readStructEnd();
+
+  return xfer;
+}
+
+uint32_t String::write(::apache::thrift::protocol::TProtocol* oprot) const {
+  uint32_t xfer = 0;
+  xfer += oprot->writeStructBegin("String");
+
+  xfer += oprot->writeFieldBegin("s", ::apache::thrift::protocol::T_STRING, 1);
+  xfer += oprot->writeString(this->s);
+  xfer += oprot->writeFieldEnd();
+
+  xfer += oprot->writeFieldStop();
+  xfer += oprot->writeStructEnd();
+  return xfer;
+}
+
+void swap(String &a, String &b) {
+  using ::std::swap;
+  swap(a.s, b.s);
+  swap(a.__isset, b.__isset);
+}
+
+const std::string& StringView::get_s() const {
+  if (!loaded_.s) {
+    ::apache::thrift::protocol::TProtocol* iprot = beginField(String::field_types[0].name);
+    if (iprot != NULL) {
+      uint32_t xfer = 0;
+      xfer += iprot->readString(this->value_.s);
+      (void) xfer;
+      value_.__isset.s = true;
+    }
+    loaded_.s = true;
+  }
+  return value_.s;
+}
+
+const char* Person::ascii_fingerprint = "3BA7357570B3C4F61DB3DB3BCECE1C68";
+const uint8_t Person::binary_fingerprint[16] = {0x3B,0xA7,0x35,0x75,0x70,0xB3,0xC4,0xF6,0x1D,0xB3,0xDB,0x3B,0xCE,0xCE,0x1C,0x68};
+
+using ::apache::thrift::protocol::TFieldTypeSpec;
+
+/* static */
+const TFieldTypeSpec Person::field_types[] = {
+  {1, ::apache::thrift::protocol::T_STRING, "name"},
+  {2, ::apache::thrift::protocol::T_DOUBLE, "weight"},
+  {3, ::apache::thrift::protocol::T_STRUCT, "birthday"},
+  {4, ::apache::thrift::protocol::T_MAP, "dict"},
+  {5, ::apache::thrift::protocol::T_LIST, "objlist"},
+  {6, ::apache::thrift::protocol::T_MAP, "objdict"},
+  {7, ::apache::thrift::protocol::T_SET, "params"},
+  {8, ::apache::thrift::protocol::T_STRING, "b"},
+};
+
+/* static */
+const TFieldTypeSpec* Person::get_field_type(const std::string& fname) {
+  switch (fname.size()) {
+    case 1:
+      if (memcmp(fname.data(), "b", 1) == 0) return &field_types[7];
+      break;
+    case 4:
+      if (memcmp(fname.data(), "name", 4) == 0) return &field_types[0];
+      if (memcmp(fname.data(), "dict", 4) == 0) return &field_types[3];
+      break;
+    case 6:
+      if (memcmp(fname.data(), "weight", 6) == 0) return &field_types[1];
+      if (memcmp(fname.data(), "params", 6) == 0) return &field_types[6];
+      break;
+    case 7:
+      if (memcmp(fname.data(), "objlist", 7) == 0) return &field_types[4];
+      if (memcmp(fname.data(), "objdict", 7) == 0) return &field_types[5];
+      break;
+    case 8:
+      if (memcmp(fname.data(), "birthday", 8) == 0) return &field_types[2];
+      break;
+  }
+  return NULL;
+}
+
+uint32_t Person::read(::apache::thrift::protocol::TProtocol* iprot) {
+
+  uint32_t xfer = 0;
+  std::string fname;
+  ::apache::thrift::protocol::TType ftype;
+  int16_t fid;
+
+  iprot->setNextStructFields(field_types, 8);
+  xfer += iprot->readStructBegin(fname);
+
+  using ::apache::thrift::protocol::TProtocolException;
+
+
+  while (true)
+  {
+    xfer += iprot->readFieldBegin(fname, ftype, fid);
+    if (ftype == ::apache::thrift::protocol::T_STOP) {
+      break;
+    }
+    if (fid == ::apache::thrift::protocol::kFieldIdUnknown) {
+      const TFieldTypeSpec* field_type = get_field_type(fname);
+      if (field_type != NULL) {
+        fid = field_type->fid;
+        ftype = field_type->ftype;
+      }
+    }
+    switch (fid)
+    {
+      case 1:
+        if (ftype == ::apache::thrift::protocol::T_STRING) {
+          xfer += iprot->readString(this->name);
+          this->__isset.name = true;
+        } else {
+          xfer += iprot->skip(ftype);
+        }
+        break;
+      case 2:
+        if (ftype == ::apache::thrift::protocol::T_DOUBLE) {
+          xfer += iprot->readDouble(this->weight);
+          this->__isset.weight = true;
+        } else {
+          xfer += iprot->skip(ftype);
+        }
+        break;
+      case 3:
+        if (ftype == ::apache::thrift::protocol::T_STRUCT) {
+          xfer += this->birthday.read(iprot);
+          this->__isset.birthday = true;
+        } else {
+          xfer += iprot->skip(ftype);
+        }
+        break;
+      case 4:
+        if (ftype == ::apache::thrift::protocol::T_MAP) {
+          {
+            this->dict.clear();
+            uint32_t _size0;
+            ::apache::thrift::protocol::TType _ktype1;
+            ::apache::thrift::protocol::TType _vtype2;
+            xfer += iprot->readMapBegin(_ktype1, _vtype2, _size0);
+            uint32_t _i4;
+            for (_i4 = 0; _i4 < _size0; ++_i4)
+            {
+              std::string _key5;
+              xfer += iprot->readString(_key5);
+              int32_t& _val6 = this->dict[_key5];
+              xfer += iprot->readI32(_val6);
+            }
+            xfer += iprot->readMapEnd();
+          }
+          this->__isset.dict = true;
+        } else {
+          xfer += iprot->skip(ftype);
+        }
+        break;
+      case 5:
+        if (ftype == ::apache::thrift::protocol::T_LIST) {
+          {
+            this->objlist.clear();
+            uint32_t _size7;
+            ::apache::thrift::protocol::TType _etype10;
+            xfer += iprot->readListBegin(_etype10, _size7);
+            this->objlist.resize(_size7);
+            uint32_t _i11;
+            for (_i11 = 0; _i11 < _size7; ++_i11)
+            {
+              xfer += this->objlist[_i11].read(iprot);
+            }
+            xfer += iprot->readListEnd();
+          }
+          this->__isset.objlist = true;
+        } else {
+          xfer += iprot->skip(ftype);
+        }
+        break;
+      case 6:
+        if (ftype == ::apache::thrift::protocol::T_MAP) {
+          {
+            this->objdict.clear();
+            uint32_t _size12;
+            ::apache::thrift::protocol::TType _ktype13;
+            ::apache::thrift::protocol::TType _vtype14;
+            xfer += iprot->readMapBegin(_ktype13, _vtype14, _size12);
+            uint32_t _i16;
+            for (_i16 = 0; _i16 < _size12; ++_i16)
+            {
+              std::string _key17;
+              xfer += iprot->readString(_key17);
+              String& _val18 = this->objdict[_key17];
+              xfer += _val18.read(iprot);
+            }
+            xfer += iprot->readMapEnd();
+          }
+          this->__isset.objdict = true;
+        } else {
+          xfer += iprot->skip(ftype);
+        }
+        break;
+      case 7:
+        if (ftype == ::apache::thrift::protocol::T_SET) {
+          {
+            this->params.clear();
+            uint32_t _size19;
+            ::apache::thrift::protocol::TType _etype22;
+            xfer += iprot->readSetBegin(_etype22, _size19);
+            uint32_t _i23;
+            for (_i23 = 0; _i23 < _size19; ++_i23)
+            {
+              std::string _elem24;
+              xfer += iprot->readString(_elem24);
+              this->params.insert(_elem24);
+            }
+            xfer += iprot->readSetEnd();
+          }
+          this->__isset.params = true;
+        } else {
+          xfer += iprot->skip(ftype);
+        }
+        break;
+      case 8:
+        if (ftype == ::apache::thrift::protocol::T_STRING) {
+          xfer += iprot->readBinary(this->b);
+          this->__isset.b = true;
+        } else {
+          xfer += iprot->skip(ftype);
+        }
+        break;
+      default:
+        xfer += iprot->skip(ftype);
+        break;
+    }
+    xfer += iprot->readFieldEnd();
+  }
+
+  xfer += iprot->readStructEnd();
+
+  return xfer;
+}
+
+uint32_t Person::write(::apache::thrift::protocol::TProtocol* oprot) const {
+  uint32_t xfer = 0;
+  xfer += oprot->writeStructBegin("Person");
+
+  if (this->__isset.name) {
+    xfer += oprot->writeFieldBegin("name", ::apache::thrift::protocol::T_STRING, 1);
+    xfer += oprot->writeString(this->name);
+    xfer += oprot->writeFieldEnd();
+  }
+  xfer += oprot->writeFieldBegin("weight", ::apache::thrift::protocol::T_DOUBLE, 2);
+  xfer += oprot->writeDouble(this->weight);
+  xfer += oprot->writeFieldEnd();
+
+  xfer += oprot->writeFieldBegin("birthday", ::apache::thrift::protocol::T_STRUCT, 3);
+  xfer += this->birthday.write(oprot);
+  xfer += oprot->writeFieldEnd();
+
+  xfer += oprot->writeFieldBegin("dict", ::apache::thrift::protocol::T_MAP, 4);
+  {
+    xfer += oprot->writeMapBegin(::apache::thrift::protocol::T_STRING, ::apache::thrift::protocol::T_I32, static_cast<uint32_t>(this->dict.size()));
+    std::map<std::string, int32_t> ::const_iterator _iter25;
+    for (_iter25 = this->dict.begin(); _iter25 != this->dict.end(); ++_iter25)
+    {
+      xfer += oprot->writeString(_iter25->first);
+      xfer += oprot->writeI32(_iter25->second);
+    }
+    xfer += oprot->writeMapEnd();
+  }
+  xfer += oprot->writeFieldEnd();
+
+  xfer += oprot->writeFieldBegin("objlist", ::apache::thrift::protocol::T_LIST, 5);
+  {
+    xfer += oprot->writeListBegin(::apache::thrift::protocol::T_STRUCT, static_cast<uint32_t>(this->objlist.size()));
+    std::vector<String> ::const_iterator _iter26;
+    for (_iter26 = this->objlist.begin(); _iter26 != this->objlist.end(); ++_iter26)
+    {
+      xfer += (*_iter26).write(oprot);
+    }
+    xfer += oprot->writeListEnd();
+  }
+  xfer += oprot->writeFieldEnd();
+
+  xfer += oprot->writeFieldBegin("objdict", ::apache::thrift::protocol::T_MAP, 6);
+  {
+    xfer += oprot->writeMapBegin(::apache::thrift::protocol::T_STRING, ::apache::thrift::protocol::T_STRUCT, static_cast<uint32_t>(this->objdict.size()));
+    std::map<std::string, String> ::const_iterator _iter27;
+    for (_iter27 = this->objdict.begin(); _iter27 != this->objdict.end(); ++_iter27)
+    {
+      xfer += oprot->writeString(_iter27->first);
+      xfer += _iter27->second.write(oprot);
+    }
+    xfer += oprot->writeMapEnd();
+  }
+  xfer += oprot->writeFieldEnd();
+
+  xfer += oprot->writeFieldBegin("params", ::apache::thrift::protocol::T_SET, 7);
+  {
+    xfer += oprot->writeSetBegin(::apache::thrift::protocol::T_STRING, static_cast<uint32_t>(this->params.size()));
+    std::set<std::string> ::const_iterator _iter28;
+    for (_iter28 = this->params.begin(); _iter28 != this->params.end(); ++_iter28)
+    {
+      xfer += oprot->writeString((*_iter28));
+    }
+    xfer += oprot->writeSetEnd();
+  }
+  xfer += oprot->writeFieldEnd();
+
+  xfer += oprot->writeFieldBegin("b", ::apache::thrift::protocol::T_STRING, 8);
+  xfer += oprot->writeBinary(this->b);
+  xfer += oprot->writeFieldEnd();
+
+  xfer += oprot->writeFieldStop();
+  xfer += oprot->writeStructEnd();
+  return xfer;
+}
+
+void swap(Person &a, Person &b) {
+  using ::std::swap;
+  swap(a.name, b.name);
+  swap(a.weight, b.weight);
+  swap(a.birthday, b.birthday);
+  swap(a.dict, b.dict);
+  swap(a.objlist, b.objlist);
+  swap(a.objdict, b.objdict);
+  swap(a.params, b.params);
+  swap(a.b, b.b);
+  swap(a.__isset, b.__isset);
+}
+
+const std::string& PersonView::get_name() const {
+  if (!loaded_.name) {
+    ::apache::thrift::protocol::TProtocol* iprot = beginField(Person::field_types[0].name);
+    if (iprot != NULL) {
+      uint32_t xfer = 0;
+      xfer += iprot->readString(this->value_.name);
+      (void) xfer;
+      value_.__isset.name = true;
+    }
+    loaded_.name = true;
+  }
+  return value_.name;
+}
+
+const double PersonView::get_weight() const {
+  if (!loaded_.weight) {
+    ::apache::thrift::protocol::TProtocol* iprot = beginField(Person::field_types[1].name);
+    if (iprot != NULL) {
+      uint32_t xfer = 0;
+      xfer += iprot->readDouble(this->value_.weight);
+      (void) xfer;
+      value_.__isset.weight = true;
+    }
+    loaded_.weight = true;
+  }
+  return value_.weight;
+}
+
+const Date& PersonView::get_birthday() const {
+  if (!loaded_.birthday) {
+    ::apache::thrift::protocol::TProtocol* iprot = beginField(Person::field_types[2].name);
+    if (iprot != NULL) {
+      uint32_t xfer = 0;
+      xfer += this->value_.birthday.read(iprot);
+      (void) xfer;
+      value_.__isset.birthday = true;
+    }
+    loaded_.birthday = true;
+  }
+  return value_.birthday;
+}
+
+const std::map<std::string, int32_t> & PersonView::get_dict() const {
+  if (!loaded_.dict) {
+    ::apache::thrift::protocol::TProtocol* iprot = beginField(Person::field_types[3].name);
+    if (iprot != NULL) {
+      uint32_t xfer = 0;
+      {
+        this->value_.dict.clear();
+        uint32_t _size29;
+        ::apache::thrift::protocol::TType _ktype30;
+        ::apache::thrift::protocol::TType _vtype31;
+        xfer += iprot->readMapBegin(_ktype30, _vtype31, _size29);
+        uint32_t _i33;
+        for (_i33 = 0; _i33 < _size29; ++_i33)
+        {
+          std::string _key34;
+          xfer += iprot->readString(_key34);
+          int32_t& _val35 = this->value_.dict[_key34];
+          xfer += iprot->readI32(_val35);
+        }
+        xfer += iprot->readMapEnd();
+      }
+      (void) xfer;
+      value_.__isset.dict = true;
+    }
+    loaded_.dict = true;
+  }
+  return value_.dict;
+}
+
+const std::vector<String> & PersonView::get_objlist() const {
+  if (!loaded_.objlist) {
+    ::apache::thrift::protocol::TProtocol* iprot = beginField(Person::field_types[4].name);
+    if (iprot != NULL) {
+      uint32_t xfer = 0;
+      {
+        this->value_.objlist.clear();
+        uint32_t _size36;
+        ::apache::thrift::protocol::TType _etype39;
+        xfer += iprot->readListBegin(_etype39, _size36);
+        this->value_.objlist.resize(_size36);
+        uint32_t _i40;
+        for (_i40 = 0; _i40 < _size36; ++_i40)
+        {
+          xfer += this->value_.objlist[_i40].read(iprot);
+        }
+        xfer += iprot->readListEnd();
+      }
+      (void) xfer;
+      value_.__isset.objlist = true;
+    }
+    loaded_.objlist = true;
+  }
+  return value_.objlist;
+}
+
+const std::map<std::string, String> & PersonView::get_objdict() const {
+  if (!loaded_.objdict) {
+    ::apache::thrift::protocol::TProtocol* iprot = beginField(Person::field_types[5].name);
+    if (iprot != NULL) {
+      uint32_t xfer = 0;
+      {
+        this->value_.objdict.clear();
+        uint32_t _size41;
+        ::apache::thrift::protocol::TType _ktype42;
+        ::apache::thrift::protocol::TType _vtype43;
+        xfer += iprot->readMapBegin(_ktype42, _vtype43, _size41);
+        uint32_t _i45;
+        for (_i45 = 0; _i45 < _size41; ++_i45)
+        {
+          std::string _key46;
+          xfer += iprot->readString(_key46);
+          String& _val47 = this->value_.objdict[_key46];
+          xfer += _val47.read(iprot);
+        }
+        xfer += iprot->readMapEnd();
+      }
+      (void) xfer;
+      value_.__isset.objdict = true;
+    }
+    loaded_.objdict = true;
+  }
+  return value_.objdict;
+}
+
+const std::set<std::string> & PersonView::get_params() const {
+  if (!loaded_.params) {
+    ::apache::thrift::protocol::TProtocol* iprot = beginField(Person::field_types[6].name);
+    if (iprot != NULL) {
+      uint32_t xfer = 0;
+      {
+        this->value_.params.clear();
+        uint32_t _size48;
+        ::apache::thrift::protocol::TType _etype51;
+        xfer += iprot->readSetBegin(_etype51, _size48);
+        uint32_t _i52;
+        for (_i52 = 0; _i52 < _size48; ++_i52)
+        {
+          std::string _elem53;
+          xfer += iprot->readString(_elem53);
+          this->value_.params.insert(_elem53);
+        }
+        xfer += iprot->readSetEnd();
+      }
+      (void) xfer;
+      value_.__isset.params = true;
+    }
+    loaded_.params = true;
+  }
+  return value_.params;
+}
+
+const std::string& PersonView::get_b() const {
+  if (!loaded_.b) {
+    ::apache::thrift::protocol::TProtocol* iprot = beginField(Person::field_types[7].name);
+    if (iprot != NULL) {
+      uint32_t xfer = 0;
+      xfer += iprot->readBinary(this->value_.b);
+      (void) xfer;
+      value_.__isset.b = true;
+    }
+    loaded_.b = true;
+  }
+  return value_.b;
+}
+
+const char* NumericLists::ascii_fingerprint = "40CC9E65D50C2C60FC6D0A7AE69F37E5";
+const uint8_t NumericLists::binary_fingerprint[16] = {0x40,0xCC,0x9E,0x65,0xD5,0x0C,0x2C,0x60,0xFC,0x6D,0x0A,0x7A,0xE6,0x9F,0x37,0xE5};
+
+using ::apache::thrift::protocol::TFieldTypeSpec;
+
+/* static */
+const TFieldTypeSpec NumericLists::field_types[] = {
+  {1, ::apache::thrift::protocol::T_LIST, "bytes"},
+  {2, ::apache::thrift::protocol::T_LIST, "shorts"},
+  {3, ::apache::thrift::protocol::T_LIST, "ints"},
+  {4, ::apache::thrift::protocol::T_LIST, "doubles"},
+  {5, ::apache::thrift::protocol::T_SET, "ids"},
+};
+
+/* static */
+const TFieldTypeSpec* NumericLists::get_field_type(const std::string& fname) {
+  switch (fname.size()) {
+    case 3:
+      if (memcmp(fname.data(), "ids", 3) == 0) return &field_types[4];
+      break;
+    case 4:
+      if (memcmp(fname.data(), "ints", 4) == 0) return &field_types[2];
+      break;
+    case 5:
+      if (memcmp(fname.data(), "bytes", 5) == 0) return &field_types[0];
+      break;
+    case 6:
+      if (memcmp(fname.data(), "shorts", 6) == 0) return &field_types[1];
+      break;
+    case 7:
+      if (memcmp(fname.data(), "doubles", 7) == 0) return &field_types[3];
+      break;
+  }
+  return NULL;
+}
+
+uint32_t NumericLists::read(::apache::thrift::protocol::TProtocol* iprot) {
+
+  uint32_t xfer = 0;
+  std::string fname;
+  ::apache::thrift::protocol::TType ftype;
+  int16_t fid;
+
+  iprot->setNextStructFields(field_types, 5);
+  xfer += iprot->readStructBegin(fname);
+
+  using ::apache::thrift::protocol::TProtocolException;
+
+
+  while (true)
+  {
+    xfer += iprot->readFieldBegin(fname, ftype, fid);
+    if (ftype == ::apache::thrift::protocol::T_STOP) {
+      break;
+    }
+    if (fid == ::apache::thrift::protocol::kFieldIdUnknown) {
+      const TFieldTypeSpec* field_type = get_field_type(fname);
+      if (field_type != NULL) {
+        fid = field_type->fid;
+        ftype = field_type->ftype;
+      }
+    }
+    switch (fid)
+    {
+      case 1:
+        if (ftype == ::apache::thrift::protocol::T_LIST) {
+          {
+            this->bytes.clear();
+            uint32_t _size54;
+            ::apache::thrift::protocol::TType _etype57;
+            xfer += iprot->readListBegin(_etype57, _size54);
+            this->bytes.resize(_size54);
+            uint32_t _i58;
+            for (_i58 = 0; _i58 < _size54; ++_i58)
+            {
+              xfer += iprot->readByte(this->bytes[_i58]);
+            }
+            xfer += iprot->readListEnd();
+          }
+          this->__isset.bytes = true;
+        } else {
+          xfer += iprot->skip(ftype);
+        }
+        break;
+      case 2:
+        if (ftype == ::apache::thrift::protocol::T_LIST) {
+          {
+            this->shorts.clear();
+            uint32_t _size59;
+            ::apache::thrift::protocol::TType _etype62 = ::apache::thrift::protocol::T_I16;
+            xfer += iprot->readListBegin(_etype62, _size59);
+            if (_size59 > 0) {
+              if (_etype62 != ::apache::thrift::protocol::T_I16) {
+                throw ::apache::thrift::protocol::TProtocolException(::apache::thrift::protocol::TProtocolException::INVALID_DATA);
+              }
+              this->shorts.resize(_size59);
+              xfer += iprot->readI16Array(&this->shorts[0], _size59);
+            }
+            xfer += iprot->readListEnd();
+          }
+          this->__isset.shorts = true;
+        } else {
+          xfer += iprot->skip(ftype);
+        }
+        break;
+      case 3:
+        if (ftype == ::apache::thrift::protocol::T_LIST) {
+          {
+            this->ints.clear();
+            uint32_t _size63;
+            ::apache::thrift::protocol::TType _etype66 = ::apache::thrift::protocol::T_I32;
+            xfer += iprot->readListBegin(_etype66, _size63);
+            if (_size63 > 0) {
+              if (_etype66 != ::apache::thrift::protocol::T_I32) {
+                throw ::apache::thrift::protocol::TProtocolException(::apache::thrift::protocol::TProtocolException::INVALID_DATA);
+              }
+              this->ints.resize(_size63);
+              xfer += iprot->readI32Array(&this->ints[0], _size63);
+            }
+            xfer += iprot->readListEnd();
+          }
+          this->__isset.ints = true;
+        } else {
+          xfer += iprot->skip(ftype);
+        }
+        break;
+      case 4:
+        if (ftype == ::apache::thrift::protocol::T_LIST) {
+          {
+            this->doubles.clear();
+            uint32_t _size67;
+            ::apache::thrift::protocol::TType _etype70 = ::apache::thrift::protocol::T_DOUBLE;
+            xfer += iprot->readListBegin(_etype70, _size67);
+            if (_size67 > 0) {
+              if (_etype70 != ::apache::thrift::protocol::T_DOUBLE) {
+                throw ::apache::thrift::protocol::TProtocolException(::apache::thrift::protocol::TProtocolException::INVALID_DATA);
+              }
+              this->doubles.resize(_size67);
+              xfer += iprot->readDoubleArray(&this->doubles[0], _size67);
+            }
+            xfer += iprot->readListEnd();
+          }
+          this->__isset.doubles = true;
+        } else {
+          xfer += iprot->skip(ftype);
+        }
+        break;
+      case 5:
+        if (ftype == ::apache::thrift::protocol::T_SET) {
+          {
+            this->ids.clear();
+            uint32_t _size71;
+            ::apache::thrift::protocol::TType _etype74 = ::apache::thrift::protocol::T_I64;
+            xfer += iprot->readSetBegin(_etype74, _size71);
+            if (_size71 > 0) {
+              if (_etype74 != ::apache::thrift::protocol::T_I64) {
+                throw ::apache::thrift::protocol::TProtocolException(::apache::thrift::protocol::TProtocolException::INVALID_DATA);
+              }
+              std::vector<int64_t> _elems75((std::min)(_size71, 1024u));
+              uint32_t _left76 = _size71;
+              while (_left76 > 0) {
+                uint32_t _count77 = (std::min)(_left76, static_cast<uint32_t>(_elems75.size()));
+                xfer += iprot->readI64Array(&_elems75[0], _count77);
+                this->ids.insert(_elems75.begin(), _elems75.begin() + _count77);
+                _left76 -= _count77;
+              }
+            }
+            xfer += iprot->readSetEnd();
+          }
+          this->__isset.ids = true;
+        } else {
+          xfer += iprot->skip(ftype);
+        }
+        break;
+      default:
+        xfer += iprot->skip(ftype);
+        break;
+    }
+    xfer += iprot->readFieldEnd();
+  }
+
+  xfer += iprot->readStructEnd();
+
+  return xfer;
+}
+
+uint32_t NumericLists::write(::apache::thrift::protocol::TProtocol* oprot) const {
+  uint32_t xfer = 0;
+  xfer += oprot->writeStructBegin("NumericLists");
+
+  xfer += oprot->writeFieldBegin("bytes", ::apache::thrift::protocol::T_LIST, 1);
+  {
+    xfer += oprot->writeListBegin(::apache::thrift::protocol::T_BYTE, static_cast<uint32_t>(this->bytes.size()));
+    std::vector<int8_t> ::const_iterator _iter78;
+    for (_iter78 = this->bytes.begin(); _iter78 != this->bytes.end(); ++_iter78)
+    {
+      xfer += oprot->writeByte((*_iter78));
+    }
+    xfer += oprot->writeListEnd();
+  }
+  xfer += oprot->writeFieldEnd();
+
+  xfer += oprot->writeFieldBegin("shorts", ::apache::thrift::protocol::T_LIST, 2);
+  {
+    xfer += oprot->writeListBegin(::apache::thrift::protocol::T_I16, static_cast<uint32_t>(this->shorts.size()));
+    if (!this->shorts.empty()) {
+      xfer += oprot->writeI16Array(&this->shorts[0], static_cast<uint32_t>(this->shorts.size()));
+    }
+    xfer += oprot->writeListEnd();
+  }
+  xfer += oprot->writeFieldEnd();
+
+  xfer += oprot->writeFieldBegin("ints", ::apache::thrift::protocol::T_LIST, 3);
+  {
+    xfer += oprot->writeListBegin(::apache::thrift::protocol::T_I32, static_cast<uint32_t>(this->ints.size()));
+    if (!this->ints.empty()) {
+      xfer += oprot->writeI32Array(&this->ints[0], static_cast<uint32_t>(this->ints.size()));
+    }
+    xfer += oprot->writeListEnd();
+  }
+  xfer += oprot->writeFieldEnd();
+
+  xfer += oprot->writeFieldBegin("doubles", ::apache::thrift::protocol::T_LIST, 4);
+  {
+    xfer += oprot->writeListBegin(::apache::thrift::protocol::T_DOUBLE, static_cast<uint32_t>(this->doubles.size()));
+    if (!this->doubles.empty()) {
+      xfer += oprot->writeDoubleArray(&this->doubles[0], static_cast<uint32_t>(this->doubles.size()));
+    }
+    xfer += oprot->writeListEnd();
+  }
+  xfer += oprot->writeFieldEnd();
+
+  xfer += oprot->writeFieldBegin("ids", ::apache::thrift::protocol::T_SET, 5);
+  {
+    xfer += oprot->writeSetBegin(::apache::thrift::protocol::T_I64, static_cast<uint32_t>(this->ids.size()));
+    std::set<int64_t> ::const_iterator _iter79;
+    for (_iter79 = this->ids.begin(); _iter79 != this->ids.end(); ++_iter79)
+    {
+      xfer += oprot->writeI64((*_iter79));
+    }
+    xfer += oprot->writeSetEnd();
+  }
+  xfer += oprot->writeFieldEnd();
+
+  xfer += oprot->writeFieldStop();
+  xfer += oprot->writeStructEnd();
+  return xfer;
+}
+
+void swap(NumericLists &a, NumericLists &b) {
+  using ::std::swap;
+  swap(a.bytes, b.bytes);
+  swap(a.shorts, b.shorts);
+  swap(a.ints, b.ints);
+  swap(a.doubles, b.doubles);
+  swap(a.ids, b.ids);
+  swap(a.__isset, b.__isset);
+}
+
+const std::vector<int8_t> & NumericListsView::get_bytes() const {
+  if (!loaded_.bytes) {
+    ::apache::thrift::protocol::TProtocol* iprot = beginField(NumericLists::field_types[0].name);
+    if (iprot != NULL) {
+      uint32_t xfer = 0;
+      {
+        this->value_.bytes.clear();
+        uint32_t _size80;
+        ::apache::thrift::protocol::TType _etype83;
+        xfer += iprot->readListBegin(_etype83, _size80);
+        this->value_.bytes.resize(_size80);
+        uint32_t _i84;
+        for (_i84 = 0; _i84 < _size80; ++_i84)
+        {
+          xfer += iprot->readByte(this->value_.bytes[_i84]);
+        }
+        xfer += iprot->readListEnd();
+      }
+      (void) xfer;
+      value_.__isset.bytes = true;
+    }
+    loaded_.bytes = true;
+  }
+  return value_.bytes;
+}
+
+const std::vector<int16_t> & NumericListsView::get_shorts() const {
+  if (!loaded_.shorts) {
+    ::apache::thrift::protocol::TProtocol* iprot = beginField(NumericLists::field_types[1].name);
+    if (iprot != NULL) {
+      uint32_t xfer = 0;
+      {
+        this->value_.shorts.clear();
+        uint32_t _size85;
+        ::apache::thrift::protocol::TType _etype88 = ::apache::thrift::protocol::T_I16;
+        xfer += iprot->readListBegin(_etype88, _size85);
+        if (_size85 > 0) {
+          if (_etype88 != ::apache::thrift::protocol::T_I16) {
+            throw ::apache::thrift::protocol::TProtocolException(::apache::thrift::protocol::TProtocolException::INVALID_DATA);
+          }
+          this->value_.shorts.resize(_size85);
+          xfer += iprot->readI16Array(&this->value_.shorts[0], _size85);
+        }
+        xfer += iprot->readListEnd();
+      }
+      (void) xfer;
+      value_.__isset.shorts = true;
+    }
+    loaded_.shorts = true;
+  }
+  return value_.shorts;
+}
+
+const std::vector<int32_t> & NumericListsView::get_ints() const {
+  if (!loaded_.ints) {
+    ::apache::thrift::protocol::TProtocol* iprot = beginField(NumericLists::field_types[2].name);
+    if (iprot != NULL) {
+      uint32_t xfer = 0;
+      {
+        this->value_.ints.clear();
+        uint32_t _size89;
+        ::apache::thrift::protocol::TType _etype92 = ::apache::thrift::protocol::T_I32;
+        xfer += iprot->readListBegin(_etype92, _size89);
+        if (_size89 > 0) {
+          if (_etype92 != ::apache::thrift::protocol::T_I32) {
+            throw ::apache::thrift::protocol::TProtocolException(::apache::thrift::protocol::TProtocolException::INVALID_DATA);
+          }
+          this->value_.ints.resize(_size89);
+          xfer += iprot->readI32Array(&this->value_.ints[0], _size89);
+        }
+        xfer += iprot->readListEnd();
+      }
+      (void) xfer;
+      value_.__isset.ints = true;
+    }
+    loaded_.ints = true;
+  }
+  return value_.ints;
+}
+
+const std::vector<double> & NumericListsView::get_doubles() const {
+  if (!loaded_.doubles) {
+    ::apache::thrift::protocol::TProtocol* iprot = beginField(NumericLists::field_types[3].name);
+    if (iprot != NULL) {
+      uint32_t xfer = 0;
+      {
+        this->value_.doubles.clear();
+        uint32_t _size93;
+        ::apache::thrift::protocol::TType _etype96 = ::apache::thrift::protocol::T_DOUBLE;
+        xfer += iprot->readListBegin(_etype96, _size93);
+        if (_size93 > 0) {
+          if (_etype96 != ::apache::thrift::protocol::T_DOUBLE) {
+            throw ::apache::thrift::protocol::TProtocolException(::apache::thrift::protocol::TProtocolException::INVALID_DATA);
+          }
+          this->value_.doubles.resize(_size93);
+          xfer += iprot->readDoubleArray(&this->value_.doubles[0], _size93);
+        }
+        xfer += iprot->readListEnd();
+      }
+      (void) xfer;
+      value_.__isset.doubles = true;
+    }
+    loaded_.doubles = true;
+  }
+  return value_.doubles;
+}
+
+const std::set<int64_t> & NumericListsView::get_ids() const {
+  if (!loaded_.ids) {
+    ::apache::thrift::protocol::TProtocol* iprot = beginField(NumericLists::field_types[4].name);
+    if (iprot != NULL) {
+      uint32_t xfer = 0;
+      {
+        this->value_.ids.clear();
+        uint32_t _size97;
+        ::apache::thrift::protocol::TType _etype100 = ::apache::thrift::protocol::T_I64;
+        xfer += iprot->readSetBegin(_etype100, _size97);
+        if (_size97 > 0) {
+          if (_etype100 != ::apache::thrift::protocol::T_I64) {
+            throw ::apache::thrift::protocol::TProtocolException(::apache::thrift::protocol::TProtocolException::INVALID_DATA);
+          }
+          std::vector<int64_t> _elems101((std::min)(_size97, 1024u));
+          uint32_t _left102 = _size97;
+          while (_left102 > 0) {
+            uint32_t _count103 = (std::min)(_left102, static_cast<uint32_t>(_elems101.size()));
+            xfer += iprot->readI64Array(&_elems101[0], _count103);
+            this->value_.ids.insert(_elems101.begin(), _elems101.begin() + _count103);
+            _left102 -= _count103;
+          }
+        }
+        xfer += iprot->readSetEnd();
+      }
+      (void) xfer;
+      value_.__isset.ids = true;
+    }
+    loaded_.ids = true;
+  }
+  return value_.ids;
+}
+
+
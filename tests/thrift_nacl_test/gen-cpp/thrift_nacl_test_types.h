@@ -0,0 +1,963 @@
+/**
+ * Autogenerated by Thrift Compiler (0.9.1)
+ *
+ * DO NOT EDIT UNLESS YOU ARE SURE THAT YOU KNOW WHAT YOU ARE DOING
+ *  @generated
+ */
+#ifndef thrift_nacl_test_TYPES_H
+#define thrift_nacl_test_TYPES_H
+
+#include <cstring>
+#include <string>
+
+#include <thrift/Thrift.h>
+#include <thrift/TApplicationException.h>
+#include <thrift/protocol/TProtocol.h>
+#include <thrift/transport/TTransport.h>
+
+#include <thrift/protocol/TNativeClientProtocol.h>
+
+#include <thrift/cxxfunctional.h>
+
+
+
+
+typedef struct _Boolean__isset {
+  _Boolean__isset() : value(false) {}
+  bool value;
+} _Boolean__isset;
+
+class Boolean : public ::apache::thrift::TStruct {
+ public:
+
+  static const char* ascii_fingerprint; // = "BF054652DEF86253C2BEE7D947F167DD";
+  static const uint8_t binary_fingerprint[16]; // = {0xBF,0x05,0x46,0x52,0xDE,0xF8,0x62,0x53,0xC2,0xBE,0xE7,0xD9,0x47,0xF1,0x67,0xDD};
+
+  Boolean() : value(0) {
+  }
+
+  virtual ~Boolean() throw() {}
+
+
+  inline bool has_value() const {
+    return __isset.value;
+  }
+
+  inline const bool get_value() const {
+    return value;
+  }
+
+  inline void set_value(const bool val) {
+    value = val;
+    __isset.value = true;
+  }
+
+  bool operator == (const Boolean & rhs) const
+  {
+    if (__isset.value != rhs.__isset.value)
+      return false;
+    else if (__isset.value && !(value == rhs.value))
+      return false;
+    return true;
+  }
+  bool operator != (const Boolean &rhs) const {
+    return !(*this == rhs);
+  }
+
+  bool operator < (const Boolean & ) const;
+
+  virtual uint32_t read(::apache::thrift::protocol::TProtocol* iprot);
+  virtual uint32_t write(::apache::thrift::protocol::TProtocol* oprot) const;
+
+ private:
+  static const apache::thrift::protocol::TFieldTypeSpec field_types[];
+  static const apache::thrift::protocol::TFieldTypeSpec* get_field_type(const std::string& fname);
+
+  bool value;
+
+  _Boolean__isset __isset;
+  friend void swap(Boolean &a, Boolean &b);
+
+  friend class BooleanView;
+
+};
+
+class BooleanView : public ::apache::thrift::protocol::TNativeClientView {
+ public:
+  BooleanView() {}
+  explicit BooleanView(const pp::Var& var)
+    : ::apache::thrift::protocol::TNativeClientView(var) {}
+
+  inline bool has_value() const {
+    return hasField(Boolean::field_types[0].name);
+  }
+  const bool get_value() const;
+
+ private:
+  struct Loaded {
+    Loaded() : value(false) {}
+    bool value;
+  };
+
+  mutable Boolean value_;
+  mutable Loaded loaded_;
+};
+
+typedef struct _Number__isset {
+  _Number__isset() : i8_value(false), i16_value(false), i32_value(false), i64_value(false), double_value(false) {}
+  bool i8_value;
+  bool i16_value;
+  bool i32_value;
+  bool i64_value;
+  bool double_value;
+} _Number__isset;
+
+class Number : public ::apache::thrift::TStruct {
+ public:
+
+  static const char* ascii_fingerprint; // = "AC34B2E1B97E5B4320CB6D16FFD88EBA";
+  static const uint8_t binary_fingerprint[16]; // = {0xAC,0x34,0xB2,0xE1,0xB9,0x7E,0x5B,0x43,0x20,0xCB,0x6D,0x16,0xFF,0xD8,0x8E,0xBA};
+
+  Number() : i8_value(0), i16_value(0), i32_value(0), i64_value(0), double_value(0) {
+  }
+
+  virtual ~Number() throw() {}
+
+
+  inline bool has_i8_value() const {
+    return __isset.i8_value;
+  }
+
+  inline const int8_t get_i8_value() const {
+    return i8_value;
+  }
+
+  inline void set_i8_value(const int8_t val) {
+    i8_value = val;
+    __isset.i8_value = true;
+  }
+
+  inline bool has_i16_value() const {
+    return __isset.i16_value;
+  }
+
+  inline const int16_t get_i16_value() const {
+    return i16_value;
+  }
+
+  inline void set_i16_value(const int16_t val) {
+    i16_value = val;
+    __isset.i16_value = true;
+  }
+
+  inline bool has_i32_value() const {
+    return __isset.i32_value;
+  }
+
+  inline const int32_t get_i32_value() const {
+    return i32_value;
+  }
+
+  inline void set_i32_value(const int32_t val) {
+    i32_value = val;
+    __isset.i32_value = true;
+  }
+
+  inline bool has_i64_value() const {
+    return __isset.i64_value;
+  }
+
+  inline const int64_t get_i64_value() const {
+    return i64_value;
+  }
+
+  inline void set_i64_value(const int64_t val) {
+    i64_value = val;
+    __isset.i64_value = true;
+  }
+
+  inline bool has_double_value() const {
+    return __isset.double_value;
+  }
+
+  inline const double get_double_value() const {
+    return double_value;
+  }
+
+  inline void set_double_value(const double val) {
+    double_value = val;
+    __isset.double_value = true;
+  }
+
+  bool operator == (const Number & rhs) const
+  {
+    if (__isset.i8_value != rhs.__isset.i8_value)
+      return false;
+    else if (__isset.i8_value && !(i8_value == rhs.i8_value))
+      return false;
+    if (__isset.i16_value != rhs.__isset.i16_value)
+      return false;
+    else if (__isset.i16_value && !(i16_value == rhs.i16_value))
+      return false;
+    if (__isset.i32_value != rhs.__isset.i32_value)
+      return false;
+    else if (__isset.i32_value && !(i32_value == rhs.i32_value))
+      return false;
+    if (__isset.i64_value != rhs.__isset.i64_value)
+      return false;
+    else if (__isset.i64_value && !(i64_value == rhs.i64_value))
+      return false;
+    if (__isset.double_value != rhs.__isset.double_value)
+      return false;
+    else if (__isset.double_value && !(double_value == rhs.double_value))
+      return false;
+    return true;
+  }
+  bool operator != (const Number &rhs) const {
+    return !(*this == rhs);
+  }
+
+  bool operator < (const Number & ) const;
+
+  virtual uint32_t read(::apache::thrift::protocol::TProtocol* iprot);
+  virtual uint32_t write(::apache::thrift::protocol::TProtocol* oprot) const;
+
+ private:
+  static const apache::thrift::protocol::TFieldTypeSpec field_types[];
+  static const apache::thrift::protocol::TFieldTypeSpec* get_field_type(const std::string& fname);
+
+  int8_t i8_value;
+  int16_t i16_value;
+  int32_t i32_value;
+  int64_t i64_value;
+  double double_value;
+
+  _Number__isset __isset;
+  friend void swap(Number &a, Number &b);
+
+  friend class NumberView;
+
+};
+
+class NumberView : public ::apache::thrift::protocol::TNativeClientView {
+ public:
+  NumberView() {}
+  explicit NumberView(const pp::Var& var)
+    : ::apache::thrift::protocol::TNativeClientView(var) {}
+
+  inline bool has_i8_value() const {
+    return hasField(Number::field_types[0].name);
+  }
+  const int8_t get_i8_value() const;
+
+  inline bool has_i16_value() const {
+    return hasField(Number::field_types[1].name);
+  }
+  const int16_t get_i16_value() const;
+
+  inline bool has_i32_value() const {
+    return hasField(Number::field_types[2].name);
+  }
+  const int32_t get_i32_value() const;
+
+  inline bool has_i64_value() const {
+    return hasField(Number::field_types[3].name);
+  }
+  const int64_t get_i64_value() const;
+
+  inline bool has_double_value() const {
+    return hasField(Number::field_types[4].name);
+  }
+  const double get_double_value() const;
+
+ private:
+  struct Loaded {
+    Loaded() : i8_value(false), i16_value(false), i32_value(false), i64_value(false), double_value(false) {}
+    bool i8_value;
+    bool i16_value;
+    bool i32_value;
+    bool i64_value;
+    bool double_value;
+  };
+
+  mutable Number value_;
+  mutable Loaded loaded_;
+};
+
+typedef struct _BinaryData__isset {
+  _BinaryData__isset() : data(false) {}
+  bool data;
+} _BinaryData__isset;
+
+class BinaryData : public ::apache::thrift::TStruct {
+ public:
+
+  static const char* ascii_fingerprint; // = "EFB929595D312AC8F305D5A794CFEDA1";
+  static const uint8_t binary_fingerprint[16]; // = {0xEF,0xB9,0x29,0x59,0x5D,0x31,0x2A,0xC8,0xF3,0x05,0xD5,0xA7,0x94,0xCF,0xED,0xA1};
+
+  BinaryData() : data() {
+  }
+
+  virtual ~BinaryData() throw() {}
+
+
+  inline const std::string& get_data() const {
+    return data;
+  }
+
+  inline void set_data(const std::string& val) {
+    data = val;
+  }
+
+  inline std::string* mutable_data() {
+    return &data;
+  }
+
+  bool operator == (const BinaryData & rhs) const
+  {
+    if (!(data == rhs.data))
+      return false;
+    return true;
+  }
+  bool operator != (const BinaryData &rhs) const {
+    return !(*this == rhs);
+  }
+
+  bool operator < (const BinaryData & ) const;
+
+  virtual uint32_t read(::apache::thrift::protocol::TProtocol* iprot);
+  virtual uint32_t write(::apache::thrift::protocol::TProtocol* oprot) const;
+
+ private:
+  static const apache::thrift::protocol::TFieldTypeSpec field_types[];
+  static const apache::thrift::protocol::TFieldTypeSpec* get_field_type(const std::string& fname);
+
+  std::string data;
+
+  _BinaryData__isset __isset;
+  friend void swap(BinaryData &a, BinaryData &b);
+
+  friend class BinaryDataView;
+
+};
+
+class BinaryDataView : public ::apache::thrift::protocol::TNativeClientView {
+ public:
+  BinaryDataView() {}
+  explicit BinaryDataView(const pp::Var& var)
+    : ::apache::thrift::protocol::TNativeClientView(var) {}
+
+  inline bool has_data() const {
+    return hasField(BinaryData::field_types[0].name);
+  }
+  const std::string& get_data() const;
+
+ private:
+  struct Loaded {
+    Loaded() : data(false) {}
+    bool data;
+  };
+
+  mutable BinaryData value_;
+  mutable Loaded loaded_;
+};
+
+typedef struct _Date__isset {
+  _Date__isset() : day(false), year(false) {}
+  bool day;
+  bool year;
+} _Date__isset;
+
+class Date : public ::apache::thrift::TStruct {
+ public:
+
+  static const char* ascii_fingerprint; // = "A5D9FD141E77B608AA21FD4BD8487AC1";
+  static const uint8_t binary_fingerprint[16]; // = {0xA5,0xD9,0xFD,0x14,0x1E,0x77,0xB6,0x08,0xAA,0x21,0xFD,0x4B,0xD8,0x48,0x7A,0xC1};
+
+  Date() : day(0), month(0), year(0) {
+  }
+
+  virtual ~Date() throw() {}
+
+
+  inline bool has_day() const {
+    return __isset.day;
+  }
+
+  inline const int32_t get_day() const {
+    return day;
+  }
+
+  inline void set_day(const int32_t val) {
+    day = val;
+    __isset.day = true;
+  }
+
+  inline const int32_t get_month() const {
+    return month;
+  }
+
+  inline void set_month(const int32_t val) {
+    month = val;
+  }
+
+  inline const int32_t get_year() const {
+    return year;
+  }
+
+  inline void set_year(const int32_t val) {
+    year = val;
+  }
+
+  bool operator == (const Date & rhs) const
+  {
+    if (__isset.day != rhs.__isset.day)
+      return false;
+    else if (__isset.day && !(day == rhs.day))
+      return false;
+    if (!(month == rhs.month))
+      return false;
+    if (!(year == rhs.year))
+      return false;
+    return true;
+  }
+  bool operator != (const Date &rhs) const {
+    return !(*this == rhs);
+  }
+
+  bool operator < (const Date & ) const;
+
+  virtual uint32_t read(::apache::thrift::protocol::TProtocol* iprot);
+  virtual uint32_t write(::apache::thrift::protocol::TProtocol* oprot) const;
+
+ private:
+  static const apache::thrift::protocol::TFieldTypeSpec field_types[];
+  static const apache::thrift::protocol::TFieldTypeSpec* get_field_type(const std::string& fname);
+
+  int32_t day;
+  int32_t month;
+  int32_t year;
+
+  _Date__isset __isset;
+  friend void swap(Date &a, Date &b);
+
+  friend class DateView;
+
+};
+
+class DateView : public ::apache::thrift::protocol::TNativeClientView {
+ public:
+  DateView() {}
+  explicit DateView(const pp::Var& var)
+    : ::apache::thrift::protocol::TNativeClientView(var) {}
+
+  inline bool has_day() const {
+    return hasField(Date::field_types[0].name);
+  }
+  const int32_t get_day() const;
+
+  inline bool has_month() const {
+    return hasField(Date::field_types[1].name);
+  }
+  const int32_t get_month() const;
+
+  inline bool has_year() const {
+    return hasField(Date::field_types[2].name);
+  }
+  const int32_t get_year() const;
+
+ private:
+  struct Loaded {
+    Loaded() : day(false), month(false), year(false) {}
+    bool day;
+    bool month;
+    bool year;
+  };
+
+  mutable Date value_;
+  mutable Loaded loaded_;
+};
+
+typedef struct _String__isset {
+  _String__isset() : s(false) {}
+  bool s;
+} _String__isset;
+
+class String : public ::apache::thrift::TStruct {
+ public:
+
+  static const char* ascii_fingerprint; // = "EFB929595D312AC8F305D5A794CFEDA1";
+  static const uint8_t binary_fingerprint[16]; // = {0xEF,0xB9,0x29,0x59,0x5D,0x31,0x2A,0xC8,0xF3,0x05,0xD5,0xA7,0x94,0xCF,0xED,0xA1};
+
+  String() : s() {
+  }
+
+  virtual ~String() throw() {}
+
+
+  inline const std::string& get_s() const {
+    return s;
+  }
+
+  inline void set_s(const std::string& val) {
+    s = val;
+  }
+
+  inline std::string* mutable_s() {
+    return &s;
+  }
+
+  bool operator == (const String & rhs) const
+  {
+    if (!(s == rhs.s))
+      return false;
+    return true;
+  }
+  bool operator != (const String &rhs) const {
+    return !(*this == rhs);
+  }
+
+  bool operator < (const String & ) const;
+
+  virtual uint32_t read(::apache::thrift::protocol::TProtocol* iprot);
+  virtual uint32_t write(::apache::thrift::protocol::TProtocol* oprot) const;
+
+ private:
+  static const apache::thrift::protocol::TFieldTypeSpec field_types[];
+  static const apache::thrift::protocol::TFieldTypeSpec* get_field_type(const std::string& fname);
+
+  std::string s;
+
+  _String__isset __isset;
+  friend void swap(String &a, String &b);
+
+  friend class StringView;
+
+};
+
+class StringView : public ::apache::thrift::protocol::TNativeClientView {
+ public:
+  StringView() {}
+  explicit StringView(const pp::Var& var)
+    : ::apache::thrift::protocol::TNativeClientView(var) {}
+
+  inline bool has_s() const {
+    return hasField(String::field_types[0].name);
+  }
+  const std::string& get_s() const;
+
+ private:
+  struct Loaded {
+    Loaded() : s(false) {}
+    bool s;
+  };
+
+  mutable String value_;
+  mutable Loaded loaded_;
+};
+
+typedef struct _Person__isset {
+  _Person__isset() : name(false), weight(false), birthday(false), dict(false), objlist(false), objdict(false), params(false), b(false) {}
+  bool name;
+  bool weight;
+  bool birthday;
+  bool dict;
+  bool objlist;
+  bool objdict;
+  bool params;
+  bool b;
+} _Person__isset;
+
+class Person : public ::apache::thrift::TStruct {
+ public:
+
+  static const char* ascii_fingerprint; // = "3BA7357570B3C4F61DB3DB3BCECE1C68";
+  static const uint8_t binary_fingerprint[16]; // = {0x3B,0xA7,0x35,0x75,0x70,0xB3,0xC4,0xF6,0x1D,0xB3,0xDB,0x3B,0xCE,0xCE,0x1C,0x68};
+
+  Person() : name(), weight(0), b() {
+  }
+
+  virtual ~Person() throw() {}
+
+
+  inline bool has_name() const {
+    return __isset.name;
+  }
+
+  inline const std::string& get_name() const {
+    return name;
+  }
+
+  inline void set_name(const std::string& val) {
+    name = val;
+    __isset.name = true;
+  }
+
+  inline std::string* mutable_name() {
+    __isset.name = true;
+    return &name;
+  }
+
+  inline const double get_weight() const {
+    return weight;
+  }
+
+  inline void set_weight(const double val) {
+    weight = val;
+  }
+
+  inline const Date& get_birthday() const {
+    return birthday;
+  }
+
+  inline void set_birthday(const Date& val) {
+    birthday = val;
+  }
+
+  inline Date* mutable_birthday() {
+    return &birthday;
+  }
+
+  inline const std::map<std::string, int32_t> & get_dict() const {
+    return dict;
+  }
+
+  inline void set_dict(const std::map<std::string, int32_t> & val) {
+    dict = val;
+  }
+
+  inline std::map<std::string, int32_t> * mutable_dict() {
+    return &dict;
+  }
+
+  inline const std::vector<String> & get_objlist() const {
+    return objlist;
+  }
+
+  inline void set_objlist(const std::vector<String> & val) {
+    objlist = val;
+  }
+
+  inline std::vector<String> * mutable_objlist() {
+    return &objlist;
+  }
+
+  inline const std::map<std::string, String> & get_objdict() const {
+    return objdict;
+  }
+
+  inline void set_objdict(const std::map<std::string, String> & val) {
+    objdict = val;
+  }
+
+  inline std::map<std::string, String> * mutable_objdict() {
+    return &objdict;
+  }
+
+  inline const std::set<std::string> & get_params() const {
+    return params;
+  }
+
+  inline void set_params(const std::set<std::string> & val) {
+    params = val;
+  }
+
+  inline std::set<std::string> * mutable_params() {
+    return &params;
+  }
+
+  inline const std::string& get_b() const {
+    return b;
+  }
+
+  inline void set_b(const std::string& val) {
+    b = val;
+  }
+
+  inline std::string* mutable_b() {
+    return &b;
+  }
+
+  bool operator == (const Person & rhs) const
+  {
+    if (__isset.name != rhs.__isset.name)
+      return false;
+    else if (__isset.name && !(name == rhs.name))
+      return false;
+    if (!(weight == rhs.weight))
+      return false;
+    if (!(birthday == rhs.birthday))
+      return false;
+    if (!(dict == rhs.dict))
+      return false;
+    if (!(objlist == rhs.objlist))
+      return false;
+    if (!(objdict == rhs.objdict))
+      return false;
+    if (!(params == rhs.params))
+      return false;
+    if (!(b == rhs.b))
+      return false;
+    return true;
+  }
+  bool operator != (const Person &rhs) const {
+    return !(*this == rhs);
+  }
+
+  bool operator < (const Person & ) const;
+
+  virtual uint32_t read(::apache::thrift::protocol::TProtocol* iprot);
+  virtual uint32_t write(::apache::thrift::protocol::TProtocol* oprot) const;
+
+ private:
+  static const apache::thrift::protocol::TFieldTypeSpec field_types[];
+  static const apache::thrift::protocol::TFieldTypeSpec* get_field_type(const std::string& fname);
+
+  std::string name;
+  double weight;
+  Date birthday;
+  std::map<std::string, int32_t>  dict;
+  std::vector<String>  objlist;
+  std::map<std::string, String>  objdict;
+  std::set<std::string>  params;
+  std::string b;
+
+  _Person__isset __isset;
+  friend void swap(Person &a, Person &b);
+
+  friend class PersonView;
+
+};
+
+class PersonView : public ::apache::thrift::protocol::TNativeClientView {
+ public:
+  PersonView() {}
+  explicit PersonView(const pp::Var& var)
+    : ::apache::thrift::protocol::TNativeClientView(var) {}
+
+  inline bool has_name() const {
+    return hasField(Person::field_types[0].name);
+  }
+  const std::string& get_name() const;
+
+  inline bool has_weight() const {
+    return hasField(Person::field_types[1].name);
+  }
+  const double get_weight() const;
+
+  inline bool has_birthday() const {
+    return hasField(Person::field_types[2].name);
+  }
+  const Date& get_birthday() const;
+
+  inline bool has_dict() const {
+    return hasField(Person::field_types[3].name);
+  }
+  const std::map<std::string, int32_t> & get_dict() const;
+
+  inline bool has_objlist() const {
+    return hasField(Person::field_types[4].name);
+  }
+  const std::vector<String> & get_objlist() const;
+
+  inline bool has_objdict() const {
+    return hasField(Person::field_types[5].name);
+  }
+  const std::map<std::string, String> & get_objdict() const;
+
+  inline bool has_params() const {
+    return hasField(Person::field_types[6].name);
+  }
+  const std::set<std::string> & get_params() const;
+
+  inline bool has_b() const {
+    return hasField(Person::field_types[7].name);
+  }
+  const std::string& get_b() const;
+
+ private:
+  struct Loaded {
+    Loaded() : name(false), weight(false), birthday(false), dict(false), objlist(false), objdict(false), params(false), b(false) {}
+    bool name;
+    bool weight;
+    bool birthday;
+    bool dict;
+    bool objlist;
+    bool objdict;
+    bool params;
+    bool b;
+  };
+
+  mutable Person value_;
+  mutable Loaded loaded_;
+};
+
+typedef struct _NumericLists__isset {
+  _NumericLists__isset() : bytes(false), shorts(false), ints(false), doubles(false), ids(false) {}
+  bool bytes;
+  bool shorts;
+  bool ints;
+  bool doubles;
+  bool ids;
+} _NumericLists__isset;
+
+class NumericLists : public ::apache::thrift::TStruct {
+ public:
+
+  static const char* ascii_fingerprint; // = "40CC9E65D50C2C60FC6D0A7AE69F37E5";
+  static const uint8_t binary_fingerprint[16]; // = {0x40,0xCC,0x9E,0x65,0xD5,0x0C,0x2C,0x60,0xFC,0x6D,0x0A,0x7A,0xE6,0x9F,0x37,0xE5};
+
+  NumericLists() {
+  }
+
+  virtual ~NumericLists() throw() {}
+
+
+  inline const std::vector<int8_t> & get_bytes() const {
+    return bytes;
+  }
+
+  inline void set_bytes(const std::vector<int8_t> & val) {
+    bytes = val;
+  }
+
+  inline std::vector<int8_t> * mutable_bytes() {
+    return &bytes;
+  }
+
+  inline const std::vector<int16_t> & get_shorts() const {
+    return shorts;
+  }
+
+  inline void set_shorts(const std::vector<int16_t> & val) {
+    shorts = val;
+  }
+
+  inline std::vector<int16_t> * mutable_shorts() {
+    return &shorts;
+  }
+
+  inline const std::vector<int32_t> & get_ints() const {
+    return ints;
+  }
+
+  inline void set_ints(const std::vector<int32_t> & val) {
+    ints = val;
+  }
+
+  inline std::vector<int32_t> * mutable_ints() {
+    return &ints;
+  }
+
+  inline const std::vector<double> & get_doubles() const {
+    return doubles;
+  }
+
+  inline void set_doubles(const std::vector<double> & val) {
+    doubles = val;
+  }
+
+  inline std::vector<double> * mutable_doubles() {
+    return &doubles;
+  }
+
+  inline const std::set<int64_t> & get_ids() const {
+    return ids;
+  }
+
+  inline void set_ids(const std::set<int64_t> & val) {
+    ids = val;
+  }
+
+  inline std::set<int64_t> * mutable_ids() {
+    return &ids;
+  }
+
+  bool operator == (const NumericLists & rhs) const
+  {
+    if (!(bytes == rhs.bytes))
+      return false;
+    if (!(shorts == rhs.shorts))
+      return false;
+    if (!(ints == rhs.ints))
+      return false;
+    if (!(doubles == rhs.doubles))
+      return false;
+    if (!(ids == rhs.ids))
+      return false;
+    return true;
+  }
+  bool operator != (const NumericLists &rhs) const {
+    return !(*this == rhs);
+  }
+
+  bool operator < (const NumericLists & ) const;
+
+  virtual uint32_t read(::apache::thrift::protocol::TProtocol* iprot);
+  virtual uint32_t write(::apache::thrift::protocol::TProtocol* oprot) const;
+
+ private:
+  static const apache::thrift::protocol::TFieldTypeSpec field_types[];
+  static const apache::thrift::protocol::TFieldTypeSpec* get_field_type(const std::string& fname);
+
+  std::vector<int8_t>  bytes;
+  std::vector<int16_t>  shorts;
+  std::vector<int32_t>  ints;
+  std::vector<double>  doubles;
+  std::set<int64_t>  ids;
+
+  _NumericLists__isset __isset;
+  friend void swap(NumericLists &a, NumericLists &b);
+
+  friend class NumericListsView;
+
+};
+
+class NumericListsView : public ::apache::thrift::protocol::TNativeClientView {
+ public:
+  NumericListsView() {}
+  explicit NumericListsView(const pp::Var& var)
+    : ::apache::thrift::protocol::TNativeClientView(var) {}
+
+  inline bool has_bytes() const {
+    return hasField(NumericLists::field_types[0].name);
+  }
+  const std::vector<int8_t> & get_bytes() const;
+
+  inline bool has_shorts() const {
+    return hasField(NumericLists::field_types[1].name);
+  }
+  const std::vector<int16_t> & get_shorts() const;
+
+  inline bool has_ints() const {
+    return hasField(NumericLists::field_types[2].name);
+  }
+  const std::vector<int32_t> & get_ints() const;
+
+  inline bool has_doubles() const {
+    return hasField(NumericLists::field_types[3].name);
+  }
+  const std::vector<double> & get_doubles() const;
+
+  inline bool has_ids() const {
+    return hasField(NumericLists::field_types[4].name);
+  }
+  const std::set<int64_t> & get_ids() const;
+
+ private:
+  struct Loaded {
+    Loaded() : bytes(false), shorts(false), ints(false), doubles(false), ids(false) {}
+    bool bytes;
+    bool shorts;
+    bool ints;
+    bool doubles;
+    bool ids;
+  };
+
+  mutable NumericLists value_;
+  mutable Loaded loaded_;
+};
+
+
+
+#endif
@@ -0,0 +1,1231 @@
+/**
+ * Autogenerated by Thrift Compiler (0.9.1)
+ *
+ * DO NOT EDIT UNLESS YOU ARE SURE THAT YOU KNOW WHAT YOU ARE DOING
+ *  @generated
+ */
+#include "thrift_nacl_types.h"
+
+#include <algorithm>
+
+
+
+const char* ThriftNaClError::ascii_fingerprint = "D0297FC5011701BD87898CC36146A565";
+const uint8_t ThriftNaClError::binary_fingerprint[16] = {0xD0,0x29,0x7F,0xC5,0x01,0x17,0x01,0xBD,0x87,0x89,0x8C,0xC3,0x61,0x46,0xA5,0x65};
+
+using ::apache::thrift::protocol::TFieldTypeSpec;
+
+/* static */
+const TFieldTypeSpec ThriftNaClError::field_types[] = {
+  {1, ::apache::thrift::protocol::T_STRING, "type"},
+  {2, ::apache::thrift::protocol::T_STRING, "message"},
+};
+
+/* static */
+const TFieldTypeSpec* ThriftNaClError::get_field_type(const std::string& fname) {
+  switch (fname.size()) {
+    case 4:
+      if (memcmp(fname.data(), "type", 4) == 0) return &field_types[0];
+      break;
+    case 7:
+      if (memcmp(fname.data(), "message", 7) == 0) return &field_types[1];
+      break;
+  }
+  return NULL;
+}
+
+uint32_t ThriftNaClError::read(::apache::thrift::protocol::TProtocol* iprot) {
+
+  uint32_t xfer = 0;
+  std::string fname;
+  ::apache::thrift::protocol::TType ftype;
+  int16_t fid;
+
+  iprot->setNextStructFields(field_types, 2);
+  xfer += iprot->readStructBegin(fname);
+
+  using ::apache::thrift::protocol::TProtocolException;
+
+
+  while (true)
+  {
+    xfer += iprot->readFieldBegin(fname, ftype, fid);
+    if (ftype == ::apache::thrift::protocol::T_STOP) {
+      break;
+    }
+    if (fid == ::apache::thrift::protocol::kFieldIdUnknown) {
+      const TFieldTypeSpec* field_type = get_field_type(fname);
+      if (field_type != NULL) {
+        fid = field_type->fid;
+        ftype = field_type->ftype;
+      }
+    }
+    switch (fid)
+    {
+      case 1:
+        if (ftype == ::apache::thrift::protocol::T_STRING) {
+          xfer += iprot->readString(this->type);
+          this->__isset.type = true;
+        } else {
+          xfer += iprot->skip(ftype);
+        }
+        break;
+      case 2:
+        if (ftype == ::apache::thrift::protocol::T_STRING) {
+          xfer += iprot->readString(this->message);
+          this->__isset.message = true;
+        } else {
+          xfer += iprot->skip(ftype);
+        }
+        break;
+      default:
+        xfer += iprot->skip(ftype);
+        break;
+    }
+    xfer += iprot->readFieldEnd();
+  }
+
+  xfer += iprot->readStructEnd();
+
+  return xfer;
+}
+
+uint32_t ThriftNaClError::write(::apache::thrift::protocol::TProtocol* oprot) const {
+  uint32_t xfer = 0;
+  xfer += oprot->writeStructBegin("ThriftNaClError");
+
+  if (this->__isset.type) {
+    xfer += oprot->writeFieldBegin("type", ::apache::thrift::protocol::T_STRING, 1);
+    xfer += oprot->writeString(this->type);
+    xfer += oprot->writeFieldEnd();
+  }
+  if (this->__isset.message) {
+    xfer += oprot->writeFieldBegin("message", ::apache::thrift::protocol::T_STRING, 2);
+    xfer += oprot->writeString(this->message);
+    xfer += oprot->writeFieldEnd();
+  }
+  xfer += oprot->writeFieldStop();
+  xfer += oprot->writeStructEnd();
+  return xfer;
+}
+
+void swap(ThriftNaClError &a, ThriftNaClError &b) {
+  using ::std::swap;
+  swap(a.type, b.type);
+  swap(a.message, b.message);
+  swap(a.__isset, b.__isset);
+}
+
+const std::string& ThriftNaClErrorView::get_type() const {
+  if (!loaded_.type) {
+    ::apache::thrift::protocol::TProtocol* iprot = beginField(ThriftNaClError::field_types[0].name);
+    if (iprot != NULL) {
+      uint32_t xfer = 0;
+      xfer += iprot->readString(this->value_.type);
+      (void) xfer;
+      value_.__isset.type = true;
+    }
+    loaded_.type = true;
+  }
+  return value_.type;
+}
+
+const std::string& ThriftNaClErrorView::get_message() const {
+  if (!loaded_.message) {
+    ::apache::thrift::protocol::TProtocol* iprot = beginField(ThriftNaClError::field_types[1].name);
+    if (iprot != NULL) {
+      uint32_t xfer = 0;
+      xfer += iprot->readString(this->value_.message);
+      (void) xfer;
+      value_.__isset.message = true;
+    }
+    loaded_.message = true;
+  }
+  return value_.message;
+}
+
+const char* ThriftNaClPhaseStats::ascii_fingerprint = "544ECE480807CBF158025B0BCE787BF7";
+const uint8_t ThriftNaClPhaseStats::binary_fingerprint[16] = {0x54,0x4E,0xCE,0x48,0x08,0x07,0xCB,0xF1,0x58,0x02,0x5B,0x0B,0xCE,0x78,0x7B,0xF7};
+
+using ::apache::thrift::protocol::TFieldTypeSpec;
+
+/* static */
+const TFieldTypeSpec ThriftNaClPhaseStats::field_types[] = {
+  {1, ::apache::thrift::protocol::T_STRING, "phase"},
+  {2, ::apache::thrift::protocol::T_I64, "count"},
+  {3, ::apache::thrift::protocol::T_I64, "total_ns"},
+  {4, ::apache::thrift::protocol::T_I64, "max_ns"},
+  {5, ::apache::thrift::protocol::T_LIST, "histogram"},
+};
+
+/* static */
+const TFieldTypeSpec* ThriftNaClPhaseStats::get_field_type(const std::string& fname) {
+  switch (fname.size()) {
+    case 5:
+      if (memcmp(fname.data(), "phase", 5) == 0) return &field_types[0];
+      if (memcmp(fname.data(), "count", 5) == 0) return &field_types[1];
+      break;
+    case 6:
+      if (memcmp(fname.data(), "max_ns", 6) == 0) return &field_types[3];
+      break;
+    case 8:
+      if (memcmp(fname.data(), "total_ns", 8) == 0) return &field_types[2];
+      break;
+    case 9:
+      if (memcmp(fname.data(), "histogram", 9) == 0) return &field_types[4];
+      break;
+  }
+  return NULL;
+}
+
+uint32_t ThriftNaClPhaseStats::read(::apache::thrift::protocol::TProtocol* iprot) {
+
+  uint32_t xfer = 0;
+  std::string fname;
+  ::apache::thrift::protocol::TType ftype;
+  int16_t fid;
+
+  iprot->setNextStructFields(field_types, 5);
+  xfer += iprot->readStructBegin(fname);
+
+  using ::apache::thrift::protocol::TProtocolException;
+
+
+  while (true)
+  {
+    xfer += iprot->readFieldBegin(fname, ftype, fid);
+    if (ftype == ::apache::thrift::protocol::T_STOP) {
+      break;
+    }
+    if (fid == ::apache::thrift::protocol::kFieldIdUnknown) {
+      const TFieldTypeSpec* field_type = get_field_type(fname);
+      if (field_type != NULL) {
+        fid = field_type->fid;
+        ftype = field_type->ftype;
+      }
+    }
+    switch (fid)
+    {
+      case 1:
+        if (ftype == ::apache::thrift::protocol::T_STRING) {
+          xfer += iprot->readString(this->phase);
+          this->__isset.phase = true;
+        } else {
+          xfer += iprot->skip(ftype);
+        }
+        break;
+      case 2:
+        if (ftype == ::apache::thrift::protocol::T_I64) {
+          xfer += iprot->readI64(this->count);
+          this->__isset.count = true;
+        } else {
+          xfer += iprot->skip(ftype);
+        }
+        break;
+      case 3:
+        if (ftype == ::apache::thrift::protocol::T_I64) {
+          xfer += iprot->readI64(this->total_ns);
+          this->__isset.total_ns = true;
+        } else {
+          xfer += iprot->skip(ftype);
+        }
+        break;
+      case 4:
+        if (ftype == ::apache::thrift::protocol::T_I64) {
+          xfer += iprot->readI64(this->max_ns);
+          this->__isset.max_ns = true;
+        } else {
+          xfer += iprot->skip(ftype);
+        }
+        break;
+      case 5:
+        if (ftype == ::apache::thrift::protocol::T_LIST) {
+          {
+            this->histogram.clear();
+            uint32_t _size0;
+            ::apache::thrift::protocol::TType _etype3 = ::apache::thrift::protocol::T_I64;
+            xfer += iprot->readListBegin(_etype3, _size0);
+            if (_size0 > 0) {
+              if (_etype3 != ::apache::thrift::protocol::T_I64) {
+                throw ::apache::thrift::protocol::TProtocolException(::apache::thrift::protocol::TProtocolException::INVALID_DATA);
+              }
+              this->histogram.resize(_size0);
+              xfer += iprot->readI64Array(&this->histogram[0], _size0);
+            }
+            xfer += iprot->readListEnd();
+          }
+          this->__isset.histogram = true;
+        } else {
+          xfer += iprot->skip(ftype);
+        }
+        break;
+      default:
+        xfer += iprot->skip(ftype);
+        break;
+    }
+    xfer += iprot->readFieldEnd();
+  }
+
+  xfer += iprot->readStructEnd();
+
+  return xfer;
+}
+
+uint32_t ThriftNaClPhaseStats::write(::apache::thrift::protocol::TProtocol* oprot) const {
+  uint32_t xfer = 0;
+  xfer += oprot->writeStructBegin("ThriftNaClPhaseStats");
+
+  if (this->__isset.phase) {
+    xfer += oprot->writeFieldBegin("phase", ::apache::thrift::protocol::T_STRING, 1);
+    xfer += oprot->writeString(this->phase);
+    xfer += oprot->writeFieldEnd();
+  }
+  if (this->__isset.count) {
+    xfer += oprot->writeFieldBegin("count", ::apache::thrift::protocol::T_I64, 2);
+    xfer += oprot->writeI64(this->count);
+    xfer += oprot->writeFieldEnd();
+  }
+  if (this->__isset.total_ns) {
+    xfer += oprot->writeFieldBegin("total_ns", ::apache::thrift::protocol::T_I64, 3);
+    xfer += oprot->writeI64(this->total_ns);
+    xfer += oprot->writeFieldEnd();
+  }
+  if (this->__isset.max_ns) {
+    xfer += oprot->writeFieldBegin("max_ns", ::apache::thrift::protocol::T_I64, 4);
+    xfer += oprot->writeI64(this->max_ns);
+    xfer += oprot->writeFieldEnd();
+  }
+  if (this->__isset.histogram) {
+    xfer += oprot->writeFieldBegin("histogram", ::apache::thrift::protocol::T_LIST, 5);
+    {
+      xfer += oprot->writeListBegin(::apache::thrift::protocol::T_I64, static_cast<uint32_t>(this->histogram.size()));
+      if (!this->histogram.empty()) {
+        xfer += oprot->writeI64Array(&this->histogram[0], static_cast<uint32_t>(this->histogram.size()));
+      }
+      xfer += oprot->writeListEnd();
+    }
+    xfer += oprot->writeFieldEnd();
+  }
+  xfer += oprot->writeFieldStop();
+  xfer += oprot->writeStructEnd();
+  return xfer;
+}
+
+void swap(ThriftNaClPhaseStats &a, ThriftNaClPhaseStats &b) {
+  using ::std::swap;
+  swap(a.phase, b.phase);
+  swap(a.count, b.count);
+  swap(a.total_ns, b.total_ns);
+  swap(a.max_ns, b.max_ns);
+  swap(a.histogram, b.histogram);
+  swap(a.__isset, b.__isset);
+}
+
+const std::string& ThriftNaClPhaseStatsView::get_phase() const {
+  if (!loaded_.phase) {
+    ::apache::thrift::protocol::TProtocol* iprot = beginField(ThriftNaClPhaseStats::field_types[0].name);
+    if (iprot != NULL) {
+      uint32_t xfer = 0;
+      xfer += iprot->readString(this->value_.phase);
+      (void) xfer;
+      value_.__isset.phase = true;
+    }
+    loaded_.phase = true;
+  }
+  return value_.phase;
+}
+
+const int64_t ThriftNaClPhaseStatsView::get_count() const {
+  if (!loaded_.count) {
+    ::apache::thrift::protocol::TProtocol* iprot = beginField(ThriftNaClPhaseStats::field_types[1].name);
+    if (iprot != NULL) {
+      uint32_t xfer = 0;
+      xfer += iprot->readI64(this->value_.count);
+      (void) xfer;
+      value_.__isset.count = true;
+    }
+    loaded_.count = true;
+  }
+  return value_.count;
+}
+
+const int64_t ThriftNaClPhaseStatsView::get_total_ns() const {
+  if (!loaded_.total_ns) {
+    ::apache::thrift::protocol::TProtocol* iprot = beginField(ThriftNaClPhaseStats::field_types[2].name);
+    if (iprot != NULL) {
+      uint32_t xfer = 0;
+      xfer += iprot->readI64(this->value_.total_ns);
+      (void) xfer;
+      value_.__isset.total_ns = true;
+    }
+    loaded_.total_ns = true;
+  }
+  return value_.total_ns;
+}
+
+const int64_t ThriftNaClPhaseStatsView::get_max_ns() const {
+  if (!loaded_.max_ns) {
+    ::apache::thrift::protocol::TProtocol* iprot = beginField(ThriftNaClPhaseStats::field_types[3].name);
+    if (iprot != NULL) {
+      uint32_t xfer = 0;
+      xfer += iprot->readI64(this->value_.max_ns);
+      (void) xfer;
+      value_.__isset.max_ns = true;
+    }
+    loaded_.max_ns = true;
+  }
+  return value_.max_ns;
+}
+
+const std::vector<int64_t> & ThriftNaClPhaseStatsView::get_histogram() const {
+  if (!loaded_.histogram) {
+    ::apache::thrift::protocol::TProtocol* iprot = beginField(ThriftNaClPhaseStats::field_types[4].name);
+    if (iprot != NULL) {
+      uint32_t xfer = 0;
+      {
+        this->value_.histogram.clear();
+        uint32_t _size4;
+        ::apache::thrift::protocol::TType _etype7 = ::apache::thrift::protocol::T_I64;
+        xfer += iprot->readListBegin(_etype7, _size4);
+        if (_size4 > 0) {
+          if (_etype7 != ::apache::thrift::protocol::T_I64) {
+            throw ::apache::thrift::protocol::TProtocolException(::apache::thrift::protocol::TProtocolException::INVALID_DATA);
+          }
+          this->value_.histogram.resize(_size4);
+          xfer += iprot->readI64Array(&this->value_.histogram[0], _size4);
+        }
+        xfer += iprot->readListEnd();
+      }
+      (void) xfer;
+      value_.__isset.histogram = true;
+    }
+    loaded_.histogram = true;
+  }
+  return value_.histogram;
+}
+
+const char* ThriftNaClMessageStats::ascii_fingerprint = "80B6D24D48D20210CECD882D84F01CC8";
+const uint8_t ThriftNaClMessageStats::binary_fingerprint[16] = {0x80,0xB6,0xD2,0x4D,0x48,0xD2,0x02,0x10,0xCE,0xCD,0x88,0x2D,0x84,0xF0,0x1C,0xC8};
+
+using ::apache::thrift::protocol::TFieldTypeSpec;
+
+/* static */
+const TFieldTypeSpec ThriftNaClMessageStats::field_types[] = {
+  {1, ::apache::thrift::protocol::T_STRING, "message_type"},
+  {2, ::apache::thrift::protocol::T_I64, "count"},
+  {3, ::apache::thrift::protocol::T_I64, "request_nodes"},
+  {4, ::apache::thrift::protocol::T_I64, "request_bytes"},
+  {5, ::apache::thrift::protocol::T_I64, "response_nodes"},
+  {6, ::apache::thrift::protocol::T_I64, "response_bytes"},
+  {7, ::apache::thrift::protocol::T_LIST, "phases"},
+  {8, ::apache::thrift::protocol::T_I64, "cache_hits"},
+  {9, ::apache::thrift::protocol::T_I64, "cache_misses"},
+};
+
+/* static */
+const TFieldTypeSpec* ThriftNaClMessageStats::get_field_type(const std::string& fname) {
+  switch (fname.size()) {
+    case 5:
+      if (memcmp(fname.data(), "count", 5) == 0) return &field_types[1];
+      break;
+    case 6:
+      if (memcmp(fname.data(), "phases", 6) == 0) return &field_types[6];
+      break;
+    case 10:
+      if (memcmp(fname.data(), "cache_hits", 10) == 0) return &field_types[7];
+      break;
+    case 12:
+      if (memcmp(fname.data(), "message_type", 12) == 0) return &field_types[0];
+      if (memcmp(fname.data(), "cache_misses", 12) == 0) return &field_types[8];
+      break;
+    case 13:
+      if (memcmp(fname.data(), "request_nodes", 13) == 0) return &field_types[2];
+      if (memcmp(fname.data(), "request_bytes", 13) == 0) return &field_types[3];
+      break;
+    case 14:
+      if (memcmp(fname.data(), "response_nodes", 14) == 0) return &field_types[4];
+      if (memcmp(fname.data(), "response_bytes", 14) == 0) return &field_types[5];
+      break;
+  }
+  return NULL;
+}
+
+uint32_t ThriftNaClMessageStats::read(::apache::thrift::protocol::TProtocol* iprot) {
+
+  uint32_t xfer = 0;
+  std::string fname;
+  ::apache::thrift::protocol::TType ftype;
+  int16_t fid;
+
+  iprot->setNextStructFields(field_types, 9);
+  xfer += iprot->readStructBegin(fname);
+
+  using ::apache::thrift::protocol::TProtocolException;
+
+
+  while (true)
+  {
+    xfer += iprot->readFieldBegin(fname, ftype, fid);
+    if (ftype == ::apache::thrift::protocol::T_STOP) {
+      break;
+    }
+    if (fid == ::apache::thrift::protocol::kFieldIdUnknown) {
+      const TFieldTypeSpec* field_type = get_field_type(fname);
+      if (field_type != NULL) {
+        fid = field_type->fid;
+        ftype = field_type->ftype;
+      }
+    }
+    switch (fid)
+    {
+      case 1:
+        if (ftype == ::apache::thrift::protocol::T_STRING) {
+          xfer += iprot->readString(this->message_type);
+          this->__isset.message_type = true;
+        } else {
+          xfer += iprot->skip(ftype);
+        }
+        break;
+      case 2:
+        if (ftype == ::apache::thrift::protocol::T_I64) {
+          xfer += iprot->readI64(this->count);
+          this->__isset.count = true;
+        } else {
+          xfer += iprot->skip(ftype);
+        }
+        break;
+      case 3:
+        if (ftype == ::apache::thrift::protocol::T_I64) {
+          xfer += iprot->readI64(this->request_nodes);
+          this->__isset.request_nodes = true;
+        } else {
+          xfer += iprot->skip(ftype);
+        }
+        break;
+      case 4:
+        if (ftype == ::apache::thrift::protocol::T_I64) {
+          xfer += iprot->readI64(this->request_bytes);
+          this->__isset.request_bytes = true;
+        } else {
+          xfer += iprot->skip(ftype);
+        }
+        break;
+      case 5:
+        if (ftype == ::apache::thrift::protocol::T_I64) {
+          xfer += iprot->readI64(this->response_nodes);
+          this->__isset.response_nodes = true;
+        } else {
+          xfer += iprot->skip(ftype);
+        }
+        break;
+      case 6:
+        if (ftype == ::apache::thrift::protocol::T_I64) {
+          xfer += iprot->readI64(this->response_bytes);
+          this->__isset.response_bytes = true;
+        } else {
+          xfer += iprot->skip(ftype);
+        }
+        break;
+      case 7:
+        if (ftype == ::apache::thrift::protocol::T_LIST) {
+          {
+            this->phases.clear();
+            uint32_t _size8;
+            ::apache::thrift::protocol::TType _etype11;
+            xfer += iprot->readListBegin(_etype11, _size8);
+            this->phases.resize(_size8);
+            uint32_t _i12;
+            for (_i12 = 0; _i12 < _size8; ++_i12)
+            {
+              xfer += this->phases[_i12].read(iprot);
+            }
+            xfer += iprot->readListEnd();
+          }
+          this->__isset.phases = true;
+        } else {
+          xfer += iprot->skip(ftype);
+        }
+        break;
+      case 8:
+        if (ftype == ::apache::thrift::protocol::T_I64) {
+          xfer += iprot->readI64(this->cache_hits);
+          this->__isset.cache_hits = true;
+        } else {
+          xfer += iprot->skip(ftype);
+        }
+        break;
+      case 9:
+        if (ftype == ::apache::thrift::protocol::T_I64) {
+          xfer += iprot->readI64(this->cache_misses);
+          this->__isset.cache_misses = true;
+        } else {
+          xfer += iprot->skip(ftype);
+        }
+        break;
+      default:
+        xfer += iprot->skip(ftype);
+        break;
+    }
+    xfer += iprot->readFieldEnd();
+  }
+
+  xfer += iprot->readStructEnd();
+
+  return xfer;
+}
+
+uint32_t ThriftNaClMessageStats::write(::apache::thrift::protocol::TProtocol* oprot) const {
+  uint32_t xfer = 0;
+  xfer += oprot->writeStructBegin("ThriftNaClMessageStats");
+
+  if (this->__isset.message_type) {
+    xfer += oprot->writeFieldBegin("message_type", ::apache::thrift::protocol::T_STRING, 1);
+    xfer += oprot->writeString(this->message_type);
+    xfer += oprot->writeFieldEnd();
+  }
+  if (this->__isset.count) {
+    xfer += oprot->writeFieldBegin("count", ::apache::thrift::protocol::T_I64, 2);
+    xfer += oprot->writeI64(this->count);
+    xfer += oprot->writeFieldEnd();
+  }
+  if (this->__isset.request_nodes) {
+    xfer += oprot->writeFieldBegin("request_nodes", ::apache::thrift::protocol::T_I64, 3);
+    xfer += oprot->writeI64(this->request_nodes);
+    xfer += oprot->writeFieldEnd();
+  }
+  if (this->__isset.request_bytes) {
+    xfer += oprot->writeFieldBegin("request_bytes", ::apache::thrift::protocol::T_I64, 4);
+    xfer += oprot->writeI64(this->request_bytes);
+    xfer += oprot->writeFieldEnd();
+  }
+  if (this->__isset.response_nodes) {
+    xfer += oprot->writeFieldBegin("response_nodes", ::apache::thrift::protocol::T_I64, 5);
+    xfer += oprot->writeI64(this->response_nodes);
+    xfer += oprot->writeFieldEnd();
+  }
+  if (this->__isset.response_bytes) {
+    xfer += oprot->writeFieldBegin("response_bytes", ::apache::thrift::protocol::T_I64, 6);
+    xfer += oprot->writeI64(this->response_bytes);
+    xfer += oprot->writeFieldEnd();
+  }
+  if (this->__isset.phases) {
+    xfer += oprot->writeFieldBegin("phases", ::apache::thrift::protocol::T_LIST, 7);
+    {
+      xfer += oprot->writeListBegin(::apache::thrift::protocol::T_STRUCT, static_cast<uint32_t>(this->phases.size()));
+      std::vector<ThriftNaClPhaseStats> ::const_iterator _iter13;
+      for (_iter13 = this->phases.begin(); _iter13 != this->phases.end(); ++_iter13)
+      {
+        xfer += (*_iter13).write(oprot);
+      }
+      xfer += oprot->writeListEnd();
+    }
+    xfer += oprot->writeFieldEnd();
+  }
+  if (this->__isset.cache_hits) {
+    xfer += oprot->writeFieldBegin("cache_hits", ::apache::thrift::protocol::T_I64, 8);
+    xfer += oprot->writeI64(this->cache_hits);
+    xfer += oprot->writeFieldEnd();
+  }
+  if (this->__isset.cache_misses) {
+    xfer += oprot->writeFieldBegin("cache_misses", ::apache::thrift::protocol::T_I64, 9);
+    xfer += oprot->writeI64(this->cache_misses);
+    xfer += oprot->writeFieldEnd();
+  }
+  xfer += oprot->writeFieldStop();
+  xfer += oprot->writeStructEnd();
+  return xfer;
+}
+
+void swap(ThriftNaClMessageStats &a, ThriftNaClMessageStats &b) {
+  using ::std::swap;
+  swap(a.message_type, b.message_type);
+  swap(a.count, b.count);
+  swap(a.request_nodes, b.request_nodes);
+  swap(a.request_bytes, b.request_bytes);
+  swap(a.response_nodes, b.response_nodes);
+  swap(a.response_bytes, b.response_bytes);
+  swap(a.phases, b.phases);
+  swap(a.cache_hits, b.cache_hits);
+  swap(a.cache_misses, b.cache_misses);
+  swap(a.__isset, b.__isset);
+}
+
+const std::string& ThriftNaClMessageStatsView::get_message_type() const {
+  if (!loaded_.message_type) {
+    ::apache::thrift::protocol::TProtocol* iprot = beginField(ThriftNaClMessageStats::field_types[0].name);
+    if (iprot != NULL) {
+      uint32_t xfer = 0;
+      xfer += iprot->readString(this->value_.message_type);
+      (void) xfer;
+      value_.__isset.message_type = true;
+    }
+    loaded_.message_type = true;
+  }
+  return value_.message_type;
+}
+
+const int64_t ThriftNaClMessageStatsView::get_count() const {
+  if (!loaded_.count) {
+    ::apache::thrift::protocol::TProtocol* iprot = beginField(ThriftNaClMessageStats::field_types[1].name);
+    if (iprot != NULL) {
+      uint32_t xfer = 0;
+      xfer += iprot->readI64(this->value_.count);
+      (void) xfer;
+      value_.__isset.count = true;
+    }
+    loaded_.count = true;
+  }
+  return value_.count;
+}
+
+const int64_t ThriftNaClMessageStatsView::get_request_nodes() const {
+  if (!loaded_.request_nodes) {
+    ::apache::thrift::protocol::TProtocol* iprot = beginField(ThriftNaClMessageStats::field_types[2].name);
+    if (iprot != NULL) {
+      uint32_t xfer = 0;
+      xfer += iprot->readI64(this->value_.request_nodes);
+      (void) xfer;
+      value_.__isset.request_nodes = true;
+    }
+    loaded_.request_nodes = true;
+  }
+  return value_.request_nodes;
+}
+
+const int64_t ThriftNaClMessageStatsView::get_request_bytes() const {
+  if (!loaded_.request_bytes) {
+    ::apache::thrift::protocol::TProtocol* iprot = beginField(ThriftNaClMessageStats::field_types[3].name);
+    if (iprot != NULL) {
+      uint32_t xfer = 0;
+      xfer += iprot->readI64(this->value_.request_bytes);
+      (void) xfer;
+      value_.__isset.request_bytes = true;
+    }
+    loaded_.request_bytes = true;
+  }
+  return value_.request_bytes;
+}
+
+const int64_t ThriftNaClMessageStatsView::get_response_nodes() const {
+  if (!loaded_.response_nodes) {
+    ::apache::thrift::protocol::TProtocol* iprot = beginField(ThriftNaClMessageStats::field_types[4].name);
+    if (iprot != NULL) {
+      uint32_t xfer = 0;
+      xfer += iprot->readI64(this->value_.response_nodes);
+      (void) xfer;
+      value_.__isset.response_nodes = true;
+    }
+    loaded_.response_nodes = true;
+  }
+  return value_.response_nodes;
+}
+
+const int64_t ThriftNaClMessageStatsView::get_response_bytes() const {
+  if (!loaded_.response_bytes) {
+    ::apache::thrift::protocol::TProtocol* iprot = beginField(ThriftNaClMessageStats::field_types[5].name);
+    if (iprot != NULL) {
+      uint32_t xfer = 0;
+      xfer += iprot->readI64(this->value_.response_bytes);
+      (void) xfer;
+      value_.__isset.response_bytes = true;
+    }
+    loaded_.response_bytes = true;
+  }
+  return value_.response_bytes;
+}
+
+const std::vector<ThriftNaClPhaseStats> & ThriftNaClMessageStatsView::get_phases() const {
+  if (!loaded_.phases) {
+    ::apache::thrift::protocol::TProtocol* iprot = beginField(ThriftNaClMessageStats::field_types[6].name);
+    if (iprot != NULL) {
+      uint32_t xfer = 0;
+      {
+        this->value_.phases.clear();
+        uint32_t _size14;
+        ::apache::thrift::protocol::TType _etype17;
+        xfer += iprot->readListBegin(_etype17, _size14);
+        this->value_.phases.resize(_size14);
+        uint32_t _i18;
+        for (_i18 = 0; _i18 < _size14; ++_i18)
+        {
+          xfer += this->value_.phases[_i18].read(iprot);
+        }
+        xfer += iprot->readListEnd();
+      }
+      (void) xfer;
+      value_.__isset.phases = true;
+    }
+    loaded_.phases = true;
+  }
+  return value_.phases;
+}
+
+const int64_t ThriftNaClMessageStatsView::get_cache_hits() const {
+  if (!loaded_.cache_hits) {
+    ::apache::thrift::protocol::TProtocol* iprot = beginField(ThriftNaClMessageStats::field_types[7].name);
+    if (iprot != NULL) {
+      uint32_t xfer = 0;
+      xfer += iprot->readI64(this->value_.cache_hits);
+      (void) xfer;
+      value_.__isset.cache_hits = true;
+    }
+    loaded_.cache_hits = true;
+  }
+  return value_.cache_hits;
+}
+
+const int64_t ThriftNaClMessageStatsView::get_cache_misses() const {
+  if (!loaded_.cache_misses) {
+    ::apache::thrift::protocol::TProtocol* iprot = beginField(ThriftNaClMessageStats::field_types[8].name);
+    if (iprot != NULL) {
+      uint32_t xfer = 0;
+      xfer += iprot->readI64(this->value_.cache_misses);
+      (void) xfer;
+      value_.__isset.cache_misses = true;
+    }
+    loaded_.cache_misses = true;
+  }
+  return value_.cache_misses;
+}
+
+const char* ThriftNaClStatsRequest::ascii_fingerprint = "BF054652DEF86253C2BEE7D947F167DD";
+const uint8_t ThriftNaClStatsRequest::binary_fingerprint[16] = {0xBF,0x05,0x46,0x52,0xDE,0xF8,0x62,0x53,0xC2,0xBE,0xE7,0xD9,0x47,0xF1,0x67,0xDD};
+
+using ::apache::thrift::protocol::TFieldTypeSpec;
+
+/* static */
+const TFieldTypeSpec ThriftNaClStatsRequest::field_types[] = {
+  {1, ::apache::thrift::protocol::T_BOOL, "reset"},
+};
+
+/* static */
+const TFieldTypeSpec* ThriftNaClStatsRequest::get_field_type(const std::string& fname) {
+  switch (fname.size()) {
+    case 5:
+      if (memcmp(fname.data(), "reset", 5) == 0) return &field_types[0];
+      break;
+  }
+  return NULL;
+}
+
+uint32_t ThriftNaClStatsRequest::read(::apache::thrift::protocol::TProtocol* iprot) {
+
+  uint32_t xfer = 0;
+  std::string fname;
+  ::apache::thrift::protocol::TType ftype;
+  int16_t fid;
+
+  iprot->setNextStructFields(field_types, 1);
+  xfer += iprot->readStructBegin(fname);
+
+  using ::apache::thrift::protocol::TProtocolException;
+
+
+  while (true)
+  {
+    xfer += iprot->readFieldBegin(fname, ftype, fid);
+    if (ftype == ::apache::thrift::protocol::T_STOP) {
+      break;
+    }
+    if (fid == ::apache::thrift::protocol::kFieldIdUnknown) {
+      const TFieldTypeSpec* field_type = get_field_type(fname);
+      if (field_type != NULL) {
+        fid = field_type->fid;
+        ftype = field_type->ftype;
+      }
+    }
+    switch (fid)
+    {
+      case 1:
+        if (ftype == ::apache::thrift::protocol::T_BOOL) {
+          xfer += iprot->readBool(this->reset);
+          this->__isset.reset = true;
+        } else {
+          xfer += iprot->skip(ftype);
+        }
+        break;
+      default:
+        xfer += iprot->skip(ftype);
+        break;
+    }
+    xfer += iprot->readFieldEnd();
+  }
+
+  xfer += iprot->readStructEnd();
+
+  return xfer;
+}
+
+uint32_t ThriftNaClStatsRequest::write(::apache::thrift::protocol::TProtocol* oprot) const {
+  uint32_t xfer = 0;
+  xfer += oprot->writeStructBegin("ThriftNaClStatsRequest");
+
+  if (this->__isset.reset) {
+    xfer += oprot->writeFieldBegin("reset", ::apache::thrift::protocol::T_BOOL, 1);
+    xfer += oprot->writeBool(this->reset);
+    xfer += oprot->writeFieldEnd();
+  }
+  xfer += oprot->writeFieldStop();
+  xfer += oprot->writeStructEnd();
+  return xfer;
+}
+
+void swap(ThriftNaClStatsRequest &a, ThriftNaClStatsRequest &b) {
+  using ::std::swap;
+  swap(a.reset, b.reset);
+  swap(a.__isset, b.__isset);
+}
+
+const bool ThriftNaClStatsRequestView::get_reset() const {
+  if (!loaded_.reset) {
+    ::apache::thrift::protocol::TProtocol* iprot = beginField(ThriftNaClStatsRequest::field_types[0].name);
+    if (iprot != NULL) {
+      uint32_t xfer = 0;
+      xfer += iprot->readBool(this->value_.reset);
+      (void) xfer;
+      value_.__isset.reset = true;
+    }
+    loaded_.reset = true;
+  }
+  return value_.reset;
+}
+
+const char* ThriftNaClStats::ascii_fingerprint = "4E4FD466653BD4E7ED9E64DC7B420CAD";
+const uint8_t ThriftNaClStats::binary_fingerprint[16] = {0x4E,0x4F,0xD4,0x66,0x65,0x3B,0xD4,0xE7,0xED,0x9E,0x64,0xDC,0x7B,0x42,0x0C,0xAD};
+
+using ::apache::thrift::protocol::TFieldTypeSpec;
+
+/* static */
+const TFieldTypeSpec ThriftNaClStats::field_types[] = {
+  {1, ::apache::thrift::protocol::T_LIST, "message_types"},
+};
+
+/* static */
+const TFieldTypeSpec* ThriftNaClStats::get_field_type(const std::string& fname) {
+  switch (fname.size()) {
+    case 13:
+      if (memcmp(fname.data(), "message_types", 13) == 0) return &field_types[0];
+      break;
+  }
+  return NULL;
+}
+
+uint32_t ThriftNaClStats::read(::apache::thrift::protocol::TProtocol* iprot) {
+
+  uint32_t xfer = 0;
+  std::string fname;
+  ::apache::thrift::protocol::TType ftype;
+  int16_t fid;
+
+  iprot->setNextStructFields(field_types, 1);
+  xfer += iprot->readStructBegin(fname);
+
+  using ::apache::thrift::protocol::TProtocolException;
+
+
+  while (true)
+  {
+    xfer += iprot->readFieldBegin(fname, ftype, fid);
+    if (ftype == ::apache::thrift::protocol::T_STOP) {
+      break;
+    }
+    if (fid == ::apache::thrift::protocol::kFieldIdUnknown) {
+      const TFieldTypeSpec* field_type = get_field_type(fname);
+      if (field_type != NULL) {
+        fid = field_type->fid;
+        ftype = field_type->ftype;
+      }
+    }
+    switch (fid)
+    {
+      case 1:
+        if (ftype == ::apache::thrift::protocol::T_LIST) {
+          {
+            this->message_types.clear();
+            uint32_t _size19;
+            ::apache::thrift::protocol::TType _etype22;
+            xfer += iprot->readListBegin(_etype22, _size19);
+            this->message_types.resize(_size19);
+            uint32_t _i23;
+            for (_i23 = 0; _i23 < _size19; ++_i23)
+            {
+              xfer += this->message_types[_i23].read(iprot);
+            }
+            xfer += iprot->readListEnd();
+          }
+          this->__isset.message_types = true;
+        } else {
+          xfer += iprot->skip(ftype);
+        }
+        break;
+      default:
+        xfer += iprot->skip(ftype);
+        break;
+    }
+    xfer += iprot->readFieldEnd();
+  }
+
+  xfer += iprot->readStructEnd();
+
+  return xfer;
+}
+
+uint32_t ThriftNaClStats::write(::apache::thrift::protocol::TProtocol* oprot) const {
+  uint32_t xfer = 0;
+  xfer += oprot->writeStructBegin("ThriftNaClStats");
+
+  if (this->__isset.message_types) {
+    xfer += oprot->writeFieldBegin("message_types", ::apache::thrift::protocol::T_LIST, 1);
+    {
+      xfer += oprot->writeListBegin(::apache::thrift::protocol::T_STRUCT, static_cast<uint32_t>(this->message_types.size()));
+      std::vector<ThriftNaClMessageStats> ::const_iterator _iter24;
+      for (_iter24 = this->message_types.begin(); _iter24 != this->message_types.end(); ++_iter24)
+      {
+        xfer += (*_iter24).write(oprot);
+      }
+      xfer += oprot->writeListEnd();
+    }
+    xfer += oprot->writeFieldEnd();
+  }
+  xfer += oprot->writeFieldStop();
+  xfer += oprot->writeStructEnd();
+  return xfer;
+}
+
+void swap(ThriftNaClStats &a, ThriftNaClStats &b) {
+  using ::std::swap;
+  swap(a.message_types, b.message_types);
+  swap(a.__isset, b.__isset);
+}
+
+const std::vector<ThriftNaClMessageStats> & ThriftNaClStatsView::get_message_types() const {
+  if (!loaded_.message_types) {
+    ::apache::thrift::protocol::TProtocol* iprot = beginField(ThriftNaClStats::field_types[0].name);
+    if (iprot != NULL) {
+      uint32_t xfer = 0;
+      {
+        this->value_.message_types.clear();
+        uint32_t _size25;
+        ::apache::thrift::protocol::TType _etype28;
+        xfer += iprot->readListBegin(_etype28, _size25);
+        this->value_.message_types.resize(_size25);
+        uint32_t _i29;
+        for (_i29 = 0; _i29 < _size25; ++_i29)
+        {
+          xfer += this->value_.message_types[_i29].read(iprot);
+        }
+        xfer += iprot->readListEnd();
+      }
+      (void) xfer;
+      value_.__isset.message_types = true;
+    }
+    loaded_.message_types = true;
+  }
+  return value_.message_types;
+}
+
+const char* ThriftNaClCancelRequest::ascii_fingerprint = "66E694018C17E5B65A59AE8F55CCA3CD";
+const uint8_t ThriftNaClCancelRequest::binary_fingerprint[16] = {0x66,0xE6,0x94,0x01,0x8C,0x17,0xE5,0xB6,0x5A,0x59,0xAE,0x8F,0x55,0xCC,0xA3,0xCD};
+
+using ::apache::thrift::protocol::TFieldTypeSpec;
+
+/* static */
+const TFieldTypeSpec ThriftNaClCancelRequest::field_types[] = {
+  {1, ::apache::thrift::protocol::T_STRING, "id"},
+};
+
+/* static */
+const TFieldTypeSpec* ThriftNaClCancelRequest::get_field_type(const std::string& fname) {
+  switch (fname.size()) {
+    case 2:
+      if (memcmp(fname.data(), "id", 2) == 0) return &field_types[0];
+      break;
+  }
+  return NULL;
+}
+
+uint32_t ThriftNaClCancelRequest::read(::apache::thrift::protocol::TProtocol* iprot) {
+
+  uint32_t xfer = 0;
+  std::string fname;
+  ::apache::thrift::protocol::TType ftype;
+  int16_t fid;
+
+  iprot->setNextStructFields(field_types, 1);
+  xfer += iprot->readStructBegin(fname);
+
+  using ::apache::thrift::protocol::TProtocolException;
+
+
+  while (true)
+  {
+    xfer += iprot->readFieldBegin(fname, ftype, fid);
+    if (ftype == ::apache::thrift::protocol::T_STOP) {
+      break;
+    }
+    if (fid == ::apache::thrift::protocol::kFieldIdUnknown) {
+      const TFieldTypeSpec* field_type = get_field_type(fname);
+      if (field_type != NULL) {
+        fid = field_type->fid;
+        ftype = field_type->ftype;
+      }
+    }
+    switch (fid)
+    {
+      case 1:
+        if (ftype == ::apache::thrift::protocol::T_STRING) {
+          xfer += iprot->readString(this->id);
+          this->__isset.id = true;
+        } else {
+          xfer += iprot->skip(ftype);
+        }
+        break;
+      default:
+        xfer += iprot->skip(ftype);
+        break;
+    }
+    xfer += iprot->readFieldEnd();
+  }
+
+  xfer += iprot->readStructEnd();
+
+  return xfer;
+}
+
+uint32_t ThriftNaClCancelRequest::write(::apache::thrift::protocol::TProtocol* oprot) const {
+  uint32_t xfer = 0;
+  xfer += oprot->writeStructBegin("ThriftNaClCancelRequest");
+
+  if (this->__isset.id) {
+    xfer += oprot->writeFieldBegin("id", ::apache::thrift::protocol::T_STRING, 1);
+    xfer += oprot->writeString(this->id);
+    xfer += oprot->writeFieldEnd();
+  }
+  xfer += oprot->writeFieldStop();
+  xfer += oprot->writeStructEnd();
+  return xfer;
+}
+
+void swap(ThriftNaClCancelRequest &a, ThriftNaClCancelRequest &b) {
+  using ::std::swap;
+  swap(a.id, b.id);
+  swap(a.__isset, b.__isset);
+}
+
+const std::string& ThriftNaClCancelRequestView::get_id() const {
+  if (!loaded_.id) {
+    ::apache::thrift::protocol::TProtocol* iprot = beginField(ThriftNaClCancelRequest::field_types[0].name);
+    if (iprot != NULL) {
+      uint32_t xfer = 0;
+      xfer += iprot->readString(this->value_.id);
+      (void) xfer;
+      value_.__isset.id = true;
+    }
+    loaded_.id = true;
+  }
+  return value_.id;
+}
+
+const char* ThriftNaClCancelResponse::ascii_fingerprint = "BF054652DEF86253C2BEE7D947F167DD";
+const uint8_t ThriftNaClCancelResponse::binary_fingerprint[16] = {0xBF,0x05,0x46,0x52,0xDE,0xF8,0x62,0x53,0xC2,0xBE,0xE7,0xD9,0x47,0xF1,0x67,0xDD};
+
+using ::apache::thrift::protocol::TFieldTypeSpec;
+
+/* static */
+const TFieldTypeSpec ThriftNaClCancelResponse::field_types[] = {
+  {1, ::apache::thrift::protocol::T_BOOL, "cancelled"},
+};
+
+/* static */
+const TFieldTypeSpec* ThriftNaClCancelResponse::get_field_type(const std::string& fname) {
+  switch (fname.size()) {
+    case 9:
+      if (memcmp(fname.data(), "cancelled", 9) == 0) return &field_types[0];
+      break;
+  }
+  return NULL;
+}
+
+uint32_t ThriftNaClCancelResponse::read(::apache::thrift::protocol::TProtocol* iprot) {
+
+  uint32_t xfer = 0;
+  std::string fname;
+  ::apache::thrift::protocol::TType ftype;
+  int16_t fid;
+
+  iprot->setNextStructFields(field_types, 1);
+  xfer += iprot->readStructBegin(fname);
+
+  using ::apache::thrift::protocol::TProtocolException;
+
+
+  while (true)
+  {
+    xfer += iprot->readFieldBegin(fname, ftype, fid);
+    if (ftype == ::apache::thrift::protocol::T_STOP) {
+      break;
+    }
+    if (fid == ::apache::thrift::protocol::kFieldIdUnknown) {
+      const TFieldTypeSpec* field_type = get_field_type(fname);
+      if (field_type != NULL) {
+        fid = field_type->fid;
+        ftype = field_type->ftype;
+      }
+    }
+    switch (fid)
+    {
+      case 1:
+        if (ftype == ::apache::thrift::protocol::T_BOOL) {
+          xfer += iprot->readBool(this->cancelled);
+          this->__isset.cancelled = true;
+        } else {
+          xfer += iprot->skip(ftype);
+        }
+        break;
+      default:
+        xfer += iprot->skip(ftype);
+        break;
+    }
+    xfer += iprot->readFieldEnd();
+  }
+
+  xfer += iprot->readStructEnd();
+
+  return xfer;
+}
+
+uint32_t ThriftNaClCancelResponse::write(::apache::thrift::protocol::TProtocol* oprot) const {
+  uint32_t xfer = 0;
+  xfer += oprot->writeStructBegin("ThriftNaClCancelResponse");
+
+  if (this->__isset.cancelled) {
+    xfer += oprot->writeFieldBegin("cancelled", ::apache::thrift::protocol::T_BOOL, 1);
+    xfer += oprot->writeBool(this->cancelled);
+    xfer += oprot->writeFieldEnd();
+  }
+  xfer += oprot->writeFieldStop();
+  xfer += oprot->writeStructEnd();
+  return xfer;
+}
+
+void swap(ThriftNaClCancelResponse &a, ThriftNaClCancelResponse &b) {
+  using ::std::swap;
+  swap(a.cancelled, b.cancelled);
+  swap(a.__isset, b.__isset);
+}
+
+const bool ThriftNaClCancelResponseView::get_cancelled() const {
+  if (!loaded_.cancelled) {
+    ::apache::thrift::protocol::TProtocol* iprot = beginField(ThriftNaClCancelResponse::field_types[0].name);
+    if (iprot != NULL) {
+      uint32_t xfer = 0;
+      xfer += iprot->readBool(this->value_.cancelled);
+      (void) xfer;
+      value_.__isset.cancelled = true;
+    }
+    loaded_.cancelled = true;
+  }
+  return value_.cancelled;
+}
+
+
@@ -0,0 +1,959 @@
+/**
+ * Autogenerated by Thrift Compiler (0.9.1)
+ *
+ * DO NOT EDIT UNLESS YOU ARE SURE THAT YOU KNOW WHAT YOU ARE DOING
+ *  @generated
+ */
+#ifndef thrift_nacl_TYPES_H
+#define thrift_nacl_TYPES_H
+
+#include <cstring>
+#include <string>
+
+#include <thrift/Thrift.h>
+#include <thrift/TApplicationException.h>
+#include <thrift/protocol/TProtocol.h>
+#include <thrift/transport/TTransport.h>
+
+#include <thrift/protocol/TNativeClientProtocol.h>
+
+#include <thrift/cxxfunctional.h>
+
+
+
+
+typedef struct _ThriftNaClError__isset {
+  _ThriftNaClError__isset() : type(false), message(false) {}
+  bool type;
+  bool message;
+} _ThriftNaClError__isset;
+
+class ThriftNaClError : public ::apache::thrift::TStruct {
+ public:
+
+  static const char* ascii_fingerprint; // = "D0297FC5011701BD87898CC36146A565";
+  static const uint8_t binary_fingerprint[16]; // = {0xD0,0x29,0x7F,0xC5,0x01,0x17,0x01,0xBD,0x87,0x89,0x8C,0xC3,0x61,0x46,0xA5,0x65};
+
+  ThriftNaClError() : type(), message() {
+  }
+
+  virtual ~ThriftNaClError() throw() {}
+
+
+  inline bool has_type() const {
+    return __isset.type;
+  }
+
+  inline const std::string& get_type() const {
+    return type;
+  }
+
+  inline void set_type(const std::string& val) {
+    type = val;
+    __isset.type = true;
+  }
+
+  inline std::string* mutable_type() {
+    __isset.type = true;
+    return &type;
+  }
+
+  inline bool has_message() const {
+    return __isset.message;
+  }
+
+  inline const std::string& get_message() const {
+    return message;
+  }
+
+  inline void set_message(const std::string& val) {
+    message = val;
+    __isset.message = true;
+  }
+
+  inline std::string* mutable_message() {
+    __isset.message = true;
+    return &message;
+  }
+
+  bool operator == (const ThriftNaClError & rhs) const
+  {
+    if (__isset.type != rhs.__isset.type)
+      return false;
+    else if (__isset.type && !(type == rhs.type))
+      return false;
+    if (__isset.message != rhs.__isset.message)
+      return false;
+    else if (__isset.message && !(message == rhs.message))
+      return false;
+    return true;
+  }
+  bool operator != (const ThriftNaClError &rhs) const {
+    return !(*this == rhs);
+  }
+
+  bool operator < (const ThriftNaClError & ) const;
+
+  virtual uint32_t read(::apache::thrift::protocol::TProtocol* iprot);
+  virtual uint32_t write(::apache::thrift::protocol::TProtocol* oprot) const;
+
+ private:
+  static const apache::thrift::protocol::TFieldTypeSpec field_types[];
+  static const apache::thrift::protocol::TFieldTypeSpec* get_field_type(const std::string& fname);
+
+  std::string type;
+  std::string message;
+
+  _ThriftNaClError__isset __isset;
+  friend void swap(ThriftNaClError &a, ThriftNaClError &b);
+
+  friend class ThriftNaClErrorView;
+
+};
+
+class ThriftNaClErrorView : public ::apache::thrift::protocol::TNativeClientView {
+ public:
+  ThriftNaClErrorView() {}
+  explicit ThriftNaClErrorView(const pp::Var& var)
+    : ::apache::thrift::protocol::TNativeClientView(var) {}
+
+  inline bool has_type() const {
+    return hasField(ThriftNaClError::field_types[0].name);
+  }
+  const std::string& get_type() const;
+
+  inline bool has_message() const {
+    return hasField(ThriftNaClError::field_types[1].name);
+  }
+  const std::string& get_message() const;
+
+ private:
+  struct Loaded {
+    Loaded() : type(false), message(false) {}
+    bool type;
+    bool message;
+  };
+
+  mutable ThriftNaClError value_;
+  mutable Loaded loaded_;
+};
+
+typedef struct _ThriftNaClPhaseStats__isset {
+  _ThriftNaClPhaseStats__isset() : phase(false), count(false), total_ns(false), max_ns(false), histogram(false) {}
+  bool phase;
+  bool count;
+  bool total_ns;
+  bool max_ns;
+  bool histogram;
+} _ThriftNaClPhaseStats__isset;
+
+class ThriftNaClPhaseStats : public ::apache::thrift::TStruct {
+ public:
+
+  static const char* ascii_fingerprint; // = "544ECE480807CBF158025B0BCE787BF7";
+  static const uint8_t binary_fingerprint[16]; // = {0x54,0x4E,0xCE,0x48,0x08,0x07,0xCB,0xF1,0x58,0x02,0x5B,0x0B,0xCE,0x78,0x7B,0xF7};
+
+  ThriftNaClPhaseStats() : phase(), count(0), total_ns(0), max_ns(0) {
+  }
+
+  virtual ~ThriftNaClPhaseStats() throw() {}
+
+
+  inline bool has_phase() const {
+    return __isset.phase;
+  }
+
+  inline const std::string& get_phase() const {
+    return phase;
+  }
+
+  inline void set_phase(const std::string& val) {
+    phase = val;
+    __isset.phase = true;
+  }
+
+  inline std::string* mutable_phase() {
+    __isset.phase = true;
+    return &phase;
+  }
+
+  inline bool has_count() const {
+    return __isset.count;
+  }
+
+  inline const int64_t get_count() const {
+    return count;
+  }
+
+  inline void set_count(const int64_t val) {
+    count = val;
+    __isset.count = true;
+  }
+
+  inline bool has_total_ns() const {
+    return __isset.total_ns;
+  }
+
+  inline const int64_t get_total_ns() const {
+    return total_ns;
+  }
+
+  inline void set_total_ns(const int64_t val) {
+    total_ns = val;
+    __isset.total_ns = true;
+  }
+
+  inline bool has_max_ns() const {
+    return __isset.max_ns;
+  }
+
+  inline const int64_t get_max_ns() const {
+    return max_ns;
+  }
+
+  inline void set_max_ns(const int64_t val) {
+    max_ns = val;
+    __isset.max_ns = true;
+  }
+
+  inline bool has_histogram() const {
+    return __isset.histogram;
+  }
+
+  inline const std::vector<int64_t> & get_histogram() const {
+    return histogram;
+  }
+
+  inline void set_histogram(const std::vector<int64_t> & val) {
+    histogram = val;
+    __isset.histogram = true;
+  }
+
+  inline std::vector<int64_t> * mutable_histogram() {
+    __isset.histogram = true;
+    return &histogram;
+  }
+
+  bool operator == (const ThriftNaClPhaseStats & rhs) const
+  {
+    if (__isset.phase != rhs.__isset.phase)
+      return false;
+    else if (__isset.phase && !(phase == rhs.phase))
+      return false;
+    if (__isset.count != rhs.__isset.count)
+      return false;
+    else if (__isset.count && !(count == rhs.count))
+      return false;
+    if (__isset.total_ns != rhs.__isset.total_ns)
+      return false;
+    else if (__isset.total_ns && !(total_ns == rhs.total_ns))
+      return false;
+    if (__isset.max_ns != rhs.__isset.max_ns)
+      return false;
+    else if (__isset.max_ns && !(max_ns == rhs.max_ns))
+      return false;
+    if (__isset.histogram != rhs.__isset.histogram)
+      return false;
+    else if (__isset.histogram && !(histogram == rhs.histogram))
+      return false;
+    return true;
+  }
+  bool operator != (const ThriftNaClPhaseStats &rhs) const {
+    return !(*this == rhs);
+  }
+
+  bool operator < (const ThriftNaClPhaseStats & ) const;
+
+  virtual uint32_t read(::apache::thrift::protocol::TProtocol* iprot);
+  virtual uint32_t write(::apache::thrift::protocol::TProtocol* oprot) const;
+
+ private:
+  static const apache::thrift::protocol::TFieldTypeSpec field_types[];
+  static const apache::thrift::protocol::TFieldTypeSpec* get_field_type(const std::string& fname);
+
+  std::string phase;
+  int64_t count;
+  int64_t total_ns;
+  int64_t max_ns;
+  std::vector<int64_t>  histogram;
+
+  _ThriftNaClPhaseStats__isset __isset;
+  friend void swap(ThriftNaClPhaseStats &a, ThriftNaClPhaseStats &b);
+
+  friend class ThriftNaClPhaseStatsView;
+
+};
+
+class ThriftNaClPhaseStatsView : public ::apache::thrift::protocol::TNativeClientView {
+ public:
+  ThriftNaClPhaseStatsView() {}
+  explicit ThriftNaClPhaseStatsView(const pp::Var& var)
+    : ::apache::thrift::protocol::TNativeClientView(var) {}
+
+  inline bool has_phase() const {
+    return hasField(ThriftNaClPhaseStats::field_types[0].name);
+  }
+  const std::string& get_phase() const;
+
+  inline bool has_count() const {
+    return hasField(ThriftNaClPhaseStats::field_types[1].name);
+  }
+  const int64_t get_count() const;
+
+  inline bool has_total_ns() const {
+    return hasField(ThriftNaClPhaseStats::field_types[2].name);
+  }
+  const int64_t get_total_ns() const;
+
+  inline bool has_max_ns() const {
+    return hasField(ThriftNaClPhaseStats::field_types[3].name);
+  }
+  const int64_t get_max_ns() const;
+
+  inline bool has_histogram() const {
+    return hasField(ThriftNaClPhaseStats::field_types[4].name);
+  }
+  const std::vector<int64_t> & get_histogram() const;
+
+ private:
+  struct Loaded {
+    Loaded() : phase(false), count(false), total_ns(false), max_ns(false), histogram(false) {}
+    bool phase;
+    bool count;
+    bool total_ns;
+    bool max_ns;
+    bool histogram;
+  };
+
+  mutable ThriftNaClPhaseStats value_;
+  mutable Loaded loaded_;
+};
+
+typedef struct _ThriftNaClMessageStats__isset {
+  _ThriftNaClMessageStats__isset() : message_type(false), count(false), request_nodes(false), request_bytes(false), response_nodes(false), response_bytes(false), phases(false), cache_hits(false), cache_misses(false) {}
+  bool message_type;
+  bool count;
+  bool request_nodes;
+  bool request_bytes;
+  bool response_nodes;
+  bool response_bytes;
+  bool phases;
+  bool cache_hits;
+  bool cache_misses;
+} _ThriftNaClMessageStats__isset;
+
+class ThriftNaClMessageStats : public ::apache::thrift::TStruct {
+ public:
+
+  static const char* ascii_fingerprint; // = "80B6D24D48D20210CECD882D84F01CC8";
+  static const uint8_t binary_fingerprint[16]; // = {0x80,0xB6,0xD2,0x4D,0x48,0xD2,0x02,0x10,0xCE,0xCD,0x88,0x2D,0x84,0xF0,0x1C,0xC8};
+
+  ThriftNaClMessageStats() : message_type(), count(0), request_nodes(0), request_bytes(0), response_nodes(0), response_bytes(0), cache_hits(0), cache_misses(0) {
+  }
+
+  virtual ~ThriftNaClMessageStats() throw() {}
+
+
+  inline bool has_message_type() const {
+    return __isset.message_type;
+  }
+
+  inline const std::string& get_message_type() const {
+    return message_type;
+  }
+
+  inline void set_message_type(const std::string& val) {
+    message_type = val;
+    __isset.message_type = true;
+  }
+
+  inline std::string* mutable_message_type() {
+    __isset.message_type = true;
+    return &message_type;
+  }
+
+  inline bool has_count() const {
+    return __isset.count;
+  }
+
+  inline const int64_t get_count() const {
+    return count;
+  }
+
+  inline void set_count(const int64_t val) {
+    count = val;
+    __isset.count = true;
+  }
+
+  inline bool has_request_nodes() const {
+    return __isset.request_nodes;
+  }
+
+  inline const int64_t get_request_nodes() const {
+    return request_nodes;
+  }
+
+  inline void set_request_nodes(const int64_t val) {
+    request_nodes = val;
+    __isset.request_nodes = true;
+  }
+
+  inline bool has_request_bytes() const {
+    return __isset.request_bytes;
+  }
+
+  inline const int64_t get_request_bytes() const {
+    return request_bytes;
+  }
+
+  inline void set_request_bytes(const int64_t val) {
+    request_bytes = val;
+    __isset.request_bytes = true;
+  }
+
+  inline bool has_response_nodes() const {
+    return __isset.response_nodes;
+  }
+
+  inline const int64_t get_response_nodes() const {
+    return response_nodes;
+  }
+
+  inline void set_response_nodes(const int64_t val) {
+    response_nodes = val;
+    __isset.response_nodes = true;
+  }
+
+  inline bool has_response_bytes() const {
+    return __isset.response_bytes;
+  }
+
+  inline const int64_t get_response_bytes() const {
+    return response_bytes;
+  }
+
+  inline void set_response_bytes(const int64_t val) {
+    response_bytes = val;
+    __isset.response_bytes = true;
+  }
+
+  inline bool has_phases() const {
+    return __isset.phases;
+  }
+
+  inline const std::vector<ThriftNaClPhaseStats> & get_phases() const {
+    return phases;
+  }
+
+  inline void set_phases(const std::vector<ThriftNaClPhaseStats> & val) {
+    phases = val;
+    __isset.phases = true;
+  }
+
+  inline std::vector<ThriftNaClPhaseStats> * mutable_phases() {
+    __isset.phases = true;
+    return &phases;
+  }
+
+  inline bool has_cache_hits() const {
+    return __isset.cache_hits;
+  }
+
+  inline const int64_t get_cache_hits() const {
+    return cache_hits;
+  }
+
+  inline void set_cache_hits(const int64_t val) {
+    cache_hits = val;
+    __isset.cache_hits = true;
+  }
+
+  inline bool has_cache_misses() const {
+    return __isset.cache_misses;
+  }
+
+  inline const int64_t get_cache_misses() const {
+    return cache_misses;
+  }
+
+  inline void set_cache_misses(const int64_t val) {
+    cache_misses = val;
+    __isset.cache_misses = true;
+  }
+
+  bool operator == (const ThriftNaClMessageStats & rhs) const
+  {
+    if (__isset.message_type != rhs.__isset.message_type)
+      return false;
+    else if (__isset.message_type && !(message_type == rhs.message_type))
+      return false;
+    if (__isset.count != rhs.__isset.count)
+      return false;
+    else if (__isset.count && !(count == rhs.count))
+      return false;
+    if (__isset.request_nodes != rhs.__isset.request_nodes)
+      return false;
+    else if (__isset.request_nodes && !(request_nodes == rhs.request_nodes))
+      return false;
+    if (__isset.request_bytes != rhs.__isset.request_bytes)
+      return false;
+    else if (__isset.request_bytes && !(request_bytes == rhs.request_bytes))
+      return false;
+    if (__isset.response_nodes != rhs.__isset.response_nodes)
+      return false;
+    else if (__isset.response_nodes && !(response_nodes == rhs.response_nodes))
+      return false;
+    if (__isset.response_bytes != rhs.__isset.response_bytes)
+      return false;
+    else if (__isset.response_bytes && !(response_bytes == rhs.response_bytes))
+      return false;
+    if (__isset.phases != rhs.__isset.phases)
+      return false;
+    else if (__isset.phases && !(phases == rhs.phases))
+      return false;
+    if (__isset.cache_hits != rhs.__isset.cache_hits)
+      return false;
+    else if (__isset.cache_hits && !(cache_hits == rhs.cache_hits))
+      return false;
+    if (__isset.cache_misses != rhs.__isset.cache_misses)
+      return false;
+    else if (__isset.cache_misses && !(cache_misses == rhs.cache_misses))
+      return false;
+    return true;
+  }
+  bool operator != (const ThriftNaClMessageStats &rhs) const {
+    return !(*this == rhs);
+  }
+
+  bool operator < (const ThriftNaClMessageStats & ) const;
+
+  virtual uint32_t read(::apache::thrift::protocol::TProtocol* iprot);
+  virtual uint32_t write(::apache::thrift::protocol::TProtocol* oprot) const;
+
+ private:
+  static const apache::thrift::protocol::TFieldTypeSpec field_types[];
+  static const apache::thrift::protocol::TFieldTypeSpec* get_field_type(const std::string& fname);
+
+  std::string message_type;
+  int64_t count;
+  int64_t request_nodes;
+  int64_t request_bytes;
+  int64_t response_nodes;
+  int64_t response_bytes;
+  std::vector<ThriftNaClPhaseStats>  phases;
+  int64_t cache_hits;
+  int64_t cache_misses;
+
+  _ThriftNaClMessageStats__isset __isset;
+  friend void swap(ThriftNaClMessageStats &a, ThriftNaClMessageStats &b);
+
+  friend class ThriftNaClMessageStatsView;
+
+};
+
+class ThriftNaClMessageStatsView : public ::apache::thrift::protocol::TNativeClientView {
+ public:
+  ThriftNaClMessageStatsView() {}
+  explicit ThriftNaClMessageStatsView(const pp::Var& var)
+    : ::apache::thrift::protocol::TNativeClientView(var) {}
+
+  inline bool has_message_type() const {
+    return hasField(ThriftNaClMessageStats::field_types[0].name);
+  }
+  const std::string& get_message_type() const;
+
+  inline bool has_count() const {
+    return hasField(ThriftNaClMessageStats::field_types[1].name);
+  }
+  const int64_t get_count() const;
+
+  inline bool has_request_nodes() const {
+    return hasField(ThriftNaClMessageStats::field_types[2].name);
+  }
+  const int64_t get_request_nodes() const;
+
+  inline bool has_request_bytes() const {
+    return hasField(ThriftNaClMessageStats::field_types[3].name);
+  }
+  const int64_t get_request_bytes() const;
+
+  inline bool has_response_nodes() const {
+    return hasField(ThriftNaClMessageStats::field_types[4].name);
+  }
+  const int64_t get_response_nodes() const;
+
+  inline bool has_response_bytes() const {
+    return hasField(ThriftNaClMessageStats::field_types[5].name);
+  }
+  const int64_t get_response_bytes() const;
+
+  inline bool has_phases() const {
+    return hasField(ThriftNaClMessageStats::field_types[6].name);
+  }
+  const std::vector<ThriftNaClPhaseStats> & get_phases() const;
+
+  inline bool has_cache_hits() const {
+    return hasField(ThriftNaClMessageStats::field_types[7].name);
+  }
+  const int64_t get_cache_hits() const;
+
+  inline bool has_cache_misses() const {
+    return hasField(ThriftNaClMessageStats::field_types[8].name);
+  }
+  const int64_t get_cache_misses() const;
+
+ private:
+  struct Loaded {
+    Loaded() : message_type(false), count(false), request_nodes(false), request_bytes(false), response_nodes(false), response_bytes(false), phases(false), cache_hits(false), cache_misses(false) {}
+    bool message_type;
+    bool count;
+    bool request_nodes;
+    bool request_bytes;
+    bool response_nodes;
+    bool response_bytes;
+    bool phases;
+    bool cache_hits;
+    bool cache_misses;
+  };
+
+  mutable ThriftNaClMessageStats value_;
+  mutable Loaded loaded_;
+};
+
+typedef struct _ThriftNaClStatsRequest__isset {
+  _ThriftNaClStatsRequest__isset() : reset(false) {}
+  bool reset;
+} _ThriftNaClStatsRequest__isset;
+
+class ThriftNaClStatsRequest : public ::apache::thrift::TStruct {
+ public:
+
+  static const char* ascii_fingerprint; // = "BF054652DEF86253C2BEE7D947F167DD";
+  static const uint8_t binary_fingerprint[16]; // = {0xBF,0x05,0x46,0x52,0xDE,0xF8,0x62,0x53,0xC2,0xBE,0xE7,0xD9,0x47,0xF1,0x67,0xDD};
+
+  ThriftNaClStatsRequest() : reset(0) {
+  }
+
+  virtual ~ThriftNaClStatsRequest() throw() {}
+
+
+  inline bool has_reset() const {
+    return __isset.reset;
+  }
+
+  inline const bool get_reset() const {
+    return reset;
+  }
+
+  inline void set_reset(const bool val) {
+    reset = val;
+    __isset.reset = true;
+  }
+
+  bool operator == (const ThriftNaClStatsRequest & rhs) const
+  {
+    if (__isset.reset != rhs.__isset.reset)
+      return false;
+    else if (__isset.reset && !(reset == rhs.reset))
+      return false;
+    return true;
+  }
+  bool operator != (const ThriftNaClStatsRequest &rhs) const {
+    return !(*this == rhs);
+  }
+
+  bool operator < (const ThriftNaClStatsRequest & ) const;
+
+  virtual uint32_t read(::apache::thrift::protocol::TProtocol* iprot);
+  virtual uint32_t write(::apache::thrift::protocol::TProtocol* oprot) const;
+
+ private:
+  static const apache::thrift::protocol::TFieldTypeSpec field_types[];
+  static const apache::thrift::protocol::TFieldTypeSpec* get_field_type(const std::string& fname);
+
+  bool reset;
+
+  _ThriftNaClStatsRequest__isset __isset;
+  friend void swap(ThriftNaClStatsRequest &a, ThriftNaClStatsRequest &b);
+
+  friend class ThriftNaClStatsRequestView;
+
+};
+
+class ThriftNaClStatsRequestView : public ::apache::thrift::protocol::TNativeClientView {
+ public:
+  ThriftNaClStatsRequestView() {}
+  explicit ThriftNaClStatsRequestView(const pp::Var& var)
+    : ::apache::thrift::protocol::TNativeClientView(var) {}
+
+  inline bool has_reset() const {
+    return hasField(ThriftNaClStatsRequest::field_types[0].name);
+  }
+  const bool get_reset() const;
+
+ private:
+  struct Loaded {
+    Loaded() : reset(false) {}
+    bool reset;
+  };
+
+  mutable ThriftNaClStatsRequest value_;
+  mutable Loaded loaded_;
+};
+
+typedef struct _ThriftNaClStats__isset {
+  _ThriftNaClStats__isset() : message_types(false) {}
+  bool message_types;
+} _ThriftNaClStats__isset;
+
+class ThriftNaClStats : public ::apache::thrift::TStruct {
+ public:
+
+  static const char* ascii_fingerprint; // = "4E4FD466653BD4E7ED9E64DC7B420CAD";
+  static const uint8_t binary_fingerprint[16]; // = {0x4E,0x4F,0xD4,0x66,0x65,0x3B,0xD4,0xE7,0xED,0x9E,0x64,0xDC,0x7B,0x42,0x0C,0xAD};
+
+  ThriftNaClStats() {
+  }
+
+  virtual ~ThriftNaClStats() throw() {}
+
+
+  inline bool has_message_types() const {
+    return __isset.message_types;
+  }
+
+  inline const std::vector<ThriftNaClMessageStats> & get_message_types() const {
+    return message_types;
+  }
+
+  inline void set_message_types(const std::vector<ThriftNaClMessageStats> & val) {
+    message_types = val;
+    __isset.message_types = true;
+  }
+
+  inline std::vector<ThriftNaClMessageStats> * mutable_message_types() {
+    __isset.message_types = true;
+    return &message_types;
+  }
+
+  bool operator == (const ThriftNaClStats & rhs) const
+  {
+    if (__isset.message_types != rhs.__isset.message_types)
+      return false;
+    else if (__isset.message_types && !(message_types == rhs.message_types))
+      return false;
+    return true;
+  }
+  bool operator != (const ThriftNaClStats &rhs) const {
+    return !(*this == rhs);
+  }
+
+  bool operator < (const ThriftNaClStats & ) const;
+
+  virtual uint32_t read(::apache::thrift::protocol::TProtocol* iprot);
+  virtual uint32_t write(::apache::thrift::protocol::TProtocol* oprot) const;
+
+ private:
+  static const apache::thrift::protocol::TFieldTypeSpec field_types[];
+  static const apache::thrift::protocol::TFieldTypeSpec* get_field_type(const std::string& fname);
+
+  std::vector<ThriftNaClMessageStats>  message_types;
+
+  _ThriftNaClStats__isset __isset;
+  friend void swap(ThriftNaClStats &a, ThriftNaClStats &b);
+
+  friend class ThriftNaClStatsView;
+
+};
+
+class ThriftNaClStatsView : public ::apache::thrift::protocol::TNativeClientView {
+ public:
+  ThriftNaClStatsView() {}
+  explicit ThriftNaClStatsView(const pp::Var& var)
+    : ::apache::thrift::protocol::TNativeClientView(var) {}
+
+  inline bool has_message_types() const {
+    return hasField(ThriftNaClStats::field_types[0].name);
+  }
+  const std::vector<ThriftNaClMessageStats> & get_message_types() const;
+
+ private:
+  struct Loaded {
+    Loaded() : message_types(false) {}
+    bool message_types;
+  };
+
+  mutable ThriftNaClStats value_;
+  mutable Loaded loaded_;
+};
+
+typedef struct _ThriftNaClCancelRequest__isset {
+  _ThriftNaClCancelRequest__isset() : id(false) {}
+  bool id;
+} _ThriftNaClCancelRequest__isset;
+
+class ThriftNaClCancelRequest : public ::apache::thrift::TStruct {
+ public:
+
+  static const char* ascii_fingerprint; // = "66E694018C17E5B65A59AE8F55CCA3CD";
+  static const uint8_t binary_fingerprint[16]; // = {0x66,0xE6,0x94,0x01,0x8C,0x17,0xE5,0xB6,0x5A,0x59,0xAE,0x8F,0x55,0xCC,0xA3,0xCD};
+
+  ThriftNaClCancelRequest() : id() {
+  }
+
+  virtual ~ThriftNaClCancelRequest() throw() {}
+
+
+  inline bool has_id() const {
+    return __isset.id;
+  }
+
+  inline const std::string& get_id() const {
+    return id;
+  }
+
+  inline void set_id(const std::string& val) {
+    id = val;
+    __isset.id = true;
+  }
+
+  inline std::string* mutable_id() {
+    __isset.id = true;
+    return &id;
+  }
+
+  bool operator == (const ThriftNaClCancelRequest & rhs) const
+  {
+    if (__isset.id != rhs.__isset.id)
+      return false;
+    else if (__isset.id && !(id == rhs.id))
+      return false;
+    return true;
+  }
+  bool operator != (const ThriftNaClCancelRequest &rhs) const {
+    return !(*this == rhs);
+  }
+
+  bool operator < (const ThriftNaClCancelRequest & ) const;
+
+  virtual uint32_t read(::apache::thrift::protocol::TProtocol* iprot);
+  virtual uint32_t write(::apache::thrift::protocol::TProtocol* oprot) const;
+
+ private:
+  static const apache::thrift::protocol::TFieldTypeSpec field_types[];
+  static const apache::thrift::protocol::TFieldTypeSpec* get_field_type(const std::string& fname);
+
+  std::string id;
+
+  _ThriftNaClCancelRequest__isset __isset;
+  friend void swap(ThriftNaClCancelRequest &a, ThriftNaClCancelRequest &b);
+
+  friend class ThriftNaClCancelRequestView;
+
+};
+
+class ThriftNaClCancelRequestView : public ::apache::thrift::protocol::TNativeClientView {
+ public:
+  ThriftNaClCancelRequestView() {}
+  explicit ThriftNaClCancelRequestView(const pp::Var& var)
+    : ::apache::thrift::protocol::TNativeClientView(var) {}
+
+  inline bool has_id() const {
+    return hasField(ThriftNaClCancelRequest::field_types[0].name);
+  }
+  const std::string& get_id() const;
+
+ private:
+  struct Loaded {
+    Loaded() : id(false) {}
+    bool id;
+  };
+
+  mutable ThriftNaClCancelRequest value_;
+  mutable Loaded loaded_;
+};
+
+typedef struct _ThriftNaClCancelResponse__isset {
+  _ThriftNaClCancelResponse__isset() : cancelled(false) {}
+  bool cancelled;
+} _ThriftNaClCancelResponse__isset;
+
+class ThriftNaClCancelResponse : public ::apache::thrift::TStruct {
+ public:
+
+  static const char* ascii_fingerprint; // = "BF054652DEF86253C2BEE7D947F167DD";
+  static const uint8_t binary_fingerprint[16]; // = {0xBF,0x05,0x46,0x52,0xDE,0xF8,0x62,0x53,0xC2,0xBE,0xE7,0xD9,0x47,0xF1,0x67,0xDD};
+
+  ThriftNaClCancelResponse() : cancelled(0) {
+  }
+
+  virtual ~ThriftNaClCancelResponse() throw() {}
+
+
+  inline bool has_cancelled() const {
+    return __isset.cancelled;
+  }
+
+  inline const bool get_cancelled() const {
+    return cancelled;
+  }
+
+  inline void set_cancelled(const bool val) {
+    cancelled = val;
+    __isset.cancelled = true;
+  }
+
+  bool operator == (const ThriftNaClCancelResponse & rhs) const
+  {
+    if (__isset.cancelled != rhs.__isset.cancelled)
+      return false;
+    else if (__isset.cancelled && !(cancelled == rhs.cancelled))
+      return false;
+    return true;
+  }
+  bool operator != (const ThriftNaClCancelResponse &rhs) const {
+    return !(*this == rhs);
+  }
+
+  bool operator < (const ThriftNaClCancelResponse & ) const;
+
+  virtual uint32_t read(::apache::thrift::protocol::TProtocol* iprot);
+  virtual uint32_t write(::apache::thrift::protocol::TProtocol* oprot) const;
+
+ private:
+  static const apache::thrift::protocol::TFieldTypeSpec field_types[];
+  static const apache::thrift::protocol::TFieldTypeSpec* get_field_type(const std::string& fname);
+
+  bool cancelled;
+
+  _ThriftNaClCancelResponse__isset __isset;
+  friend void swap(ThriftNaClCancelResponse &a, ThriftNaClCancelResponse &b);
+
+  friend class ThriftNaClCancelResponseView;
+
+};
+
+class ThriftNaClCancelResponseView : public ::apache::thrift::protocol::TNativeClientView {
+ public:
+  ThriftNaClCancelResponseView() {}
+  explicit ThriftNaClCancelResponseView(const pp::Var& var)
+    : ::apache::thrift::protocol::TNativeClientView(var) {}
+
+  inline bool has_cancelled() const {
+    return hasField(ThriftNaClCancelResponse::field_types[0].name);
+  }
+  const bool get_cancelled() const;
+
+ private:
+  struct Loaded {
+    Loaded() : cancelled(false) {}
+    bool cancelled;
+  };
+
+  mutable ThriftNaClCancelResponse value_;
+  mutable Loaded loaded_;
+};
+
+
+
+#endif
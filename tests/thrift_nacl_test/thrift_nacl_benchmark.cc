@@ -0,0 +1,104 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include <string>
+
+#include <boost/shared_ptr.hpp>
+#include <thrift/protocol/TNativeClientProtocol.h>
+
+#include "ppapi/cpp/var.h"
+
+#include "thrift_nacl_test_types.h"
+
+using apache::thrift::protocol::TNativeClientProtocol;
+using boost::shared_ptr;
+using pp::Var;
+using std::string;
+
+static const int kDefaultIterations = 100000;
+
+double GetTimeSeconds() {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+void CreateBenchmarkPerson(Person* person) {
+  person->set_name("John");
+  person->set_weight(160.0);
+
+  person->mutable_birthday()->set_month(1);
+  person->mutable_birthday()->set_day(1);
+  person->mutable_birthday()->set_year(1970);
+
+  String obj;
+  obj.set_s("test");
+
+  for (int i = 0; i < 8; ++i) {
+    char key[16];
+    snprintf(key, sizeof(key), "key%d", i);
+    (*person->mutable_dict())[key] = i;
+    (*person->mutable_objdict())[key] = obj;
+    person->mutable_objlist()->push_back(obj);
+    person->mutable_params()->insert(key);
+  }
+
+  person->set_b(string(64, 'x'));
+}
+
+void PrintResult(const char* name, int iterations, double elapsed) {
+  printf("%-12s %10d iterations %10.3f s %12.0f ops/s %10.3f us/op\n",
+         name, iterations, elapsed, iterations / elapsed,
+         1e6 * elapsed / iterations);
+}
+
+int main(int argc, char* argv[]) {
+  int iterations = kDefaultIterations;
+  if (argc > 1) {
+    iterations = atoi(argv[1]);
+  }
+  if (iterations <= 0) {
+    fprintf(stderr, "usage: %s [iterations]\n", argv[0]);
+    return 1;
+  }
+
+  Person person;
+  CreateBenchmarkPerson(&person);
+
+  TNativeClientProtocol protocol;
+  double start;
+
+  // Struct -> pp::Var
+  start = GetTimeSeconds();
+  for (int i = 0; i < iterations; ++i) {
+    person.write(&protocol);
+  }
+  PrintResult("write", iterations, GetTimeSeconds() - start);
+
+  // pp::Var -> struct
+  shared_ptr<const Var> person_var(protocol.getVar());
+  Person person2;
+  start = GetTimeSeconds();
+  for (int i = 0; i < iterations; ++i) {
+    protocol.setVar(person_var);
+    person2.read(&protocol);
+  }
+  PrintResult("read", iterations, GetTimeSeconds() - start);
+
+  // Struct -> pp::Var -> struct
+  start = GetTimeSeconds();
+  for (int i = 0; i < iterations; ++i) {
+    person.write(&protocol);
+    protocol.setVar(protocol.getVar());
+    person2.read(&protocol);
+  }
+  PrintResult("round trip", iterations, GetTimeSeconds() - start);
+
+  if (!(person == person2)) {
+    fprintf(stderr, "Round trip mismatch\n");
+    return 1;
+  }
+
+  return 0;
+}
@@ -0,0 +1,362 @@
+// Tests of NaClModule in examples/hello_world/thrift_nacl.js, run with node
+// against a fake embed element:
+//
+//   make -f Makefile.linux jstest
+
+'use strict';
+
+var assert = require('assert');
+var fs = require('fs');
+var path = require('path');
+var vm = require('vm');
+
+var SOURCE = path.join(__dirname, '../../examples/hello_world/thrift_nacl.js');
+
+var REPLY = 2;
+
+// Loads thrift_nacl.js into a fresh context and returns its window.
+function loadThriftNaCl() {
+  var window = {setTimeout: setTimeout, clearTimeout: clearTimeout};
+  window.window = window;
+  vm.createContext(window);
+  vm.runInContext(fs.readFileSync(SOURCE, 'utf8'), window, SOURCE);
+  return window;
+}
+
+// Records the messages posted to the module and delivers its responses.
+function FakeElement() {
+  this.sent = [];
+  this.listener = null;
+}
+
+FakeElement.prototype.addEventListener = function (type, listener) {
+  assert.strictEqual(type, 'message');
+  this.listener = listener;
+};
+
+FakeElement.prototype.postMessage = function (message) {
+  this.sent.push(message);
+};
+
+FakeElement.prototype.respond = function (data) {
+  this.listener({data: data});
+};
+
+var EmptyStruct = function () {};
+
+EmptyStruct.prototype.write = function (protocol) {
+  protocol.writeStructBegin('EmptyStruct');
+  protocol.writeFieldStop();
+  protocol.writeStructEnd();
+};
+
+EmptyStruct.prototype.read = function (protocol) {
+  protocol.readStructBegin();
+  assert.strictEqual(protocol.readFieldBegin().ftype, 0);
+  protocol.readStructEnd();
+};
+
+// Returns the compact protocol encoded reply to the binary message seqid.
+function binaryReply(window, seqid) {
+  var protocol = new window.NaClCompactProtocol();
+  protocol.writeMessageBegin('echo', REPLY, seqid);
+  new EmptyStruct().write(protocol);
+  protocol.writeMessageEnd();
+  return protocol.getBuffer();
+}
+
+var tests = {};
+
+tests.binaryMessageReply = function () {
+  var window = loadThriftNaCl();
+  var element = new FakeElement();
+  var module = new window.NaClModule(element);
+  var responses = [];
+
+  var id = module.postBinaryMessage('echo', new EmptyStruct(), EmptyStruct,
+                                    function (response) {
+                                      responses.push(response);
+                                    });
+  assert.strictEqual(element.sent.length, 1);
+
+  element.respond(binaryReply(window, Number(id)));
+  assert.strictEqual(responses.length, 1);
+  assert.ok(responses[0] instanceof EmptyStruct);
+  assert.ok(!(id in module.messageMap));
+};
+
+tests.cancelMessage = function () {
+  var window = loadThriftNaCl();
+  var element = new FakeElement();
+  var module = new window.NaClModule(element);
+  var errors = [];
+
+  var id = module.postMessage('echo', {}, function () {
+    assert.fail('onSuccess called for a cancelled message');
+  }, function (error) {
+    errors.push(error);
+  });
+
+  assert.ok(module.cancel(id));
+  assert.strictEqual(errors.length, 1);
+  assert.strictEqual(errors[0].type, 'cancelled');
+  assert.strictEqual(element.sent[1].type, '__cancel');
+  assert.strictEqual(element.sent[1].data.id, id);
+
+  // The late response is dropped.
+  element.respond({id: id, data: {}});
+  assert.strictEqual(errors.length, 1);
+  assert.ok(!(id in module.messageMap));
+  assert.ok(!module.cancel(id));
+};
+
+tests.cancelBinaryMessage = function () {
+  var window = loadThriftNaCl();
+  var element = new FakeElement();
+  var module = new window.NaClModule(element);
+  var errors = [];
+
+  var id = module.postBinaryMessage('echo', new EmptyStruct(), EmptyStruct,
+                                    function () {
+                                      assert.fail('onSuccess called for a ' +
+                                                  'cancelled message');
+                                    }, function (error) {
+                                      errors.push(error);
+                                    });
+
+  assert.ok(module.cancel(id));
+  assert.strictEqual(errors.length, 1);
+  assert.strictEqual(errors[0].type, 'cancelled');
+  assert.strictEqual(element.sent[1].type, '__cancel');
+  assert.strictEqual(element.sent[1].data.id, id);
+
+  // The late reply is dropped.
+  element.respond(binaryReply(window, Number(id)));
+  assert.strictEqual(errors.length, 1);
+  assert.ok(!(id in module.messageMap));
+  assert.ok(!module.cancel(id));
+};
+
+tests.batchMessages = function () {
+  var window = loadThriftNaCl();
+  var element = new FakeElement();
+  var module = new window.NaClModule(element);
+  var results = [];
+  var onSuccess = function (response) {
+    results.push(response);
+  };
+  var onError = function (error) {
+    results.push(error);
+  };
+
+  module.setBatching(true);
+  var id1 = module.postMessage('main', {}, onSuccess, onError);
+  var id2 = module.postMessage('worker', {}, onSuccess, onError);
+  var id3 = module.postBinaryMessage('main', new EmptyStruct(), EmptyStruct,
+                                     onSuccess, onError);
+  assert.strictEqual(element.sent.length, 0);
+
+  // The messages are sent as one array.
+  module.flushBatch();
+  assert.strictEqual(element.sent.length, 1);
+  var batch = element.sent[0];
+  assert.ok(Array.isArray(batch));
+  assert.strictEqual(batch.length, 3);
+  assert.strictEqual(batch[0].id, id1);
+  assert.strictEqual(batch[1].id, id2);
+  assert.ok(batch[2] instanceof vm.runInContext('ArrayBuffer', window));
+
+  // The responses of the main thread handlers arrive as one array, in which
+  // binary replies are ArrayBuffers.
+  element.respond([{id: id1, data: {value: 1}},
+                   binaryReply(window, Number(id3))]);
+  assert.strictEqual(results.length, 2);
+  assert.deepStrictEqual(JSON.parse(JSON.stringify(results[0])), {value: 1});
+  assert.ok(results[1] instanceof EmptyStruct);
+
+  // The worker thread response arrives on its own.
+  element.respond({id: id2, error: {type: 'failed', message: 'Failed'}});
+  assert.strictEqual(results.length, 3);
+  assert.strictEqual(results[2].type, 'failed');
+  assert.deepStrictEqual(Object.keys(module.messageMap), []);
+
+  // A batch of one message is sent unwrapped, and disabling batching sends
+  // the pending batch.
+  var id4 = module.postMessage('main', {}, onSuccess, onError);
+  module.setBatching(false);
+  assert.strictEqual(element.sent.length, 2);
+  assert.strictEqual(element.sent[1].id, id4);
+  module.postMessage('main', {}, onSuccess, onError);
+  assert.strictEqual(element.sent.length, 3);
+};
+
+tests.streamingChunks = function () {
+  var window = loadThriftNaCl();
+  var element = new FakeElement();
+  var module = new window.NaClModule(element);
+  var chunks = [];
+  var responses = [];
+
+  var id = module.postStreamingMessage('stream', {}, function (chunk) {
+    chunks.push(chunk);
+  }, function (response) {
+    responses.push(response);
+  });
+
+  // Chunks are passed to onChunk in order.
+  element.respond({id: id, seq: 0, chunk: [{value: 1}, {value: 2}]});
+  element.respond({id: id, seq: 1, chunk: [{value: 3}]});
+  assert.strictEqual(chunks.length, 2);
+  assert.strictEqual(chunks[1][0].value, 3);
+  assert.strictEqual(responses.length, 0);
+
+  // Out of order chunks are rejected and do not advance the sequence.
+  assert.throws(function () {
+    element.respond({id: id, seq: 3, chunk: [{value: 5}]});
+  }, /Received chunk 3 of message \d+, expected 2/);
+  assert.throws(function () {
+    element.respond({id: id, seq: 1, chunk: [{value: 3}]});
+  }, /expected 2/);
+  element.respond({id: id, seq: 2, chunk: [{value: 4}]});
+  assert.strictEqual(chunks.length, 3);
+
+  // The final response ends the stream.
+  element.respond({id: id, data: {count: 4}});
+  assert.strictEqual(responses.length, 1);
+  assert.strictEqual(responses[0].count, 4);
+  assert.ok(!(id in module.messageMap));
+  assert.throws(function () {
+    element.respond({id: id, seq: 3, chunk: [{value: 5}]});
+  }, /unknown id/);
+
+  // Without onChunk the chunks are joined, arrays of structs into one array
+  // and ArrayBuffers into one ArrayBuffer.
+  var joined = [];
+  id = module.postStreamingMessage('stream', {}, null,
+                                   function (response, results) {
+                                     joined.push(results);
+                                   });
+  element.respond({id: id, seq: 0, chunk: [{value: 1}]});
+  element.respond({id: id, seq: 1, chunk: [{value: 2}, {value: 3}]});
+  element.respond({id: id, data: {}});
+  assert.deepStrictEqual(JSON.parse(JSON.stringify(joined[0])),
+                         [{value: 1}, {value: 2}, {value: 3}]);
+
+  var Uint8Array = vm.runInContext('Uint8Array', window);
+  id = module.postStreamingMessage('stream', {}, null,
+                                   function (response, results) {
+                                     joined.push(results);
+                                   });
+  element.respond({id: id, seq: 0, chunk: new Uint8Array([1, 2]).buffer});
+  element.respond({id: id, seq: 1, chunk: new Uint8Array([3]).buffer});
+  element.respond({id: id, data: {}});
+  assert.deepStrictEqual(Array.from(new Uint8Array(joined[1])), [1, 2, 3]);
+
+  // Chunks of a cancelled message are dropped.
+  id = module.postStreamingMessage('stream', {}, function () {
+    assert.fail('onChunk called for a cancelled message');
+  });
+  assert.ok(module.cancel(id));
+  element.respond({id: id, seq: 0, chunk: [{value: 1}]});
+  element.respond({id: id, data: {}});
+  assert.ok(!(id in module.messageMap));
+};
+
+tests.getStats = function () {
+  var window = loadThriftNaCl();
+  var element = new FakeElement();
+  var module = new window.NaClModule(element);
+  var results = [];
+
+  module.getStats(true, function (stats) {
+    results.push(stats);
+  });
+  assert.strictEqual(element.sent.length, 1);
+  var request = element.sent[0];
+  assert.strictEqual(request.type, '__stats');
+  assert.deepStrictEqual(JSON.parse(JSON.stringify(request.data)),
+                         {reset: true});
+
+  var stats = {message_types: [{
+    message_type: 'echo',
+    count: 2,
+    phases: [{phase: 'parse', count: 2, total_ns: 300, max_ns: 200,
+              histogram: [0, 0, 0, 0, 0, 0, 0, 1, 1]}]
+  }]};
+  element.respond({id: request.id, data: stats});
+  assert.strictEqual(results.length, 1);
+  assert.deepStrictEqual(JSON.parse(JSON.stringify(results[0])), stats);
+  assert.ok(!(request.id in module.messageMap));
+
+  // reset defaults to false.
+  module.getStats();
+  assert.strictEqual(element.sent[1].data.reset, false);
+};
+
+tests.statePatches = function () {
+  var window = loadThriftNaCl();
+  var element = new FakeElement();
+  var module = new window.NaClModule(element);
+  var states = [];
+  module.onStateChange('game', function (state) {
+    states.push(state);
+  });
+
+  element.respond({state: 'game', data: {
+    name: 'a',
+    score: 1,
+    board: {cells: [1, 2, 3], owner: 'x'},
+    players: ['p1', 'p2']
+  }});
+  var state = module.getState('game');
+  assert.strictEqual(states.length, 1);
+  assert.strictEqual(states[0], state);
+
+  // Fields are set, deleted and patched in place.
+  element.respond({state: 'game', patch: {
+    set: {score: 2, level: 3},
+    'delete': ['name'],
+    patch: {board: {set: {owner: 'y'}}}
+  }});
+  assert.strictEqual(module.getState('game'), state);
+  assert.deepStrictEqual(JSON.parse(JSON.stringify(state)), {
+    score: 2,
+    level: 3,
+    board: {cells: [1, 2, 3], owner: 'y'},
+    players: ['p1', 'p2']
+  });
+
+  // Lists shrink to their new length and grow with their new elements.
+  element.respond({state: 'game', patch: {patch: {
+    board: {patch: {cells: {length: 2, set: {'1': 5}}}},
+    players: {length: 4, set: {'2': 'p3', '3': 'p4'}}
+  }}});
+  assert.deepStrictEqual(state.board.cells, [1, 5]);
+  assert.deepStrictEqual(state.players, ['p1', 'p2', 'p3', 'p4']);
+
+  // Packed lists are replaced whole and unpacked.
+  var Float64Array = vm.runInContext('Float64Array', window);
+  var doubles = new Float64Array([1.5, 2.5]);
+  element.respond({state: 'game', patch: {set: {
+    weights: {__typed_array: 'Float64Array', buffer: doubles.buffer}
+  }}});
+  assert.ok(state.weights instanceof Float64Array);
+  assert.deepStrictEqual(Array.from(state.weights), [1.5, 2.5]);
+  assert.strictEqual(states.length, 4);
+
+  assert.throws(function () {
+    element.respond({state: 'other', patch: {set: {a: 1}}});
+  }, /unknown state/);
+};
+
+var failed = 0;
+Object.keys(tests).forEach(function (name) {
+  try {
+    tests[name]();
+    console.log('[       OK ] ' + name);
+  } catch (e) {
+    console.log('[  FAILED  ] ' + name + '\n' + e.stack);
+    failed++;
+  }
+});
+process.exit(failed ? 1 : 0);
@@ -0,0 +1,500 @@
+// Tests of the message handling of examples/hello_world/thrift_nacl.cc, run
+// on the pp::Instance emulation in tests/host_ppapi.
+
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <string>
+#include <vector>
+
+#include <boost/scoped_ptr.hpp>
+#include <boost/shared_ptr.hpp>
+#include <gtest/gtest.h>
+#include <thrift/protocol/TCompactProtocol.h>
+#include <thrift/transport/TBufferTransports.h>
+
+#include "ppapi/cpp/instance.h"
+#include "ppapi/cpp/message_loop.h"
+#include "ppapi/cpp/module.h"
+#include "ppapi/cpp/var.h"
+#include "ppapi/cpp/var_array.h"
+#include "ppapi/cpp/var_array_buffer.h"
+#include "ppapi/cpp/var_dictionary.h"
+
+#include "thrift_nacl.h"
+#include "thrift_nacl_test_types.h"
+#include "thrift_nacl_types.h"
+
+using apache::thrift::protocol::TCompactProtocol;
+using apache::thrift::protocol::TMessageType;
+using apache::thrift::transport::TMemoryBuffer;
+using boost::shared_ptr;
+using pp::Var;
+using pp::VarArray;
+using pp::VarArrayBuffer;
+using pp::VarDictionary;
+using std::string;
+
+// Date has a required month, so reading a request without one throws.
+static bool FormatDate(const Date& request, String* response,
+                       ThriftNaClError* error) {
+  char s[32];
+  snprintf(s, sizeof(s), "%d/%d", request.get_month(), request.get_year());
+  response->set_s(s);
+  return true;
+}
+
+REGISTER_MESSAGE_HANDLER_FULL("date", FormatDate, Date, String, ThriftNaClError)
+
+static bool FormatWorkerDate(const Date& request, String* response,
+                             ThriftNaClError* error) {
+  return FormatDate(request, response, error);
+}
+
+REGISTER_MESSAGE_HANDLER_FULL("worker_date", FormatWorkerDate, Date, String, ThriftNaClError)
+static bool worker_date_thread_result = thrift_nacl::SetHandlerThread(
+    "worker_date", thrift_nacl::WORKER_THREAD);
+
+typedef String StreamStringsRequest;
+typedef String StreamStringsResponse;
+
+// Streams five strings in chunks of two.
+static bool StreamStrings(const String& request,
+                          thrift_nacl::ResponseStream* stream,
+                          String* response, ThriftNaClError* error) {
+  stream->set_chunk_size(2);
+  for (int i = 0; i < 5; ++i) {
+    String element;
+    element.set_s(request.get_s());
+    stream->Write(element);
+  }
+  response->set_s("done");
+  return true;
+}
+
+REGISTER_STREAMING_MESSAGE_HANDLER("stream_strings", StreamStrings)
+
+typedef String StreamWorkerStringsRequest;
+typedef String StreamWorkerStringsResponse;
+
+static bool StreamWorkerStrings(const String& request,
+                                thrift_nacl::ResponseStream* stream,
+                                String* response, ThriftNaClError* error) {
+  return StreamStrings(request, stream, response, error);
+}
+
+REGISTER_STREAMING_MESSAGE_HANDLER("stream_worker_strings", StreamWorkerStrings)
+static bool stream_worker_strings_thread_result =
+    thrift_nacl::SetHandlerThread("stream_worker_strings",
+                                  thrift_nacl::WORKER_THREAD);
+
+// Spends its time in a nested read phase timer, which should not be counted
+// in the handler phase.
+static bool NestedTimer(const String& request, String* response,
+                        ThriftNaClError* error) {
+  thrift_nacl::ScopedPhaseTimer timer(thrift_nacl::PHASE_READ);
+  usleep(20000);
+  return true;
+}
+
+REGISTER_MESSAGE_HANDLER_FULL("nested_timer", NestedTimer, String, String, ThriftNaClError)
+
+typedef String CachedEchoRequest;
+typedef String CachedEchoResponse;
+
+static int cached_echo_calls = 0;
+
+static bool CachedEcho(const String& request, String* response,
+                       ThriftNaClError* error) {
+  ++cached_echo_calls;
+  response->set_s(request.get_s());
+  return true;
+}
+
+REGISTER_CACHED_MESSAGE_HANDLER("cached_echo", CachedEcho, 2)
+
+static volatile bool worker_blocked = false;
+
+// Keeps the worker thread busy until worker_blocked is cleared.
+static bool BlockWorker(const String& request, String* response,
+                        ThriftNaClError* error) {
+  while (worker_blocked) {
+    usleep(1000);
+  }
+  return true;
+}
+
+REGISTER_MESSAGE_HANDLER_FULL("block_worker", BlockWorker, String, String, ThriftNaClError)
+static bool block_worker_thread_result = thrift_nacl::SetHandlerThread(
+    "block_worker", thrift_nacl::WORKER_THREAD);
+
+static pp::Instance* instance;
+
+VarDictionary CreateMessage(const string& id, const string& type,
+                            const Var& data) {
+  VarDictionary message;
+  message.Set(Var("id"), Var(id));
+  message.Set(Var("type"), Var(type));
+  message.Set(Var("data"), data);
+  return message;
+}
+
+// Runs the work posted to the main thread until the instance has posted
+// count messages, or for at most ten seconds, and returns the messages.
+std::vector<Var> WaitForMessages(size_t count) {
+  std::vector<Var> messages = instance->TakePostedMessages();
+  time_t give_up = time(NULL) + 10;
+  while (messages.size() < count && time(NULL) < give_up) {
+    pp::MessageLoop::GetForMainThread().RunPendingWork(10);
+    std::vector<Var> posted = instance->TakePostedMessages();
+    messages.insert(messages.end(), posted.begin(), posted.end());
+  }
+  return messages;
+}
+
+// Handles message and returns its single response.
+VarDictionary HandleMessage(const Var& message) {
+  instance->HandleMessage(message);
+  std::vector<Var> responses = WaitForMessages(1);
+  EXPECT_EQ(1u, responses.size());
+  return responses.empty() ? VarDictionary() : VarDictionary(responses[0]);
+}
+
+// Returns a compact protocol encoded call, as posted by postBinaryMessage().
+VarArrayBuffer CreateBinaryMessage(const string& type, int32_t seqid,
+                                   const apache::thrift::TStruct& request) {
+  shared_ptr<TMemoryBuffer> transport(new TMemoryBuffer());
+  TCompactProtocol protocol(transport);
+  protocol.writeMessageBegin(type, apache::thrift::protocol::T_CALL, seqid);
+  request.write(&protocol);
+  protocol.writeMessageEnd();
+
+  uint8_t* data;
+  uint32_t size;
+  transport->getBuffer(&data, &size);
+  VarArrayBuffer buffer(size);
+  memcpy(buffer.Map(), data, size);
+  buffer.Unmap();
+  return buffer;
+}
+
+// Reads the header of a binary reply and, for an exception, its error.
+void ReadBinaryReply(VarArrayBuffer reply, int32_t* seqid, TMessageType* type,
+                     ThriftNaClError* error) {
+  uint32_t size = reply.ByteLength();
+  shared_ptr<TMemoryBuffer> transport(new TMemoryBuffer(
+      static_cast<uint8_t*>(reply.Map()), size, TMemoryBuffer::COPY));
+  reply.Unmap();
+  TCompactProtocol protocol(transport);
+  string name;
+  protocol.readMessageBegin(name, *type, *seqid);
+  if (*type == apache::thrift::protocol::T_EXCEPTION) {
+    error->read(&protocol);
+  }
+}
+
+// Sends a __cancel message for id and returns whether it was cancelled.
+bool CancelMessage(const string& cancel_id, const string& id) {
+  VarDictionary cancel_data;
+  cancel_data.Set(Var("id"), Var(id));
+  VarDictionary response =
+      HandleMessage(CreateMessage(cancel_id, "__cancel", cancel_data));
+  VarDictionary cancel_response(response.Get(Var("data")));
+  return cancel_response.Get(Var("cancelled")).AsBool();
+}
+
+// Reads and clears the stats of every message type.
+ThriftNaClStats GetMessageStats() {
+  VarDictionary request;
+  request.Set(Var("reset"), Var(true));
+  VarDictionary response =
+      HandleMessage(CreateMessage("stats", "__stats", request));
+  ThriftNaClStats stats;
+  apache::thrift::protocol::TNativeClientProtocol protocol;
+  protocol.setRootVar(response.Get(Var("data")));
+  stats.read(&protocol);
+  return stats;
+}
+
+ThriftNaClMessageStats FindMessageTypeStats(const ThriftNaClStats& stats,
+                                            const string& message_type) {
+  const std::vector<ThriftNaClMessageStats>& message_types =
+      stats.get_message_types();
+  for (size_t i = 0; i < message_types.size(); ++i) {
+    if (message_types[i].get_message_type() == message_type) {
+      return message_types[i];
+    }
+  }
+  ADD_FAILURE() << "No stats for " << message_type;
+  return ThriftNaClMessageStats();
+}
+
+VarDictionary CreateDate(int32_t month, int32_t year) {
+  VarDictionary date;
+  date.Set(Var("month"), Var(month));
+  date.Set(Var("year"), Var(year));
+  return date;
+}
+
+TEST(ThriftNaClModuleTest, HandlerTest) {
+  VarDictionary response =
+      HandleMessage(CreateMessage("1", "date", CreateDate(10, 2014)));
+  EXPECT_EQ("1", response.Get(Var("id")).AsString());
+  VarDictionary data(response.Get(Var("data")));
+  EXPECT_EQ("10/2014", data.Get(Var("s")).AsString());
+
+  response =
+      HandleMessage(CreateMessage("2", "worker_date", CreateDate(11, 2014)));
+  EXPECT_EQ("2", response.Get(Var("id")).AsString());
+  data = VarDictionary(response.Get(Var("data")));
+  EXPECT_EQ("11/2014", data.Get(Var("s")).AsString());
+}
+
+TEST(ThriftNaClModuleTest, HandlerExceptionTest) {
+  VarDictionary response =
+      HandleMessage(CreateMessage("1", "date", VarDictionary()));
+  EXPECT_EQ("1", response.Get(Var("id")).AsString());
+  VarDictionary error(response.Get(Var("error")));
+  EXPECT_EQ("invalid_message", error.Get(Var("type")).AsString());
+
+  // The response is posted for a worker thread too.
+  response = HandleMessage(CreateMessage("2", "worker_date", VarDictionary()));
+  EXPECT_EQ("2", response.Get(Var("id")).AsString());
+  error = VarDictionary(response.Get(Var("error")));
+  EXPECT_EQ("invalid_message", error.Get(Var("type")).AsString());
+
+  // And its cancellation token is unregistered.
+  EXPECT_FALSE(CancelMessage("3", "2"));
+}
+
+TEST(ThriftNaClModuleTest, CancelBinaryMessageTest) {
+  Date date;
+  date.set_month(10);
+  date.set_year(2014);
+
+  // The binary message is queued behind the blocked worker thread.
+  worker_blocked = true;
+  instance->HandleMessage(CreateMessage("1", "block_worker", VarDictionary()));
+  instance->HandleMessage(CreateBinaryMessage("worker_date", 2, date));
+
+  // Binary messages are cancelled by seqid.
+  EXPECT_TRUE(CancelMessage("3", "2"));
+  worker_blocked = false;
+
+  std::vector<Var> responses = WaitForMessages(2);
+  ASSERT_EQ(2u, responses.size());
+  ASSERT_TRUE(responses[1].is_array_buffer());
+  int32_t seqid;
+  TMessageType type;
+  ThriftNaClError error;
+  ReadBinaryReply(VarArrayBuffer(responses[1]), &seqid, &type, &error);
+  EXPECT_EQ(2, seqid);
+  EXPECT_EQ(apache::thrift::protocol::T_EXCEPTION, type);
+  EXPECT_EQ("cancelled", error.get_type());
+
+  // The token was unregistered with the reply.
+  EXPECT_FALSE(CancelMessage("4", "2"));
+
+  // Uncancelled binary messages still get their reply.
+  instance->HandleMessage(CreateBinaryMessage("worker_date", 5, date));
+  responses = WaitForMessages(1);
+  ASSERT_EQ(1u, responses.size());
+  ASSERT_TRUE(responses[0].is_array_buffer());
+  ReadBinaryReply(VarArrayBuffer(responses[0]), &seqid, &type, &error);
+  EXPECT_EQ(5, seqid);
+  EXPECT_EQ(apache::thrift::protocol::T_REPLY, type);
+}
+
+TEST(ThriftNaClModuleTest, BatchMessageTest) {
+  GetMessageStats();
+
+  VarArray batch;
+  batch.Set(0, CreateMessage("1", "date", CreateDate(1, 2014)));
+  batch.Set(1, CreateMessage("2", "worker_date", CreateDate(2, 2014)));
+  batch.Set(2, CreateMessage("3", "date", CreateDate(3, 2014)));
+  instance->HandleMessage(batch);
+
+  // The responses of the main thread handlers are posted as one array, the
+  // worker thread response separately.
+  std::vector<Var> responses = WaitForMessages(2);
+  ASSERT_EQ(2u, responses.size());
+  ASSERT_TRUE(responses[0].is_array());
+  VarArray batch_responses(responses[0]);
+  ASSERT_EQ(2u, batch_responses.GetLength());
+  VarDictionary response(batch_responses.Get(0));
+  EXPECT_EQ("1", response.Get(Var("id")).AsString());
+  response = VarDictionary(batch_responses.Get(1));
+  EXPECT_EQ("3", response.Get(Var("id")).AsString());
+  response = VarDictionary(responses[1]);
+  EXPECT_EQ("2", response.Get(Var("id")).AsString());
+
+  // Only the main thread messages share the post of the batch.
+  ThriftNaClStats stats = GetMessageStats();
+  ThriftNaClMessageStats date_stats = FindMessageTypeStats(stats, "date");
+  EXPECT_EQ(2, date_stats.get_count());
+  EXPECT_EQ(2, date_stats.get_phases()[thrift_nacl::PHASE_POST].get_count());
+  ThriftNaClMessageStats worker_stats =
+      FindMessageTypeStats(stats, "worker_date");
+  EXPECT_EQ(1, worker_stats.get_count());
+  EXPECT_EQ(1,
+            worker_stats.get_phases()[thrift_nacl::PHASE_POST].get_count());
+}
+
+// Checks the chunks and final response posted for a stream_strings message.
+void ExpectStreamedStrings(const string& id,
+                           const std::vector<Var>& messages) {
+  ASSERT_EQ(4u, messages.size());
+  const uint32_t chunk_lengths[] = {2, 2, 1};
+  for (int32_t seq = 0; seq < 3; ++seq) {
+    SCOPED_TRACE(seq);
+    VarDictionary message(messages[seq]);
+    EXPECT_EQ(id, message.Get(Var("id")).AsString());
+    EXPECT_EQ(seq, message.Get(Var("seq")).AsInt());
+    ASSERT_TRUE(message.Get(Var("chunk")).is_array());
+    VarArray chunk(message.Get(Var("chunk")));
+    ASSERT_EQ(chunk_lengths[seq], chunk.GetLength());
+    VarDictionary element(chunk.Get(0));
+    EXPECT_EQ("x", element.Get(Var("s")).AsString());
+  }
+
+  // The response is posted after the last chunk.
+  VarDictionary response(messages[3]);
+  EXPECT_EQ(id, response.Get(Var("id")).AsString());
+  EXPECT_FALSE(response.HasKey(Var("seq")));
+  VarDictionary data(response.Get(Var("data")));
+  EXPECT_EQ("done", data.Get(Var("s")).AsString());
+}
+
+TEST(ThriftNaClModuleTest, StreamingMessageTest) {
+  VarDictionary request;
+  request.Set(Var("s"), Var("x"));
+  instance->HandleMessage(CreateMessage("1", "stream_strings", request));
+  ExpectStreamedStrings("1", WaitForMessages(4));
+
+  // Chunks written on a worker thread are posted in order too.
+  instance->HandleMessage(
+      CreateMessage("2", "stream_worker_strings", request));
+  ExpectStreamedStrings("2", WaitForMessages(4));
+}
+
+TEST(ThriftNaClModuleTest, StatsTest) {
+  GetMessageStats();
+
+  for (int i = 0; i < 3; ++i) {
+    HandleMessage(CreateMessage("1", "date", CreateDate(1, 2014)));
+    HandleMessage(CreateMessage("2", "worker_date", CreateDate(1, 2014)));
+  }
+  ThriftNaClStats stats = GetMessageStats();
+  ThriftNaClMessageStats date_stats = FindMessageTypeStats(stats, "date");
+  EXPECT_EQ(3, date_stats.get_count());
+  ASSERT_EQ(static_cast<size_t>(thrift_nacl::NUM_MESSAGE_PHASES),
+            date_stats.get_phases().size());
+  for (int i = 0; i < thrift_nacl::NUM_MESSAGE_PHASES; ++i) {
+    const ThriftNaClPhaseStats& phase = date_stats.get_phases()[i];
+    EXPECT_EQ(3, phase.get_count());
+    EXPECT_LE(phase.get_max_ns(), phase.get_total_ns());
+    int64_t histogram_count = 0;
+    for (size_t j = 0; j < phase.get_histogram().size(); ++j) {
+      histogram_count += phase.get_histogram()[j];
+    }
+    EXPECT_EQ(3, histogram_count);
+  }
+  EXPECT_EQ(3, FindMessageTypeStats(stats, "worker_date").get_count());
+  // Size stats are opt-in.
+  EXPECT_FALSE(date_stats.has_request_nodes());
+  EXPECT_FALSE(date_stats.has_response_bytes());
+
+  // The stats were reset when read.
+  stats = GetMessageStats();
+  EXPECT_EQ(0, FindMessageTypeStats(stats, "date").get_count());
+
+  thrift_nacl::SetMessageSizeStatsEnabled(true);
+  HandleMessage(CreateMessage("1", "date", CreateDate(1, 2014)));
+  stats = GetMessageStats();
+  thrift_nacl::SetMessageSizeStatsEnabled(false);
+  date_stats = FindMessageTypeStats(stats, "date");
+  // The message, its id, type and data, and the two fields of the data.
+  EXPECT_EQ(6, date_stats.get_request_nodes());
+  EXPECT_LT(0, date_stats.get_request_bytes());
+  EXPECT_LT(0, date_stats.get_response_nodes());
+  EXPECT_LT(0, date_stats.get_response_bytes());
+}
+
+TEST(ThriftNaClModuleTest, NestedPhaseTimerTest) {
+  GetMessageStats();
+  HandleMessage(CreateMessage("1", "nested_timer", VarDictionary()));
+  ThriftNaClMessageStats stats =
+      FindMessageTypeStats(GetMessageStats(), "nested_timer");
+
+  // The time of the nested timer is only recorded in its own phase.
+  const std::vector<ThriftNaClPhaseStats>& phases = stats.get_phases();
+  EXPECT_LE(20000000, phases[thrift_nacl::PHASE_READ].get_total_ns());
+  EXPECT_GT(20000000, phases[thrift_nacl::PHASE_HANDLER].get_total_ns());
+}
+
+// Sends a cached_echo message for s and returns the echoed string.
+string CachedEchoMessage(const string& s) {
+  VarDictionary request;
+  request.Set(Var("s"), Var(s));
+  VarDictionary response =
+      HandleMessage(CreateMessage("1", "cached_echo", request));
+  VarDictionary data(response.Get(Var("data")));
+  return data.Get(Var("s")).AsString();
+}
+
+TEST(ThriftNaClModuleTest, MessageCacheTest) {
+  GetMessageStats();
+  cached_echo_calls = 0;
+
+  EXPECT_EQ("a", CachedEchoMessage("a"));
+  EXPECT_EQ("a", CachedEchoMessage("a"));
+  EXPECT_EQ(1, cached_echo_calls);
+  EXPECT_EQ("b", CachedEchoMessage("b"));
+  EXPECT_EQ("a", CachedEchoMessage("a"));
+  EXPECT_EQ(2, cached_echo_calls);
+
+  // The cache holds two entries and b was used least recently.
+  EXPECT_EQ("c", CachedEchoMessage("c"));
+  EXPECT_EQ("a", CachedEchoMessage("a"));
+  EXPECT_EQ(3, cached_echo_calls);
+  EXPECT_EQ("b", CachedEchoMessage("b"));
+  EXPECT_EQ(4, cached_echo_calls);
+
+  // Requests with the same fields set in another order hit.
+  VarDictionary request;
+  request.Set(Var("s"), Var("d"));
+  request.Set(Var("extra"), Var(1));
+  HandleMessage(CreateMessage("1", "cached_echo", request));
+  VarDictionary reordered_request;
+  reordered_request.Set(Var("extra"), Var(1));
+  reordered_request.Set(Var("s"), Var("d"));
+  HandleMessage(CreateMessage("1", "cached_echo", reordered_request));
+  EXPECT_EQ(5, cached_echo_calls);
+
+  ThriftNaClMessageStats stats =
+      FindMessageTypeStats(GetMessageStats(), "cached_echo");
+  EXPECT_EQ(9, stats.get_count());
+  EXPECT_EQ(4, stats.get_cache_hits());
+  EXPECT_EQ(5, stats.get_cache_misses());
+
+  // A size of 0 removes the cache.
+  thrift_nacl::SetMessageCacheSize("cached_echo", 0);
+  EXPECT_EQ("a", CachedEchoMessage("a"));
+  EXPECT_EQ("a", CachedEchoMessage("a"));
+  EXPECT_EQ(7, cached_echo_calls);
+  stats = FindMessageTypeStats(GetMessageStats(), "cached_echo");
+  EXPECT_FALSE(stats.has_cache_hits());
+  thrift_nacl::SetMessageCacheSize("cached_echo", 2);
+}
+
+int main(int argc, char* argv[]) {
+  ::testing::InitGoogleTest(&argc, argv);
+  // Messages queue behind a blocked worker thread.
+  thrift_nacl::SetWorkerThreadCount(1);
+  boost::scoped_ptr<pp::Module> module(pp::CreateModule());
+  instance = module->CreateInstance(1);
+  int result = RUN_ALL_TESTS();
+  delete instance;
+  return result;
+}
@@ -9,24 +9,44 @@
 #include <boost/shared_ptr.hpp>
 #include <boost/scoped_ptr.hpp>
 #include <gtest/gtest.h>
+#include <thrift/protocol/TBase64Utils.h>
+#include <thrift/protocol/TBinaryProtocol.h>
+#include <thrift/protocol/TCompactProtocol.h>
+#include <thrift/protocol/TJSONProtocol.h>
 #include <thrift/protocol/TNativeClientProtocol.h>
 #include <thrift/transport/TBufferTransports.h>
 
 #include "ppapi/cpp/var.h"
+#include "ppapi/cpp/var_array_buffer.h"
 #include "ppapi/cpp/var_dictionary.h"
 #include "ppapi/cpp/module.h"
 #include "ppapi_simple/ps_main.h"
 
+#include "TestService.h"
+#include "thrift_nacl_cache.h"
 #include "thrift_nacl_test_types.h"
+#include "thrift_nacl_vars.h"
 
+using apache::thrift::protocol::TBinaryProtocol;
+using apache::thrift::protocol::TCompactProtocol;
+using apache::thrift::protocol::TJSONProtocol;
 using apache::thrift::protocol::TNativeClientProtocol;
 using apache::thrift::protocol::TProtocolException;
+using apache::thrift::transport::TBufferedTransport;
+using apache::thrift::transport::TMemoryBuffer;
+using apache::thrift::transport::TTransport;
+using apache::thrift::transport::TTransportException;
 using boost::scoped_ptr;
 using boost::shared_ptr;
 using pp::Var;
 using pp::VarArray;
+using pp::VarArrayBuffer;
 using pp::VarDictionary;
 using std::string;
+using thrift_nacl::DiffVar;
+using thrift_nacl::HashVar;
+using thrift_nacl::MessageCache;
+using thrift_nacl::VarEquals;
 
 double RandomDouble() {
   return rand() / (RAND_MAX + 1.0);
@@ -69,6 +89,33 @@ shared_ptr<Var> CreateStringVar(const string& key, const string& value) {
 }
 
 
+class TestServiceHandler : public TestServiceIf {
+ public:
+  TestServiceHandler() : last_ping_(0) {}
+
+  void echo(String& _return, const String& s) {
+    _return = s;
+  }
+
+  void ping(const int32_t value) {
+    last_ping_ = value;
+  }
+
+  int32_t last_ping() const { return last_ping_; }
+
+ private:
+  int32_t last_ping_;
+};
+
+VarDictionary CreateCallVar(const string& id, const string& type,
+                            const Var& data) {
+  VarDictionary message;
+  message.Set(Var("id"), Var(id));
+  message.Set(Var("type"), Var(type));
+  message.Set(Var("data"), data);
+  return message;
+}
+
 Person* CreateTestPerson() {
   Person* person = new Person();
   person->set_name("John");
@@ -269,7 +316,7 @@ TEST(ThriftNaclTest, StringTest) {
   ASSERT_TRUE(*obj == *obj2);
 }
 
-TEST(ThriftNaclTest, Base64Test) {
+TEST(ThriftNaclTest, ArrayBufferTest) {
   for (int i = 0; i < 1000; i++) {
     shared_ptr<TNativeClientProtocol> protocol(new TNativeClientProtocol());
     shared_ptr<BinaryData> data(new BinaryData());
@@ -278,15 +325,489 @@ TEST(ThriftNaclTest, Base64Test) {
     data->set_data(s);
     data->write(protocol.get());
 
+    VarDictionary data_dict(protocol->getRootVar());
+    VarArrayBuffer buffer(data_dict.Get(Var("data")));
+    ASSERT_TRUE(buffer.is_array_buffer());
+    ASSERT_EQ(s.size(), buffer.ByteLength());
+
+    shared_ptr<TNativeClientProtocol> protocol2(
+        new TNativeClientProtocol(data_dict));
+    scoped_ptr<BinaryData> data2(new BinaryData());
+    data2->read(protocol2.get());
+    string s2 = data2->get_data();
+    ASSERT_TRUE(s == s2);
+  }
+}
+
+TEST(ThriftNaclTest, Base64Test) {
+  for (int i = 0; i < 1000; i++) {
+    shared_ptr<TNativeClientProtocol> protocol(new TNativeClientProtocol());
+    protocol->setBinaryEncoding(TNativeClientProtocol::BINARY_BASE64);
+    shared_ptr<BinaryData> data(new BinaryData());
+    string s;
+    CreateRandomBinaryString(RandomInt(0, 200), &s);
+    data->set_data(s);
+    data->write(protocol.get());
+
     shared_ptr<const Var> data_var(protocol->getVar());
+    ASSERT_TRUE(static_cast<const VarDictionary*>(data_var.get())
+                    ->Get(Var("data")).is_string());
     shared_ptr<TNativeClientProtocol> protocol2(new TNativeClientProtocol(data_var));
     scoped_ptr<BinaryData> data2(new BinaryData());
     data2->read(protocol2.get());
     string s2 = data2->get_data();
     ASSERT_TRUE(s == s2);
+
+    // The JSON protocol encodes the same way, without padding.
+    shared_ptr<TMemoryBuffer> buffer(new TMemoryBuffer());
+    TJSONProtocol json_protocol(buffer);
+    json_protocol.writeBinary(s);
+    string b64 = static_cast<const VarDictionary*>(data_var.get())
+                     ->Get(Var("data")).AsString();
+    ASSERT_EQ("\"" + b64 + "\"", buffer->getBufferAsString());
+    json_protocol.readBinary(s2);
+    ASSERT_TRUE(s == s2);
+
+    // Padding is accepted when decoding.
+    b64.append((4 - b64.size() % 4) % 4, '=');
+    ASSERT_TRUE(apache::thrift::protocol::base64DecodeString(b64, &s2));
+    ASSERT_TRUE(s == s2);
+  }
+
+  string invalid[] = {"A", "QQ=", "QR==", "Q===", "QQ=A", "QUJD\n",
+                      string(40, 'A') + "*" + string(39, 'A')};
+  for (size_t i = 0; i < sizeof(invalid) / sizeof(invalid[0]); ++i) {
+    string s;
+    ASSERT_FALSE(apache::thrift::protocol::base64DecodeString(invalid[i], &s))
+        << invalid[i];
+
+    shared_ptr<TNativeClientProtocol> protocol(
+        new TNativeClientProtocol(CreateStringVar("data", invalid[i])));
+    scoped_ptr<BinaryData> data(new BinaryData());
+    ASSERT_THROW(data->read(protocol.get()), TProtocolException);
+
+    shared_ptr<TMemoryBuffer> buffer(new TMemoryBuffer());
+    TJSONProtocol json_protocol(buffer);
+    json_protocol.writeString(invalid[i]);
+    ASSERT_THROW(json_protocol.readBinary(s), TProtocolException);
+  }
+
+  // Skipped JSON strings are not decoded, so they need not be base64.
+  scoped_ptr<Person> person(CreateTestPerson());
+  person->set_name("Not base64!");
+  shared_ptr<TMemoryBuffer> buffer(new TMemoryBuffer());
+  TJSONProtocol json_protocol(buffer);
+  person->write(&json_protocol);
+  Boolean boolean;
+  boolean.read(&json_protocol);
+  ASSERT_FALSE(boolean.has_value());
+  ASSERT_EQ(0, buffer->available_read());
+
+  // Strings read outside of skip() are decoded again.
+  json_protocol.writeString("Not base64!");
+  string s;
+  ASSERT_THROW(json_protocol.readBinary(s), TProtocolException);
+}
+
+NumericLists* CreateTestNumericLists() {
+  NumericLists* lists = new NumericLists();
+  for (int i = 0; i < 100; ++i) {
+    lists->mutable_bytes()->push_back(static_cast<int8_t>(RandomInt(-128, 128)));
+    lists->mutable_shorts()->push_back(static_cast<int16_t>(RandomInt(-1000, 1000)));
+    lists->mutable_ints()->push_back(RandomInt(-100000, 100000));
+    lists->mutable_doubles()->push_back(RandomDouble());
+    lists->mutable_ids()->insert(RandomInt(0, 1 << 30));
+  }
+  return lists;
+}
+
+TEST(ThriftNaclTest, PackedListTest) {
+  shared_ptr<TNativeClientProtocol> protocol(new TNativeClientProtocol());
+  scoped_ptr<NumericLists> lists(CreateTestNumericLists());
+  lists->write(protocol.get());
+
+  VarDictionary lists_dict(protocol->getRootVar());
+  ASSERT_TRUE(lists_dict.Get(Var("shorts")).is_array());
+
+  VarDictionary doubles_dict(lists_dict.Get(Var("doubles")));
+  ASSERT_TRUE(doubles_dict.is_dictionary());
+  ASSERT_EQ("Float64Array", doubles_dict.Get(Var("__typed_array")).AsString());
+  VarArrayBuffer doubles_buffer(doubles_dict.Get(Var("buffer")));
+  ASSERT_EQ(100 * sizeof(double), doubles_buffer.ByteLength());
+
+  scoped_ptr<NumericLists> lists2(new NumericLists());
+  lists2->read(protocol.get());
+  ASSERT_TRUE(*lists == *lists2);
+
+  // Unpacked lists are still accepted.
+  protocol->setPackedLists(false);
+  lists->write(protocol.get());
+  ASSERT_TRUE(VarDictionary(protocol->getRootVar()).Get(Var("doubles")).is_array());
+  scoped_ptr<NumericLists> lists3(new NumericLists());
+  lists3->read(protocol.get());
+  ASSERT_TRUE(*lists == *lists3);
+
+  // Packed lists must get exactly the declared number of elements.
+  for (int written = 2; written <= 4; written += 2) {
+    shared_ptr<TNativeClientProtocol> protocol2(new TNativeClientProtocol());
+    protocol2->writeStructBegin("NumericLists");
+    protocol2->writeFieldBegin("doubles", apache::thrift::protocol::T_LIST, 4);
+    protocol2->writeListBegin(apache::thrift::protocol::T_DOUBLE, 3);
+    for (int i = 0; i < 3 && i < written; ++i) {
+      protocol2->writeDouble(i);
+    }
+    if (written < 3) {
+      ASSERT_THROW(protocol2->writeListEnd(), TProtocolException);
+    } else {
+      ASSERT_THROW(protocol2->writeDouble(3), TProtocolException);
+    }
+  }
+}
+
+TEST(ThriftNaclTest, BinaryFixedArrayTest) {
+  std::vector<int32_t> ints;
+  std::vector<double> doubles;
+  for (int i = 0; i < 5000; ++i) {
+    ints.push_back(RandomInt(-100000, 100000));
+    doubles.push_back(RandomDouble());
+  }
+
+  // The bulk methods write the same bytes as writing element by element.
+  shared_ptr<TMemoryBuffer> buffer(new TMemoryBuffer());
+  TBinaryProtocol protocol(buffer);
+  protocol.writeI32Array(&ints[0], ints.size());
+  protocol.writeDoubleArray(&doubles[0], doubles.size());
+  shared_ptr<TMemoryBuffer> expected(new TMemoryBuffer());
+  TBinaryProtocol expected_protocol(expected);
+  for (size_t i = 0; i < ints.size(); ++i) {
+    expected_protocol.writeI32(ints[i]);
+  }
+  for (size_t i = 0; i < doubles.size(); ++i) {
+    expected_protocol.writeDouble(doubles[i]);
+  }
+  ASSERT_EQ(expected->getBufferAsString(), buffer->getBufferAsString());
+
+  // Read back from a borrowable buffer, and through a small buffered
+  // transport that makes the protocol fall back to readAll().
+  string bytes = buffer->getBufferAsString();
+  for (int buffered = 0; buffered < 2; ++buffered) {
+    shared_ptr<TTransport> transport(new TMemoryBuffer(
+        reinterpret_cast<uint8_t*>(&bytes[0]), bytes.size()));
+    if (buffered) {
+      transport.reset(new TBufferedTransport(transport, 64));
+    }
+    TBinaryProtocol read_protocol(transport);
+    std::vector<int32_t> ints2(ints.size());
+    std::vector<double> doubles2(doubles.size());
+    ASSERT_EQ(ints.size() * 4, read_protocol.readI32Array(&ints2[0], ints2.size()));
+    ASSERT_EQ(doubles.size() * 8,
+              read_protocol.readDoubleArray(&doubles2[0], doubles2.size()));
+    ASSERT_TRUE(ints == ints2);
+    ASSERT_TRUE(doubles == doubles2);
+  }
+
+  // Generated structs use them for their lists.
+  scoped_ptr<NumericLists> lists(CreateTestNumericLists());
+  buffer->resetBuffer();
+  lists->write(&protocol);
+  scoped_ptr<NumericLists> lists2(new NumericLists());
+  lists2->read(&protocol);
+  ASSERT_TRUE(*lists == *lists2);
+}
+
+TEST(ThriftNaclTest, CompactVarintArrayTest) {
+  // Mostly one-byte varints, with runs of longer ones up to ten bytes.
+  std::vector<int64_t> values;
+  for (int i = 0; i < 5000; ++i) {
+    int64_t value = RandomInt(-64, 64);
+    if (i % 100 >= 90) {
+      value = static_cast<int64_t>(static_cast<uint64_t>(value) << (i % 10) * 7);
+    }
+    values.push_back(value);
+  }
+  values.push_back(std::numeric_limits<int64_t>::min());
+  values.push_back(std::numeric_limits<int64_t>::max());
+  std::vector<int32_t> ints(values.begin(), values.end());
+
+  // The bulk methods write the same bytes as writing element by element.
+  shared_ptr<TMemoryBuffer> buffer(new TMemoryBuffer());
+  TCompactProtocol protocol(buffer);
+  protocol.writeI64Array(&values[0], values.size());
+  protocol.writeI32Array(&ints[0], ints.size());
+  shared_ptr<TMemoryBuffer> expected(new TMemoryBuffer());
+  TCompactProtocol expected_protocol(expected);
+  for (size_t i = 0; i < values.size(); ++i) {
+    expected_protocol.writeI64(values[i]);
+  }
+  for (size_t i = 0; i < ints.size(); ++i) {
+    expected_protocol.writeI32(ints[i]);
+  }
+  ASSERT_EQ(expected->getBufferAsString(), buffer->getBufferAsString());
+
+  // Read back from a borrowable buffer, and through a small buffered
+  // transport whose buffer ends in the middle of varints.
+  string bytes = buffer->getBufferAsString();
+  for (int buffered = 0; buffered < 2; ++buffered) {
+    shared_ptr<TTransport> transport(new TMemoryBuffer(
+        reinterpret_cast<uint8_t*>(&bytes[0]), bytes.size()));
+    if (buffered) {
+      transport.reset(new TBufferedTransport(transport, 61));
+    }
+    TCompactProtocol read_protocol(transport);
+    std::vector<int64_t> values2(values.size());
+    std::vector<int32_t> ints2(ints.size());
+    uint32_t rsize = read_protocol.readI64Array(&values2[0], values2.size());
+    rsize += read_protocol.readI32Array(&ints2[0], ints2.size());
+    ASSERT_EQ(bytes.size(), rsize);
+    ASSERT_TRUE(values == values2);
+    ASSERT_TRUE(ints == ints2);
+  }
+
+  // Generated structs use them for their lists and sets.
+  scoped_ptr<NumericLists> lists(CreateTestNumericLists());
+  buffer->resetBuffer();
+  lists->write(&protocol);
+  scoped_ptr<NumericLists> lists2(new NumericLists());
+  lists2->read(&protocol);
+  ASSERT_TRUE(*lists == *lists2);
+}
+
+// Writes a NumericLists whose ids set claims size elements of type etype,
+// followed by count i64 elements.
+string WriteNumericListsIds(apache::thrift::protocol::TType etype,
+                            uint32_t size, int count) {
+  shared_ptr<TMemoryBuffer> buffer(new TMemoryBuffer());
+  TCompactProtocol protocol(buffer);
+  protocol.writeStructBegin("NumericLists");
+  protocol.writeFieldBegin("ids", apache::thrift::protocol::T_SET, 5);
+  protocol.writeSetBegin(etype, size);
+  for (int i = 0; i < count; ++i) {
+    protocol.writeI64(i);
+  }
+  protocol.writeSetEnd();
+  protocol.writeFieldEnd();
+  protocol.writeFieldStop();
+  protocol.writeStructEnd();
+  return buffer->getBufferAsString();
+}
+
+TEST(ThriftNaclTest, BulkSetReadTest) {
+  // Sets larger than one read chunk are read completely.
+  string bytes =
+      WriteNumericListsIds(apache::thrift::protocol::T_I64, 3000, 3000);
+  shared_ptr<TMemoryBuffer> buffer(new TMemoryBuffer(
+      reinterpret_cast<uint8_t*>(&bytes[0]), bytes.size()));
+  TCompactProtocol protocol(buffer);
+  NumericLists lists;
+  lists.read(&protocol);
+  ASSERT_EQ(3000u, lists.get_ids().size());
+  ASSERT_EQ(1, lists.get_ids().count(2999));
+
+  // Elements of another type are rejected rather than reinterpreted.
+  bytes = WriteNumericListsIds(apache::thrift::protocol::T_I32, 2, 2);
+  buffer.reset(new TMemoryBuffer(
+      reinterpret_cast<uint8_t*>(&bytes[0]), bytes.size()));
+  TCompactProtocol wrong_type_protocol(buffer);
+  ASSERT_THROW(lists.read(&wrong_type_protocol), TProtocolException);
+
+  // A huge size runs out of input without allocating for every element.
+  bytes =
+      WriteNumericListsIds(apache::thrift::protocol::T_I64, 0x7fffffff, 2);
+  buffer.reset(new TMemoryBuffer(
+      reinterpret_cast<uint8_t*>(&bytes[0]), bytes.size()));
+  TCompactProtocol huge_protocol(buffer);
+  ASSERT_THROW(lists.read(&huge_protocol), TTransportException);
+}
+
+string WriteJSONDouble(double value) {
+  shared_ptr<TMemoryBuffer> buffer(new TMemoryBuffer());
+  TJSONProtocol protocol(buffer);
+  protocol.writeDouble(value);
+  return buffer->getBufferAsString();
+}
+
+TEST(ThriftNaclTest, JSONNumberTest) {
+  // Doubles are written with digits that round-trip, usually the shortest
+  // ones, laid out the way JavaScript prints them.
+  ASSERT_EQ("0.1", WriteJSONDouble(0.1));
+  ASSERT_EQ("0.3333333333333333", WriteJSONDouble(1.0 / 3));
+  ASSERT_EQ("123456789012", WriteJSONDouble(123456789012.0));
+  ASSERT_EQ("1e+21", WriteJSONDouble(1e21));
+  ASSERT_EQ("0.000001", WriteJSONDouble(1e-6));
+  ASSERT_EQ("1.5e-7", WriteJSONDouble(1.5e-7));
+  ASSERT_EQ("5e-324", WriteJSONDouble(5e-324));
+  ASSERT_EQ("1.7976931348623157e+308",
+            WriteJSONDouble(std::numeric_limits<double>::max()));
+  ASSERT_EQ("-0", WriteJSONDouble(-0.0));
+  ASSERT_EQ("\"-Infinity\"",
+            WriteJSONDouble(-std::numeric_limits<double>::infinity()));
+
+  std::vector<double> doubles;
+  std::vector<int64_t> ints;
+  for (int i = 0; i < 2000; ++i) {
+    uint64_t bits = (static_cast<uint64_t>(RandomInt(0, 1 << 30)) << 34) ^
+                    (static_cast<uint64_t>(RandomInt(0, 1 << 30)) << 4);
+    double value;
+    memcpy(&value, &bits, sizeof(value));
+    if (value == value) {
+      doubles.push_back(value);
+    }
+    doubles.push_back(RandomInt(-1000, 1000) / 8.0);
+    ints.push_back(static_cast<int64_t>(bits));
+  }
+  ints.push_back(std::numeric_limits<int64_t>::min());
+  ints.push_back(std::numeric_limits<int64_t>::max());
+
+  shared_ptr<TMemoryBuffer> buffer(new TMemoryBuffer());
+  TJSONProtocol protocol(buffer);
+  protocol.writeListBegin(apache::thrift::protocol::T_DOUBLE, doubles.size());
+  for (size_t i = 0; i < doubles.size(); ++i) {
+    protocol.writeDouble(doubles[i]);
+  }
+  protocol.writeListEnd();
+  protocol.writeListBegin(apache::thrift::protocol::T_I64, ints.size());
+  for (size_t i = 0; i < ints.size(); ++i) {
+    protocol.writeI64(ints[i]);
+  }
+  protocol.writeListEnd();
+
+  // Read back from a borrowable buffer, and through a small buffered
+  // transport whose buffer ends in the middle of numbers.
+  string bytes = buffer->getBufferAsString();
+  for (int buffered = 0; buffered < 2; ++buffered) {
+    shared_ptr<TTransport> transport(new TMemoryBuffer(
+        reinterpret_cast<uint8_t*>(&bytes[0]), bytes.size()));
+    if (buffered) {
+      transport.reset(new TBufferedTransport(transport, 61));
+    }
+    TJSONProtocol read_protocol(transport);
+    apache::thrift::protocol::TType type;
+    uint32_t size;
+    read_protocol.readListBegin(type, size);
+    ASSERT_EQ(doubles.size(), size);
+    for (uint32_t i = 0; i < size; ++i) {
+      double value;
+      read_protocol.readDouble(value);
+      ASSERT_EQ(0, memcmp(&value, &doubles[i], sizeof(value)));
+    }
+    read_protocol.readListEnd();
+    read_protocol.readListBegin(type, size);
+    ASSERT_EQ(ints.size(), size);
+    for (uint32_t i = 0; i < size; ++i) {
+      int64_t value;
+      read_protocol.readI64(value);
+      ASSERT_EQ(ints[i], value);
+    }
+    read_protocol.readListEnd();
+  }
+
+  // Out of range, malformed and quoted numbers are rejected.
+  string bad[] = {"[\"i32\",1,2147483648]", "[\"i32\",1,1-2]",
+                  "[\"dbl\",1,1e]", "[\"dbl\",1,\"1.5\"]"};
+  for (size_t i = 0; i < sizeof(bad) / sizeof(bad[0]); ++i) {
+    shared_ptr<TTransport> transport(new TMemoryBuffer(
+        reinterpret_cast<uint8_t*>(&bad[i][0]), bad[i].size()));
+    TJSONProtocol read_protocol(transport);
+    apache::thrift::protocol::TType type;
+    uint32_t size;
+    read_protocol.readListBegin(type, size);
+    int32_t i32;
+    double dub;
+    ASSERT_THROW(type == apache::thrift::protocol::T_I32 ?
+                     read_protocol.readI32(i32) : read_protocol.readDouble(dub),
+                 TProtocolException);
   }
 }
 
+TEST(ThriftNaclTest, JSONStringTest) {
+  shared_ptr<TMemoryBuffer> buffer(new TMemoryBuffer());
+  TJSONProtocol protocol(buffer);
+  protocol.writeString(string("a\"b\\c\n\x01\x7f", 8));
+  ASSERT_EQ("\"a\\\"b\\\\c\\n\\u0001\x7f\"", buffer->getBufferAsString());
+
+  // Strings with special characters at every offset of the vector widths,
+  // nested deeper than the inline context stack.
+  const int kDepth = 40;
+  std::vector<string> strings;
+  for (int length = 0; length < 70; ++length) {
+    for (int offset = 0; offset < length; offset += 7) {
+      string s(length, 'x');
+      s[offset] = "\"\\\t\x1f\x80"[offset % 5];
+      strings.push_back(s);
+    }
+  }
+  string binary;
+  CreateRandomBinaryString(1000, &binary);
+  strings.push_back(binary);
+
+  buffer->resetBuffer();
+  for (int i = 0; i < kDepth; ++i) {
+    protocol.writeListBegin(apache::thrift::protocol::T_LIST, 1);
+  }
+  protocol.writeListBegin(apache::thrift::protocol::T_STRING, strings.size());
+  for (size_t i = 0; i < strings.size(); ++i) {
+    protocol.writeString(strings[i]);
+  }
+  protocol.writeListEnd();
+  for (int i = 0; i < kDepth; ++i) {
+    protocol.writeListEnd();
+  }
+
+  string bytes = buffer->getBufferAsString();
+  for (int buffered = 0; buffered < 2; ++buffered) {
+    shared_ptr<TTransport> transport(new TMemoryBuffer(
+        reinterpret_cast<uint8_t*>(&bytes[0]), bytes.size()));
+    if (buffered) {
+      transport.reset(new TBufferedTransport(transport, 61));
+    }
+    TJSONProtocol read_protocol(transport);
+    apache::thrift::protocol::TType type;
+    uint32_t size;
+    for (int i = 0; i < kDepth; ++i) {
+      read_protocol.readListBegin(type, size);
+      ASSERT_EQ(1, size);
+    }
+    read_protocol.readListBegin(type, size);
+    ASSERT_EQ(strings.size(), size);
+    for (uint32_t i = 0; i < size; ++i) {
+      string value;
+      read_protocol.readString(value);
+      ASSERT_EQ(strings[i], value);
+    }
+    read_protocol.readListEnd();
+    for (int i = 0; i < kDepth; ++i) {
+      read_protocol.readListEnd();
+    }
+  }
+}
+
+TEST(ThriftNaclTest, DedupSubtreesTest) {
+  shared_ptr<TNativeClientProtocol> protocol(new TNativeClientProtocol());
+  protocol->setDedupSubtrees(true);
+  scoped_ptr<Person> person(CreateTestPerson());
+  (*person->mutable_objlist())[1].set_s("other");
+  person->mutable_objlist()->push_back(person->get_objlist()[0]);
+  person->write(protocol.get());
+
+  VarDictionary person_dict(protocol->getRootVar());
+  VarArray objlist(person_dict.Get(Var("objlist")));
+  VarDictionary objdict(person_dict.Get(Var("objdict")));
+  ASSERT_TRUE(objlist.Get(0) == objlist.Get(2));
+  ASSERT_FALSE(objlist.Get(0) == objlist.Get(1));
+  ASSERT_TRUE(objdict.Get(Var("c")) == objlist.Get(0));
+  ASSERT_TRUE(objdict.Get(Var("d")) == objlist.Get(0));
+
+  scoped_ptr<Person> person2(new Person());
+  person2->read(protocol.get());
+  ASSERT_TRUE(*person == *person2);
+
+  // Without deduplication every struct gets its own var.
+  protocol->setDedupSubtrees(false);
+  person->write(protocol.get());
+  objlist = VarArray(VarDictionary(protocol->getRootVar()).Get(Var("objlist")));
+  ASSERT_FALSE(objlist.Get(0) == objlist.Get(2));
+}
+
 TEST(ThriftNaclTest, UndefinedTest) {
   shared_ptr<TNativeClientProtocol> protocol(new TNativeClientProtocol());
   shared_ptr<Number> number(new Number());
@@ -446,6 +967,415 @@ TEST(ThriftNaclTest, ReadTest) {
   ASSERT_TRUE(*person == *person2);
 }
 
+TEST(ThriftNaclTest, KeyEnumerationReadTest) {
+  shared_ptr<TNativeClientProtocol> protocol(new TNativeClientProtocol());
+  shared_ptr<Person> person(CreateTestPerson());
+  person->write(protocol.get());
+
+  VarDictionary person_var(protocol->getRootVar());
+  person_var.Set(Var("unknown"), Var(1));
+  person_var.Set(Var("name"), Var(Var::Null()));
+
+  TNativeClientProtocol protocol2(person_var);
+  protocol2.setFieldOrderedReads(false);
+  Person person2;
+  person2.read(&protocol2);
+
+  ASSERT_FALSE(person2.has_name());
+  person2.set_name(person->get_name());
+  ASSERT_TRUE(*person == person2);
+}
+
+TEST(ThriftNaclTest, ViewTest) {
+  shared_ptr<TNativeClientProtocol> protocol(new TNativeClientProtocol());
+  shared_ptr<Person> person(CreateTestPerson());
+  person->write(protocol.get());
+
+  PersonView view(protocol->getRootVar());
+  ASSERT_TRUE(view.has_name());
+  ASSERT_EQ(person->get_name(), view.get_name());
+  ASSERT_EQ(person->get_name(), view.get_name());
+  ASSERT_TRUE(view.get_birthday() == person->get_birthday());
+  ASSERT_TRUE(view.get_dict() == person->get_dict());
+  ASSERT_TRUE(view.get_objlist() == person->get_objlist());
+  ASSERT_TRUE(view.get_params() == person->get_params());
+
+  // Absent fields read as the defaults of the struct.
+  VarDictionary person_var(protocol->getRootVar());
+  person_var.Delete(Var("weight"));
+  PersonView view2(person_var);
+  ASSERT_FALSE(view2.has_weight());
+  ASSERT_EQ(0.0, view2.get_weight());
+
+  PersonView empty_view;
+  ASSERT_FALSE(empty_view.has_name());
+  ASSERT_EQ("", empty_view.get_name());
+}
+
+TEST(ThriftNaclTest, ProcessorTest) {
+  shared_ptr<TestServiceHandler> handler(new TestServiceHandler());
+  TestServiceProcessor processor(handler);
+
+  VarDictionary s;
+  s.Set(Var("s"), Var("hello"));
+  VarDictionary echo_args;
+  echo_args.Set(Var("s"), s);
+
+  shared_ptr<TNativeClientProtocol> in(
+      new TNativeClientProtocol(CreateCallVar("7", "echo", echo_args)));
+  shared_ptr<TNativeClientProtocol> out(new TNativeClientProtocol());
+  ASSERT_TRUE(processor.process(in, out, NULL));
+
+  VarDictionary reply(out->getRootVar());
+  ASSERT_EQ("7", reply.Get(Var("id")).AsString());
+  ASSERT_FALSE(reply.HasKey(Var("type")));
+  VarDictionary result(reply.Get(Var("data")));
+  VarDictionary success(result.Get(Var("success")));
+  ASSERT_EQ("hello", success.Get(Var("s")).AsString());
+
+  // Oneway calls write no reply.
+  VarDictionary ping_args;
+  ping_args.Set(Var("value"), Var(3));
+  in->setRootVar(CreateCallVar("8", "ping", ping_args));
+  out->reset();
+  ASSERT_TRUE(processor.process(in, out, NULL));
+  ASSERT_EQ(3, handler->last_ping());
+  ASSERT_TRUE(out->getRootVar().is_undefined());
+
+  in->setRootVar(CreateCallVar("9", "unknown", VarDictionary()));
+  out->reset();
+  processor.process(in, out, NULL);
+  reply = VarDictionary(out->getRootVar());
+  ASSERT_EQ("9", reply.Get(Var("id")).AsString());
+  ASSERT_TRUE(reply.Get(Var("error")).is_dictionary());
+
+  in->setRootVar(CreateCallVar("x", "echo", echo_args));
+  ASSERT_THROW(processor.process(in, out, NULL), TProtocolException);
+}
+
+TEST(ThriftNaclTest, ClientCallTest) {
+  shared_ptr<TNativeClientProtocol> protocol(new TNativeClientProtocol());
+  TestServiceClient client(protocol);
+  String s;
+  s.set_s("hello");
+  client.send_echo(s);
+
+  VarDictionary call(protocol->getRootVar());
+  ASSERT_EQ("echo", call.Get(Var("type")).AsString());
+  ASSERT_TRUE(call.Get(Var("id")).is_string());
+  VarDictionary args(call.Get(Var("data")));
+  VarDictionary arg(args.Get(Var("s")));
+  ASSERT_EQ("hello", arg.Get(Var("s")).AsString());
+}
+
+// Returns a copy of the var tree of var, which shares no array or dictionary
+// with it.
+Var CopyVar(const Var& var) {
+  if (var.is_array()) {
+    VarArray array(var);
+    VarArray copy;
+    for (uint32_t i = 0; i < array.GetLength(); ++i) {
+      copy.Set(i, CopyVar(array.Get(i)));
+    }
+    return copy;
+  }
+  if (var.is_dictionary()) {
+    VarDictionary dict(var);
+    VarDictionary copy;
+    VarArray keys = dict.GetKeys();
+    for (uint32_t i = 0; i < keys.GetLength(); ++i) {
+      copy.Set(keys.Get(i), CopyVar(dict.Get(keys.Get(i))));
+    }
+    return copy;
+  }
+  return var;
+}
+
+// Applies a patch made by DiffVar() to value, in place, the way applyPatch()
+// in thrift_nacl.js does, and returns the result.
+Var ApplyPatch(const Var& value, const VarDictionary& patch) {
+  if (patch.HasKey(Var("length"))) {
+    VarArray(value).SetLength(patch.Get(Var("length")).AsInt());
+  }
+  if (patch.HasKey(Var("delete"))) {
+    VarArray deleted(patch.Get(Var("delete")));
+    for (uint32_t i = 0; i < deleted.GetLength(); ++i) {
+      VarDictionary(value).Delete(deleted.Get(i));
+    }
+  }
+  const char* kinds[] = {"set", "patch"};
+  for (int kind = 0; kind < 2; ++kind) {
+    if (!patch.HasKey(Var(kinds[kind]))) {
+      continue;
+    }
+    VarDictionary entries(patch.Get(Var(kinds[kind])));
+    VarArray keys = entries.GetKeys();
+    for (uint32_t i = 0; i < keys.GetLength(); ++i) {
+      Var key = keys.Get(i);
+      Var entry = entries.Get(key);
+      if (value.is_array()) {
+        uint32_t index = atoi(key.AsString().c_str());
+        VarArray array(value);
+        array.Set(index, kind == 0 ? entry : ApplyPatch(array.Get(index),
+                                                        VarDictionary(entry)));
+      } else {
+        VarDictionary dict(value);
+        dict.Set(key, kind == 0 ? entry : ApplyPatch(dict.Get(key),
+                                                     VarDictionary(entry)));
+      }
+    }
+  }
+  return value;
+}
+
+Var WriteVar(const apache::thrift::TStruct& value) {
+  TNativeClientProtocol protocol;
+  value.write(&protocol);
+  return protocol.getRootVar();
+}
+
+// Checks that the patch from from to to turns a copy of from into to.
+void ExpectPatchRoundTrip(const Var& from, const Var& to) {
+  VarDictionary patch;
+  thrift_nacl::DiffResult result = DiffVar(from, to, &patch);
+  if (VarEquals(from, to)) {
+    EXPECT_EQ(thrift_nacl::DIFF_UNCHANGED, result);
+    EXPECT_EQ(0u, patch.GetKeys().GetLength());
+    return;
+  }
+  ASSERT_EQ(thrift_nacl::DIFF_PATCHED, result);
+  EXPECT_TRUE(VarEquals(to, ApplyPatch(CopyVar(from), patch)));
+}
+
+TEST(ThriftNaclTest, DiffVarTest) {
+  VarDictionary from;
+  from.Set(Var("a"), Var(1));
+  from.Set(Var("b"), Var("x"));
+  VarDictionary nested;
+  nested.Set(Var("y"), Var(2));
+  from.Set(Var("c"), nested);
+  VarArray list;
+  for (int i = 0; i < 3; ++i) {
+    list.Set(i, Var(i));
+  }
+  from.Set(Var("d"), list);
+
+  VarDictionary patch;
+  ASSERT_EQ(thrift_nacl::DIFF_UNCHANGED, DiffVar(from, CopyVar(from), &patch));
+  ASSERT_EQ(0u, patch.GetKeys().GetLength());
+
+  // Replaced and new fields are set, removed fields deleted.
+  VarDictionary to(CopyVar(from));
+  to.Set(Var("a"), Var(2));
+  to.Delete(Var("b"));
+  to.Set(Var("e"), Var(true));
+  ASSERT_EQ(thrift_nacl::DIFF_PATCHED, DiffVar(from, to, &patch));
+  ASSERT_EQ(2u, patch.GetKeys().GetLength());
+  VarDictionary set(patch.Get(Var("set")));
+  ASSERT_EQ(2u, set.GetKeys().GetLength());
+  ASSERT_EQ(2, set.Get(Var("a")).AsInt());
+  ASSERT_TRUE(set.Get(Var("e")).AsBool());
+  VarArray deleted(patch.Get(Var("delete")));
+  ASSERT_EQ(1u, deleted.GetLength());
+  ASSERT_EQ("b", deleted.Get(0).AsString());
+
+  // Nested containers are patched in place.
+  to = VarDictionary(CopyVar(from));
+  VarDictionary(to.Get(Var("c"))).Set(Var("y"), Var(3));
+  patch = VarDictionary();
+  ASSERT_EQ(thrift_nacl::DIFF_PATCHED, DiffVar(from, to, &patch));
+  ASSERT_EQ(1u, patch.GetKeys().GetLength());
+  VarDictionary sub_patch(VarDictionary(patch.Get(Var("patch"))).Get(Var("c")));
+  ASSERT_EQ(3, VarDictionary(sub_patch.Get(Var("set"))).Get(Var("y")).AsInt());
+
+  // Shrunk lists get their new length, grown lists also their new elements.
+  to = VarDictionary(CopyVar(from));
+  VarArray to_list(to.Get(Var("d")));
+  to_list.SetLength(2);
+  to_list.Set(1, Var(5));
+  patch = VarDictionary();
+  ASSERT_EQ(thrift_nacl::DIFF_PATCHED, DiffVar(from, to, &patch));
+  sub_patch = VarDictionary(VarDictionary(patch.Get(Var("patch"))).Get(Var("d")));
+  ASSERT_EQ(2, sub_patch.Get(Var("length")).AsInt());
+  set = VarDictionary(sub_patch.Get(Var("set")));
+  ASSERT_EQ(1u, set.GetKeys().GetLength());
+  ASSERT_EQ(5, set.Get(Var("1")).AsInt());
+  ExpectPatchRoundTrip(from, to);
+
+  to_list.SetLength(4);
+  to_list.Set(1, Var(1));
+  to_list.Set(2, Var(2));
+  to_list.Set(3, Var(3));
+  patch = VarDictionary();
+  ASSERT_EQ(thrift_nacl::DIFF_PATCHED, DiffVar(from, to, &patch));
+  sub_patch = VarDictionary(VarDictionary(patch.Get(Var("patch"))).Get(Var("d")));
+  ASSERT_EQ(4, sub_patch.Get(Var("length")).AsInt());
+  set = VarDictionary(sub_patch.Get(Var("set")));
+  ASSERT_EQ(1u, set.GetKeys().GetLength());
+  ASSERT_EQ(3, set.Get(Var("3")).AsInt());
+  ExpectPatchRoundTrip(from, to);
+
+  // Vars of a different type are replaced.
+  patch = VarDictionary();
+  ASSERT_EQ(thrift_nacl::DIFF_REPLACED, DiffVar(Var(1), Var("1"), &patch));
+  ASSERT_EQ(thrift_nacl::DIFF_REPLACED, DiffVar(from, list, &patch));
+  ASSERT_EQ(0u, patch.GetKeys().GetLength());
+}
+
+TEST(ThriftNaclTest, DiffVarRoundTripTest) {
+  scoped_ptr<Person> person(CreateTestPerson());
+  Var from = WriteVar(*person);
+
+  std::vector<Person> changes;
+  for (int i = 0; i < 10; ++i) {
+    changes.push_back(*person);
+  }
+  changes[1].set_name("Jane");
+  // Without the optional name.
+  changes[2] = Person();
+  changes[2].set_weight(person->get_weight());
+  changes[2].set_birthday(person->get_birthday());
+  changes[2].set_dict(person->get_dict());
+  changes[2].set_objlist(person->get_objlist());
+  changes[2].set_objdict(person->get_objdict());
+  changes[2].set_params(person->get_params());
+  changes[3].mutable_birthday()->set_year(1971);
+  (*changes[4].mutable_dict())["c"] = 3;
+  changes[4].mutable_dict()->erase("a");
+  changes[5].mutable_objlist()->resize(3);
+  (*changes[5].mutable_objlist())[2].set_s("new");
+  changes[6].mutable_objlist()->resize(1);
+  (*changes[7].mutable_objlist())[1].set_s("other");
+  (*changes[7].mutable_objdict())["d"].set_s("other");
+  changes[8].mutable_params()->insert("p3");
+  changes[9].set_b("bytes");
+
+  for (size_t i = 0; i < changes.size(); ++i) {
+    SCOPED_TRACE(i);
+    Var to = WriteVar(changes[i]);
+    ExpectPatchRoundTrip(from, to);
+    ExpectPatchRoundTrip(to, from);
+  }
+
+  // Packed lists are replaced whole.
+  scoped_ptr<NumericLists> lists(CreateTestNumericLists());
+  from = WriteVar(*lists);
+  (*lists->mutable_doubles())[50] += 1;
+  Var to = WriteVar(*lists);
+  VarDictionary patch;
+  ASSERT_EQ(thrift_nacl::DIFF_PATCHED, DiffVar(from, to, &patch));
+  VarDictionary set(patch.Get(Var("set")));
+  ASSERT_EQ(1u, set.GetKeys().GetLength());
+  ASSERT_TRUE(set.HasKey(Var("doubles")));
+  ExpectPatchRoundTrip(from, to);
+}
+
+TEST(ThriftNaclTest, HashVarTest) {
+  scoped_ptr<Person> person(CreateTestPerson());
+  Var a = WriteVar(*person);
+
+  // The same entries set in another order.
+  VarDictionary b;
+  VarDictionary a_dict(a);
+  VarArray keys = a_dict.GetKeys();
+  for (uint32_t i = keys.GetLength(); i > 0; --i) {
+    b.Set(keys.Get(i - 1), CopyVar(a_dict.Get(keys.Get(i - 1))));
+  }
+  ASSERT_TRUE(VarEquals(a, b));
+  ASSERT_EQ(HashVar(a), HashVar(b));
+
+  person->set_weight(person->get_weight() + 1);
+  Var c = WriteVar(*person);
+  ASSERT_FALSE(VarEquals(a, c));
+  ASSERT_NE(HashVar(a), HashVar(c));
+
+  // Vars of different types or with their elements in another order differ.
+  ASSERT_NE(HashVar(Var("1")), HashVar(Var(1)));
+  ASSERT_NE(HashVar(Var(true)), HashVar(Var(false)));
+  ASSERT_NE(HashVar(Var(Var::Null())), HashVar(Var()));
+  VarArray ab;
+  ab.Set(0, Var("a"));
+  ab.Set(1, Var("b"));
+  VarArray ba;
+  ba.Set(0, Var("b"));
+  ba.Set(1, Var("a"));
+  ASSERT_FALSE(VarEquals(ab, ba));
+  ASSERT_NE(HashVar(ab), HashVar(ba));
+  VarDictionary a_to_b;
+  a_to_b.Set(Var("a"), Var("b"));
+  VarDictionary b_to_a;
+  b_to_a.Set(Var("b"), Var("a"));
+  ASSERT_FALSE(VarEquals(a_to_b, b_to_a));
+  ASSERT_NE(HashVar(a_to_b), HashVar(b_to_a));
+
+  VarArrayBuffer buffer1(4);
+  VarArrayBuffer buffer2(4);
+  ASSERT_TRUE(VarEquals(buffer1, buffer2));
+  ASSERT_EQ(HashVar(buffer1), HashVar(buffer2));
+  static_cast<uint8_t*>(buffer2.Map())[3] = 1;
+  buffer2.Unmap();
+  ASSERT_FALSE(VarEquals(buffer1, buffer2));
+  ASSERT_NE(HashVar(buffer1), HashVar(buffer2));
+}
+
+Var CreateRequest(int32_t value) {
+  VarDictionary request;
+  request.Set(Var("value"), Var(value));
+  return request;
+}
+
+TEST(ThriftNaclTest, MessageCacheTest) {
+  MessageCache cache(2);
+  Var a = CreateRequest(1);
+  Var b = CreateRequest(2);
+  Var c = CreateRequest(3);
+  Var response;
+
+  ASSERT_FALSE(cache.Lookup(a, HashVar(a), &response));
+  cache.Insert(a, HashVar(a), Var("a"));
+  cache.Insert(b, HashVar(b), Var("b"));
+
+  // Equal requests hit.
+  ASSERT_TRUE(cache.Lookup(CreateRequest(1), HashVar(a), &response));
+  ASSERT_EQ("a", response.AsString());
+
+  // a was used last, so b is evicted.
+  cache.Insert(c, HashVar(c), Var("c"));
+  ASSERT_FALSE(cache.Lookup(b, HashVar(b), &response));
+  ASSERT_TRUE(cache.Lookup(a, HashVar(a), &response));
+  ASSERT_EQ("a", response.AsString());
+  ASSERT_TRUE(cache.Lookup(c, HashVar(c), &response));
+  ASSERT_EQ("c", response.AsString());
+
+  uint64_t hits;
+  uint64_t misses;
+  cache.GetStats(true, &hits, &misses);
+  ASSERT_EQ(3u, hits);
+  ASSERT_EQ(2u, misses);
+  cache.GetStats(false, &hits, &misses);
+  ASSERT_EQ(0u, hits);
+  ASSERT_EQ(0u, misses);
+}
+
+TEST(ThriftNaclTest, MessageCacheCollisionTest) {
+  MessageCache cache(2);
+  Var a = CreateRequest(1);
+  Var b = CreateRequest(2);
+  Var response;
+
+  // A request with the hash of a cached one but other data misses.
+  cache.Insert(a, 42, Var("a"));
+  ASSERT_FALSE(cache.Lookup(b, 42, &response));
+  ASSERT_TRUE(cache.Lookup(a, 42, &response));
+  ASSERT_EQ("a", response.AsString());
+
+  // And replaces it when inserted.
+  cache.Insert(b, 42, Var("b"));
+  ASSERT_FALSE(cache.Lookup(a, 42, &response));
+  ASSERT_TRUE(cache.Lookup(b, 42, &response));
+  ASSERT_EQ("b", response.AsString());
+}
+
 int test_main(int argc, char* argv[]) {
   srand(time(NULL));
   ::testing::InitGoogleTest(&argc, argv);
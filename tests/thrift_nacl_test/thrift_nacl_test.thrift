@@ -35,3 +35,16 @@ struct Person {
   8:binary b;
 }
 
+
+struct NumericLists {
+  1:list<byte> bytes,
+  2:list<i16> shorts,
+  3:list<i32> ints,
+  4:list<double> doubles,
+  5:set<i64> ids
+}
+
+service TestService {
+  String echo(1:String s),
+  oneway void ping(1:i32 value)
+}